@@ -0,0 +1,342 @@
+#include "AssetPack.h"
+#include "LZ4Block.h"
+#include <string.h>
+#include <algorithm>
+
+namespace
+{
+    // Orders names as std::string does, which is the order the writer sorts
+    // them in.
+    int CompareNames(const char* a, size_t aLength, const char* b, size_t bLength)
+    {
+        int result = memcmp(a, b, std::min(aLength, bLength));
+        if (result != 0)
+        {
+            return result;
+        }
+        return (aLength < bLength) ? -1 : (aLength > bLength ? 1 : 0);
+    }
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+std::string NormalizeAssetName(_In_z_ const char* name)
+{
+    std::string normalized;
+    for (const char* c = name; *c; c++)
+    {
+        char ch = (*c == '\\') ? '/' : *c;
+        if (ch >= 'A' && ch <= 'Z')
+        {
+            ch = static_cast<char>(ch - 'A' + 'a');
+        }
+        normalized.push_back(ch);
+    }
+
+    size_t start = 0;
+    while (true)
+    {
+        if (normalized.compare(start, 2, "./") == 0)
+        {
+            start += 2;
+        }
+        else if (normalized.compare(start, 1, "/") == 0)
+        {
+            start += 1;
+        }
+        else
+        {
+            break;
+        }
+    }
+    return normalized.substr(start);
+}
+
+AssetPack::AssetPack() :
+    m_entries(nullptr),
+    m_entryCount(0),
+    m_names(nullptr),
+    m_namesSize(0)
+{
+}
+
+bool AssetPack::Open(_In_z_ const MappedFile::PathChar* path)
+{
+    MappedFile file;
+    if (!file.Open(path))
+    {
+        Close();
+        return false;
+    }
+    return Open(std::move(file));
+}
+
+bool AssetPack::Open(MappedFile&& file)
+{
+    Close();
+
+    const uint8_t* data = file.Data();
+    size_t size = file.Size();
+    if (!data || size < sizeof(AssetPackHeader))
+    {
+        return false;
+    }
+
+    AssetPackHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != AssetPackMagic || header.version != AssetPackVersion ||
+        header.alignment == 0 || (header.alignment & (header.alignment - 1)) != 0)
+    {
+        return false;
+    }
+
+    if (header.indexOffset > size || header.indexSize > size - header.indexOffset ||
+        header.entryCount > header.indexSize / sizeof(AssetPackEntry))
+    {
+        return false;
+    }
+
+    const AssetPackEntry* entries = reinterpret_cast<const AssetPackEntry*>(data + header.indexOffset);
+    const char* names = reinterpret_cast<const char*>(entries + header.entryCount);
+    size_t namesSize = static_cast<size_t>(header.indexSize - header.entryCount * sizeof(AssetPackEntry));
+
+    // Validate every entry once here, so that lookups and reads can trust the
+    // index.
+    for (size_t i = 0; i < header.entryCount; i++)
+    {
+        const AssetPackEntry& entry = entries[i];
+        if (entry.offset > header.indexOffset || entry.storedSize > header.indexOffset - entry.offset ||
+            entry.size > SIZE_MAX || entry.nameOffset > namesSize || entry.nameLength > namesSize - entry.nameOffset)
+        {
+            return false;
+        }
+
+        switch (static_cast<AssetCompression>(entry.compression))
+        {
+        case AssetCompression::None:
+            if (entry.storedSize != entry.size)
+            {
+                return false;
+            }
+            break;
+
+        case AssetCompression::LZ4:
+            // Each LZ4 length byte adds at most 255 bytes, which bounds the
+            // unpacked size before anything is allocated for it.
+            if (entry.size / 255 > entry.storedSize)
+            {
+                return false;
+            }
+            break;
+
+        default:
+            return false;
+        }
+
+        if (i > 0)
+        {
+            const AssetPackEntry& previous = entries[i - 1];
+            if (CompareNames(names + previous.nameOffset, previous.nameLength, names + entry.nameOffset, entry.nameLength) >= 0)
+            {
+                return false;
+            }
+        }
+    }
+
+    m_file = std::make_shared<const MappedFile>(std::move(file));
+    m_entries = entries;
+    m_entryCount = header.entryCount;
+    m_names = names;
+    m_namesSize = namesSize;
+    return true;
+}
+
+void AssetPack::Close()
+{
+    m_file.reset();
+    m_entries = nullptr;
+    m_entryCount = 0;
+    m_names = nullptr;
+    m_namesSize = 0;
+}
+
+std::string AssetPack::GetName(size_t index) const
+{
+    return std::string(m_names + m_entries[index].nameOffset, m_entries[index].nameLength);
+}
+
+size_t AssetPack::Find(_In_z_ const char* name) const
+{
+    std::string normalized = NormalizeAssetName(name);
+
+    size_t low = 0;
+    size_t high = m_entryCount;
+    while (low < high)
+    {
+        size_t middle = low + (high - low) / 2;
+        const AssetPackEntry& entry = m_entries[middle];
+        int order = CompareNames(m_names + entry.nameOffset, entry.nameLength, normalized.data(), normalized.size());
+        if (order == 0)
+        {
+            return middle;
+        }
+        if (order < 0)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return NotFound;
+}
+
+bool AssetPack::Read(size_t index, _Out_ std::vector<uint8_t>* data) const
+{
+    const AssetPackEntry& entry = m_entries[index];
+    const uint8_t* stored = m_file->Data() + entry.offset;
+
+    data->resize(static_cast<size_t>(entry.size));
+    if (entry.size == 0)
+    {
+        return true;
+    }
+
+    if (static_cast<AssetCompression>(entry.compression) == AssetCompression::None)
+    {
+        memcpy(data->data(), stored, data->size());
+        return true;
+    }
+
+    if (!LZ4DecompressBlock(stored, static_cast<size_t>(entry.storedSize), data->data(), data->size()))
+    {
+        data->clear();
+        return false;
+    }
+    return true;
+}
+
+MappedFile AssetPack::Map(size_t index) const
+{
+    const AssetPackEntry& entry = m_entries[index];
+    if (entry.size == 0)
+    {
+        return MappedFile();
+    }
+
+    if (static_cast<AssetCompression>(entry.compression) == AssetCompression::None)
+    {
+        return MappedFile(m_file, m_file->Data() + entry.offset, static_cast<size_t>(entry.size));
+    }
+
+    auto unpacked = std::make_shared<std::vector<uint8_t>>();
+    if (!Read(index, unpacked.get()))
+    {
+        return MappedFile();
+    }
+    const uint8_t* data = unpacked->data();
+    size_t size = unpacked->size();
+    return MappedFile(std::move(unpacked), data, size);
+}
+
+AssetPackWriter::AssetPackWriter(uint32_t alignment) :
+    m_alignment((alignment != 0 && (alignment & (alignment - 1)) == 0) ? alignment : AssetPackDefaultAlignment)
+{
+}
+
+bool AssetPackWriter::Add(
+    _In_z_ const char* name,
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    bool compress
+)
+{
+    PendingEntry entry;
+    entry.name = NormalizeAssetName(name);
+    if (entry.name.empty() || entry.name.size() > UINT16_MAX)
+    {
+        return false;
+    }
+    for (const auto& existing : m_entries)
+    {
+        if (existing.name == entry.name)
+        {
+            return false;
+        }
+    }
+
+    entry.size = size;
+    entry.compression = AssetCompression::None;
+
+    if (compress && size > 0)
+    {
+        entry.data.resize(LZ4CompressBound(size));
+        size_t compressedSize = LZ4CompressBlock(data, size, entry.data.data(), entry.data.size());
+        if (compressedSize != 0 && compressedSize <= size - size / 8)
+        {
+            entry.data.resize(compressedSize);
+            entry.compression = AssetCompression::LZ4;
+        }
+    }
+
+    if (entry.compression == AssetCompression::None)
+    {
+        entry.data.assign(data, data + size);
+    }
+
+    m_entries.push_back(std::move(entry));
+    return true;
+}
+
+void AssetPackWriter::Write(_Out_ std::vector<uint8_t>* pack) const
+{
+    std::vector<const PendingEntry*> sorted;
+    for (const auto& entry : m_entries)
+    {
+        sorted.push_back(&entry);
+    }
+    std::sort(sorted.begin(), sorted.end(), [](const PendingEntry* a, const PendingEntry* b) { return a->name < b->name; });
+
+    // Data first, each entry aligned, then the index.
+    std::vector<AssetPackEntry> index(sorted.size());
+    std::string names;
+    uint64_t offset = AlignUp(sizeof(AssetPackHeader), m_alignment);
+    for (size_t i = 0; i < sorted.size(); i++)
+    {
+        index[i].offset = offset;
+        index[i].storedSize = sorted[i]->data.size();
+        index[i].size = sorted[i]->size;
+        index[i].nameOffset = static_cast<uint32_t>(names.size());
+        index[i].nameLength = static_cast<uint16_t>(sorted[i]->name.size());
+        index[i].compression = static_cast<uint16_t>(sorted[i]->compression);
+        names += sorted[i]->name;
+        offset = AlignUp(offset + sorted[i]->data.size(), m_alignment);
+    }
+
+    AssetPackHeader header = {};
+    header.magic = AssetPackMagic;
+    header.version = AssetPackVersion;
+    header.entryCount = static_cast<uint32_t>(index.size());
+    header.alignment = m_alignment;
+    header.indexOffset = offset;
+    header.indexSize = index.size() * sizeof(AssetPackEntry) + names.size();
+
+    pack->assign(static_cast<size_t>(header.indexOffset + header.indexSize), 0);
+    memcpy(pack->data(), &header, sizeof(header));
+    for (size_t i = 0; i < sorted.size(); i++)
+    {
+        if (!sorted[i]->data.empty())
+        {
+            memcpy(pack->data() + index[i].offset, sorted[i]->data.data(), sorted[i]->data.size());
+        }
+    }
+    if (!index.empty())
+    {
+        memcpy(pack->data() + header.indexOffset, index.data(), index.size() * sizeof(AssetPackEntry));
+    }
+    memcpy(pack->data() + header.indexOffset + index.size() * sizeof(AssetPackEntry), names.data(), names.size());
+}
@@ -0,0 +1,138 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+#include "BasicSal.h"
+#include "MappedFile.h"
+
+// An asset pack is one file holding many assets, so that loading them costs a
+// single open and a single mapping instead of one of each per asset. Layout,
+// all integers little-endian:
+//
+//   AssetPackHeader                 at offset 0
+//   entry data                      each entry at a multiple of the alignment
+//   AssetPackEntry[entryCount]      at indexOffset, sorted by name
+//   names                           UTF-8, not terminated
+//
+// Stored entries can be used in place from the mapping; compressed entries are
+// unpacked on read. Names are normalized by NormalizeAssetName.
+
+const uint32_t AssetPackMagic = 0x4B415041; // "APAK"
+const uint32_t AssetPackVersion = 1;
+const uint32_t AssetPackDefaultAlignment = 4096;
+
+enum class AssetCompression : uint16_t
+{
+    None = 0,
+    LZ4 = 1,    // one LZ4 block; see LZ4Block.h
+};
+
+#pragma pack(push, 1)
+struct AssetPackHeader
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t alignment;
+    uint64_t indexOffset;
+    uint64_t indexSize;
+};
+
+struct AssetPackEntry
+{
+    uint64_t offset;
+    uint64_t storedSize;        // bytes in the pack
+    uint64_t size;              // bytes once unpacked
+    uint32_t nameOffset;        // from the start of the names
+    uint16_t nameLength;
+    uint16_t compression;       // an AssetCompression
+};
+#pragma pack(pop)
+
+static_assert(sizeof(AssetPackHeader) == 32, "AssetPackHeader must match the file layout");
+static_assert(sizeof(AssetPackEntry) == 32, "AssetPackEntry must match the file layout");
+
+// Makes a path into the form names are stored and looked up in: '/'
+// separators, ASCII letters in lower case, and no leading "./" or '/'. Paths
+// on Windows are case-insensitive, so lookups should be too.
+std::string NormalizeAssetName(_In_z_ const char* name);
+
+// Reads a pack through a read-only mapping. All const methods may be called
+// from several threads at once.
+class AssetPack
+{
+public:
+    static const size_t NotFound = SIZE_MAX;
+
+    AssetPack();
+
+    // Maps the pack at path and validates its index. Returns false if the
+    // file cannot be mapped or is not a well-formed pack.
+    bool Open(_In_z_ const MappedFile::PathChar* path);
+    bool Open(MappedFile&& file);
+    void Close();
+    bool IsOpen() const { return m_file != nullptr; }
+
+    size_t GetEntryCount() const { return m_entryCount; }
+    const AssetPackEntry& GetEntry(size_t index) const { return m_entries[index]; }
+    std::string GetName(size_t index) const;
+
+    // Returns the index of the entry named name (normalized first), or
+    // NotFound.
+    size_t Find(_In_z_ const char* name) const;
+
+    // Copies or unpacks an entry into data. Returns false if a compressed
+    // entry does not unpack to its recorded size.
+    bool Read(size_t index, _Out_ std::vector<uint8_t>* data) const;
+
+    // Returns an entry as a MappedFile that keeps the pack mapped for as long
+    // as it lives. Stored entries point straight into the mapping; compressed
+    // ones are unpacked into memory that the MappedFile owns. Returns a closed
+    // MappedFile if the entry is empty or cannot be unpacked.
+    MappedFile Map(size_t index) const;
+
+private:
+    std::shared_ptr<const MappedFile> m_file;
+    const AssetPackEntry* m_entries;
+    size_t m_entryCount;
+    const char* m_names;
+    size_t m_namesSize;
+};
+
+// Builds a pack in memory. The packer tool and any runtime that wants to write
+// its own packs (caches, for example) share it.
+class AssetPackWriter
+{
+public:
+    // alignment must be a power of two. Page alignment (the default) lets
+    // each stored entry start on its own page of the mapping.
+    explicit AssetPackWriter(uint32_t alignment = AssetPackDefaultAlignment);
+
+    // Adds an asset. With compress, the asset is stored as LZ4 when that
+    // saves at least an eighth of its size, and as-is otherwise, so that data
+    // that does not compress can still be used in place. Returns false for an
+    // empty or duplicate name.
+    bool Add(
+        _In_z_ const char* name,
+        _In_reads_bytes_(size) const uint8_t* data,
+        size_t size,
+        bool compress
+    );
+
+    // Lays out the pack and returns it in pack.
+    void Write(_Out_ std::vector<uint8_t>* pack) const;
+
+private:
+    struct PendingEntry
+    {
+        std::string name;
+        std::vector<uint8_t> data;
+        uint64_t size;
+        AssetCompression compression;
+    };
+
+    uint32_t m_alignment;
+    std::vector<PendingEntry> m_entries;
+};
@@ -0,0 +1,737 @@
+//--------------------------------------------------------------------------------------
+// File: BCDecoder.cpp
+//
+// Software decoding of block-compressed (BC1-BC5 and BC7) surfaces to 8-bit RGBA.
+//
+// Every texel of a block is an interpolation between two endpoint colors, so each
+// format is decoded by first writing the two endpoints and a weight out to 64
+// channel-wide arrays, then blending all of them at once with the 6-bit weights of
+// the BC7 specification. The blend is the only per-texel arithmetic and is the part
+// that runs on SSE2 or NEON.
+//--------------------------------------------------------------------------------------
+
+#include "BCDecoder.h"
+#include "BasicMath.h"
+#include <string.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const uint8_t Weights2[4] = { 0, 21, 43, 64 };
+    const uint8_t Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+    const uint8_t Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // BC1 index order is (c0, c1, 2/3 c0 + 1/3 c1, 1/3 c0 + 2/3 c1); the thirds use
+    // the nearest 6-bit weights, as BC7 does.
+    const uint8_t BC1Weights[4] = { 0, 64, 21, 43 };
+
+    // out = ((64 - w) * a + w * b + 32) >> 6 for the 64 channels of a block.
+    void Interpolate(
+        _In_reads_(64) const uint8_t* a,
+        _In_reads_(64) const uint8_t* b,
+        _In_reads_(64) const uint8_t* w,
+        _Out_writes_(64) uint8_t* out)
+    {
+#if defined(BASICMATH_SSE2)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i full = _mm_set1_epi16(64);
+        const __m128i round = _mm_set1_epi16(32);
+        for (int i = 0; i < 64; i += 16)
+        {
+            __m128i va = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+            __m128i vb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+            __m128i vw = _mm_loadu_si128(reinterpret_cast<const __m128i*>(w + i));
+
+            __m128i wLo = _mm_unpacklo_epi8(vw, zero);
+            __m128i wHi = _mm_unpackhi_epi8(vw, zero);
+            __m128i lo = _mm_add_epi16(
+                _mm_mullo_epi16(_mm_sub_epi16(full, wLo), _mm_unpacklo_epi8(va, zero)),
+                _mm_mullo_epi16(wLo, _mm_unpacklo_epi8(vb, zero)));
+            __m128i hi = _mm_add_epi16(
+                _mm_mullo_epi16(_mm_sub_epi16(full, wHi), _mm_unpackhi_epi8(va, zero)),
+                _mm_mullo_epi16(wHi, _mm_unpackhi_epi8(vb, zero)));
+            lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 6);
+            hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 6);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_packus_epi16(lo, hi));
+        }
+#elif defined(BASICMATH_NEON)
+        const uint8x16_t full = vdupq_n_u8(64);
+        for (int i = 0; i < 64; i += 16)
+        {
+            uint8x16_t va = vld1q_u8(a + i);
+            uint8x16_t vb = vld1q_u8(b + i);
+            uint8x16_t vw = vld1q_u8(w + i);
+            uint8x16_t vi = vsubq_u8(full, vw);
+
+            uint16x8_t lo = vmlal_u8(vmull_u8(vget_low_u8(vi), vget_low_u8(va)), vget_low_u8(vw), vget_low_u8(vb));
+            uint16x8_t hi = vmlal_u8(vmull_u8(vget_high_u8(vi), vget_high_u8(va)), vget_high_u8(vw), vget_high_u8(vb));
+
+            vst1q_u8(out + i, vcombine_u8(vrshrn_n_u16(lo, 6), vrshrn_n_u16(hi, 6)));
+        }
+#else
+        for (int i = 0; i < 64; i++)
+        {
+            out[i] = static_cast<uint8_t>(((64 - w[i]) * a[i] + w[i] * b[i] + 32) >> 6);
+        }
+#endif
+    }
+
+    uint16_t Read16(const uint8_t* data)
+    {
+        return static_cast<uint16_t>(data[0] | (data[1] << 8));
+    }
+
+    uint32_t Read32(const uint8_t* data)
+    {
+        return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<uint32_t>(data[3]) << 24);
+    }
+
+    uint64_t Read64(const uint8_t* data)
+    {
+        return Read32(data) | (static_cast<uint64_t>(Read32(data + 4)) << 32);
+    }
+
+    void Expand565(uint16_t color, uint8_t* rgb)
+    {
+        uint8_t r = (color >> 11) & 0x1f;
+        uint8_t g = (color >> 5) & 0x3f;
+        uint8_t b = color & 0x1f;
+        rgb[0] = static_cast<uint8_t>((r << 3) | (r >> 2));
+        rgb[1] = static_cast<uint8_t>((g << 2) | (g >> 4));
+        rgb[2] = static_cast<uint8_t>((b << 3) | (b >> 2));
+    }
+
+    // Decodes the color half of a BC1, BC2 or BC3 block. BC2 and BC3 always use four
+    // colors; BC1 uses three colors and transparent black when color0 <= color1.
+    void DecodeColorBlock(const uint8_t* block, bool allowPunchThrough, uint8_t* rgba)
+    {
+        uint16_t color0 = Read16(block);
+        uint16_t color1 = Read16(block + 2);
+        uint32_t indices = Read32(block + 4);
+
+        uint8_t c0[4] = { 0, 0, 0, 255 };
+        uint8_t c1[4] = { 0, 0, 0, 255 };
+        Expand565(color0, c0);
+        Expand565(color1, c1);
+
+        bool threeColor = allowPunchThrough && color0 <= color1;
+
+        uint8_t a[64], b[64], w[64];
+        for (int i = 0; i < 16; i++)
+        {
+            unsigned int index = (indices >> (2 * i)) & 3;
+            uint8_t weight = BC1Weights[index];
+            if (threeColor && index >= 2)
+            {
+                weight = 32;
+            }
+
+            bool black = threeColor && index == 3;
+            for (int c = 0; c < 4; c++)
+            {
+                a[i * 4 + c] = black ? 0 : c0[c];
+                b[i * 4 + c] = black ? 0 : c1[c];
+                w[i * 4 + c] = (c < 3) ? weight : 0;
+            }
+        }
+
+        Interpolate(a, b, w, rgba);
+    }
+
+    // Decodes a BC4-style block of 3-bit indices into an 8-entry palette, writing
+    // every fourth byte of out starting at out[0].
+    void DecodeUnormChannel(const uint8_t* block, uint8_t* out)
+    {
+        int e0 = block[0];
+        int e1 = block[1];
+
+        uint8_t palette[8];
+        palette[0] = static_cast<uint8_t>(e0);
+        palette[1] = static_cast<uint8_t>(e1);
+        if (e0 > e1)
+        {
+            for (int i = 1; i < 7; i++)
+            {
+                palette[i + 1] = static_cast<uint8_t>(((7 - i) * e0 + i * e1 + 3) / 7);
+            }
+        }
+        else
+        {
+            for (int i = 1; i < 5; i++)
+            {
+                palette[i + 1] = static_cast<uint8_t>(((5 - i) * e0 + i * e1 + 2) / 5);
+            }
+            palette[6] = 0;
+            palette[7] = 255;
+        }
+
+        uint64_t indices = Read64(block) >> 16;
+        for (int i = 0; i < 16; i++)
+        {
+            out[i * 4] = palette[(indices >> (3 * i)) & 7];
+        }
+    }
+
+    // The signed form of DecodeUnormChannel. Values in [-127, 127] are remapped to
+    // [0, 255]; -128 is treated as -127, as Direct3D does.
+    void DecodeSnormChannel(const uint8_t* block, uint8_t* out)
+    {
+        int e0 = (static_cast<int8_t>(block[0]) == -128) ? -127 : static_cast<int8_t>(block[0]);
+        int e1 = (static_cast<int8_t>(block[1]) == -128) ? -127 : static_cast<int8_t>(block[1]);
+
+        int palette[8];
+        palette[0] = e0;
+        palette[1] = e1;
+        if (e0 > e1)
+        {
+            for (int i = 1; i < 7; i++)
+            {
+                int sum = (7 - i) * e0 + i * e1;
+                palette[i + 1] = (sum >= 0) ? (sum + 3) / 7 : -((-sum + 3) / 7);
+            }
+        }
+        else
+        {
+            for (int i = 1; i < 5; i++)
+            {
+                int sum = (5 - i) * e0 + i * e1;
+                palette[i + 1] = (sum >= 0) ? (sum + 2) / 5 : -((-sum + 2) / 5);
+            }
+            palette[6] = -127;
+            palette[7] = 127;
+        }
+
+        uint64_t indices = Read64(block) >> 16;
+        for (int i = 0; i < 16; i++)
+        {
+            int value = palette[(indices >> (3 * i)) & 7];
+            out[i * 4] = static_cast<uint8_t>(((value + 127) * 255 + 127) / 254);
+        }
+    }
+
+    //----------------------------------------------------------------------------------
+    // BC7
+    //----------------------------------------------------------------------------------
+
+    struct BC7Mode
+    {
+        uint8_t subsets;
+        uint8_t partitionBits;
+        uint8_t rotationBits;
+        uint8_t indexSelectionBits;
+        uint8_t colorBits;
+        uint8_t alphaBits;
+        uint8_t endpointPBits;      // one p-bit per endpoint
+        uint8_t sharedPBits;        // one p-bit per subset
+        uint8_t indexBits;
+        uint8_t secondaryIndexBits;
+    };
+
+    const BC7Mode BC7Modes[8] =
+    {
+        { 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+        { 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+        { 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+        { 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+        { 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+        { 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+        { 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+        { 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+    };
+
+    // Two-subset partitions; bit i is the subset of texel i.
+    const uint16_t BC7Partitions2[64] =
+    {
+        0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+        0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+        0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+        0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+        0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+        0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+        0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+        0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+    };
+
+    // Three-subset partitions; two bits per texel, texel 0 in the low bits.
+    const uint32_t BC7Partitions3[64] =
+    {
+        0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0, 0x5a5a5050,
+        0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250,
+        0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+        0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400, 0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200,
+        0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50,
+        0x500aa550, 0xaaaa4444, 0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+        0xaa444444, 0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+        0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254,
+    };
+
+    // The texel whose index drops its top bit, for the second subset of a
+    // two-subset partition and the second and third subsets of a three-subset one.
+    // The first subset's anchor is always texel 0.
+    const uint8_t BC7Anchors2[64] =
+    {
+        15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+        15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+        15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+         6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+    };
+
+    const uint8_t BC7Anchors3Second[64] =
+    {
+         3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+         3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+         8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+         3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3,
+    };
+
+    const uint8_t BC7Anchors3Third[64] =
+    {
+        15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+        15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+        15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+        15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8,
+    };
+
+    // Reads a 128-bit block from the least significant bit up.
+    class BlockReader
+    {
+    public:
+        BlockReader(const uint8_t* block) :
+            m_low(Read64(block)),
+            m_high(Read64(block + 8)),
+            m_position(0)
+        {
+        }
+
+        unsigned int Read(unsigned int count)
+        {
+            if (count == 0)
+            {
+                return 0;
+            }
+
+            uint64_t value;
+            if (m_position >= 64)
+            {
+                value = m_high >> (m_position - 64);
+            }
+            else if (m_position + count <= 64)
+            {
+                value = m_low >> m_position;
+            }
+            else
+            {
+                value = (m_low >> m_position) | (m_high << (64 - m_position));
+            }
+
+            m_position += count;
+            return static_cast<unsigned int>(value & ((1u << count) - 1));
+        }
+
+    private:
+        uint64_t m_low;
+        uint64_t m_high;
+        unsigned int m_position;
+    };
+
+    unsigned int GetSubset(unsigned int subsets, unsigned int partition, unsigned int texel)
+    {
+        switch (subsets)
+        {
+        case 2:
+            return (BC7Partitions2[partition] >> texel) & 1;
+        case 3:
+            return (BC7Partitions3[partition] >> (2 * texel)) & 3;
+        default:
+            return 0;
+        }
+    }
+
+    bool IsAnchor(unsigned int subsets, unsigned int partition, unsigned int texel)
+    {
+        switch (subsets)
+        {
+        case 2:
+            return texel == 0 || texel == BC7Anchors2[partition];
+        case 3:
+            return texel == 0 || texel == BC7Anchors3Second[partition] || texel == BC7Anchors3Third[partition];
+        default:
+            return texel == 0;
+        }
+    }
+
+    const uint8_t* GetWeights(unsigned int indexBits)
+    {
+        switch (indexBits)
+        {
+        case 2:
+            return Weights2;
+        case 3:
+            return Weights3;
+        default:
+            return Weights4;
+        }
+    }
+
+    void DecodeBC7Block(const uint8_t* block, uint8_t* rgba)
+    {
+        unsigned int modeIndex = 0;
+        while (modeIndex < 8 && !(block[0] & (1 << modeIndex)))
+        {
+            modeIndex++;
+        }
+        if (modeIndex == 8)
+        {
+            memset(rgba, 0, 64);
+            return;
+        }
+
+        const BC7Mode& mode = BC7Modes[modeIndex];
+        BlockReader reader(block);
+        reader.Read(modeIndex + 1);
+
+        unsigned int partition = reader.Read(mode.partitionBits);
+        unsigned int rotation = reader.Read(mode.rotationBits);
+        unsigned int indexSelection = reader.Read(mode.indexSelectionBits);
+
+        // endpoints[subset][end][channel], read channel by channel.
+        unsigned int endpoints[3][2][4] = {};
+        for (unsigned int c = 0; c < 3; c++)
+        {
+            for (unsigned int s = 0; s < mode.subsets; s++)
+            {
+                endpoints[s][0][c] = reader.Read(mode.colorBits);
+                endpoints[s][1][c] = reader.Read(mode.colorBits);
+            }
+        }
+        for (unsigned int s = 0; s < mode.subsets; s++)
+        {
+            endpoints[s][0][3] = reader.Read(mode.alphaBits);
+            endpoints[s][1][3] = reader.Read(mode.alphaBits);
+        }
+
+        unsigned int pBits[3][2] = {};
+        for (unsigned int s = 0; s < mode.subsets; s++)
+        {
+            if (mode.endpointPBits)
+            {
+                pBits[s][0] = reader.Read(1);
+                pBits[s][1] = reader.Read(1);
+            }
+            else if (mode.sharedPBits)
+            {
+                pBits[s][0] = pBits[s][1] = reader.Read(1);
+            }
+        }
+
+        // Append the p-bit and replicate the high bits into the low ones.
+        bool hasPBits = mode.endpointPBits || mode.sharedPBits;
+        uint8_t expanded[3][2][4];
+        for (unsigned int s = 0; s < mode.subsets; s++)
+        {
+            for (unsigned int e = 0; e < 2; e++)
+            {
+                for (unsigned int c = 0; c < 4; c++)
+                {
+                    unsigned int bits = (c < 3) ? mode.colorBits : mode.alphaBits;
+                    if (bits == 0)
+                    {
+                        expanded[s][e][c] = 255;
+                        continue;
+                    }
+
+                    unsigned int value = endpoints[s][e][c];
+                    if (hasPBits)
+                    {
+                        value = (value << 1) | pBits[s][e];
+                        bits++;
+                    }
+                    value <<= (8 - bits);
+                    value |= value >> bits;
+                    expanded[s][e][c] = static_cast<uint8_t>(value);
+                }
+            }
+        }
+
+        unsigned int primary[16];
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            bool anchor = IsAnchor(mode.subsets, partition, i);
+            primary[i] = reader.Read(anchor ? mode.indexBits - 1 : mode.indexBits);
+        }
+
+        unsigned int secondary[16] = {};
+        if (mode.secondaryIndexBits)
+        {
+            for (unsigned int i = 0; i < 16; i++)
+            {
+                secondary[i] = reader.Read(i == 0 ? mode.secondaryIndexBits - 1 : mode.secondaryIndexBits);
+            }
+        }
+
+        // Modes 4 and 5 carry a second index set; mode 4 can swap which of the two
+        // drives color and which drives alpha.
+        const unsigned int* colorIndices = primary;
+        const unsigned int* alphaIndices = mode.secondaryIndexBits ? secondary : primary;
+        const uint8_t* colorWeights = GetWeights(mode.indexBits);
+        const uint8_t* alphaWeights = GetWeights(mode.secondaryIndexBits ? mode.secondaryIndexBits : mode.indexBits);
+        if (indexSelection)
+        {
+            colorIndices = secondary;
+            alphaIndices = primary;
+            colorWeights = GetWeights(mode.secondaryIndexBits);
+            alphaWeights = GetWeights(mode.indexBits);
+        }
+
+        uint8_t a[64], b[64], w[64];
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            unsigned int s = GetSubset(mode.subsets, partition, i);
+            for (unsigned int c = 0; c < 4; c++)
+            {
+                a[i * 4 + c] = expanded[s][0][c];
+                b[i * 4 + c] = expanded[s][1][c];
+                w[i * 4 + c] = (c < 3) ? colorWeights[colorIndices[i]] : alphaWeights[alphaIndices[i]];
+            }
+        }
+
+        Interpolate(a, b, w, rgba);
+
+        // Rotation swaps alpha with red, green or blue after interpolation.
+        if (rotation)
+        {
+            for (unsigned int i = 0; i < 16; i++)
+            {
+                uint8_t* texel = rgba + i * 4;
+                uint8_t swap = texel[rotation - 1];
+                texel[rotation - 1] = texel[3];
+                texel[3] = swap;
+            }
+        }
+    }
+
+    size_t GetBlockSize(DDS_FORMAT format)
+    {
+        switch (format)
+        {
+        case DDS_FORMAT_BC1_TYPELESS:
+        case DDS_FORMAT_BC1_UNORM:
+        case DDS_FORMAT_BC1_UNORM_SRGB:
+        case DDS_FORMAT_BC4_TYPELESS:
+        case DDS_FORMAT_BC4_UNORM:
+        case DDS_FORMAT_BC4_SNORM:
+            return 8;
+
+        default:
+            return 16;
+        }
+    }
+
+    void DecodeBlockRows(
+        DDS_FORMAT format,
+        const uint8_t* blocks,
+        size_t blockRowPitch,
+        size_t width,
+        size_t height,
+        uint8_t* rgba,
+        size_t rgbaRowPitch,
+        size_t firstRow,
+        size_t lastRow)
+    {
+        size_t blockSize = GetBlockSize(format);
+        size_t blocksWide = (width + 3) / 4;
+
+        uint8_t texels[64];
+        for (size_t row = firstRow; row < lastRow; row++)
+        {
+            const uint8_t* block = blocks + row * blockRowPitch;
+            size_t rows = (height - row * 4 < 4) ? height - row * 4 : 4;
+
+            for (size_t column = 0; column < blocksWide; column++, block += blockSize)
+            {
+                DecodeBCBlock(format, block, texels);
+
+                size_t columns = (width - column * 4 < 4) ? width - column * 4 : 4;
+                for (size_t y = 0; y < rows; y++)
+                {
+                    memcpy(rgba + (row * 4 + y) * rgbaRowPitch + column * 16, texels + y * 16, columns * 4);
+                }
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------
+bool IsBCDecodable(_In_ DDS_FORMAT format)
+{
+    switch (format)
+    {
+    case DDS_FORMAT_BC1_TYPELESS:
+    case DDS_FORMAT_BC1_UNORM:
+    case DDS_FORMAT_BC1_UNORM_SRGB:
+    case DDS_FORMAT_BC2_TYPELESS:
+    case DDS_FORMAT_BC2_UNORM:
+    case DDS_FORMAT_BC2_UNORM_SRGB:
+    case DDS_FORMAT_BC3_TYPELESS:
+    case DDS_FORMAT_BC3_UNORM:
+    case DDS_FORMAT_BC3_UNORM_SRGB:
+    case DDS_FORMAT_BC4_TYPELESS:
+    case DDS_FORMAT_BC4_UNORM:
+    case DDS_FORMAT_BC4_SNORM:
+    case DDS_FORMAT_BC5_TYPELESS:
+    case DDS_FORMAT_BC5_UNORM:
+    case DDS_FORMAT_BC5_SNORM:
+    case DDS_FORMAT_BC7_TYPELESS:
+    case DDS_FORMAT_BC7_UNORM:
+    case DDS_FORMAT_BC7_UNORM_SRGB:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+//--------------------------------------------------------------------------------------
+DDSResult DecodeBCBlock(
+    _In_ DDS_FORMAT format,
+    _In_reads_bytes_(DDSBitsPerPixel(format) * 2) const uint8_t* block,
+    _Out_writes_bytes_(64) uint8_t* rgba
+)
+{
+    if (!block || !rgba)
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    switch (format)
+    {
+    case DDS_FORMAT_BC1_TYPELESS:
+    case DDS_FORMAT_BC1_UNORM:
+    case DDS_FORMAT_BC1_UNORM_SRGB:
+        DecodeColorBlock(block, true, rgba);
+        break;
+
+    case DDS_FORMAT_BC2_TYPELESS:
+    case DDS_FORMAT_BC2_UNORM:
+    case DDS_FORMAT_BC2_UNORM_SRGB:
+        DecodeColorBlock(block + 8, false, rgba);
+        for (int i = 0; i < 16; i++)
+        {
+            uint8_t alpha = (block[i / 2] >> ((i & 1) * 4)) & 0xf;
+            rgba[i * 4 + 3] = static_cast<uint8_t>(alpha * 17);
+        }
+        break;
+
+    case DDS_FORMAT_BC3_TYPELESS:
+    case DDS_FORMAT_BC3_UNORM:
+    case DDS_FORMAT_BC3_UNORM_SRGB:
+        DecodeColorBlock(block + 8, false, rgba);
+        DecodeUnormChannel(block, rgba + 3);
+        break;
+
+    case DDS_FORMAT_BC4_TYPELESS:
+    case DDS_FORMAT_BC4_UNORM:
+    case DDS_FORMAT_BC4_SNORM:
+        for (int i = 0; i < 16; i++)
+        {
+            rgba[i * 4 + 1] = 0;
+            rgba[i * 4 + 2] = 0;
+            rgba[i * 4 + 3] = 255;
+        }
+        if (format == DDS_FORMAT_BC4_SNORM)
+        {
+            DecodeSnormChannel(block, rgba);
+        }
+        else
+        {
+            DecodeUnormChannel(block, rgba);
+        }
+        break;
+
+    case DDS_FORMAT_BC5_TYPELESS:
+    case DDS_FORMAT_BC5_UNORM:
+    case DDS_FORMAT_BC5_SNORM:
+        for (int i = 0; i < 16; i++)
+        {
+            rgba[i * 4 + 2] = 0;
+            rgba[i * 4 + 3] = 255;
+        }
+        if (format == DDS_FORMAT_BC5_SNORM)
+        {
+            DecodeSnormChannel(block, rgba);
+            DecodeSnormChannel(block + 8, rgba + 1);
+        }
+        else
+        {
+            DecodeUnormChannel(block, rgba);
+            DecodeUnormChannel(block + 8, rgba + 1);
+        }
+        break;
+
+    case DDS_FORMAT_BC7_TYPELESS:
+    case DDS_FORMAT_BC7_UNORM:
+    case DDS_FORMAT_BC7_UNORM_SRGB:
+        DecodeBC7Block(block, rgba);
+        break;
+
+    default:
+        return DDSResult::InvalidArgument;
+    }
+
+    return DDSResult::Ok;
+}
+
+//--------------------------------------------------------------------------------------
+DDSResult DecodeBCSurface(
+    _In_ DDS_FORMAT format,
+    _In_ const uint8_t* blocks,
+    _In_ size_t blockRowPitch,
+    _In_ size_t width,
+    _In_ size_t height,
+    _Out_writes_bytes_(rgbaRowPitch * height) uint8_t* rgba,
+    _In_ size_t rgbaRowPitch,
+    _In_ unsigned int threadCount
+)
+{
+    if (!blocks || !rgba || !IsBCDecodable(format) || rgbaRowPitch < width * 4)
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    size_t blockRows = (height + 3) / 4;
+    if (threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount > blockRows)
+    {
+        threadCount = static_cast<unsigned int>(blockRows);
+    }
+
+    if (threadCount <= 1)
+    {
+        DecodeBlockRows(format, blocks, blockRowPitch, width, height, rgba, rgbaRowPitch, 0, blockRows);
+        return DDSResult::Ok;
+    }
+
+    // Each thread decodes a contiguous band of block rows; the calling thread
+    // takes the last band.
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (unsigned int t = 0; t + 1 < threadCount; t++)
+    {
+        size_t firstRow = blockRows * t / threadCount;
+        size_t lastRow = blockRows * (t + 1) / threadCount;
+        threads.emplace_back(DecodeBlockRows, format, blocks, blockRowPitch, width, height, rgba, rgbaRowPitch, firstRow, lastRow);
+    }
+    DecodeBlockRows(format, blocks, blockRowPitch, width, height, rgba, rgbaRowPitch, blockRows * (threadCount - 1) / threadCount, blockRows);
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    return DDSResult::Ok;
+}
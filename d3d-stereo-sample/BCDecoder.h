@@ -0,0 +1,55 @@
+//--------------------------------------------------------------------------------------
+// File: BCDecoder.h
+//
+// Software decoding of block-compressed (BC1-BC5 and BC7) surfaces to 8-bit RGBA, for
+// thumbnails, CPU-side alpha tests and devices that cannot sample a format. Works on
+// the subresources located by DDSParser and needs no Windows headers or device.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "BasicSal.h"
+#include "DDSParser.h"
+
+//--------------------------------------------------------------------------------------
+// Returns true for the BC formats that DecodeBCBlock and DecodeBCSurface accept:
+// BC1, BC2, BC3, BC4, BC5 and BC7, including their typeless and sRGB variants.
+//--------------------------------------------------------------------------------------
+bool IsBCDecodable(_In_ DDS_FORMAT format);
+
+//--------------------------------------------------------------------------------------
+// Decodes one 4x4 block to 16 RGBA texels in row-major order (64 bytes).
+//
+// Channels follow Direct3D sampling: BC4 decodes to (r, 0, 0, 255) and BC5 to
+// (r, g, 0, 255). Signed BC4 and BC5 values in [-1, 1] are remapped to [0, 255].
+// sRGB formats return the stored values without conversion to linear. Invalid BC7
+// blocks decode to transparent black.
+//
+// The BC1, BC2 and BC3 colors a third and two thirds of the way between the endpoints
+// use the BC7 weights 21/64 and 43/64 rather than exact thirds, so results may differ
+// by 1 from other decoders: two parts red to one part blue gives a red of 171, where
+// (2 * 255 + 0) / 3 gives 170. tools/BCCodecTest pins these values.
+//--------------------------------------------------------------------------------------
+DDSResult DecodeBCBlock(
+    _In_ DDS_FORMAT format,
+    _In_reads_bytes_(DDSBitsPerPixel(format) * 2) const uint8_t* block,
+    _Out_writes_bytes_(64) uint8_t* rgba
+);
+
+//--------------------------------------------------------------------------------------
+// Decodes a width x height surface, such as one DDSSubresource, into RGBA rows of
+// rgbaRowPitch bytes. Blocks on the right and bottom edges are cropped to the surface.
+// Rows of blocks are split across threadCount threads; 0 uses one per hardware thread.
+//--------------------------------------------------------------------------------------
+DDSResult DecodeBCSurface(
+    _In_ DDS_FORMAT format,
+    _In_ const uint8_t* blocks,
+    _In_ size_t blockRowPitch,
+    _In_ size_t width,
+    _In_ size_t height,
+    _Out_writes_bytes_(rgbaRowPitch * height) uint8_t* rgba,
+    _In_ size_t rgbaRowPitch,
+    _In_ unsigned int threadCount = 0
+);
@@ -0,0 +1,755 @@
+//--------------------------------------------------------------------------------------
+// File: BCEncoder.cpp
+//
+// Software block compression of 8-bit RGBA pixels to BC1, BC3 and BC7.
+//
+// Each block is fitted the same way: the endpoints start at the extremes of the
+// texels along their principal axis, every texel picks the nearest entry of the
+// palette those endpoints decode to, and the endpoints are then refitted to the
+// chosen weights by least squares. Palettes are built with the decoder's own
+// arithmetic, so the error that guides each choice is the error that will be seen.
+//--------------------------------------------------------------------------------------
+
+#include "BCEncoder.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    const uint8_t Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+    // BC1 weights in index order; see BCDecoder.cpp.
+    const uint8_t BC1Weights[4] = { 0, 64, 21, 43 };
+    const uint8_t BC1PunchThroughWeights[3] = { 0, 64, 32 };
+
+    // Refinement passes after the initial principal-axis fit.
+    const int RefinementPasses = 2;
+
+    int Blend(int a, int b, int weight)
+    {
+        return ((64 - weight) * a + weight * b + 32) >> 6;
+    }
+
+    int Clamp(int value, int low, int high)
+    {
+        return value < low ? low : (value > high ? high : value);
+    }
+
+    // Fits a line through the texels selected by mask, using the first channels of
+    // each, and returns the points of the line at the extreme projections.
+    void FitEndpoints(const uint8_t* rgba, uint16_t mask, int channels, float* low, float* high)
+    {
+        float mean[4] = {};
+        int count = 0;
+        for (int i = 0; i < 16; i++)
+        {
+            if (mask & (1 << i))
+            {
+                for (int c = 0; c < channels; c++)
+                {
+                    mean[c] += rgba[i * 4 + c];
+                }
+                count++;
+            }
+        }
+        for (int c = 0; c < channels; c++)
+        {
+            mean[c] /= count;
+        }
+
+        float covariance[4][4] = {};
+        for (int i = 0; i < 16; i++)
+        {
+            if (mask & (1 << i))
+            {
+                for (int r = 0; r < channels; r++)
+                {
+                    for (int c = 0; c < channels; c++)
+                    {
+                        covariance[r][c] += (rgba[i * 4 + r] - mean[r]) * (rgba[i * 4 + c] - mean[c]);
+                    }
+                }
+            }
+        }
+
+        // Power iteration converges on the principal axis quickly enough for a
+        // 4x4 block; a flat block keeps the starting diagonal.
+        float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+        for (int iteration = 0; iteration < 8; iteration++)
+        {
+            float next[4] = {};
+            float largest = 0.0f;
+            for (int r = 0; r < channels; r++)
+            {
+                for (int c = 0; c < channels; c++)
+                {
+                    next[r] += covariance[r][c] * axis[c];
+                }
+                largest = fmaxf(largest, fabsf(next[r]));
+            }
+            if (largest < 1e-6f)
+            {
+                break;
+            }
+            for (int c = 0; c < channels; c++)
+            {
+                axis[c] = next[c] / largest;
+            }
+        }
+
+        float lengthSquared = 0.0f;
+        for (int c = 0; c < channels; c++)
+        {
+            lengthSquared += axis[c] * axis[c];
+        }
+
+        float minT = FLT_MAX;
+        float maxT = -FLT_MAX;
+        for (int i = 0; i < 16; i++)
+        {
+            if (mask & (1 << i))
+            {
+                float t = 0.0f;
+                for (int c = 0; c < channels; c++)
+                {
+                    t += (rgba[i * 4 + c] - mean[c]) * axis[c];
+                }
+                minT = fminf(minT, t);
+                maxT = fmaxf(maxT, t);
+            }
+        }
+
+        for (int c = 0; c < channels; c++)
+        {
+            low[c] = fminf(fmaxf(mean[c] + axis[c] * minT / lengthSquared, 0.0f), 255.0f);
+            high[c] = fminf(fmaxf(mean[c] + axis[c] * maxT / lengthSquared, 0.0f), 255.0f);
+        }
+    }
+
+    // Solves for the endpoints that best reproduce the selected texels at the given
+    // 6-bit weights. Leaves the endpoints alone when every weight is the same.
+    void RefitEndpoints(const uint8_t* rgba, uint16_t mask, const uint8_t* weights, int channels, float* low, float* high)
+    {
+        float aa = 0.0f, ab = 0.0f, bb = 0.0f;
+        float ax[4] = {}, bx[4] = {};
+        for (int i = 0; i < 16; i++)
+        {
+            if (mask & (1 << i))
+            {
+                float t = weights[i] / 64.0f;
+                float s = 1.0f - t;
+                aa += s * s;
+                ab += s * t;
+                bb += t * t;
+                for (int c = 0; c < channels; c++)
+                {
+                    ax[c] += s * rgba[i * 4 + c];
+                    bx[c] += t * rgba[i * 4 + c];
+                }
+            }
+        }
+
+        float determinant = aa * bb - ab * ab;
+        if (fabsf(determinant) < 1e-6f)
+        {
+            return;
+        }
+
+        for (int c = 0; c < channels; c++)
+        {
+            low[c] = fminf(fmaxf((bb * ax[c] - ab * bx[c]) / determinant, 0.0f), 255.0f);
+            high[c] = fminf(fmaxf((aa * bx[c] - ab * ax[c]) / determinant, 0.0f), 255.0f);
+        }
+    }
+
+    uint16_t Quantize565(const float* rgb)
+    {
+        int r = Clamp(static_cast<int>(rgb[0] * 31.0f / 255.0f + 0.5f), 0, 31);
+        int g = Clamp(static_cast<int>(rgb[1] * 63.0f / 255.0f + 0.5f), 0, 63);
+        int b = Clamp(static_cast<int>(rgb[2] * 31.0f / 255.0f + 0.5f), 0, 31);
+        return static_cast<uint16_t>((r << 11) | (g << 5) | b);
+    }
+
+    void Expand565(uint16_t color, int* rgb)
+    {
+        int r = (color >> 11) & 0x1f;
+        int g = (color >> 5) & 0x3f;
+        int b = color & 0x1f;
+        rgb[0] = (r << 3) | (r >> 2);
+        rgb[1] = (g << 2) | (g >> 4);
+        rgb[2] = (b << 3) | (b >> 2);
+    }
+
+    void Write16(uint8_t* data, uint16_t value)
+    {
+        data[0] = static_cast<uint8_t>(value);
+        data[1] = static_cast<uint8_t>(value >> 8);
+    }
+
+    void Write32(uint8_t* data, uint32_t value)
+    {
+        Write16(data, static_cast<uint16_t>(value));
+        Write16(data + 2, static_cast<uint16_t>(value >> 16));
+    }
+
+    // Picks the nearest palette entry for each opaque texel of a BC1-style block
+    // and returns the total squared error. Transparent texels take index 3.
+    int SelectColorIndices(
+        const uint8_t* rgba,
+        uint16_t opaque,
+        uint16_t color0,
+        uint16_t color1,
+        bool threeColor,
+        uint32_t* indices,
+        uint8_t* weights)
+    {
+        int c0[3], c1[3];
+        Expand565(color0, c0);
+        Expand565(color1, c1);
+
+        const uint8_t* paletteWeights = threeColor ? BC1PunchThroughWeights : BC1Weights;
+        int paletteSize = threeColor ? 3 : 4;
+
+        int palette[4][3];
+        for (int p = 0; p < paletteSize; p++)
+        {
+            for (int c = 0; c < 3; c++)
+            {
+                palette[p][c] = Blend(c0[c], c1[c], paletteWeights[p]);
+            }
+        }
+
+        int error = 0;
+        *indices = 0;
+        for (int i = 0; i < 16; i++)
+        {
+            if (!(opaque & (1 << i)))
+            {
+                *indices |= 3u << (2 * i);
+                weights[i] = 0;
+                continue;
+            }
+
+            int best = 0;
+            int bestError = INT32_MAX;
+            for (int p = 0; p < paletteSize; p++)
+            {
+                int dr = rgba[i * 4] - palette[p][0];
+                int dg = rgba[i * 4 + 1] - palette[p][1];
+                int db = rgba[i * 4 + 2] - palette[p][2];
+                int e = dr * dr + dg * dg + db * db;
+                if (e < bestError)
+                {
+                    bestError = e;
+                    best = p;
+                }
+            }
+
+            *indices |= static_cast<uint32_t>(best) << (2 * i);
+            weights[i] = paletteWeights[best];
+            error += bestError;
+        }
+        return error;
+    }
+
+    // Encodes the color half of a BC1 or BC3 block. BC3 always decodes four colors,
+    // so allowPunchThrough is false for it.
+    void EncodeColorBlock(const uint8_t* rgba, bool allowPunchThrough, uint8_t* block)
+    {
+        uint16_t opaque = 0xffff;
+        if (allowPunchThrough)
+        {
+            for (int i = 0; i < 16; i++)
+            {
+                if (rgba[i * 4 + 3] < 128)
+                {
+                    opaque &= ~(1 << i);
+                }
+            }
+        }
+
+        if (opaque == 0)
+        {
+            Write16(block, 0);
+            Write16(block + 2, 0);
+            Write32(block + 4, 0xffffffff);
+            return;
+        }
+
+        bool threeColor = opaque != 0xffff;
+
+        float low[4], high[4];
+        FitEndpoints(rgba, opaque, 3, low, high);
+
+        int bestError = INT32_MAX;
+        uint16_t bestColor0 = 0, bestColor1 = 0;
+        uint32_t bestIndices = 0;
+
+        for (int pass = 0; pass <= RefinementPasses; pass++)
+        {
+            uint16_t color0 = Quantize565(high);
+            uint16_t color1 = Quantize565(low);
+
+            // Four-color blocks need color0 > color1 and three-color blocks the
+            // reverse. Equal colors decode as three-color, which only matters for
+            // the indices chosen below.
+            bool swapped = threeColor ? color0 > color1 : color0 < color1;
+            if (swapped)
+            {
+                uint16_t swap = color0;
+                color0 = color1;
+                color1 = swap;
+            }
+
+            uint32_t indices;
+            uint8_t weights[16];
+            int error = SelectColorIndices(rgba, opaque, color0, color1, threeColor || color0 == color1, &indices, weights);
+            if (error < bestError)
+            {
+                bestError = error;
+                bestColor0 = color0;
+                bestColor1 = color1;
+                bestIndices = indices;
+            }
+
+            if (error == 0)
+            {
+                break;
+            }
+
+            // Refit against the weights in the same endpoint order as high/low.
+            if (swapped)
+            {
+                RefitEndpoints(rgba, opaque, weights, 3, low, high);
+            }
+            else
+            {
+                RefitEndpoints(rgba, opaque, weights, 3, high, low);
+            }
+        }
+
+        Write16(block, bestColor0);
+        Write16(block + 2, bestColor1);
+        Write32(block + 4, bestIndices);
+    }
+
+    // Encodes channel values found every fourth byte from values[0] as a BC4-style
+    // block, in its eight-value mode.
+    void EncodeAlphaBlock(const uint8_t* values, uint8_t* block)
+    {
+        int low = 255;
+        int high = 0;
+        for (int i = 0; i < 16; i++)
+        {
+            low = values[i * 4] < low ? values[i * 4] : low;
+            high = values[i * 4] > high ? values[i * 4] : high;
+        }
+
+        block[0] = static_cast<uint8_t>(high);
+        block[1] = static_cast<uint8_t>(low);
+
+        uint64_t indices = 0;
+        if (high > low)
+        {
+            int palette[8];
+            palette[0] = high;
+            palette[1] = low;
+            for (int i = 1; i < 7; i++)
+            {
+                palette[i + 1] = ((7 - i) * high + i * low + 3) / 7;
+            }
+
+            for (int i = 0; i < 16; i++)
+            {
+                int best = 0;
+                int bestError = INT32_MAX;
+                for (int p = 0; p < 8; p++)
+                {
+                    int e = abs(values[i * 4] - palette[p]);
+                    if (e < bestError)
+                    {
+                        bestError = e;
+                        best = p;
+                    }
+                }
+                indices |= static_cast<uint64_t>(best) << (3 * i);
+            }
+        }
+
+        for (int i = 0; i < 6; i++)
+        {
+            block[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+        }
+    }
+
+    // Writes a 128-bit block from the least significant bit up.
+    class BlockWriter
+    {
+    public:
+        BlockWriter() :
+            m_low(0),
+            m_high(0),
+            m_position(0)
+        {
+        }
+
+        void Write(uint32_t value, unsigned int count)
+        {
+            uint64_t bits = value & ((1ull << count) - 1);
+            if (m_position >= 64)
+            {
+                m_high |= bits << (m_position - 64);
+            }
+            else
+            {
+                m_low |= bits << m_position;
+                if (m_position + count > 64)
+                {
+                    m_high |= bits >> (64 - m_position);
+                }
+            }
+            m_position += count;
+        }
+
+        void Store(uint8_t* block) const
+        {
+            for (int i = 0; i < 8; i++)
+            {
+                block[i] = static_cast<uint8_t>(m_low >> (8 * i));
+                block[8 + i] = static_cast<uint8_t>(m_high >> (8 * i));
+            }
+        }
+
+    private:
+        uint64_t m_low;
+        uint64_t m_high;
+        unsigned int m_position;
+    };
+
+    // Mode 6 endpoints: 7 bits per channel plus a p-bit per endpoint shared by all
+    // four channels, giving 8-bit values whose lowest bit is the p-bit.
+    void QuantizeBC7Endpoint(const float* value, unsigned int pBit, int* quantized)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            quantized[c] = Clamp(static_cast<int>((value[c] - pBit) / 2.0f + 0.5f), 0, 127);
+        }
+    }
+
+    int SelectBC7Indices(const uint8_t* rgba, const int* end0, const int* end1, uint8_t* indices)
+    {
+        int palette[16][4];
+        for (int p = 0; p < 16; p++)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                palette[p][c] = Blend(end0[c], end1[c], Weights4[p]);
+            }
+        }
+
+        int error = 0;
+        for (int i = 0; i < 16; i++)
+        {
+            int best = 0;
+            int bestError = INT32_MAX;
+            for (int p = 0; p < 16; p++)
+            {
+                int e = 0;
+                for (int c = 0; c < 4; c++)
+                {
+                    int d = rgba[i * 4 + c] - palette[p][c];
+                    e += d * d;
+                }
+                if (e < bestError)
+                {
+                    bestError = e;
+                    best = p;
+                }
+            }
+            indices[i] = static_cast<uint8_t>(best);
+            error += bestError;
+        }
+        return error;
+    }
+
+    void EncodeBC7Block(const uint8_t* rgba, uint8_t* block)
+    {
+        float low[4], high[4];
+        FitEndpoints(rgba, 0xffff, 4, low, high);
+
+        // The p-bit is the lowest bit of alpha as well as of the colors, so only
+        // endpoints with both p-bits set decode to an alpha of exactly 255.
+        bool opaque = true;
+        for (int i = 0; i < 16; i++)
+        {
+            opaque = opaque && rgba[i * 4 + 3] == 255;
+        }
+
+        int bestError = INT32_MAX;
+        int bestQuantized[2][4] = {};
+        unsigned int bestPBits[2] = {};
+        uint8_t bestIndices[16] = {};
+
+        for (int pass = 0; pass <= RefinementPasses; pass++)
+        {
+            int passError = INT32_MAX;
+            uint8_t passIndices[16] = {};
+
+            for (unsigned int pBits = 0; pBits < 4; pBits++)
+            {
+                unsigned int p0 = pBits & 1;
+                unsigned int p1 = pBits >> 1;
+                if (opaque && !(p0 && p1))
+                {
+                    continue;
+                }
+
+                int quantized[2][4];
+                QuantizeBC7Endpoint(low, p0, quantized[0]);
+                QuantizeBC7Endpoint(high, p1, quantized[1]);
+                if (opaque)
+                {
+                    quantized[0][3] = 127;
+                    quantized[1][3] = 127;
+                }
+
+                int end0[4], end1[4];
+                for (int c = 0; c < 4; c++)
+                {
+                    end0[c] = (quantized[0][c] << 1) | p0;
+                    end1[c] = (quantized[1][c] << 1) | p1;
+                }
+
+                uint8_t indices[16];
+                int error = SelectBC7Indices(rgba, end0, end1, indices);
+                if (error < passError)
+                {
+                    passError = error;
+                    memcpy(passIndices, indices, sizeof(indices));
+                }
+                if (error < bestError)
+                {
+                    bestError = error;
+                    memcpy(bestQuantized, quantized, sizeof(quantized));
+                    bestPBits[0] = p0;
+                    bestPBits[1] = p1;
+                    memcpy(bestIndices, indices, sizeof(indices));
+                }
+            }
+
+            if (bestError == 0)
+            {
+                break;
+            }
+
+            uint8_t weights[16];
+            for (int i = 0; i < 16; i++)
+            {
+                weights[i] = Weights4[passIndices[i]];
+            }
+            RefitEndpoints(rgba, 0xffff, weights, 4, low, high);
+        }
+
+        // Texel 0 is the anchor and stores its index without the top bit. The
+        // weights are symmetric, so swapping the endpoints and mirroring the
+        // indices decodes to the same texels.
+        if (bestIndices[0] & 8)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                int swap = bestQuantized[0][c];
+                bestQuantized[0][c] = bestQuantized[1][c];
+                bestQuantized[1][c] = swap;
+            }
+            unsigned int swap = bestPBits[0];
+            bestPBits[0] = bestPBits[1];
+            bestPBits[1] = swap;
+            for (int i = 0; i < 16; i++)
+            {
+                bestIndices[i] = static_cast<uint8_t>(15 - bestIndices[i]);
+            }
+        }
+
+        BlockWriter writer;
+        writer.Write(1 << 6, 7);
+        for (int c = 0; c < 4; c++)
+        {
+            writer.Write(bestQuantized[0][c], 7);
+            writer.Write(bestQuantized[1][c], 7);
+        }
+        writer.Write(bestPBits[0], 1);
+        writer.Write(bestPBits[1], 1);
+        writer.Write(bestIndices[0], 3);
+        for (int i = 1; i < 16; i++)
+        {
+            writer.Write(bestIndices[i], 4);
+        }
+        writer.Store(block);
+    }
+
+    size_t GetBlockSize(DDS_FORMAT format)
+    {
+        switch (format)
+        {
+        case DDS_FORMAT_BC1_TYPELESS:
+        case DDS_FORMAT_BC1_UNORM:
+        case DDS_FORMAT_BC1_UNORM_SRGB:
+            return 8;
+
+        default:
+            return 16;
+        }
+    }
+
+    void EncodeBlockRows(
+        DDS_FORMAT format,
+        const uint8_t* rgba,
+        size_t rgbaRowPitch,
+        size_t width,
+        size_t height,
+        uint8_t* blocks,
+        size_t blockRowPitch,
+        size_t firstRow,
+        size_t lastRow)
+    {
+        size_t blockSize = GetBlockSize(format);
+        size_t blocksWide = (width + 3) / 4;
+
+        uint8_t texels[64];
+        for (size_t row = firstRow; row < lastRow; row++)
+        {
+            uint8_t* block = blocks + row * blockRowPitch;
+            for (size_t column = 0; column < blocksWide; column++, block += blockSize)
+            {
+                for (size_t y = 0; y < 4; y++)
+                {
+                    size_t sourceY = (row * 4 + y < height) ? row * 4 + y : height - 1;
+                    for (size_t x = 0; x < 4; x++)
+                    {
+                        size_t sourceX = (column * 4 + x < width) ? column * 4 + x : width - 1;
+                        memcpy(texels + (y * 4 + x) * 4, rgba + sourceY * rgbaRowPitch + sourceX * 4, 4);
+                    }
+                }
+
+                EncodeBCBlock(format, texels, block);
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------
+bool IsBCEncodable(_In_ DDS_FORMAT format)
+{
+    switch (format)
+    {
+    case DDS_FORMAT_BC1_TYPELESS:
+    case DDS_FORMAT_BC1_UNORM:
+    case DDS_FORMAT_BC1_UNORM_SRGB:
+    case DDS_FORMAT_BC3_TYPELESS:
+    case DDS_FORMAT_BC3_UNORM:
+    case DDS_FORMAT_BC3_UNORM_SRGB:
+    case DDS_FORMAT_BC7_TYPELESS:
+    case DDS_FORMAT_BC7_UNORM:
+    case DDS_FORMAT_BC7_UNORM_SRGB:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+//--------------------------------------------------------------------------------------
+DDSResult EncodeBCBlock(
+    _In_ DDS_FORMAT format,
+    _In_reads_bytes_(64) const uint8_t* rgba,
+    _Out_writes_bytes_(DDSBitsPerPixel(format) * 2) uint8_t* block
+)
+{
+    if (!rgba || !block)
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    switch (format)
+    {
+    case DDS_FORMAT_BC1_TYPELESS:
+    case DDS_FORMAT_BC1_UNORM:
+    case DDS_FORMAT_BC1_UNORM_SRGB:
+        EncodeColorBlock(rgba, true, block);
+        break;
+
+    case DDS_FORMAT_BC3_TYPELESS:
+    case DDS_FORMAT_BC3_UNORM:
+    case DDS_FORMAT_BC3_UNORM_SRGB:
+        EncodeAlphaBlock(rgba + 3, block);
+        EncodeColorBlock(rgba, false, block + 8);
+        break;
+
+    case DDS_FORMAT_BC7_TYPELESS:
+    case DDS_FORMAT_BC7_UNORM:
+    case DDS_FORMAT_BC7_UNORM_SRGB:
+        EncodeBC7Block(rgba, block);
+        break;
+
+    default:
+        return DDSResult::InvalidArgument;
+    }
+
+    return DDSResult::Ok;
+}
+
+//--------------------------------------------------------------------------------------
+DDSResult EncodeBCSurface(
+    _In_ DDS_FORMAT format,
+    _In_ const uint8_t* rgba,
+    _In_ size_t rgbaRowPitch,
+    _In_ size_t width,
+    _In_ size_t height,
+    _Out_ uint8_t* blocks,
+    _In_ size_t blockRowPitch,
+    _In_ unsigned int threadCount
+)
+{
+    if (!rgba || !blocks || !width || !height || !IsBCEncodable(format) || rgbaRowPitch < width * 4)
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    size_t blockRows = (height + 3) / 4;
+    if (threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount > blockRows)
+    {
+        threadCount = static_cast<unsigned int>(blockRows);
+    }
+
+    if (threadCount <= 1)
+    {
+        EncodeBlockRows(format, rgba, rgbaRowPitch, width, height, blocks, blockRowPitch, 0, blockRows);
+        return DDSResult::Ok;
+    }
+
+    // Each thread encodes a contiguous band of block rows; the calling thread
+    // takes the last band.
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (unsigned int t = 0; t + 1 < threadCount; t++)
+    {
+        size_t firstRow = blockRows * t / threadCount;
+        size_t lastRow = blockRows * (t + 1) / threadCount;
+        threads.emplace_back(EncodeBlockRows, format, rgba, rgbaRowPitch, width, height, blocks, blockRowPitch, firstRow, lastRow);
+    }
+    EncodeBlockRows(format, rgba, rgbaRowPitch, width, height, blocks, blockRowPitch, blockRows * (threadCount - 1) / threadCount, blockRows);
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    return DDSResult::Ok;
+}
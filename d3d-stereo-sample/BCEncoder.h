@@ -0,0 +1,51 @@
+//--------------------------------------------------------------------------------------
+// File: BCEncoder.h
+//
+// Software block compression of 8-bit RGBA pixels to BC1, BC3 and BC7, so that images
+// decoded through WIC can be stored at a quarter or an eighth of their size. The
+// output decodes with BCDecoder or on the GPU. Needs no Windows headers or device.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "BasicSal.h"
+#include "DDSParser.h"
+
+//--------------------------------------------------------------------------------------
+// Returns true for the formats EncodeBCBlock and EncodeBCSurface can write: BC1, BC3
+// and BC7, including their typeless and sRGB variants.
+//--------------------------------------------------------------------------------------
+bool IsBCEncodable(_In_ DDS_FORMAT format);
+
+//--------------------------------------------------------------------------------------
+// Encodes 16 RGBA texels in row-major order (64 bytes) to one block.
+//
+// BC1 switches to its three-color mode, with transparent black, for blocks that have
+// texels with alpha below 128. BC7 blocks are written in mode 6, one subset with
+// 7.7.7.7 endpoints, per-endpoint p-bits and 4-bit indices; opaque blocks always set
+// both p-bits, so that their alpha decodes as exactly 255. sRGB formats encode the
+// stored values without conversion.
+//--------------------------------------------------------------------------------------
+DDSResult EncodeBCBlock(
+    _In_ DDS_FORMAT format,
+    _In_reads_bytes_(64) const uint8_t* rgba,
+    _Out_writes_bytes_(DDSBitsPerPixel(format) * 2) uint8_t* block
+);
+
+//--------------------------------------------------------------------------------------
+// Encodes a width x height RGBA surface into rows of blocks blockRowPitch bytes apart.
+// Edge blocks are padded by repeating the last row and column. Rows of blocks are
+// split across threadCount threads; 0 uses one per hardware thread.
+//--------------------------------------------------------------------------------------
+DDSResult EncodeBCSurface(
+    _In_ DDS_FORMAT format,
+    _In_ const uint8_t* rgba,
+    _In_ size_t rgbaRowPitch,
+    _In_ size_t width,
+    _In_ size_t height,
+    _Out_ uint8_t* blocks,
+    _In_ size_t blockRowPitch,
+    _In_ unsigned int threadCount = 0
+);
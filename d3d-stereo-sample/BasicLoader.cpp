@@ -1,7 +1,13 @@
 #include "pch.h"
 #include "BasicLoader.h"
 #include "DDSTextureLoader.h"
+#include "BCEncoder.h"
+#include "TextureCooker.h"
 #include "BasicShapes.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "VertexQuantization.h"
+#include "D3DTextureResidencyBackend.h"
 
 namespace winrt
 {
@@ -15,10 +21,21 @@ BasicLoader::BasicLoader(
     winrt::com_ptr<ID3D11Device> const& d3dDevice,
     winrt::com_ptr<IWICImagingFactory2> wicFactory) : 
         m_d3dDevice(d3dDevice),
-        m_wicFactory(wicFactory)
+        m_wicFactory(wicFactory),
+        m_memoryMappedLoading(true),
+        m_wicTextureFormat(DXGI_FORMAT_UNKNOWN),
+        m_wicMipmaps(true),
+        m_meshLodLevels(0),
+        m_meshLodReduction(0.5f),
+        m_meshOptimization(false),
+        m_meshQuantization(false),
+        m_textureResidency(nullptr)
 {
     // Create a new BasicReaderWriter to do raw file I/O.
     m_basicReaderWriter = std::make_unique<BasicReaderWriter>();
+
+    // WIC images are always converted to a premultiplied format below.
+    m_wicMipOptions.premultipliedAlpha = true;
 }
 
 template <class DeviceChildType>
@@ -92,10 +109,11 @@ std::wstring BasicLoader::GetExtension(
 
 void BasicLoader::CreateTexture(
     _In_ bool decodeAsDDS,
-    _In_reads_bytes_(dataSize) byte* data,
-    _In_ uint32_t dataSize,
+    _In_reads_bytes_(dataSize) const byte* data,
+    _In_ size_t dataSize,
     _Out_opt_ ID3D11Texture2D** texture,
     _Out_opt_ ID3D11ShaderResourceView** textureView,
+    _Out_opt_ TextureResidencyId* residencyId,
     std::wstring const& debugName
 )
 {
@@ -151,10 +169,12 @@ void BasicLoader::CreateTexture(
             m_wicFactory->CreateStream(stream.put())
         );
 
+        // WIC only reads from the buffer, which may be a read-only file
+        // mapping.
         winrt::check_hresult(
             stream->InitializeFromMemory(
-                data,
-                dataSize
+                const_cast<byte*>(data),
+                static_cast<DWORD>(dataSize)
             )
         );
 
@@ -173,6 +193,25 @@ void BasicLoader::CreateTexture(
             bitmapDecoder->GetFrame(0, bitmapFrame.put())
         );
 
+        uint32_t width;
+        uint32_t height;
+        winrt::check_hresult(
+            bitmapFrame->GetSize(&width, &height)
+        );
+
+        // Block-compressed textures need a top level that is a multiple of
+        // four in each dimension. Padding the image would stretch it across
+        // texture coordinates, so other images are loaded uncompressed instead.
+        bool compress = m_wicTextureFormat != DXGI_FORMAT_UNKNOWN;
+        if (compress && ((width % 4) != 0 || (height % 4) != 0))
+        {
+            compress = false;
+            OutputDebugStringW(
+                (L"BasicLoader: " + debugName + L" is " + std::to_wstring(width) + L"x" +
+                std::to_wstring(height) + L", not a multiple of 4; loading it uncompressed\n").c_str()
+            );
+        }
+
         winrt::com_ptr<IWICFormatConverter> formatConverter;
         winrt::check_hresult(
             m_wicFactory->CreateFormatConverter(formatConverter.put())
@@ -181,7 +220,7 @@ void BasicLoader::CreateTexture(
         winrt::check_hresult(
             formatConverter->Initialize(
                 bitmapFrame.get(),
-                GUID_WICPixelFormat32bppPBGRA,
+                compress ? GUID_WICPixelFormat32bppPRGBA : GUID_WICPixelFormat32bppPBGRA,
                 WICBitmapDitherTypeNone,
                 nullptr,
                 0.0,
@@ -189,12 +228,6 @@ void BasicLoader::CreateTexture(
             )
         );
 
-        uint32_t width;
-        uint32_t height;
-        winrt::check_hresult(
-            bitmapFrame->GetSize(&width, &height)
-        );
-
         std::unique_ptr<byte[]> bitmapPixels(new byte[width * height * 4]);
         winrt::check_hresult(
             formatConverter->CopyPixels(
@@ -205,47 +238,119 @@ void BasicLoader::CreateTexture(
             )
         );
 
-        D3D11_SUBRESOURCE_DATA initialData;
-        ZeroMemory(&initialData, sizeof(initialData));
-        initialData.pSysMem = bitmapPixels.get();
-        initialData.SysMemPitch = width * 4;
-        initialData.SysMemSlicePitch = 0;
-
-        CD3D11_TEXTURE2D_DESC textureDesc(
-            DXGI_FORMAT_B8G8R8A8_UNORM,
-            width,
-            height,
-            1,
-            1
-        );
+        if (compress)
+        {
+            std::vector<uint8_t> ddsFile;
+            DDSResult result = CookBCTexture(
+                bitmapPixels.get(),
+                width * 4,
+                width,
+                height,
+                static_cast<DDS_FORMAT>(m_wicTextureFormat),
+                DDS_ALPHA_MODE_PREMULTIPLIED,
+                m_wicMipmaps ? &m_wicMipOptions : nullptr,
+                0,
+                &ddsFile
+            );
+            if (result != DDSResult::Ok)
+            {
+                throw winrt::hresult_error(E_FAIL);
+            }
 
-        winrt::check_hresult(
-            m_d3dDevice->CreateTexture2D(
-                &textureDesc,
-                &initialData,
-                texture2D.put()
-            )
-        );
+            winrt::com_ptr<ID3D11Resource> resource;
+            CreateDDSTextureFromMemory(
+                m_d3dDevice.get(),
+                ddsFile.data(),
+                ddsFile.size(),
+                resource.put(),
+                textureView != nullptr ? shaderResourceView.put() : nullptr
+            );
 
-        if (textureView != nullptr)
+            texture2D = resource.as<ID3D11Texture2D>();
+        }
+        else
         {
-            CD3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc(
-                texture2D.get(),
-                D3D11_SRV_DIMENSION_TEXTURE2D
+            // Without mipmaps, or for a 1x1 image, the decoded pixels are the
+            // only level and are uploaded as they are.
+            std::vector<uint8_t> chain;
+            std::vector<DDSSubresource> levels(1);
+            levels[0].data = bitmapPixels.get();
+            levels[0].rowPitch = width * 4;
+            levels[0].slicePitch = width * height * 4;
+
+            size_t mipCount = m_wicMipmaps ? GetMipCount(width, height) : 1;
+            if (mipCount > 1)
+            {
+                DDSResult result = GenerateMipChain(
+                    bitmapPixels.get(),
+                    width * 4,
+                    width,
+                    height,
+                    mipCount,
+                    m_wicMipOptions,
+                    &chain,
+                    &levels
+                );
+                if (result != DDSResult::Ok)
+                {
+                    throw winrt::hresult_error(E_FAIL);
+                }
+            }
+
+            std::vector<D3D11_SUBRESOURCE_DATA> initialData(levels.size());
+            for (size_t i = 0; i < levels.size(); i++)
+            {
+                initialData[i].pSysMem = levels[i].data;
+                initialData[i].SysMemPitch = static_cast<UINT>(levels[i].rowPitch);
+                initialData[i].SysMemSlicePitch = static_cast<UINT>(levels[i].slicePitch);
+            }
+
+            CD3D11_TEXTURE2D_DESC textureDesc(
+                DXGI_FORMAT_B8G8R8A8_UNORM,
+                width,
+                height,
+                1,
+                static_cast<UINT>(levels.size())
             );
 
             winrt::check_hresult(
-                m_d3dDevice->CreateShaderResourceView(
-                    texture2D.get(),
-                    &shaderResourceViewDesc,
-                    shaderResourceView.put()
+                m_d3dDevice->CreateTexture2D(
+                    &textureDesc,
+                    initialData.data(),
+                    texture2D.put()
                 )
             );
+
+            if (textureView != nullptr)
+            {
+                CD3D11_SHADER_RESOURCE_VIEW_DESC shaderResourceViewDesc(
+                    texture2D.get(),
+                    D3D11_SRV_DIMENSION_TEXTURE2D
+                );
+
+                winrt::check_hresult(
+                    m_d3dDevice->CreateShaderResourceView(
+                        texture2D.get(),
+                        &shaderResourceViewDesc,
+                        shaderResourceView.put()
+                    )
+                );
+            }
         }
     }
 
     SetDebugName(texture2D.get(), debugName);
 
+    TextureResidencyId id = InvalidTextureResidencyId;
+    if (m_textureResidency != nullptr)
+    {
+        id = RegisterResidentTexture(*m_textureResidency, texture2D.get());
+    }
+    if (residencyId != nullptr)
+    {
+        *residencyId = id;
+    }
+
     if (texture != nullptr)
     {
         *texture = texture2D.detach();
@@ -299,33 +404,77 @@ void BasicLoader::CreateInputLayout(
 }
 
 void BasicLoader::CreateMesh(
-    _In_ byte* meshData,
+    _In_reads_bytes_(meshDataSize) const byte* meshData,
+    _In_ size_t meshDataSize,
     _Out_ ID3D11Buffer** vertexBuffer,
     _Out_ ID3D11Buffer** indexBuffer,
     _Out_opt_ uint32_t* vertexCount,
     _Out_opt_ uint32_t* indexCount,
+    _Out_opt_ LoadedMeshInfo* meshInfo,
     std::wstring const& debugName
 )
 {
-    // The first 4 bytes of the BasicMesh format define the number of vertices in the mesh.
-    uint32_t numVertices = *reinterpret_cast<uint32_t*>(meshData);
+    // Version 1 meshes have no magic number; they are converted to the
+    // current version so that both are created by the same code below.
+    std::vector<uint8_t> converted;
+    if (!IsBasicMesh(meshData, meshDataSize))
+    {
+        if (ConvertLegacyBasicMesh(meshData, meshDataSize, &converted) != BasicMeshResult::Ok)
+        {
+            throw winrt::hresult_error(E_INVALIDARG);
+        }
+        meshData = converted.data();
+        meshDataSize = converted.size();
+    }
 
-    // The following 4 bytes define the number of indices in the mesh.
-    uint32_t numIndices = *reinterpret_cast<uint32_t*>(meshData + sizeof(uint32_t));
+    std::vector<uint8_t> simplified;
+    if (m_meshLodLevels != 0)
+    {
+        if (GenerateBasicMeshLods(meshData, meshDataSize, m_meshLodLevels, m_meshLodReduction, &simplified) != BasicMeshResult::Ok)
+        {
+            throw winrt::hresult_error(E_INVALIDARG);
+        }
+        meshData = simplified.data();
+        meshDataSize = simplified.size();
+    }
+
+    std::vector<uint8_t> optimized;
+    if (m_meshOptimization)
+    {
+        if (OptimizeBasicMesh(meshData, meshDataSize, &optimized) != BasicMeshResult::Ok)
+        {
+            throw winrt::hresult_error(E_INVALIDARG);
+        }
+        meshData = optimized.data();
+        meshDataSize = optimized.size();
+    }
 
-    // The next segment of the BasicMesh format contains the vertices of the mesh.
-    BasicVertex* vertices = reinterpret_cast<BasicVertex*>(meshData + sizeof(uint32_t) * 2);
+    std::vector<uint8_t> quantized;
+    if (m_meshQuantization)
+    {
+        if (QuantizeBasicMesh(meshData, meshDataSize, &quantized) != BasicMeshResult::Ok)
+        {
+            throw winrt::hresult_error(E_INVALIDARG);
+        }
+        meshData = quantized.data();
+        meshDataSize = quantized.size();
+    }
 
-    // The last segment of the BasicMesh format contains the indices of the mesh.
-    uint16_t* indices = reinterpret_cast<uint16_t*>(meshData + sizeof(uint32_t) * 2 + sizeof(BasicVertex) * numVertices);
+    BasicMeshInfo info;
+    if (ParseBasicMesh(meshData, meshDataSize, &info) != BasicMeshResult::Ok ||
+        static_cast<uint64_t>(info.vertexCount) * info.vertexStride > UINT32_MAX ||
+        static_cast<uint64_t>(info.indexCount) * info.indexSize > UINT32_MAX)
+    {
+        throw winrt::hresult_error(E_INVALIDARG);
+    }
 
     // Create the vertex and index buffers with the mesh data.
 
     D3D11_SUBRESOURCE_DATA vertexBufferData = { 0 };
-    vertexBufferData.pSysMem = vertices;
+    vertexBufferData.pSysMem = info.vertexData;
     vertexBufferData.SysMemPitch = 0;
     vertexBufferData.SysMemSlicePitch = 0;
-    CD3D11_BUFFER_DESC vertexBufferDesc(numVertices * sizeof(BasicVertex), D3D11_BIND_VERTEX_BUFFER);
+    CD3D11_BUFFER_DESC vertexBufferDesc(info.vertexCount * info.vertexStride, D3D11_BIND_VERTEX_BUFFER);
     winrt::check_hresult(
         m_d3dDevice->CreateBuffer(
             &vertexBufferDesc,
@@ -335,10 +484,10 @@ void BasicLoader::CreateMesh(
     );
 
     D3D11_SUBRESOURCE_DATA indexBufferData = { 0 };
-    indexBufferData.pSysMem = indices;
+    indexBufferData.pSysMem = info.indexData;
     indexBufferData.SysMemPitch = 0;
     indexBufferData.SysMemSlicePitch = 0;
-    CD3D11_BUFFER_DESC indexBufferDesc(numIndices * sizeof(uint16_t), D3D11_BIND_INDEX_BUFFER);
+    CD3D11_BUFFER_DESC indexBufferDesc(info.indexCount * info.indexSize, D3D11_BIND_INDEX_BUFFER);
     winrt::check_hresult(
         m_d3dDevice->CreateBuffer(
             &indexBufferDesc,
@@ -352,20 +501,143 @@ void BasicLoader::CreateMesh(
 
     if (vertexCount != nullptr)
     {
-        *vertexCount = numVertices;
+        *vertexCount = info.vertexCount;
     }
     if (indexCount != nullptr)
     {
-        *indexCount = numIndices;
+        *indexCount = info.indexCount;
+    }
+
+    if (meshInfo != nullptr)
+    {
+        static const char* const semanticNames[] = { "POSITION", "NORMAL", "TEXCOORD", "TANGENT", "COLOR" };
+        static const DXGI_FORMAT elementFormats[] =
+        {
+            DXGI_FORMAT_R32G32_FLOAT,
+            DXGI_FORMAT_R32G32B32_FLOAT,
+            DXGI_FORMAT_R32G32B32A32_FLOAT,
+            DXGI_FORMAT_R16G16_FLOAT,
+            DXGI_FORMAT_R16G16B16A16_FLOAT,
+            DXGI_FORMAT_R16G16_SNORM,
+            DXGI_FORMAT_R16G16B16A16_SNORM,
+            DXGI_FORMAT_R16G16_UNORM,
+            DXGI_FORMAT_R16G16B16A16_UNORM,
+            DXGI_FORMAT_R8G8B8A8_SNORM,
+            DXGI_FORMAT_R8G8B8A8_UNORM,
+        };
+        static_assert(ARRAYSIZE(semanticNames) == static_cast<size_t>(MeshSemantic::Count), "one name per semantic");
+        static_assert(ARRAYSIZE(elementFormats) == static_cast<size_t>(MeshAttributeFormat::Count), "one format per attribute format");
+
+        meshInfo->indexFormat = (info.indexSize == 2) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+        meshInfo->vertexStride = info.vertexStride;
+        meshInfo->inputElements.clear();
+        for (uint32_t i = 0; i < info.attributeCount; i++)
+        {
+            const BasicMeshAttribute& attribute = info.attributes[i];
+            D3D11_INPUT_ELEMENT_DESC element = {};
+            element.SemanticName = semanticNames[attribute.semantic];
+            element.SemanticIndex = attribute.semanticIndex;
+            element.Format = elementFormats[attribute.format];
+            element.AlignedByteOffset = attribute.offset;
+            element.InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+            meshInfo->inputElements.push_back(element);
+        }
+        meshInfo->submeshes = GetMeshSubmeshes(info);
+        meshInfo->bounds = info.bounds;
+        meshInfo->boundingSphere = info.boundingSphere;
+    }
+}
+
+void BasicLoader::SetMemoryMappedLoading(
+    bool enabled
+)
+{
+    m_memoryMappedLoading = enabled;
+}
+
+void BasicLoader::SetWICTextureCompression(
+    DXGI_FORMAT format
+)
+{
+    if (format != DXGI_FORMAT_UNKNOWN && !IsBCEncodable(static_cast<DDS_FORMAT>(format)))
+    {
+        throw winrt::hresult_invalid_argument();
     }
+
+    m_wicTextureFormat = format;
+}
+
+void BasicLoader::SetWICMipmaps(
+    bool enabled,
+    MipFilter filter
+)
+{
+    m_wicMipmaps = enabled;
+    m_wicMipOptions.filter = filter;
+}
+
+void BasicLoader::SetMeshLods(
+    uint32_t levelCount,
+    float reduction
+)
+{
+    m_meshLodLevels = levelCount;
+    m_meshLodReduction = reduction;
+}
+
+void BasicLoader::SetMeshOptimization(
+    bool enabled
+)
+{
+    m_meshOptimization = enabled;
+}
+
+void BasicLoader::SetMeshQuantization(
+    bool enabled
+)
+{
+    m_meshQuantization = enabled;
+}
+
+void BasicLoader::SetTextureResidency(
+    _In_opt_ TextureResidencyManager* manager
+)
+{
+    m_textureResidency = manager;
+}
+
+void BasicLoader::MountPack(
+    std::wstring const& filename
+)
+{
+    m_basicReaderWriter->MountPack(filename);
 }
 
 void BasicLoader::LoadTexture(
     std::wstring const& filename,
     _Out_opt_ ID3D11Texture2D** texture,
-    _Out_opt_ ID3D11ShaderResourceView** textureView
+    _Out_opt_ ID3D11ShaderResourceView** textureView,
+    _Out_opt_ TextureResidencyId* residencyId
 )
 {
+    if (m_memoryMappedLoading)
+    {
+        // The DDS loader points its subresource data into the source
+        // buffer, so the upload reads directly from the mapped pages.
+        auto textureFile = m_basicReaderWriter->MapData(filename);
+
+        CreateTexture(
+            GetExtension(filename) == L"dds",
+            textureFile.Data(),
+            textureFile.Size(),
+            texture,
+            textureView,
+            residencyId,
+            filename
+        );
+        return;
+    }
+
     auto textureData = m_basicReaderWriter->ReadData(filename);
 
     CreateTexture(
@@ -374,6 +646,7 @@ void BasicLoader::LoadTexture(
         textureData.size(),
         texture,
         textureView,
+        residencyId,
         filename
     );
 }
@@ -381,7 +654,8 @@ void BasicLoader::LoadTexture(
 winrt::Windows::Foundation::IAsyncAction BasicLoader::LoadTextureAsync(
     std::wstring const& filename,
     _Out_opt_ ID3D11Texture2D** texture,
-    _Out_opt_ ID3D11ShaderResourceView** textureView
+    _Out_opt_ ID3D11ShaderResourceView** textureView,
+    _Out_opt_ TextureResidencyId* residencyId
 )
 {
     auto textureData = co_await m_basicReaderWriter->ReadDataAsync(filename);
@@ -391,6 +665,7 @@ winrt::Windows::Foundation::IAsyncAction BasicLoader::LoadTextureAsync(
         textureData.size(),
         texture,
         textureView,
+        residencyId,
         filename
     );
 }
@@ -808,17 +1083,20 @@ void BasicLoader::LoadMesh(
     _Out_ ID3D11Buffer** vertexBuffer,
     _Out_ ID3D11Buffer** indexBuffer,
     _Out_opt_ uint32_t* vertexCount,
-    _Out_opt_ uint32_t* indexCount
+    _Out_opt_ uint32_t* indexCount,
+    _Out_opt_ LoadedMeshInfo* meshInfo
 )
 {
     auto meshData = m_basicReaderWriter->ReadData(filename);
 
     CreateMesh(
         meshData.data(),
+        meshData.size(),
         vertexBuffer,
         indexBuffer,
         vertexCount,
         indexCount,
+        meshInfo,
         filename
     );
 }
@@ -828,16 +1106,19 @@ winrt::IAsyncAction BasicLoader::LoadMeshAsync(
     _Out_ ID3D11Buffer** vertexBuffer,
     _Out_ ID3D11Buffer** indexBuffer,
     _Out_opt_ uint32_t* vertexCount,
-    _Out_opt_ uint32_t* indexCount
+    _Out_opt_ uint32_t* indexCount,
+    _Out_opt_ LoadedMeshInfo* meshInfo
 )
 {
     auto meshData = co_await m_basicReaderWriter->ReadDataAsync(filename);
     CreateMesh(
         meshData.data(),
+        meshData.size(),
         vertexBuffer,
         indexBuffer,
         vertexCount,
         indexCount,
+        meshInfo,
         filename
     );
 }
\ No newline at end of file
@@ -1,5 +1,21 @@
 #pragma once
+#include "BasicMeshFormat.h"
 #include "BasicReaderWriter.h"
+#include "MipmapGenerator.h"
+#include "TextureResidencyManager.h"
+
+// What LoadMesh reports about a mesh beyond its buffers: how to bind and draw
+// it, and its bounds for culling. The semantic names in inputElements are
+// static strings.
+struct LoadedMeshInfo
+{
+    DXGI_FORMAT indexFormat;
+    uint32_t vertexStride;
+    std::vector<D3D11_INPUT_ELEMENT_DESC> inputElements;
+    std::vector<BasicMeshSubmesh> submeshes;
+    AABB bounds;
+    Sphere boundingSphere;
+};
 
 // A simple loader class that provides support for loading shaders, textures,
 // and meshes from files on disk. Provides synchronous and asynchronous methods.
@@ -11,16 +27,89 @@ public:
         winrt::com_ptr<IWICImagingFactory2> wicFactory
     );
 
+    // When enabled (the default), LoadTexture maps texture files into memory
+    // and creates the texture straight from the mapping, so the file is never
+    // copied into a heap buffer. When disabled, the file is read into memory
+    // first.
+    void SetMemoryMappedLoading(
+        bool enabled
+    );
+
+    // Textures loaded through WIC (anything but .dds) are normally created as
+    // uncompressed B8G8R8A8. Setting a BC1, BC3 or BC7 format here makes
+    // LoadTexture encode them to that format instead, on all cores, for a
+    // quarter or less of the memory. Images whose sizes are not multiples of
+    // four are still loaded uncompressed, with a message in the debugger
+    // output. DXGI_FORMAT_UNKNOWN (the default) turns the encoding off.
+    void SetWICTextureCompression(
+        DXGI_FORMAT format
+    );
+
+    // When enabled (the default), textures loaded through WIC are created with
+    // a full mip chain, filtered on the CPU with the given filter in linear
+    // space (image files hold sRGB-encoded colors, which WIC premultiplies by
+    // alpha). When disabled, they have a single level, uploaded as decoded.
+    void SetWICMipmaps(
+        bool enabled,
+        MipFilter filter = MipFilter::Box
+    );
+
+    // When enabled, LoadMesh reorders triangles and vertices for the vertex
+    // cache, overdraw and vertex fetch (see MeshOptimizer.h) before creating
+    // the buffers. Disabled by default, since meshes can be optimized once
+    // offline with MeshConverter --optimize instead.
+    void SetMeshOptimization(
+        bool enabled
+    );
+
+    // When levelCount is nonzero, LoadMesh adds up to levelCount simplified
+    // levels of detail after each submesh (see MeshSimplifier.h), each with
+    // about reduction times the triangles of the one before, before any
+    // optimization. The levels are submeshes with a nonzero lodError in
+    // LoadedMeshInfo.submeshes; pick one to draw with SelectSubmeshLod.
+    // Meshes can get their levels offline with MeshConverter --lods instead.
+    void SetMeshLods(
+        uint32_t levelCount,
+        float reduction = 0.5f
+    );
+
+    // When enabled, LoadMesh quantizes float vertices to 16-byte
+    // QuantizedVertex records (see VertexQuantization.h) before creating the
+    // buffers, after any optimization. Such meshes are drawn with
+    // QuantizedVertexShader, given LoadedMeshInfo.bounds. Meshes that are
+    // already quantized, or that have other attributes, fail to load.
+    void SetMeshQuantization(
+        bool enabled
+    );
+
+    // When set, every texture that LoadTexture creates is registered as
+    // resident with the manager (see TextureResidencyManager::RegisterResident),
+    // so that it counts against the budget, and its id is reported through
+    // residencyId. Unregister the texture when it is released. The manager
+    // must outlive the loader. Null (the default) turns the tracking off.
+    void SetTextureResidency(
+        _In_opt_ TextureResidencyManager* manager
+    );
+
+    // Mounts an asset pack on the loader's reader; see
+    // BasicReaderWriter::MountPack. Every Load method then finds its file in
+    // the pack if it is there.
+    void MountPack(
+        std::wstring const& filename
+    );
+
     void LoadTexture(
         std::wstring const& filename,
         _Out_opt_ ID3D11Texture2D** texture,
-        _Out_opt_ ID3D11ShaderResourceView** textureView
+        _Out_opt_ ID3D11ShaderResourceView** textureView,
+        _Out_opt_ TextureResidencyId* residencyId = nullptr
     );
 
     winrt::Windows::Foundation::IAsyncAction LoadTextureAsync(
         std::wstring const& filename,
         _Out_opt_ ID3D11Texture2D** texture,
-        _Out_opt_ ID3D11ShaderResourceView** textureView
+        _Out_opt_ ID3D11ShaderResourceView** textureView,
+        _Out_opt_ TextureResidencyId* residencyId = nullptr
     );
 
     void LoadShader(
@@ -109,12 +198,17 @@ public:
         _Out_ ID3D11DomainShader** shader
     );
 
+    // Loads a BasicMesh file (see BasicMeshFormat.h). Version 1 files, which
+    // have no header, are converted on load. The index buffer holds 16- or
+    // 32-bit indices as the file does; meshInfo reports which, along with the
+    // vertex layout and the submeshes.
     void LoadMesh(
         std::wstring const& filename,
         _Out_ ID3D11Buffer** vertexBuffer,
         _Out_ ID3D11Buffer** indexBuffer,
         _Out_opt_ uint32_t* vertexCount,
-        _Out_opt_ uint32_t* indexCount
+        _Out_opt_ uint32_t* indexCount,
+        _Out_opt_ LoadedMeshInfo* meshInfo = nullptr
     );
 
     winrt::Windows::Foundation::IAsyncAction LoadMeshAsync(
@@ -122,13 +216,23 @@ public:
         _Out_ ID3D11Buffer** vertexBuffer,
         _Out_ ID3D11Buffer** indexBuffer,
         _Out_opt_ uint32_t* vertexCount,
-        _Out_opt_ uint32_t* indexCount
+        _Out_opt_ uint32_t* indexCount,
+        _Out_opt_ LoadedMeshInfo* meshInfo = nullptr
     );
 
 private:
     winrt::com_ptr<ID3D11Device> m_d3dDevice;
     winrt::com_ptr<IWICImagingFactory2> m_wicFactory;
     std::unique_ptr<BasicReaderWriter> m_basicReaderWriter;
+    bool m_memoryMappedLoading;
+    DXGI_FORMAT m_wicTextureFormat;
+    bool m_wicMipmaps;
+    MipmapOptions m_wicMipOptions;
+    uint32_t m_meshLodLevels;
+    float m_meshLodReduction;
+    bool m_meshOptimization;
+    bool m_meshQuantization;
+    TextureResidencyManager* m_textureResidency;
 
     template <class DeviceChildType>
     inline void SetDebugName(
@@ -142,10 +246,11 @@ private:
 
     void CreateTexture(
         _In_ bool decodeAsDDS,
-        _In_reads_bytes_(dataSize) byte* data,
-        _In_ uint32_t dataSize,
+        _In_reads_bytes_(dataSize) const byte* data,
+        _In_ size_t dataSize,
         _Out_opt_ ID3D11Texture2D** texture,
         _Out_opt_ ID3D11ShaderResourceView** textureView,
+        _Out_opt_ TextureResidencyId* residencyId,
         std::wstring const& debugName
     );
 
@@ -158,11 +263,13 @@ private:
     );
 
     void CreateMesh(
-        _In_ byte* meshData,
+        _In_reads_bytes_(meshDataSize) const byte* meshData,
+        _In_ size_t meshDataSize,
         _Out_ ID3D11Buffer** vertexBuffer,
         _Out_ ID3D11Buffer** indexBuffer,
         _Out_opt_ uint32_t* vertexCount,
         _Out_opt_ uint32_t* indexCount,
+        _Out_opt_ LoadedMeshInfo* meshInfo,
         std::wstring const& debugName
     );
 };
@@ -9,10 +9,36 @@
 
 #define _USE_MATH_DEFINES
 #include <math.h>
+#include <stddef.h>
 
 // This header defines math and matrix helper functions and structures used 
 // by DirectX SDK samples.
 
+// SIMD Backend Selection
+//
+// The float4 and float4x4 overloads at the end of this header are compiled
+// against the widest instruction set enabled for the target: AVX2 or SSE2 on
+// x86/x64 and NEON on ARM. When none is available, or BASICMATH_NO_SIMD is
+// defined, the scalar template implementations are used instead.
+
+#if !defined(BASICMATH_NO_SIMD)
+#if defined(_M_X64) || defined(__x86_64__) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BASICMATH_SSE2
+#include <emmintrin.h>
+#if defined(__AVX2__)
+#define BASICMATH_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(_M_ARM64) || defined(_M_ARM) || defined(__ARM_NEON)
+#define BASICMATH_NEON
+#if defined(_M_ARM64)
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+#endif
+
 // Common Constants
 
 #define PI_F 3.1415927f
@@ -42,10 +68,15 @@ template <class T> struct Vector2
 
     T& operator[](unsigned int index)
     {
-        return static_cast<T*>(this)[index];
+        return (&x)[index];
+    }
+
+    const T& operator[](unsigned int index) const
+    {
+        return (&x)[index];
     }
 
-    Vector2(T _x = 0, T _y = 0) : x(_x), y(_y) { }
+    constexpr Vector2(T _x = 0, T _y = 0) : x(_x), y(_y) { }
 };
 
 template <class T> struct Vector3
@@ -74,10 +105,15 @@ template <class T> struct Vector3
 
     T& operator[](unsigned int index)
     {
-        return static_cast<T*>(this)[index];
+        return (&x)[index];
+    }
+
+    const T& operator[](unsigned int index) const
+    {
+        return (&x)[index];
     }
 
-    Vector3(T _x = 0, T _y = 0, T _z = 0) : x(_x), y(_y), z(_z) { }
+    constexpr Vector3(T _x = 0, T _y = 0, T _z = 0) : x(_x), y(_y), z(_z) { }
 };
 
 template <class T> struct Vector4
@@ -102,10 +138,15 @@ template <class T> struct Vector4
 
     T& operator[](unsigned int index)
     {
-        return static_cast<T*>(this)[index];
+        return (&x)[index];
     }
 
-    Vector4(T _x = 0, T _y = 0, T _z = 0, T _w = 0) : x(_x), y(_y), z(_z), w(_w) { }
+    const T& operator[](unsigned int index) const
+    {
+        return (&x)[index];
+    }
+
+    constexpr Vector4(T _x = 0, T _y = 0, T _z = 0, T _w = 0) : x(_x), y(_y), z(_z), w(_w) { }
 };
 
 template <class T> struct Matrix4x4
@@ -128,51 +169,56 @@ template <class T> struct Matrix4x4
         };
     };
 
-    Matrix4x4(T value = 0)
+    constexpr Matrix4x4(T value = 0) :
+        _11(value), _12(value), _13(value), _14(value),
+        _21(value), _22(value), _23(value), _24(value),
+        _31(value), _32(value), _33(value), _34(value),
+        _41(value), _42(value), _43(value), _44(value)
     {
-        _11 = _12 = _13 = _14 = value;
-        _21 = _22 = _23 = _24 = value;
-        _31 = _32 = _33 = _34 = value;
-        _41 = _42 = _43 = _44 = value;
     }
 
-    Matrix4x4(
+    constexpr Matrix4x4(
         T i11, T i12, T i13, T i14,
         T i21, T i22, T i23, T i24,
         T i31, T i32, T i33, T i34,
         T i41, T i42, T i43, T i44
-    )
+    ) :
+        _11(i11), _12(i12), _13(i13), _14(i14),
+        _21(i21), _22(i22), _23(i23), _24(i24),
+        _31(i31), _32(i32), _33(i33), _34(i34),
+        _41(i41), _42(i42), _43(i43), _44(i44)
     {
-        _11 = i11; _12 = i12; _13 = i13; _14 = i14;
-        _21 = i21; _22 = i22; _23 = i23; _24 = i24;
-        _31 = i31; _32 = i32; _33 = i33; _34 = i34;
-        _41 = i41; _42 = i42; _43 = i43; _44 = i44;
     }
 
     T* operator[](unsigned int index)
     {
         return &(reinterpret_cast<T*>(this)[index * 4]);
     }
+
+    const T* operator[](unsigned int index) const
+    {
+        return &(reinterpret_cast<const T*>(this)[index * 4]);
+    }
 };
 
 // Template Vector Operations
 
 template <class T>
-T dot(Vector2<T> a, Vector2<T> b)
+constexpr T dot(Vector2<T> a, Vector2<T> b)
 {
     return a.x * b.x + a.y * b.y;
 }
 
 template <class T>
-T dot(Vector3<T> a, Vector3<T> b)
+constexpr T dot(Vector3<T> a, Vector3<T> b)
 {
     return a.x * b.x + a.y * b.y + a.z * b.z;
 }
 
 template <class T>
-T dot(Vector4<T> a, Vector4<T> b)
+constexpr T dot(Vector4<T> a, Vector4<T> b)
 {
-    return a.x * b.x + a.y * b.y + a.z * b.z + a.w + b.w;
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
 }
 
 template <class T>
@@ -194,7 +240,7 @@ T length(Vector4<T> a)
 }
 
 template <class T>
-Vector3<T> cross(Vector3<T> a, Vector3<T> b)
+constexpr Vector3<T> cross(Vector3<T> a, Vector3<T> b)
 {
     return Vector3<T>((a.y * b.z) - (a.z * b.y), (a.z * b.x) - (a.x * b.z), (a.x * b.y) - (a.y * b.x));
 }
@@ -223,127 +269,127 @@ Vector4<T> normalize(Vector4<T> a)
 // Template Vector Operators
 
 template <class T>
-Vector2<T> operator-(Vector2<T> a, Vector2<T> b)
+constexpr Vector2<T> operator-(Vector2<T> a, Vector2<T> b)
 {
     return Vector2<T>(a.x - b.x, a.y - b.y);
 }
 
 template <class T>
-Vector2<T> operator-(Vector2<T> a)
+constexpr Vector2<T> operator-(Vector2<T> a)
 {
     return Vector2<T>(-a.x, -a.y);
 }
 
 template <class T>
-Vector3<T> operator-(Vector3<T> a, Vector3<T> b)
+constexpr Vector3<T> operator-(Vector3<T> a, Vector3<T> b)
 {
     return Vector3<T>(a.x - b.x, a.y - b.y, a.z - b.z);
 }
 
 template <class T>
-Vector3<T> operator-(Vector3<T> a)
+constexpr Vector3<T> operator-(Vector3<T> a)
 {
     return Vector3<T>(-a.x, -a.y, -a.z);
 }
 
 template <class T>
-Vector4<T> operator-(Vector4<T> a, Vector4<T> b)
+constexpr Vector4<T> operator-(Vector4<T> a, Vector4<T> b)
 {
     return Vector4<T>(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w);
 }
 
 template <class T>
-Vector4<T> operator-(Vector4<T> a)
+constexpr Vector4<T> operator-(Vector4<T> a)
 {
     return Vector4<T>(-a.x, -a.y, -a.z, -a.w);
 }
 
 template <class T>
-Vector2<T> operator+(Vector2<T> a, Vector2<T> b)
+constexpr Vector2<T> operator+(Vector2<T> a, Vector2<T> b)
 {
     return Vector2<T>(a.x + b.x, a.y + b.y);
 }
 
 template <class T>
-Vector3<T> operator+(Vector3<T> a, Vector3<T> b)
+constexpr Vector3<T> operator+(Vector3<T> a, Vector3<T> b)
 {
     return Vector3<T>(a.x + b.x, a.y + b.y, a.z + b.z);
 }
 
 template <class T>
-Vector4<T> operator+(Vector4<T> a, Vector4<T> b)
+constexpr Vector4<T> operator+(Vector4<T> a, Vector4<T> b)
 {
     return Vector4<T>(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
 }
 
 template <class T>
-Vector2<T> operator*(Vector2<T> a, T s)
+constexpr Vector2<T> operator*(Vector2<T> a, T s)
 {
     return Vector2<T>(a.x * s, a.y * s);
 }
 
 template <class T>
-Vector2<T> operator*(T s, Vector2<T> a)
+constexpr Vector2<T> operator*(T s, Vector2<T> a)
 {
     return a * s;
 }
 
 template <class T>
-Vector2<T> operator*(Vector2<T> a, Vector2<T> b)
+constexpr Vector2<T> operator*(Vector2<T> a, Vector2<T> b)
 {
     return Vector2<T>(a.x * b.x, a.y * b.y);
 }
 
 template <class T>
-Vector2<T> operator/(Vector2<T> a, T s)
+constexpr Vector2<T> operator/(Vector2<T> a, T s)
 {
     return Vector2<T>(a.x / s, a.y / s);
 }
 
 template <class T>
-Vector3<T> operator*(Vector3<T> a, T s)
+constexpr Vector3<T> operator*(Vector3<T> a, T s)
 {
     return Vector3<T>(a.x * s, a.y * s, a.z * s);
 }
 
 template <class T>
-Vector3<T> operator*(T s, Vector3<T> a)
+constexpr Vector3<T> operator*(T s, Vector3<T> a)
 {
     return a * s;
 }
 
 template <class T>
-Vector3<T> operator*(Vector3<T> a, Vector3<T> b)
+constexpr Vector3<T> operator*(Vector3<T> a, Vector3<T> b)
 {
     return Vector3<T>(a.x * b.x, a.y * b.y, a.z * b.z);
 }
 
 template <class T>
-Vector3<T> operator/(Vector3<T> a, T s)
+constexpr Vector3<T> operator/(Vector3<T> a, T s)
 {
     return Vector3<T>(a.x / s, a.y / s, a.z / s);
 }
 
 template <class T>
-Vector4<T> operator*(Vector4<T> a, T s)
+constexpr Vector4<T> operator*(Vector4<T> a, T s)
 {
     return Vector4<T>(a.x * s, a.y * s, a.z * s, a.w * s);
 }
 
 template <class T>
-Vector4<T> operator*(T s, Vector4<T> a)
+constexpr Vector4<T> operator*(T s, Vector4<T> a)
 {
     return a * s;
 }
 
 template <class T>
-Vector4<T> operator*(Vector4<T> a, Vector4<T> b)
+constexpr Vector4<T> operator*(Vector4<T> a, Vector4<T> b)
 {
     return Vector4<T>(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w);
 }
 
 template <class T>
-Vector4<T> operator/(Vector4<T> a, T s)
+constexpr Vector4<T> operator/(Vector4<T> a, T s)
 {
     return Vector4<T>(a.x / s, a.y / s, a.z / s, a.w / s);
 }
@@ -353,33 +399,57 @@ Vector4<T> operator/(Vector4<T> a, T s)
 // Template Matrix Operations
 
 template <class T>
-Matrix4x4<T> transpose(Matrix4x4<T> m)
+constexpr Matrix4x4<T> transpose(const Matrix4x4<T>& m)
 {
     return Matrix4x4<T>(
         m._11, m._21, m._31, m._41,
-        m_.12, m._22, m._32, m._42,
+        m._12, m._22, m._32, m._42,
         m._13, m._23, m._33, m._43,
         m._14, m._24, m._34, m._44
         );
 }
 
+// The generic multiply is written out element by element so that it can be
+// evaluated at compile time. For float4x4 arguments the SIMD overload at the
+// end of this header is preferred; call mul<float>() explicitly to compose
+// constant matrices in a constant expression.
 template <class T>
-Matrix4x4<T> mul(Matrix4x4<T> m1, Matrix4x4<T> m2)
+constexpr Matrix4x4<T> mul(const Matrix4x4<T>& m1, const Matrix4x4<T>& m2)
 {
-    Matrix4x4<T> mOut;
-
-    for (int i = 0; i < 4; i++)
-    {
-        for (int j = 0; j < 4; j++)
-        {
-            for (int k = 0; k < 4; k++)
-            {
-                mOut[i][j] += m1[i][k] * m2[k][j];
-            }
-        }
-    }
+    return Matrix4x4<T>(
+        m1._11 * m2._11 + m1._12 * m2._21 + m1._13 * m2._31 + m1._14 * m2._41,
+        m1._11 * m2._12 + m1._12 * m2._22 + m1._13 * m2._32 + m1._14 * m2._42,
+        m1._11 * m2._13 + m1._12 * m2._23 + m1._13 * m2._33 + m1._14 * m2._43,
+        m1._11 * m2._14 + m1._12 * m2._24 + m1._13 * m2._34 + m1._14 * m2._44,
+
+        m1._21 * m2._11 + m1._22 * m2._21 + m1._23 * m2._31 + m1._24 * m2._41,
+        m1._21 * m2._12 + m1._22 * m2._22 + m1._23 * m2._32 + m1._24 * m2._42,
+        m1._21 * m2._13 + m1._22 * m2._23 + m1._23 * m2._33 + m1._24 * m2._43,
+        m1._21 * m2._14 + m1._22 * m2._24 + m1._23 * m2._34 + m1._24 * m2._44,
+
+        m1._31 * m2._11 + m1._32 * m2._21 + m1._33 * m2._31 + m1._34 * m2._41,
+        m1._31 * m2._12 + m1._32 * m2._22 + m1._33 * m2._32 + m1._34 * m2._42,
+        m1._31 * m2._13 + m1._32 * m2._23 + m1._33 * m2._33 + m1._34 * m2._43,
+        m1._31 * m2._14 + m1._32 * m2._24 + m1._33 * m2._34 + m1._34 * m2._44,
+
+        m1._41 * m2._11 + m1._42 * m2._21 + m1._43 * m2._31 + m1._44 * m2._41,
+        m1._41 * m2._12 + m1._42 * m2._22 + m1._43 * m2._32 + m1._44 * m2._42,
+        m1._41 * m2._13 + m1._42 * m2._23 + m1._43 * m2._33 + m1._44 * m2._43,
+        m1._41 * m2._14 + m1._42 * m2._24 + m1._43 * m2._34 + m1._44 * m2._44
+        );
+}
 
-    return mOut;
+// Transforms a column vector: mul(m, v) matches HLSL mul(matrix, vector) and
+// the column-vector convention used by translation() and the rotations below.
+template <class T>
+constexpr Vector4<T> mul(const Matrix4x4<T>& m, const Vector4<T>& v)
+{
+    return Vector4<T>(
+        m._11 * v.x + m._12 * v.y + m._13 * v.z + m._14 * v.w,
+        m._21 * v.x + m._22 * v.y + m._23 * v.z + m._24 * v.w,
+        m._31 * v.x + m._32 * v.y + m._33 * v.z + m._34 * v.w,
+        m._41 * v.x + m._42 * v.y + m._43 * v.z + m._44 * v.w
+        );
 }
 
 // Common HLSL-compatible vector typedefs
@@ -392,95 +462,182 @@ typedef Vector4<float> float4;
 
 typedef Matrix4x4<float> float4x4;
 
-// Standard Matrix Intializers
+// Compile-Time Trigonometry
+//
+// sinConstexpr and cosConstexpr evaluate a Taylor series in double precision
+// after reducing the angle to [-pi/2, pi/2], which keeps the float result
+// within rounding of sinf/cosf. They back the rotation builders with a
+// Constexpr suffix, which fold rotations by constant angles into compile-time
+// tables; the builders without it call sinf/cosf, which is faster for angles
+// that change at runtime.
 
-inline float4x4 identity()
+namespace BasicMathConstexpr
 {
-    float4x4 mOut;
+    constexpr double Pi = 3.14159265358979323846;
 
-    mOut._11 = 1.0f; mOut._12 = 0.0f; mOut._13 = 0.0f; mOut._14 = 0.0f;
-    mOut._21 = 0.0f; mOut._22 = 1.0f; mOut._23 = 0.0f; mOut._24 = 0.0f;
-    mOut._31 = 0.0f; mOut._32 = 0.0f; mOut._33 = 1.0f; mOut._34 = 0.0f;
-    mOut._41 = 0.0f; mOut._42 = 0.0f; mOut._43 = 0.0f; mOut._44 = 1.0f;
+    constexpr double SinRadians(double x)
+    {
+        if (x - x != 0.0)
+        {
+            // NaN or infinity.
+            return x - x;
+        }
 
-    return mOut;
+        // From 2^52 turns up every double is a whole number of turns, and
+        // the angle has no precision left below a turn; smaller counts fit
+        // in a long long for rounding.
+        const double WholeTurns = 4503599627370496.0;
+        double turns = x / (2.0 * Pi);
+        if (turns >= WholeTurns || turns <= -WholeTurns)
+        {
+            return 0.0;
+        }
+        long long k = static_cast<long long>(turns >= 0.0 ? turns + 0.5 : turns - 0.5);
+        x -= static_cast<double>(k) * (2.0 * Pi);
+
+        if (x > Pi / 2.0)
+        {
+            x = Pi - x;
+        }
+        else if (x < -Pi / 2.0)
+        {
+            x = -Pi - x;
+        }
+
+        double x2 = x * x;
+        double term = x;
+        double sum = x;
+        for (int n = 1; n <= 10; n++)
+        {
+            term *= -x2 / static_cast<double>((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
 }
 
-inline float4x4 translation(float x, float y, float z)
+constexpr float sinConstexpr(float angleInRadians)
 {
-    float4x4 mOut;
-
-    mOut._11 = 1.0f; mOut._12 = 0.0f; mOut._13 = 0.0f; mOut._14 = x;
-    mOut._21 = 0.0f; mOut._22 = 1.0f; mOut._23 = 0.0f; mOut._24 = y;
-    mOut._31 = 0.0f; mOut._32 = 0.0f; mOut._33 = 1.0f; mOut._34 = z;
-    mOut._41 = 0.0f; mOut._42 = 0.0f; mOut._43 = 0.0f; mOut._44 = 1.0f;
+    return static_cast<float>(BasicMathConstexpr::SinRadians(angleInRadians));
+}
 
-    return mOut;
+constexpr float cosConstexpr(float angleInRadians)
+{
+    return static_cast<float>(BasicMathConstexpr::SinRadians(static_cast<double>(angleInRadians) + BasicMathConstexpr::Pi / 2.0));
 }
 
-inline float4x4 scale(float x, float y, float z)
+// Standard Matrix Intializers
+
+constexpr float4x4 identity()
 {
-    float4x4 mOut;
+    return float4x4(
+        1.0f, 0.0f, 0.0f, 0.0f,
+        0.0f, 1.0f, 0.0f, 0.0f,
+        0.0f, 0.0f, 1.0f, 0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+        );
+}
 
-    mOut._11 = x;    mOut._12 = 0.0f; mOut._13 = 0.0f; mOut._14 = 0.0f;
-    mOut._21 = 0.0f; mOut._22 = y;    mOut._23 = 0.0f; mOut._24 = 0.0f;
-    mOut._31 = 0.0f; mOut._32 = 0.0f; mOut._33 = z;    mOut._34 = 0.0f;
-    mOut._41 = 0.0f; mOut._42 = 0.0f; mOut._43 = 0.0f; mOut._44 = 1.0f;
+constexpr float4x4 translation(float x, float y, float z)
+{
+    return float4x4(
+        1.0f, 0.0f, 0.0f, x,
+        0.0f, 1.0f, 0.0f, y,
+        0.0f, 0.0f, 1.0f, z,
+        0.0f, 0.0f, 0.0f, 1.0f
+        );
+}
 
-    return mOut;
+constexpr float4x4 scale(float x, float y, float z)
+{
+    return float4x4(
+        x,    0.0f, 0.0f, 0.0f,
+        0.0f, y,    0.0f, 0.0f,
+        0.0f, 0.0f, z,    0.0f,
+        0.0f, 0.0f, 0.0f, 1.0f
+        );
 }
 
-inline float4x4 rotationX(float degreeX)
+// The rotation matrices for given sines and cosines, shared by the runtime and
+// compile-time builders.
+namespace BasicMathConstexpr
 {
-    float angleInRadians = degreeX * (PI_F / 180.0f);
+    constexpr float4x4 RotationX(float sinAngle, float cosAngle)
+    {
+        return float4x4(
+            1.0f, 0.0f,     0.0f,      0.0f,
+            0.0f, cosAngle, -sinAngle, 0.0f,
+            0.0f, sinAngle, cosAngle,  0.0f,
+            0.0f, 0.0f,     0.0f,      1.0f
+            );
+    }
 
-    float sinAngle = sinf(angleInRadians);
-    float cosAngle = cosf(angleInRadians);
+    constexpr float4x4 RotationY(float sinAngle, float cosAngle)
+    {
+        return float4x4(
+            cosAngle,  0.0f, sinAngle, 0.0f,
+            0.0f,      1.0f, 0.0f,     0.0f,
+            -sinAngle, 0.0f, cosAngle, 0.0f,
+            0.0f,      0.0f, 0.0f,     1.0f
+            );
+    }
 
-    float4x4 mOut;
+    constexpr float4x4 RotationZ(float sinAngle, float cosAngle)
+    {
+        return float4x4(
+            cosAngle, -sinAngle, 0.0f, 0.0f,
+            sinAngle, cosAngle,  0.0f, 0.0f,
+            0.0f,     0.0f,      1.0f, 0.0f,
+            0.0f,     0.0f,      0.0f, 1.0f
+            );
+    }
+}
 
-    mOut._11 = 1.0f; mOut._12 = 0.0f;     mOut._13 = 0.0f;      mOut._14 = 0.0f;
-    mOut._21 = 0.0f; mOut._22 = cosAngle; mOut._23 = -sinAngle; mOut._24 = 0.0f;
-    mOut._31 = 0.0f; mOut._32 = sinAngle; mOut._33 = cosAngle;  mOut._34 = 0.0f;
-    mOut._41 = 0.0f; mOut._42 = 0.0f;     mOut._43 = 0.0f;      mOut._44 = 1.0f;
+inline float4x4 rotationX(float degreeX)
+{
+    float angleInRadians = degreeX * (PI_F / 180.0f);
+    return BasicMathConstexpr::RotationX(sinf(angleInRadians), cosf(angleInRadians));
+}
 
-    return mOut;
+constexpr float4x4 rotationXConstexpr(float degreeX)
+{
+    float angleInRadians = degreeX * (PI_F / 180.0f);
+    return BasicMathConstexpr::RotationX(sinConstexpr(angleInRadians), cosConstexpr(angleInRadians));
 }
 
 inline float4x4 rotationY(float degreeY)
 {
     float angleInRadians = degreeY * (PI_F / 180.0f);
+    return BasicMathConstexpr::RotationY(sinf(angleInRadians), cosf(angleInRadians));
+}
 
-    float sinAngle = sinf(angleInRadians);
-    float cosAngle = cosf(angleInRadians);
-
-    float4x4 mOut;
-
-    mOut._11 = cosAngle;  mOut._12 = 0.0f; mOut._13 = sinAngle; mOut._14 = 0.0f;
-    mOut._21 = 0.0f;      mOut._22 = 1.0f; mOut._23 = 0.0f;     mOut._24 = 0.0f;
-    mOut._31 = -sinAngle; mOut._32 = 0.0f; mOut._33 = cosAngle; mOut._34 = 0.0f;
-    mOut._41 = 0.0f;      mOut._42 = 0.0f; mOut._43 = 0.0f;     mOut._44 = 1.0f;
-
-    return mOut;
+constexpr float4x4 rotationYConstexpr(float degreeY)
+{
+    float angleInRadians = degreeY * (PI_F / 180.0f);
+    return BasicMathConstexpr::RotationY(sinConstexpr(angleInRadians), cosConstexpr(angleInRadians));
 }
 
 inline float4x4 rotationZ(float degreeZ)
 {
     float angleInRadians = degreeZ * (PI_F / 180.0f);
+    return BasicMathConstexpr::RotationZ(sinf(angleInRadians), cosf(angleInRadians));
+}
 
-    float sinAngle = sinf(angleInRadians);
-    float cosAngle = cosf(angleInRadians);
-
-    float4x4 mOut;
-
-    mOut._11 = cosAngle; mOut._12 = -sinAngle; mOut._13 = 0.0f; mOut._14 = 0.0f;
-    mOut._21 = sinAngle; mOut._22 = cosAngle;  mOut._23 = 0.0f; mOut._24 = 0.0f;
-    mOut._31 = 0.0f;     mOut._32 = 0.0f;      mOut._33 = 1.0f; mOut._34 = 0.0f;
-    mOut._41 = 0.0f;     mOut._42 = 0.0f;      mOut._43 = 0.0f; mOut._44 = 1.0f;
-
-    return mOut;
+constexpr float4x4 rotationZConstexpr(float degreeZ)
+{
+    float angleInRadians = degreeZ * (PI_F / 180.0f);
+    return BasicMathConstexpr::RotationZ(sinConstexpr(angleInRadians), cosConstexpr(angleInRadians));
 }
 
+// Compile-time checks of the constexpr builders.
+static_assert(identity()._11 == 1.0f && identity()._12 == 0.0f && identity()._44 == 1.0f, "identity");
+static_assert(translation(1.0f, 2.0f, 3.0f)._24 == 2.0f, "translation is stored in the fourth column");
+static_assert(scale(2.0f, 3.0f, 4.0f)._33 == 4.0f, "scale");
+static_assert(sinConstexpr(0.0f) == 0.0f && cosConstexpr(0.0f) == 1.0f, "trigonometry at zero");
+static_assert(rotationZConstexpr(90.0f)._21 > 0.99999f && rotationZConstexpr(90.0f)._11 < 0.00001f, "rotationZ quarter turn");
+static_assert(mul<float>(translation(1.0f, 2.0f, 3.0f), translation(4.0f, 5.0f, 6.0f))._34 == 9.0f, "composed translation");
+static_assert(mul<float>(translation(1.0f, 0.0f, 0.0f), float4(0.0f, 0.0f, 0.0f, 1.0f)).x == 1.0f, "point transform");
+
 // 3D Rotation matrix for an arbitrary axis specified by x, y and z
 inline float4x4 rotationArbitrary(float3 axis, float degree)
 {
@@ -516,3 +673,874 @@ inline float4x4 rotationArbitrary(float3 axis, float degree)
 
     return mOut;
 }
+
+
+// SIMD float4 / float4x4 Overloads
+//
+// These non-template overloads are preferred over the generic templates above
+// whenever the arguments are float4 or float4x4. The vector and matrix types
+// carry no alignment guarantee, so every load and store is unaligned.
+
+#if defined(BASICMATH_SSE2) || defined(BASICMATH_NEON)
+
+namespace BasicMathSimd
+{
+#if defined(BASICMATH_SSE2)
+    // Returns the dot product of a and b splatted across all four lanes.
+    inline __m128 Dot4(__m128 a, __m128 b)
+    {
+        __m128 m = _mm_mul_ps(a, b);
+        __m128 s = _mm_add_ps(m, _mm_shuffle_ps(m, m, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_add_ps(s, _mm_shuffle_ps(s, s, _MM_SHUFFLE(1, 0, 3, 2)));
+    }
+
+    // Multiplies the row vector a by the matrix whose rows are b0..b3.
+    inline __m128 MulRow(__m128 a, __m128 b0, __m128 b1, __m128 b2, __m128 b3)
+    {
+        __m128 r = _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 0, 0)), b0);
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(1, 1, 1, 1)), b1));
+        r = _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 2, 2)), b2));
+        return _mm_add_ps(r, _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 3, 3, 3)), b3));
+    }
+#else
+    // Returns the dot product of a and b splatted across all four lanes.
+    inline float32x4_t Dot4(float32x4_t a, float32x4_t b)
+    {
+        float32x4_t m = vmulq_f32(a, b);
+        float32x2_t s = vadd_f32(vget_low_f32(m), vget_high_f32(m));
+        s = vpadd_f32(s, s);
+        return vcombine_f32(s, s);
+    }
+
+    // Multiplies the row vector a by the matrix whose rows are b0..b3.
+    inline float32x4_t MulRow(float32x4_t a, float32x4_t b0, float32x4_t b1, float32x4_t b2, float32x4_t b3)
+    {
+        float32x4_t r = vmulq_n_f32(b0, vgetq_lane_f32(a, 0));
+        r = vmlaq_n_f32(r, b1, vgetq_lane_f32(a, 1));
+        r = vmlaq_n_f32(r, b2, vgetq_lane_f32(a, 2));
+        return vmlaq_n_f32(r, b3, vgetq_lane_f32(a, 3));
+    }
+#endif
+}
+
+inline float dot(const float4& a, const float4& b)
+{
+#if defined(BASICMATH_SSE2)
+    return _mm_cvtss_f32(BasicMathSimd::Dot4(_mm_loadu_ps(&a.x), _mm_loadu_ps(&b.x)));
+#else
+    return vgetq_lane_f32(BasicMathSimd::Dot4(vld1q_f32(&a.x), vld1q_f32(&b.x)), 0);
+#endif
+}
+
+inline float4 normalize(const float4& a)
+{
+    float4 vOut;
+#if defined(BASICMATH_SSE2)
+    __m128 v = _mm_loadu_ps(&a.x);
+    __m128 len = _mm_sqrt_ps(BasicMathSimd::Dot4(v, v));
+    _mm_storeu_ps(&vOut.x, _mm_div_ps(v, len));
+#else
+    float32x4_t v = vld1q_f32(&a.x);
+    float len = sqrtf(vgetq_lane_f32(BasicMathSimd::Dot4(v, v), 0));
+    vst1q_f32(&vOut.x, vmulq_n_f32(v, 1.0f / len));
+#endif
+    return vOut;
+}
+
+inline float4x4 transpose(const float4x4& m)
+{
+    float4x4 mOut;
+#if defined(BASICMATH_SSE2)
+    __m128 r0 = _mm_loadu_ps(&m._11);
+    __m128 r1 = _mm_loadu_ps(&m._21);
+    __m128 r2 = _mm_loadu_ps(&m._31);
+    __m128 r3 = _mm_loadu_ps(&m._41);
+    _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+    _mm_storeu_ps(&mOut._11, r0);
+    _mm_storeu_ps(&mOut._21, r1);
+    _mm_storeu_ps(&mOut._31, r2);
+    _mm_storeu_ps(&mOut._41, r3);
+#else
+    // vld4q de-interleaves the 16 floats, which yields the columns directly.
+    float32x4x4_t columns = vld4q_f32(&m._11);
+    vst1q_f32(&mOut._11, columns.val[0]);
+    vst1q_f32(&mOut._21, columns.val[1]);
+    vst1q_f32(&mOut._31, columns.val[2]);
+    vst1q_f32(&mOut._41, columns.val[3]);
+#endif
+    return mOut;
+}
+
+inline float4x4 mul(const float4x4& m1, const float4x4& m2)
+{
+    float4x4 mOut;
+#if defined(BASICMATH_AVX2)
+    // Each 256-bit register holds two rows of m1, so two output rows are
+    // produced per pass against m2's rows broadcast into both halves.
+    __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m2._11));
+    __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m2._21));
+    __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m2._31));
+    __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(&m2._41));
+    for (int i = 0; i < 4; i += 2)
+    {
+        __m256 a = _mm256_loadu_ps(m1[i]);
+        __m256 r = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), b0);
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x55), b1));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xAA), b2));
+        r = _mm256_add_ps(r, _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0xFF), b3));
+        _mm256_storeu_ps(mOut[i], r);
+    }
+#elif defined(BASICMATH_SSE2)
+    __m128 b0 = _mm_loadu_ps(&m2._11);
+    __m128 b1 = _mm_loadu_ps(&m2._21);
+    __m128 b2 = _mm_loadu_ps(&m2._31);
+    __m128 b3 = _mm_loadu_ps(&m2._41);
+    for (int i = 0; i < 4; i++)
+    {
+        _mm_storeu_ps(mOut[i], BasicMathSimd::MulRow(_mm_loadu_ps(m1[i]), b0, b1, b2, b3));
+    }
+#else
+    float32x4_t b0 = vld1q_f32(&m2._11);
+    float32x4_t b1 = vld1q_f32(&m2._21);
+    float32x4_t b2 = vld1q_f32(&m2._31);
+    float32x4_t b3 = vld1q_f32(&m2._41);
+    for (int i = 0; i < 4; i++)
+    {
+        vst1q_f32(mOut[i], BasicMathSimd::MulRow(vld1q_f32(m1[i]), b0, b1, b2, b3));
+    }
+#endif
+    return mOut;
+}
+
+inline float4 mul(const float4x4& m, const float4& v)
+{
+    // The product is the sum of m's columns scaled by the components of v.
+    float4 vOut;
+#if defined(BASICMATH_SSE2)
+    __m128 c0 = _mm_loadu_ps(&m._11);
+    __m128 c1 = _mm_loadu_ps(&m._21);
+    __m128 c2 = _mm_loadu_ps(&m._31);
+    __m128 c3 = _mm_loadu_ps(&m._41);
+    _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+    _mm_storeu_ps(&vOut.x, BasicMathSimd::MulRow(_mm_loadu_ps(&v.x), c0, c1, c2, c3));
+#else
+    float32x4x4_t columns = vld4q_f32(&m._11);
+    vst1q_f32(&vOut.x, BasicMathSimd::MulRow(vld1q_f32(&v.x), columns.val[0], columns.val[1], columns.val[2], columns.val[3]));
+#endif
+    return vOut;
+}
+
+#endif
+
+// Batched Transform Kernels
+//
+// These transform arrays of values against a single matrix. The SoA variants
+// take one array per component and process WideWidth values per iteration
+// (8 with AVX2, 4 with SSE2 or NEON, 1 for the scalar fallback). The AoS
+// variants transpose blocks of WideWidth values onto the stack and run the
+// same kernel. Input and output arrays must not partially overlap.
+
+namespace BasicMathSimd
+{
+#if defined(BASICMATH_AVX2)
+    typedef __m256 WideFloat;
+    const size_t WideWidth = 8;
+
+    inline WideFloat WideLoad(const float* p) { return _mm256_loadu_ps(p); }
+    inline void WideStore(float* p, WideFloat v) { _mm256_storeu_ps(p, v); }
+    inline WideFloat WideSplat(float s) { return _mm256_set1_ps(s); }
+    inline WideFloat WideAdd(WideFloat a, WideFloat b) { return _mm256_add_ps(a, b); }
+    inline WideFloat WideSub(WideFloat a, WideFloat b) { return _mm256_sub_ps(a, b); }
+    inline WideFloat WideMul(WideFloat a, WideFloat b) { return _mm256_mul_ps(a, b); }
+    inline WideFloat WideFlipSign(WideFloat v, WideFloat s) { return _mm256_xor_ps(v, _mm256_and_ps(s, _mm256_set1_ps(-0.0f))); }
+    inline WideFloat WideMad(WideFloat a, WideFloat b, WideFloat c) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+    inline WideFloat WideMin(WideFloat a, WideFloat b) { return _mm256_min_ps(a, b); }
+    inline WideFloat WideRsqrt(WideFloat v) { return _mm256_div_ps(_mm256_set1_ps(1.0f), _mm256_sqrt_ps(v)); }
+#elif defined(BASICMATH_SSE2)
+    typedef __m128 WideFloat;
+    const size_t WideWidth = 4;
+
+    inline WideFloat WideLoad(const float* p) { return _mm_loadu_ps(p); }
+    inline void WideStore(float* p, WideFloat v) { _mm_storeu_ps(p, v); }
+    inline WideFloat WideSplat(float s) { return _mm_set1_ps(s); }
+    inline WideFloat WideAdd(WideFloat a, WideFloat b) { return _mm_add_ps(a, b); }
+    inline WideFloat WideSub(WideFloat a, WideFloat b) { return _mm_sub_ps(a, b); }
+    inline WideFloat WideMul(WideFloat a, WideFloat b) { return _mm_mul_ps(a, b); }
+    inline WideFloat WideFlipSign(WideFloat v, WideFloat s) { return _mm_xor_ps(v, _mm_and_ps(s, _mm_set1_ps(-0.0f))); }
+    inline WideFloat WideMad(WideFloat a, WideFloat b, WideFloat c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    inline WideFloat WideMin(WideFloat a, WideFloat b) { return _mm_min_ps(a, b); }
+    inline WideFloat WideRsqrt(WideFloat v) { return _mm_div_ps(_mm_set1_ps(1.0f), _mm_sqrt_ps(v)); }
+#elif defined(BASICMATH_NEON)
+    typedef float32x4_t WideFloat;
+    const size_t WideWidth = 4;
+
+    inline WideFloat WideLoad(const float* p) { return vld1q_f32(p); }
+    inline void WideStore(float* p, WideFloat v) { vst1q_f32(p, v); }
+    inline WideFloat WideSplat(float s) { return vdupq_n_f32(s); }
+    inline WideFloat WideAdd(WideFloat a, WideFloat b) { return vaddq_f32(a, b); }
+    inline WideFloat WideSub(WideFloat a, WideFloat b) { return vsubq_f32(a, b); }
+    inline WideFloat WideMul(WideFloat a, WideFloat b) { return vmulq_f32(a, b); }
+    inline WideFloat WideFlipSign(WideFloat v, WideFloat s)
+    {
+        uint32x4_t signBits = vandq_u32(vreinterpretq_u32_f32(s), vdupq_n_u32(0x80000000u));
+        return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(v), signBits));
+    }
+    inline WideFloat WideMad(WideFloat a, WideFloat b, WideFloat c) { return vmlaq_f32(c, a, b); }
+    inline WideFloat WideMin(WideFloat a, WideFloat b) { return vminq_f32(a, b); }
+    inline WideFloat WideRsqrt(WideFloat v)
+    {
+        // Refine the hardware estimate with two Newton-Raphson steps.
+        float32x4_t e = vrsqrteq_f32(v);
+        e = vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(v, e), e));
+        return vmulq_f32(e, vrsqrtsq_f32(vmulq_f32(v, e), e));
+    }
+#else
+    typedef float WideFloat;
+    const size_t WideWidth = 1;
+
+    inline WideFloat WideLoad(const float* p) { return *p; }
+    inline void WideStore(float* p, WideFloat v) { *p = v; }
+    inline WideFloat WideSplat(float s) { return s; }
+    inline WideFloat WideAdd(WideFloat a, WideFloat b) { return a + b; }
+    inline WideFloat WideSub(WideFloat a, WideFloat b) { return a - b; }
+    inline WideFloat WideMul(WideFloat a, WideFloat b) { return a * b; }
+    inline WideFloat WideFlipSign(WideFloat v, WideFloat s) { return signbit(s) ? -v : v; }
+    inline WideFloat WideMad(WideFloat a, WideFloat b, WideFloat c) { return a * b + c; }
+    inline WideFloat WideMin(WideFloat a, WideFloat b) { return a < b ? a : b; }
+    inline WideFloat WideRsqrt(WideFloat v) { return 1.0f / sqrtf(v); }
+#endif
+
+    // Transforms count values, where count is a multiple of WideWidth.
+    // When w is true, the translation column is applied and outW is written.
+    inline void TransformWide(
+        const float4x4& m,
+        bool w,
+        bool renormalize,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ, float* outW,
+        size_t count
+    )
+    {
+        WideFloat m11 = WideSplat(m._11), m12 = WideSplat(m._12), m13 = WideSplat(m._13);
+        WideFloat m21 = WideSplat(m._21), m22 = WideSplat(m._22), m23 = WideSplat(m._23);
+        WideFloat m31 = WideSplat(m._31), m32 = WideSplat(m._32), m33 = WideSplat(m._33);
+        WideFloat m41 = WideSplat(m._41), m42 = WideSplat(m._42), m43 = WideSplat(m._43);
+        WideFloat m14 = WideSplat(w ? m._14 : 0.0f);
+        WideFloat m24 = WideSplat(w ? m._24 : 0.0f);
+        WideFloat m34 = WideSplat(w ? m._34 : 0.0f);
+        WideFloat m44 = WideSplat(m._44);
+
+        for (size_t i = 0; i < count; i += WideWidth)
+        {
+            WideFloat x = WideLoad(inX + i);
+            WideFloat y = WideLoad(inY + i);
+            WideFloat z = WideLoad(inZ + i);
+
+            WideFloat rx = WideMad(m11, x, WideMad(m12, y, WideMad(m13, z, m14)));
+            WideFloat ry = WideMad(m21, x, WideMad(m22, y, WideMad(m23, z, m24)));
+            WideFloat rz = WideMad(m31, x, WideMad(m32, y, WideMad(m33, z, m34)));
+
+            if (renormalize)
+            {
+                WideFloat s = WideRsqrt(WideMad(rx, rx, WideMad(ry, ry, WideMul(rz, rz))));
+                rx = WideMul(rx, s);
+                ry = WideMul(ry, s);
+                rz = WideMul(rz, s);
+            }
+
+            WideStore(outX + i, rx);
+            WideStore(outY + i, ry);
+            WideStore(outZ + i, rz);
+            if (w)
+            {
+                WideStore(outW + i, WideMad(m41, x, WideMad(m42, y, WideMad(m43, z, m44))));
+            }
+        }
+    }
+
+    // Handles the SoA remainder that does not fill a whole register.
+    inline void TransformTail(
+        const float4x4& m,
+        bool w,
+        bool renormalize,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ, float* outW,
+        size_t count
+    )
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            float x = inX[i], y = inY[i], z = inZ[i];
+            float rx = m._11 * x + m._12 * y + m._13 * z;
+            float ry = m._21 * x + m._22 * y + m._23 * z;
+            float rz = m._31 * x + m._32 * y + m._33 * z;
+            if (w)
+            {
+                rx += m._14;
+                ry += m._24;
+                rz += m._34;
+                outW[i] = m._41 * x + m._42 * y + m._43 * z + m._44;
+            }
+            if (renormalize)
+            {
+                float s = 1.0f / sqrtf(rx * rx + ry * ry + rz * rz);
+                rx *= s;
+                ry *= s;
+                rz *= s;
+            }
+            outX[i] = rx;
+            outY[i] = ry;
+            outZ[i] = rz;
+        }
+    }
+
+    inline void TransformSoA(
+        const float4x4& m,
+        bool w,
+        bool renormalize,
+        const float* inX, const float* inY, const float* inZ,
+        float* outX, float* outY, float* outZ, float* outW,
+        size_t count
+    )
+    {
+        size_t wideCount = count - count % WideWidth;
+        TransformWide(m, w, renormalize, inX, inY, inZ, outX, outY, outZ, outW, wideCount);
+        TransformTail(
+            m, w, renormalize,
+            inX + wideCount, inY + wideCount, inZ + wideCount,
+            outX + wideCount, outY + wideCount, outZ + wideCount, w ? outW + wideCount : nullptr,
+            count - wideCount
+        );
+    }
+
+    // Transposes blocks of float3 values onto the stack and transforms them.
+    // OutputType is float4 when w is true and float3 otherwise.
+    template <class OutputType>
+    inline void TransformAoS(
+        const float4x4& m,
+        bool w,
+        bool renormalize,
+        const float3* in,
+        OutputType* out,
+        size_t count
+    )
+    {
+        float x[WideWidth], y[WideWidth], z[WideWidth];
+        float rx[WideWidth], ry[WideWidth], rz[WideWidth], rw[WideWidth];
+
+        for (size_t i = 0; i < count; i += WideWidth)
+        {
+            size_t blockCount = (count - i < WideWidth) ? count - i : WideWidth;
+            for (size_t j = 0; j < blockCount; j++)
+            {
+                x[j] = in[i + j].x;
+                y[j] = in[i + j].y;
+                z[j] = in[i + j].z;
+            }
+
+            if (blockCount == WideWidth)
+            {
+                TransformWide(m, w, renormalize, x, y, z, rx, ry, rz, rw, WideWidth);
+            }
+            else
+            {
+                TransformTail(m, w, renormalize, x, y, z, rx, ry, rz, rw, blockCount);
+            }
+
+            for (size_t j = 0; j < blockCount; j++)
+            {
+                out[i + j][0] = rx[j];
+                out[i + j][1] = ry[j];
+                out[i + j][2] = rz[j];
+                if (w)
+                {
+                    out[i + j][3] = rw[j];
+                }
+            }
+        }
+    }
+}
+
+// Transforms positions as (x, y, z, 1) and writes the homogeneous result.
+inline void TransformPoints(const float4x4& m, const float3* in, float4* out, size_t count)
+{
+    BasicMathSimd::TransformAoS(m, true, false, in, out, count);
+}
+
+// Transforms directions as (x, y, z, 0); translation is ignored.
+inline void TransformDirections(const float4x4& m, const float3* in, float3* out, size_t count)
+{
+    BasicMathSimd::TransformAoS(m, false, false, in, out, count);
+}
+
+// Transforms directions as (x, y, z, 0) and renormalizes the results. Pass the
+// inverse transpose of the world matrix when it contains non-uniform scale.
+inline void TransformNormals(const float4x4& m, const float3* in, float3* out, size_t count)
+{
+    BasicMathSimd::TransformAoS(m, false, true, in, out, count);
+}
+
+inline void TransformPointsSoA(
+    const float4x4& m,
+    const float* inX, const float* inY, const float* inZ,
+    float* outX, float* outY, float* outZ, float* outW,
+    size_t count
+)
+{
+    BasicMathSimd::TransformSoA(m, true, false, inX, inY, inZ, outX, outY, outZ, outW, count);
+}
+
+inline void TransformDirectionsSoA(
+    const float4x4& m,
+    const float* inX, const float* inY, const float* inZ,
+    float* outX, float* outY, float* outZ,
+    size_t count
+)
+{
+    BasicMathSimd::TransformSoA(m, false, false, inX, inY, inZ, outX, outY, outZ, nullptr, count);
+}
+
+inline void TransformNormalsSoA(
+    const float4x4& m,
+    const float* inX, const float* inY, const float* inZ,
+    float* outX, float* outY, float* outZ,
+    size_t count
+)
+{
+    BasicMathSimd::TransformSoA(m, false, true, inX, inY, inZ, outX, outY, outZ, nullptr, count);
+}
+
+// Quaternions
+//
+// quat stores (x, y, z, w) with w as the scalar part and follows the same
+// convention as rotationX/Y/Z: a positive angle is a counter-clockwise
+// rotation about the axis, and quatToMatrix produces a matrix for column
+// vectors. mul(a, b) applies b first, then a, matching mul(float4x4, float4x4).
+
+template <class T> struct Quaternion
+{
+    T x;
+    T y;
+    T z;
+    T w;
+
+    constexpr Quaternion(T _x = 0, T _y = 0, T _z = 0, T _w = 1) : x(_x), y(_y), z(_z), w(_w) { }
+    constexpr Quaternion(Vector3<T> v, T s) : x(v.x), y(v.y), z(v.z), w(s) { }
+
+    constexpr Vector3<T> xyz() const { return Vector3<T>(x, y, z); }
+};
+
+typedef Quaternion<float> quat;
+
+template <class T>
+constexpr Quaternion<T> operator+(Quaternion<T> a, Quaternion<T> b)
+{
+    return Quaternion<T>(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w);
+}
+
+template <class T>
+constexpr Quaternion<T> operator-(Quaternion<T> a)
+{
+    return Quaternion<T>(-a.x, -a.y, -a.z, -a.w);
+}
+
+template <class T>
+constexpr Quaternion<T> operator*(Quaternion<T> a, T s)
+{
+    return Quaternion<T>(a.x * s, a.y * s, a.z * s, a.w * s);
+}
+
+template <class T>
+constexpr Quaternion<T> operator*(T s, Quaternion<T> a)
+{
+    return a * s;
+}
+
+template <class T>
+constexpr T dot(Quaternion<T> a, Quaternion<T> b)
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+template <class T>
+constexpr Quaternion<T> conjugate(Quaternion<T> q)
+{
+    return Quaternion<T>(-q.x, -q.y, -q.z, q.w);
+}
+
+template <class T>
+constexpr Quaternion<T> mul(Quaternion<T> a, Quaternion<T> b)
+{
+    return Quaternion<T>(
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z
+        );
+}
+
+template <class T>
+Quaternion<T> normalize(Quaternion<T> q)
+{
+    return q * (static_cast<T>(1) / static_cast<T>(sqrt(dot(q, q))));
+}
+
+template <class T>
+Quaternion<T> inverse(Quaternion<T> q)
+{
+    return conjugate(q) * (static_cast<T>(1) / dot(q, q));
+}
+
+// Rotates v by the unit quaternion q.
+template <class T>
+constexpr Vector3<T> rotate(Quaternion<T> q, Vector3<T> v)
+{
+    Vector3<T> u = q.xyz();
+    Vector3<T> t = cross(u, v) * static_cast<T>(2);
+    return v + t * q.w + cross(u, t);
+}
+
+constexpr quat quatIdentity()
+{
+    return quat(0.0f, 0.0f, 0.0f, 1.0f);
+}
+
+inline quat quatRotationX(float degreeX)
+{
+    float halfAngle = degreeX * (PI_F / 360.0f);
+    return quat(sinf(halfAngle), 0.0f, 0.0f, cosf(halfAngle));
+}
+
+constexpr quat quatRotationXConstexpr(float degreeX)
+{
+    float halfAngle = degreeX * (PI_F / 360.0f);
+    return quat(sinConstexpr(halfAngle), 0.0f, 0.0f, cosConstexpr(halfAngle));
+}
+
+inline quat quatRotationY(float degreeY)
+{
+    float halfAngle = degreeY * (PI_F / 360.0f);
+    return quat(0.0f, sinf(halfAngle), 0.0f, cosf(halfAngle));
+}
+
+constexpr quat quatRotationYConstexpr(float degreeY)
+{
+    float halfAngle = degreeY * (PI_F / 360.0f);
+    return quat(0.0f, sinConstexpr(halfAngle), 0.0f, cosConstexpr(halfAngle));
+}
+
+inline quat quatRotationZ(float degreeZ)
+{
+    float halfAngle = degreeZ * (PI_F / 360.0f);
+    return quat(0.0f, 0.0f, sinf(halfAngle), cosf(halfAngle));
+}
+
+constexpr quat quatRotationZConstexpr(float degreeZ)
+{
+    float halfAngle = degreeZ * (PI_F / 360.0f);
+    return quat(0.0f, 0.0f, sinConstexpr(halfAngle), cosConstexpr(halfAngle));
+}
+
+inline quat quatRotationArbitrary(float3 axis, float degree)
+{
+    float halfAngle = degree * (PI_F / 360.0f);
+    return quat(normalize(axis) * sinf(halfAngle), cosf(halfAngle));
+}
+
+// Converts a unit quaternion to a rotation matrix.
+constexpr float4x4 quatToMatrix(quat q)
+{
+    float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+
+    return float4x4(
+        1.0f - 2.0f * (yy + zz), 2.0f * (xy - wz),        2.0f * (xz + wy),        0.0f,
+        2.0f * (xy + wz),        1.0f - 2.0f * (xx + zz), 2.0f * (yz - wx),        0.0f,
+        2.0f * (xz - wy),        2.0f * (yz + wx),        1.0f - 2.0f * (xx + yy), 0.0f,
+        0.0f,                    0.0f,                    0.0f,                    1.0f
+        );
+}
+
+// Extracts the rotation from the upper 3x3 of m, which must be orthonormal.
+inline quat quatFromMatrix(const float4x4& m)
+{
+    float trace = m._11 + m._22 + m._33;
+    if (trace > 0.0f)
+    {
+        float s = 0.5f / sqrtf(trace + 1.0f);
+        return quat((m._32 - m._23) * s, (m._13 - m._31) * s, (m._21 - m._12) * s, 0.25f / s);
+    }
+    else if (m._11 > m._22 && m._11 > m._33)
+    {
+        float s = 0.5f / sqrtf(1.0f + m._11 - m._22 - m._33);
+        return quat(0.25f / s, (m._12 + m._21) * s, (m._13 + m._31) * s, (m._32 - m._23) * s);
+    }
+    else if (m._22 > m._33)
+    {
+        float s = 0.5f / sqrtf(1.0f + m._22 - m._11 - m._33);
+        return quat((m._12 + m._21) * s, 0.25f / s, (m._23 + m._32) * s, (m._13 - m._31) * s);
+    }
+    else
+    {
+        float s = 0.5f / sqrtf(1.0f + m._33 - m._11 - m._22);
+        return quat((m._13 + m._31) * s, (m._23 + m._32) * s, 0.25f / s, (m._21 - m._12) * s);
+    }
+}
+
+static_assert(quatToMatrix(quatRotationZConstexpr(90.0f))._21 > 0.99999f, "quatRotationZ matches rotationZ");
+static_assert(mul(quatRotationXConstexpr(30.0f), conjugate(quatRotationXConstexpr(30.0f))).w > 0.99999f, "conjugate is the inverse");
+
+namespace BasicMathSimd
+{
+    // Slerp weights for unit quaternions with cosine c = dot(a, b) >= 0.
+    // sin(t * theta) / sin(theta) is expanded as a series in (c - 1) and
+    // evaluated in Horner form, so no acos, sin or division is needed (after
+    // D. Eberly, "A Fast and Accurate Algorithm for Computing SLERP"). The last
+    // term is scaled to compensate for truncating the series; the weights are
+    // within 2e-7 of the exact values over the whole range.
+    const int SlerpTerms = 14;
+    const float SlerpCorrection = 1.9052f;
+
+    constexpr float SlerpU(int i)
+    {
+        return (i == SlerpTerms ? SlerpCorrection : 1.0f) / static_cast<float>(i * (2 * i + 1));
+    }
+
+    constexpr float SlerpV(int i)
+    {
+        return (i == SlerpTerms ? SlerpCorrection : 1.0f) * static_cast<float>(i) / static_cast<float>(2 * i + 1);
+    }
+
+    inline void SlerpWeights(WideFloat c, WideFloat t, WideFloat* weightA, WideFloat* weightB)
+    {
+        WideFloat one = WideSplat(1.0f);
+        WideFloat s = WideSub(one, t);
+        WideFloat cm1 = WideSub(c, one);
+        WideFloat tt = WideMul(t, t);
+        WideFloat ss = WideMul(s, s);
+
+        WideFloat polyB = one;
+        WideFloat polyA = one;
+        for (int i = SlerpTerms; i >= 1; i--)
+        {
+            WideFloat u = WideSplat(SlerpU(i));
+            WideFloat v = WideSplat(SlerpV(i));
+            polyB = WideMad(WideMul(WideSub(WideMul(u, tt), v), cm1), polyB, one);
+            polyA = WideMad(WideMul(WideSub(WideMul(u, ss), v), cm1), polyA, one);
+        }
+
+        *weightA = WideMul(s, polyA);
+        *weightB = WideMul(t, polyB);
+    }
+
+    enum class QuatOp
+    {
+        Mul,
+        Nlerp,
+        Slerp,
+    };
+
+    // Processes one block of WideWidth quaternions stored as SoA on the stack.
+    inline void QuatWide(QuatOp op, const float* a, const float* b, float t, float* out)
+    {
+        WideFloat ax = WideLoad(a), ay = WideLoad(a + WideWidth), az = WideLoad(a + 2 * WideWidth), aw = WideLoad(a + 3 * WideWidth);
+        WideFloat bx = WideLoad(b), by = WideLoad(b + WideWidth), bz = WideLoad(b + 2 * WideWidth), bw = WideLoad(b + 3 * WideWidth);
+        WideFloat rx, ry, rz, rw;
+
+        if (op == QuatOp::Mul)
+        {
+            rx = WideSub(WideMad(aw, bx, WideMad(ax, bw, WideMul(ay, bz))), WideMul(az, by));
+            ry = WideSub(WideMad(aw, by, WideMad(ay, bw, WideMul(az, bx))), WideMul(ax, bz));
+            rz = WideSub(WideMad(aw, bz, WideMad(az, bw, WideMul(ax, by))), WideMul(ay, bx));
+            rw = WideSub(WideMul(aw, bw), WideMad(ax, bx, WideMad(ay, by, WideMul(az, bz))));
+        }
+        else
+        {
+            // Take the shortest path by negating b where the quaternions are
+            // more than 180 degrees apart.
+            WideFloat c = WideMad(ax, bx, WideMad(ay, by, WideMad(az, bz, WideMul(aw, bw))));
+            bx = WideFlipSign(bx, c);
+            by = WideFlipSign(by, c);
+            bz = WideFlipSign(bz, c);
+            bw = WideFlipSign(bw, c);
+
+            WideFloat weightA, weightB;
+            if (op == QuatOp::Slerp)
+            {
+                SlerpWeights(WideFlipSign(c, c), WideSplat(t), &weightA, &weightB);
+            }
+            else
+            {
+                weightA = WideSplat(1.0f - t);
+                weightB = WideSplat(t);
+            }
+
+            rx = WideMad(ax, weightA, WideMul(bx, weightB));
+            ry = WideMad(ay, weightA, WideMul(by, weightB));
+            rz = WideMad(az, weightA, WideMul(bz, weightB));
+            rw = WideMad(aw, weightA, WideMul(bw, weightB));
+
+            if (op == QuatOp::Nlerp)
+            {
+                WideFloat s = WideRsqrt(WideMad(rx, rx, WideMad(ry, ry, WideMad(rz, rz, WideMul(rw, rw)))));
+                rx = WideMul(rx, s);
+                ry = WideMul(ry, s);
+                rz = WideMul(rz, s);
+                rw = WideMul(rw, s);
+            }
+        }
+
+        WideStore(out, rx);
+        WideStore(out + WideWidth, ry);
+        WideStore(out + 2 * WideWidth, rz);
+        WideStore(out + 3 * WideWidth, rw);
+    }
+
+    // Transposes blocks of quaternions onto the stack and runs QuatWide on
+    // them. A partial final block is padded with identity quaternions.
+    inline void QuatAoS(QuatOp op, const quat* a, const quat* b, float t, quat* out, size_t count)
+    {
+        float sa[4 * WideWidth], sb[4 * WideWidth], sr[4 * WideWidth];
+
+        for (size_t i = 0; i < count; i += WideWidth)
+        {
+            size_t blockCount = (count - i < WideWidth) ? count - i : WideWidth;
+            for (size_t j = 0; j < WideWidth; j++)
+            {
+                quat qa = (j < blockCount) ? a[i + j] : quatIdentity();
+                quat qb = (j < blockCount) ? b[i + j] : quatIdentity();
+                sa[j] = qa.x; sa[j + WideWidth] = qa.y; sa[j + 2 * WideWidth] = qa.z; sa[j + 3 * WideWidth] = qa.w;
+                sb[j] = qb.x; sb[j + WideWidth] = qb.y; sb[j + 2 * WideWidth] = qb.z; sb[j + 3 * WideWidth] = qb.w;
+            }
+
+            QuatWide(op, sa, sb, t, sr);
+
+            for (size_t j = 0; j < blockCount; j++)
+            {
+                out[i + j] = quat(sr[j], sr[j + WideWidth], sr[j + 2 * WideWidth], sr[j + 3 * WideWidth]);
+            }
+        }
+    }
+}
+
+// Interpolates unit quaternions along the shortest arc at a constant angular
+// rate, without calling acosf or sinf.
+inline quat slerp(quat a, quat b, float t)
+{
+    quat out;
+    BasicMathSimd::QuatAoS(BasicMathSimd::QuatOp::Slerp, &a, &b, t, &out, 1);
+    return out;
+}
+
+// Interpolates linearly and renormalizes. Cheaper than slerp; the angular
+// rate is not constant, which is rarely visible between animation keys.
+inline quat nlerp(quat a, quat b, float t)
+{
+    quat out;
+    BasicMathSimd::QuatAoS(BasicMathSimd::QuatOp::Nlerp, &a, &b, t, &out, 1);
+    return out;
+}
+
+// Batched forms. out[i] = op(a[i], b[i]); out may alias a or b exactly.
+inline void MulQuaternions(const quat* a, const quat* b, quat* out, size_t count)
+{
+    BasicMathSimd::QuatAoS(BasicMathSimd::QuatOp::Mul, a, b, 0.0f, out, count);
+}
+
+inline void SlerpQuaternions(const quat* a, const quat* b, float t, quat* out, size_t count)
+{
+    BasicMathSimd::QuatAoS(BasicMathSimd::QuatOp::Slerp, a, b, t, out, count);
+}
+
+inline void NlerpQuaternions(const quat* a, const quat* b, float t, quat* out, size_t count)
+{
+    BasicMathSimd::QuatAoS(BasicMathSimd::QuatOp::Nlerp, a, b, t, out, count);
+}
+
+// Converts count unit quaternions to rotation matrices.
+inline void QuaternionsToMatrices(const quat* in, float4x4* out, size_t count)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        out[i] = quatToMatrix(in[i]);
+    }
+}
+
+// Dual Quaternions
+//
+// A unit dual quaternion encodes a rigid transform: real holds the rotation
+// and dual holds 0.5 * t * real for translation t. The transform applies the
+// rotation first, then the translation. Blending dual quaternions and
+// renormalizing avoids the volume loss of blending skinning matrices.
+
+template <class T> struct DualQuaternion
+{
+    Quaternion<T> real;
+    Quaternion<T> dual;
+
+    constexpr DualQuaternion() : real(), dual(0, 0, 0, 0) { }
+    constexpr DualQuaternion(Quaternion<T> r, Quaternion<T> d) : real(r), dual(d) { }
+};
+
+typedef DualQuaternion<float> dualquat;
+
+constexpr dualquat dualQuatFromRotationTranslation(quat rotation, float3 translation)
+{
+    return dualquat(rotation, mul(quat(translation, 0.0f), rotation) * 0.5f);
+}
+
+constexpr float3 dualQuatTranslation(dualquat dq)
+{
+    return (mul(dq.dual, conjugate(dq.real)) * 2.0f).xyz();
+}
+
+// Applies b first, then a.
+constexpr dualquat mul(dualquat a, dualquat b)
+{
+    return dualquat(mul(a.real, b.real), mul(a.real, b.dual) + mul(a.dual, b.real));
+}
+
+inline dualquat normalize(dualquat dq)
+{
+    float s = 1.0f / sqrtf(dot(dq.real, dq.real));
+    quat real = dq.real * s;
+    quat dual = dq.dual * s;
+
+    // Remove the component of dual along real so that the result stays a
+    // rigid transform.
+    return dualquat(real, dual + real * -dot(real, dual));
+}
+
+constexpr float3 dualQuatTransformPoint(dualquat dq, float3 p)
+{
+    return rotate(dq.real, p) + dualQuatTranslation(dq);
+}
+
+constexpr float4x4 dualQuatToMatrix(dualquat dq)
+{
+    float4x4 m = quatToMatrix(dq.real);
+    float3 t = dualQuatTranslation(dq);
+    m._14 = t.x;
+    m._24 = t.y;
+    m._34 = t.z;
+    return m;
+}
+
+// Dual quaternion linear blending. Each input is sign-aligned with the first
+// so that the blend follows the shortest path, then the sum is renormalized.
+inline dualquat dualQuatBlend(const dualquat* transforms, const float* weights, size_t count)
+{
+    dualquat sum(quat(0.0f, 0.0f, 0.0f, 0.0f), quat(0.0f, 0.0f, 0.0f, 0.0f));
+    for (size_t i = 0; i < count; i++)
+    {
+        float w = weights[i];
+        if (i > 0 && dot(transforms[0].real, transforms[i].real) < 0.0f)
+        {
+            w = -w;
+        }
+        sum.real = sum.real + transforms[i].real * w;
+        sum.dual = sum.dual + transforms[i].dual * w;
+    }
+    return normalize(sum);
+}
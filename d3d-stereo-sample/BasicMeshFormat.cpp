@@ -0,0 +1,469 @@
+#include "BasicMeshFormat.h"
+#include "BasicVertexStream.h"
+#include "VertexQuantization.h"
+#include <float.h>
+#include <string.h>
+
+const BasicMeshAttribute BasicVertexAttributes[3] =
+{
+    { static_cast<uint8_t>(MeshSemantic::Position), 0, static_cast<uint8_t>(MeshAttributeFormat::Float3), 0, 0, 0 },
+    { static_cast<uint8_t>(MeshSemantic::Normal), 0, static_cast<uint8_t>(MeshAttributeFormat::Float3), 0, 12, 0 },
+    { static_cast<uint8_t>(MeshSemantic::TexCoord), 0, static_cast<uint8_t>(MeshAttributeFormat::Float2), 0, 24, 0 },
+};
+
+namespace
+{
+    const size_t VertexDataAlignment = 16;
+
+    size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+
+    // The first submesh must be full detail, as a level of detail refers
+    // back to one.
+    bool IsValidLodError(float lodError, size_t submeshIndex)
+    {
+        return lodError >= 0.0f && lodError <= FLT_MAX && (submeshIndex != 0 || lodError == 0.0f);
+    }
+
+    float Snorm(int32_t value, float scale)
+    {
+        float result = value / scale;
+        return (result < -1.0f) ? -1.0f : result;
+    }
+
+    bool IsNormalized(MeshAttributeFormat format)
+    {
+        return format >= MeshAttributeFormat::Snorm16x2;
+    }
+
+    // Validates a vertex layout and returns the position attribute, or null
+    // if the layout is malformed or has no position.
+    const BasicMeshAttribute* CheckLayout(
+        const BasicMeshAttribute* attributes,
+        uint32_t attributeCount,
+        uint32_t vertexStride)
+    {
+        if (attributeCount == 0 || attributeCount > BasicMeshMaxAttributes || vertexStride == 0 ||
+            vertexStride > UINT16_MAX)
+        {
+            return nullptr;
+        }
+
+        const BasicMeshAttribute* position = nullptr;
+        for (uint32_t i = 0; i < attributeCount; i++)
+        {
+            const BasicMeshAttribute& attribute = attributes[i];
+            if (attribute.semantic >= static_cast<uint8_t>(MeshSemantic::Count) ||
+                attribute.format >= static_cast<uint8_t>(MeshAttributeFormat::Count) ||
+                attribute.offset + GetMeshAttributeFormatSize(static_cast<MeshAttributeFormat>(attribute.format)) > vertexStride)
+            {
+                return nullptr;
+            }
+
+            if (static_cast<MeshSemantic>(attribute.semantic) == MeshSemantic::Position && attribute.semanticIndex == 0)
+            {
+                if (position != nullptr)
+                {
+                    return nullptr;
+                }
+                position = &attribute;
+            }
+        }
+        return position;
+    }
+
+    float3 ReadPosition(
+        const uint8_t* vertices,
+        uint32_t vertexStride,
+        const BasicMeshAttribute& position,
+        const AABB& positionBounds,
+        size_t index)
+    {
+        MeshAttributeFormat format = static_cast<MeshAttributeFormat>(position.format);
+        float4 value = DecodeMeshAttribute(format, vertices + index * vertexStride + position.offset);
+        float3 result(value.x, value.y, value.z);
+        if (IsNormalized(format))
+        {
+            result = positionBounds.center + positionBounds.extents * result;
+        }
+        return result;
+    }
+}
+
+bool IsBasicMesh(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size
+)
+{
+    uint32_t magic;
+    if (!data || size < sizeof(magic))
+    {
+        return false;
+    }
+    memcpy(&magic, data, sizeof(magic));
+    return magic == BasicMeshMagic;
+}
+
+BasicMeshResult ParseBasicMesh(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    _Out_ BasicMeshInfo* info
+)
+{
+    if (!data || !info || size == 0)
+    {
+        return BasicMeshResult::InvalidArgument;
+    }
+    *info = BasicMeshInfo();
+
+    if (size < sizeof(BasicMeshHeader))
+    {
+        return BasicMeshResult::OutOfBounds;
+    }
+
+    const BasicMeshHeader* header = reinterpret_cast<const BasicMeshHeader*>(data);
+    if (header->magic != BasicMeshMagic ||
+        header->version < BasicMeshMinimumVersion || header->version > BasicMeshVersion ||
+        (header->indexSize != 2 && header->indexSize != 4) || header->indexCount % 3 != 0 ||
+        header->submeshCount == 0)
+    {
+        return BasicMeshResult::InvalidData;
+    }
+
+    uint64_t tableSize = header->attributeCount * sizeof(BasicMeshAttribute) +
+        static_cast<uint64_t>(header->submeshCount) * sizeof(BasicMeshSubmesh);
+    if (tableSize > size - sizeof(BasicMeshHeader))
+    {
+        return BasicMeshResult::OutOfBounds;
+    }
+
+    const BasicMeshAttribute* attributes = reinterpret_cast<const BasicMeshAttribute*>(data + sizeof(BasicMeshHeader));
+    const BasicMeshSubmesh* submeshes = reinterpret_cast<const BasicMeshSubmesh*>(attributes + header->attributeCount);
+    if (!CheckLayout(attributes, header->attributeCount, header->vertexStride))
+    {
+        return BasicMeshResult::InvalidData;
+    }
+
+    // Sizes are at most 2^32 * 2^16, so 64-bit arithmetic cannot overflow.
+    uint64_t vertexDataSize = static_cast<uint64_t>(header->vertexCount) * header->vertexStride;
+    uint64_t indexDataSize = static_cast<uint64_t>(header->indexCount) * header->indexSize;
+    if (header->vertexDataOffset > size || vertexDataSize > size - header->vertexDataOffset ||
+        header->indexDataOffset > size || indexDataSize > size - header->indexDataOffset)
+    {
+        return BasicMeshResult::OutOfBounds;
+    }
+
+    for (uint32_t i = 0; i < header->submeshCount; i++)
+    {
+        const BasicMeshSubmesh& submesh = submeshes[i];
+        bool validLod = header->version < 3 || IsValidLodError(submesh.lodError, i);
+        if (submesh.indexCount % 3 != 0 || !validLod ||
+            submesh.indexStart > header->indexCount || submesh.indexCount > header->indexCount - submesh.indexStart ||
+            submesh.vertexStart > header->vertexCount || submesh.vertexCount > header->vertexCount - submesh.vertexStart)
+        {
+            return BasicMeshResult::InvalidData;
+        }
+    }
+
+    info->version = header->version;
+    info->vertexCount = header->vertexCount;
+    info->indexCount = header->indexCount;
+    info->vertexStride = header->vertexStride;
+    info->indexSize = header->indexSize;
+    info->attributes = attributes;
+    info->attributeCount = header->attributeCount;
+    info->submeshes = submeshes;
+    info->submeshCount = header->submeshCount;
+    info->bounds.center = float3(header->boundsCenter[0], header->boundsCenter[1], header->boundsCenter[2]);
+    info->bounds.extents = float3(header->boundsExtents[0], header->boundsExtents[1], header->boundsExtents[2]);
+    info->boundingSphere.center = float3(header->sphereCenter[0], header->sphereCenter[1], header->sphereCenter[2]);
+    info->boundingSphere.radius = header->sphereRadius;
+    info->vertexData = data + header->vertexDataOffset;
+    info->indexData = data + header->indexDataOffset;
+    return BasicMeshResult::Ok;
+}
+
+BasicMeshResult WriteBasicMesh(
+    const BasicMeshDesc& desc,
+    _Out_ std::vector<uint8_t>* file
+)
+{
+    if (!file || !desc.vertices || !desc.attributes || desc.vertexCount == 0 ||
+        (desc.indexCount != 0 && !desc.indices) || (desc.submeshCount != 0 && !desc.submeshes))
+    {
+        return BasicMeshResult::InvalidArgument;
+    }
+
+    const BasicMeshAttribute* position = CheckLayout(desc.attributes, desc.attributeCount, desc.vertexStride);
+    if (!position || desc.indexCount % 3 != 0 ||
+        (IsNormalized(static_cast<MeshAttributeFormat>(position->format)) && !desc.positionBounds))
+    {
+        return BasicMeshResult::InvalidData;
+    }
+
+    const uint8_t* vertices = static_cast<const uint8_t*>(desc.vertices);
+    AABB positionBounds = desc.positionBounds ? *desc.positionBounds : AABB();
+
+    // Positions are decoded once into a positions-only stream, which the
+    // whole-mesh and submesh bounds then share.
+    PositionArrays positionArrays;
+    positionArrays.Resize(desc.vertexCount);
+    for (uint32_t i = 0; i < desc.vertexCount; i++)
+    {
+        positionArrays.Set(i, ReadPosition(vertices, desc.vertexStride, *position, positionBounds, i));
+    }
+    PositionStream positions = positionArrays.Positions();
+
+    AABB bounds = desc.positionBounds ? *desc.positionBounds : ComputeBoundingBox(positions);
+    float radius = ComputeBoundingRadius(positions, bounds.center);
+
+    std::vector<BasicMeshSubmesh> submeshes;
+    if (desc.submeshCount == 0)
+    {
+        BasicMeshSubmesh whole = {};
+        whole.indexCount = desc.indexCount;
+        whole.vertexCount = desc.vertexCount;
+        submeshes.push_back(whole);
+    }
+    else
+    {
+        submeshes.assign(desc.submeshes, desc.submeshes + desc.submeshCount);
+    }
+
+    for (size_t i = 0; i < submeshes.size(); i++)
+    {
+        BasicMeshSubmesh& submesh = submeshes[i];
+        if (submesh.indexCount % 3 != 0 || !IsValidLodError(submesh.lodError, i) ||
+            submesh.indexStart > desc.indexCount || submesh.indexCount > desc.indexCount - submesh.indexStart ||
+            submesh.vertexStart > desc.vertexCount || submesh.vertexCount > desc.vertexCount - submesh.vertexStart)
+        {
+            return BasicMeshResult::InvalidData;
+        }
+
+        AABB box = ComputeBoundingBox(positions.Range(submesh.vertexStart, submesh.vertexCount));
+        memcpy(submesh.boundsCenter, &box.center, sizeof(submesh.boundsCenter));
+        memcpy(submesh.boundsExtents, &box.extents, sizeof(submesh.boundsExtents));
+    }
+
+    // 0xFFFF is the strip cut value, so 16-bit indices stop one short of it.
+    uint32_t indexSize = 2;
+    for (uint32_t i = 0; i < desc.indexCount; i++)
+    {
+        if (desc.indices[i] >= UINT16_MAX)
+        {
+            indexSize = 4;
+            break;
+        }
+    }
+
+    BasicMeshHeader header = {};
+    header.magic = BasicMeshMagic;
+    header.version = BasicMeshVersion;
+    header.indexSize = static_cast<uint16_t>(indexSize);
+    header.vertexCount = desc.vertexCount;
+    header.indexCount = desc.indexCount;
+    header.vertexStride = static_cast<uint16_t>(desc.vertexStride);
+    header.attributeCount = static_cast<uint16_t>(desc.attributeCount);
+    header.submeshCount = static_cast<uint32_t>(submeshes.size());
+    memcpy(header.boundsCenter, &bounds.center, sizeof(header.boundsCenter));
+    memcpy(header.boundsExtents, &bounds.extents, sizeof(header.boundsExtents));
+    memcpy(header.sphereCenter, &bounds.center, sizeof(header.sphereCenter));
+    header.sphereRadius = radius;
+
+    size_t tablesEnd = sizeof(header) + desc.attributeCount * sizeof(BasicMeshAttribute) +
+        submeshes.size() * sizeof(BasicMeshSubmesh);
+    size_t vertexDataSize = static_cast<size_t>(desc.vertexCount) * desc.vertexStride;
+    header.vertexDataOffset = AlignUp(tablesEnd, VertexDataAlignment);
+    header.indexDataOffset = AlignUp(static_cast<size_t>(header.vertexDataOffset) + vertexDataSize, sizeof(uint32_t));
+
+    file->assign(static_cast<size_t>(header.indexDataOffset) + static_cast<size_t>(desc.indexCount) * indexSize, 0);
+    uint8_t* out = file->data();
+    memcpy(out, &header, sizeof(header));
+    memcpy(out + sizeof(header), desc.attributes, desc.attributeCount * sizeof(BasicMeshAttribute));
+    memcpy(out + sizeof(header) + desc.attributeCount * sizeof(BasicMeshAttribute), submeshes.data(),
+        submeshes.size() * sizeof(BasicMeshSubmesh));
+    memcpy(out + header.vertexDataOffset, vertices, vertexDataSize);
+
+    uint8_t* indexData = out + header.indexDataOffset;
+    for (uint32_t i = 0; i < desc.indexCount; i++)
+    {
+        if (indexSize == 2)
+        {
+            uint16_t index = static_cast<uint16_t>(desc.indices[i]);
+            memcpy(indexData + i * 2, &index, sizeof(index));
+        }
+        else
+        {
+            memcpy(indexData + i * 4, &desc.indices[i], sizeof(uint32_t));
+        }
+    }
+    return BasicMeshResult::Ok;
+}
+
+BasicMeshResult ConvertLegacyBasicMesh(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    _Out_ std::vector<uint8_t>* file
+)
+{
+    if (!data || !file || size == 0)
+    {
+        return BasicMeshResult::InvalidArgument;
+    }
+
+    uint32_t counts[2];
+    if (size < sizeof(counts))
+    {
+        return BasicMeshResult::OutOfBounds;
+    }
+    memcpy(counts, data, sizeof(counts));
+
+    uint64_t expectedSize = sizeof(counts) + static_cast<uint64_t>(counts[0]) * sizeof(BasicVertex) +
+        static_cast<uint64_t>(counts[1]) * sizeof(uint16_t);
+    if (expectedSize > size)
+    {
+        return BasicMeshResult::OutOfBounds;
+    }
+    if (counts[0] == 0 || counts[1] % 3 != 0)
+    {
+        return BasicMeshResult::InvalidData;
+    }
+
+    const uint8_t* legacyIndices = data + sizeof(counts) + counts[0] * sizeof(BasicVertex);
+    std::vector<uint32_t> indices(counts[1]);
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        uint16_t index;
+        memcpy(&index, legacyIndices + i * sizeof(index), sizeof(index));
+        indices[i] = index;
+    }
+
+    // The vertices are copied out so that the writer reads them aligned.
+    std::vector<BasicVertex> vertices(counts[0]);
+    memcpy(vertices.data(), data + sizeof(counts), vertices.size() * sizeof(BasicVertex));
+
+    BasicMeshDesc desc = {};
+    desc.vertices = vertices.data();
+    desc.vertexCount = counts[0];
+    desc.vertexStride = sizeof(BasicVertex);
+    desc.attributes = BasicVertexAttributes;
+    desc.attributeCount = 3;
+    desc.indices = indices.data();
+    desc.indexCount = counts[1];
+    return WriteBasicMesh(desc, file);
+}
+
+uint32_t GetMeshAttributeFormatSize(MeshAttributeFormat format)
+{
+    switch (format)
+    {
+    case MeshAttributeFormat::Float2: return 8;
+    case MeshAttributeFormat::Float3: return 12;
+    case MeshAttributeFormat::Float4: return 16;
+    case MeshAttributeFormat::Half2: return 4;
+    case MeshAttributeFormat::Half4: return 8;
+    case MeshAttributeFormat::Snorm16x2: return 4;
+    case MeshAttributeFormat::Snorm16x4: return 8;
+    case MeshAttributeFormat::Unorm16x2: return 4;
+    case MeshAttributeFormat::Unorm16x4: return 8;
+    case MeshAttributeFormat::Snorm8x4: return 4;
+    case MeshAttributeFormat::Unorm8x4: return 4;
+    default: return 0;
+    }
+}
+
+const BasicMeshAttribute* FindMeshAttribute(
+    const BasicMeshInfo& info,
+    MeshSemantic semantic,
+    uint32_t semanticIndex
+)
+{
+    for (uint32_t i = 0; i < info.attributeCount; i++)
+    {
+        if (info.attributes[i].semantic == static_cast<uint8_t>(semantic) &&
+            info.attributes[i].semanticIndex == semanticIndex)
+        {
+            return &info.attributes[i];
+        }
+    }
+    return nullptr;
+}
+
+float4 DecodeMeshAttribute(
+    MeshAttributeFormat format,
+    _In_ const uint8_t* data
+)
+{
+    float4 value(0.0f, 0.0f, 0.0f, 1.0f);
+    switch (format)
+    {
+    case MeshAttributeFormat::Float2:
+    case MeshAttributeFormat::Float3:
+    case MeshAttributeFormat::Float4:
+        memcpy(&value.x, data, GetMeshAttributeFormatSize(format));
+        break;
+
+    case MeshAttributeFormat::Half2:
+    case MeshAttributeFormat::Half4:
+        for (uint32_t i = 0; i < GetMeshAttributeFormatSize(format) / 2; i++)
+        {
+            uint16_t half;
+            memcpy(&half, data + i * 2, sizeof(half));
+            value[i] = HalfToFloat(half);
+        }
+        break;
+
+    case MeshAttributeFormat::Snorm16x2:
+    case MeshAttributeFormat::Snorm16x4:
+        for (uint32_t i = 0; i < GetMeshAttributeFormatSize(format) / 2; i++)
+        {
+            int16_t component;
+            memcpy(&component, data + i * 2, sizeof(component));
+            value[i] = Snorm(component, 32767.0f);
+        }
+        break;
+
+    case MeshAttributeFormat::Unorm16x2:
+    case MeshAttributeFormat::Unorm16x4:
+        for (uint32_t i = 0; i < GetMeshAttributeFormatSize(format) / 2; i++)
+        {
+            uint16_t component;
+            memcpy(&component, data + i * 2, sizeof(component));
+            value[i] = component / 65535.0f;
+        }
+        break;
+
+    case MeshAttributeFormat::Snorm8x4:
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            value[i] = Snorm(static_cast<int8_t>(data[i]), 127.0f);
+        }
+        break;
+
+    case MeshAttributeFormat::Unorm8x4:
+        for (uint32_t i = 0; i < 4; i++)
+        {
+            value[i] = data[i] / 255.0f;
+        }
+        break;
+
+    default:
+        break;
+    }
+    return value;
+}
+
+std::vector<BasicMeshSubmesh> GetMeshSubmeshes(const BasicMeshInfo& info)
+{
+    std::vector<BasicMeshSubmesh> submeshes(info.submeshes, info.submeshes + info.submeshCount);
+    if (info.version < 3)
+    {
+        for (BasicMeshSubmesh& submesh : submeshes)
+        {
+            submesh.lodError = 0.0f;
+        }
+    }
+    return submeshes;
+}
@@ -0,0 +1,223 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "BasicSal.h"
+#include "BasicVertex.h"
+#include "FrustumCulling.h"
+
+// Version 3 of the BasicMesh format. Version 1 was a bare blob of a vertex
+// count, an index count, BasicVertex records and 16-bit indices; version 2
+// added a header, a declared vertex layout, 16- or 32-bit indices, submeshes
+// and bounding volumes, and version 3 gives submeshes levels of detail.
+// Layout, all integers little-endian:
+//
+//   BasicMeshHeader
+//   BasicMeshAttribute[attributeCount]
+//   BasicMeshSubmesh[submeshCount]
+//   vertex data                     at vertexDataOffset, vertexStride per vertex
+//   index data                      at indexDataOffset, indexSize per index
+//
+// Indices form a triangle list. Files are written with 16-bit indices when
+// every index fits and 32-bit indices otherwise.
+//
+// A submesh with a nonzero lodError is a simplified level of detail of the
+// nearest earlier submesh whose lodError is 0, drawn instead of it rather
+// than as well; its levels follow it in order of increasing error. lodError
+// is the largest distance, in mesh units, by which the level departs from
+// the full-detail surface (see MeshSimplifier.h).
+//
+// Version 2 files are still read. Their submeshes have a reserved field where
+// version 3 has lodError, which version 2 writers did not always clear, so it
+// is ignored and every submesh is full detail; GetMeshSubmeshes reports them
+// that way. Files are always written as version 3.
+
+const uint32_t BasicMeshMagic = 0x4853454D; // "MESH"
+const uint16_t BasicMeshVersion = 3;
+const uint16_t BasicMeshMinimumVersion = 2;
+const uint32_t BasicMeshMaxAttributes = 16;
+
+enum class BasicMeshResult
+{
+    Ok,
+    InvalidArgument,    // a null pointer or an empty buffer was passed
+    InvalidData,        // the header or layout is malformed or unsupported
+    OutOfBounds,        // the data is shorter than the header describes
+};
+
+enum class MeshSemantic : uint8_t
+{
+    Position,
+    Normal,
+    TexCoord,
+    Tangent,
+    Color,
+    Count
+};
+
+// Normalized formats decode to [-1, 1] (snorm) or [0, 1] (unorm). Normalized
+// positions are relative to the mesh bounds: the position is
+// bounds.center + bounds.extents * value.
+enum class MeshAttributeFormat : uint8_t
+{
+    Float2,
+    Float3,
+    Float4,
+    Half2,
+    Half4,
+    Snorm16x2,
+    Snorm16x4,
+    Unorm16x2,
+    Unorm16x4,
+    Snorm8x4,
+    Unorm8x4,
+    Count
+};
+
+#pragma pack(push, 1)
+struct BasicMeshHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t indexSize;         // 2 or 4
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint16_t vertexStride;
+    uint16_t attributeCount;
+    uint32_t submeshCount;
+    uint64_t vertexDataOffset;
+    uint64_t indexDataOffset;
+    float boundsCenter[3];
+    float boundsExtents[3];
+    float sphereCenter[3];
+    float sphereRadius;
+};
+
+struct BasicMeshAttribute
+{
+    uint8_t semantic;           // a MeshSemantic
+    uint8_t semanticIndex;
+    uint8_t format;             // a MeshAttributeFormat
+    uint8_t reserved;
+    uint16_t offset;            // from the start of a vertex
+    uint16_t reserved2;
+};
+
+struct BasicMeshSubmesh
+{
+    uint32_t indexStart;
+    uint32_t indexCount;
+    uint32_t vertexStart;       // the range of vertices the indices refer to
+    uint32_t vertexCount;
+    uint32_t materialIndex;
+    float lodError;             // 0 for full detail; reserved in version 2
+    float boundsCenter[3];
+    float boundsExtents[3];
+};
+#pragma pack(pop)
+
+static_assert(sizeof(BasicMeshHeader) == 80, "BasicMeshHeader must match the file layout");
+static_assert(sizeof(BasicMeshAttribute) == 8, "BasicMeshAttribute must match the file layout");
+static_assert(sizeof(BasicMeshSubmesh) == 48, "BasicMeshSubmesh must match the file layout");
+
+// The layout of BasicVertex: float3 position, float3 normal, float2 texcoord.
+extern const BasicMeshAttribute BasicVertexAttributes[3];
+
+// A parsed mesh. The pointers refer into the parsed buffer, which must outlive
+// the info.
+struct BasicMeshInfo
+{
+    uint32_t version;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    uint32_t vertexStride;
+    uint32_t indexSize;
+    const BasicMeshAttribute* attributes;
+    uint32_t attributeCount;
+    const BasicMeshSubmesh* submeshes;
+    uint32_t submeshCount;
+    AABB bounds;
+    Sphere boundingSphere;
+    const uint8_t* vertexData;
+    const uint8_t* indexData;
+};
+
+// What WriteBasicMesh packs into a file. Indices are always passed as 32-bit
+// values. Without submeshes, the file gets one submesh covering the whole
+// mesh; the bounds of given submeshes are filled in by the writer.
+// positionBounds must be given for normalized positions, whose values are
+// relative to it, and is computed from the positions otherwise.
+struct BasicMeshDesc
+{
+    const void* vertices;
+    uint32_t vertexCount;
+    uint32_t vertexStride;
+    const BasicMeshAttribute* attributes;
+    uint32_t attributeCount;
+    const uint32_t* indices;
+    uint32_t indexCount;
+    const BasicMeshSubmesh* submeshes;
+    uint32_t submeshCount;
+    const AABB* positionBounds;
+};
+
+// Returns true if data starts with the magic number of versions 2 and 3.
+bool IsBasicMesh(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size
+);
+
+// Checks the header, the layout and the submeshes, and that the vertex and
+// index data fit in size bytes. Index values are not checked against the
+// vertex count; Direct3D returns zeros for out-of-range vertex fetches.
+BasicMeshResult ParseBasicMesh(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    _Out_ BasicMeshInfo* info
+);
+
+BasicMeshResult WriteBasicMesh(
+    const BasicMeshDesc& desc,
+    _Out_ std::vector<uint8_t>* file
+);
+
+// Converts a version 1 mesh to the current version, checking that the counts
+// at its start agree with its size.
+BasicMeshResult ConvertLegacyBasicMesh(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    _Out_ std::vector<uint8_t>* file
+);
+
+uint32_t GetMeshAttributeFormatSize(MeshAttributeFormat format);
+
+// Returns the first attribute with the given semantic and index, or null.
+const BasicMeshAttribute* FindMeshAttribute(
+    const BasicMeshInfo& info,
+    MeshSemantic semantic,
+    uint32_t semanticIndex = 0
+);
+
+// Decodes one attribute value to floats; missing components are 0, except w,
+// which is 1.
+float4 DecodeMeshAttribute(
+    MeshAttributeFormat format,
+    _In_ const uint8_t* data
+);
+
+// Copies the submeshes of a parsed mesh, with lodError cleared for version 2
+// files. Use this rather than info.submeshes wherever levels of detail
+// matter.
+std::vector<BasicMeshSubmesh> GetMeshSubmeshes(const BasicMeshInfo& info);
+
+// Returns the index at position i of the parsed index data.
+inline uint32_t GetMeshIndex(const BasicMeshInfo& info, size_t i)
+{
+    if (info.indexSize == 2)
+    {
+        return static_cast<uint32_t>(info.indexData[i * 2]) | (static_cast<uint32_t>(info.indexData[i * 2 + 1]) << 8);
+    }
+    const uint8_t* index = info.indexData + i * 4;
+    return static_cast<uint32_t>(index[0]) | (static_cast<uint32_t>(index[1]) << 8) |
+        (static_cast<uint32_t>(index[2]) << 16) | (static_cast<uint32_t>(index[3]) << 24);
+}
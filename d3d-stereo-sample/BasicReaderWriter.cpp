@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "BasicReaderWriter.h"
+#include "CompressedStream.h"
 
 namespace winrt
 {
@@ -10,6 +11,57 @@ namespace winrt
     using namespace Windows::ApplicationModel;
 }
 
+namespace
+{
+    // Files written with compressed = true are compressed streams (see
+    // CompressedStream.h); they are unpacked on every hardware thread straight
+    // into the buffer that is handed back, so callers never see the stream.
+    void UnpackIfCompressed(_Inout_ std::vector<byte>& fileData)
+    {
+        if (!IsCompressedStream(fileData.data(), fileData.size()))
+        {
+            return;
+        }
+
+        CompressedStreamReader reader;
+        if (!reader.Open(fileData.data(), fileData.size()) || reader.GetSize() > SIZE_MAX)
+        {
+            throw winrt::hresult_error(E_UNEXPECTED);
+        }
+
+        std::vector<byte> unpacked(static_cast<size_t>(reader.GetSize()));
+        if (!reader.Decompress(unpacked.data(), unpacked.size(), 0))
+        {
+            throw winrt::hresult_error(E_UNEXPECTED);
+        }
+        fileData.swap(unpacked);
+    }
+
+    MappedFile UnpackIfCompressed(MappedFile file)
+    {
+        if (!IsCompressedStream(file.Data(), file.Size()))
+        {
+            return file;
+        }
+
+        CompressedStreamReader reader;
+        if (!reader.Open(file.Data(), file.Size()) || reader.GetSize() > SIZE_MAX)
+        {
+            throw winrt::hresult_error(E_UNEXPECTED);
+        }
+
+        auto unpacked = std::make_shared<std::vector<uint8_t>>(static_cast<size_t>(reader.GetSize()));
+        if (!reader.Decompress(unpacked->data(), unpacked->size(), 0))
+        {
+            throw winrt::hresult_error(E_UNEXPECTED);
+        }
+
+        const uint8_t* data = unpacked->data();
+        size_t size = unpacked->size();
+        return MappedFile(std::move(unpacked), data, size);
+    }
+}
+
 BasicReaderWriter::BasicReaderWriter()
 {
     m_location = winrt::Package::Current().InstalledLocation();
@@ -30,77 +82,161 @@ BasicReaderWriter::BasicReaderWriter(
     }
 }
 
+void BasicReaderWriter::MountPack(
+    std::wstring const& filename)
+{
+    auto pack = std::make_shared<AssetPack>();
+    if (!pack->Open(filename.c_str()))
+    {
+        throw winrt::hresult_error(E_UNEXPECTED);
+    }
+
+    m_packs.insert(m_packs.begin(), std::move(pack));
+}
+
+std::shared_ptr<AssetPack> BasicReaderWriter::FindInPacks(
+    std::wstring const& filename,
+    _Out_ size_t* index)
+{
+    *index = AssetPack::NotFound;
+    if (m_packs.empty())
+    {
+        return nullptr;
+    }
+
+    std::string name = winrt::to_string(filename);
+    for (auto const& pack : m_packs)
+    {
+        *index = pack->Find(name.c_str());
+        if (*index != AssetPack::NotFound)
+        {
+            return pack;
+        }
+    }
+    return nullptr;
+}
+
 std::vector<byte> BasicReaderWriter::ReadData(
     std::wstring const& filename)
 {
-    CREATEFILE2_EXTENDED_PARAMETERS extendedParams = { 0 };
-    extendedParams.dwSize = sizeof(CREATEFILE2_EXTENDED_PARAMETERS);
-    extendedParams.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
-    extendedParams.dwFileFlags = FILE_FLAG_SEQUENTIAL_SCAN;
-    extendedParams.dwSecurityQosFlags = SECURITY_ANONYMOUS;
-    extendedParams.lpSecurityAttributes = nullptr;
-    extendedParams.hTemplateFile = nullptr;
+    size_t index;
+    if (auto pack = FindInPacks(filename, &index))
+    {
+        std::vector<byte> fileData;
+        if (!pack->Read(index, &fileData))
+        {
+            throw winrt::hresult_error(E_UNEXPECTED);
+        }
+        UnpackIfCompressed(fileData);
+        return fileData;
+    }
 
-    wil::unique_hfile file(
-        CreateFile2(
-            filename.data(),
-            GENERIC_READ,
-            FILE_SHARE_READ,
-            OPEN_EXISTING,
-            &extendedParams
-        )
-    );
-    if (file.get() == INVALID_HANDLE_VALUE)
+    PlatformFile file;
+    if (!file.Open(filename.c_str()))
     {
         throw winrt::hresult_error(E_UNEXPECTED);
     }
 
-    FILE_STANDARD_INFO fileInfo = {};
-    if (!GetFileInformationByHandleEx(
-        file.get(),
-        FileStandardInfo,
-        &fileInfo,
-        sizeof(fileInfo)
-    ))
+    if (file.GetSize() > SIZE_MAX)
+    {
+        throw winrt::hresult_error(E_OUTOFMEMORY);
+    }
+
+    std::vector<byte> fileData(static_cast<size_t>(file.GetSize()), 0);
+    if (!file.Read(0, fileData.data(), fileData.size()))
     {
         throw winrt::hresult_error(E_UNEXPECTED);
     }
 
-    if (fileInfo.EndOfFile.HighPart != 0)
+    UnpackIfCompressed(fileData);
+    return fileData;
+}
+
+void BasicReaderWriter::ReadData(
+    std::wstring const& filename,
+    uint64_t offset,
+    _Out_writes_bytes_(size) void* destination,
+    size_t size)
+{
+    PlatformFile file;
+    if (!file.Open(filename.c_str(), PlatformFile::Access::Random) ||
+        !file.Read(offset, destination, size))
     {
-        throw winrt::hresult_error(E_OUTOFMEMORY);
+        throw winrt::hresult_error(E_UNEXPECTED);
     }
+}
 
-    std::vector<byte> fileData(fileInfo.EndOfFile.LowPart, 0);
+uint64_t BasicReaderWriter::GetDataSize(
+    std::wstring const& filename)
+{
+    PlatformFile file;
+    if (!file.Open(filename.c_str(), PlatformFile::Access::Random))
+    {
+        throw winrt::hresult_error(E_UNEXPECTED);
+    }
+    return file.GetSize();
+}
+
+MappedFile BasicReaderWriter::MapData(
+    std::wstring const& filename)
+{
+    size_t index;
+    if (auto pack = FindInPacks(filename, &index))
+    {
+        MappedFile entry = pack->Map(index);
+        if (!entry.IsOpen())
+        {
+            throw winrt::hresult_error(E_UNEXPECTED);
+        }
+        return UnpackIfCompressed(std::move(entry));
+    }
 
-    if (!ReadFile(
-        file.get(),
-        fileData.data(),
-        fileData.size(),
-        nullptr,
-        nullptr
-    ))
+    MappedFile file;
+    if (!file.Open(filename.c_str()))
     {
         throw winrt::hresult_error(E_UNEXPECTED);
     }
 
-    return fileData;
+    return UnpackIfCompressed(std::move(file));
 }
 
 std::future<std::vector<byte>> BasicReaderWriter::ReadDataAsync(
     std::wstring const& filename)
 {
+    size_t index;
+    if (auto pack = FindInPacks(filename, &index))
+    {
+        // Entries are read straight from the mapping; there is no I/O to wait
+        // for beyond page faults.
+        std::vector<byte> fileData;
+        if (!pack->Read(index, &fileData))
+        {
+            throw winrt::hresult_error(E_UNEXPECTED);
+        }
+        UnpackIfCompressed(fileData);
+        co_return fileData;
+    }
+
     auto file = co_await m_location.GetFileAsync(filename);
     auto buffer = co_await winrt::FileIO::ReadBufferAsync(file);
     std::vector<byte> fileData(buffer.Length(), 0);
     winrt::DataReader::FromBuffer(buffer).ReadBytes(fileData);
+    UnpackIfCompressed(fileData);
     co_return fileData;
 }
 
 uint32_t BasicReaderWriter::WriteData(
     std::wstring const& filename,
-    std::vector<byte> fileData)
+    std::vector<byte> fileData,
+    bool compressed)
 {
+    if (compressed)
+    {
+        std::vector<byte> stream;
+        CompressStream(fileData.data(), fileData.size(), CompressedStreamDefaultChunkSize, 0, &stream);
+        fileData.swap(stream);
+    }
+
     CREATEFILE2_EXTENDED_PARAMETERS extendedParams = {};
     extendedParams.dwSize = sizeof(CREATEFILE2_EXTENDED_PARAMETERS);
     extendedParams.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
@@ -143,8 +279,16 @@ uint32_t BasicReaderWriter::WriteData(
 
 winrt::IAsyncAction BasicReaderWriter::WriteDataAsync(
     std::wstring const& filename,
-    std::vector<byte> fileData)
+    std::vector<byte> fileData,
+    bool compressed)
 {
+    if (compressed)
+    {
+        std::vector<byte> stream;
+        CompressStream(fileData.data(), fileData.size(), CompressedStreamDefaultChunkSize, 0, &stream);
+        fileData.swap(stream);
+    }
+
     auto file = co_await m_location.CreateFileAsync(filename, winrt::CreationCollisionOption::ReplaceExisting);
     co_await winrt::FileIO::WriteBytesAsync(file, fileData);
 }
\ No newline at end of file
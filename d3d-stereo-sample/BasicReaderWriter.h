@@ -1,4 +1,7 @@
 #pragma once
+#include "AssetPack.h"
+#include "MappedFile.h"
+#include "PlatformFile.h"
 
 // A simple reader/writer class that provides support for reading and writing
 // files on disk. Provides synchronous and asynchronous methods.
@@ -6,6 +9,12 @@ class BasicReaderWriter
 {
 private:
     winrt::Windows::Storage::StorageFolder m_location{ nullptr };
+    std::vector<std::shared_ptr<AssetPack>> m_packs;
+
+    std::shared_ptr<AssetPack> FindInPacks(
+        std::wstring const& filename,
+        _Out_ size_t* index
+    );
 
 public:
     BasicReaderWriter();
@@ -13,21 +22,56 @@ public:
         winrt::Windows::Storage::StorageFolder const& folder
     );
 
+    // Opens an asset pack (see AssetPack.h). From then on, ReadData,
+    // ReadDataAsync and MapData look each filename up in the mounted packs,
+    // the most recently mounted first, before going to the file system, so
+    // callers load packed and loose files the same way.
+    void MountPack(
+        std::wstring const& filename
+    );
+
+    // ReadData, MapData and ReadDataAsync unpack files that were written as
+    // compressed streams (see CompressedStream.h) before returning them, using
+    // every hardware thread.
     std::vector<byte> ReadData(
         std::wstring const& filename
     );
 
+    // Reads size bytes of a loose file, starting at offset, into a buffer the
+    // caller owns. Files over 4 GB can be read this way in pieces; the data is
+    // returned as stored, without unpacking compressed streams.
+    void ReadData(
+        std::wstring const& filename,
+        uint64_t offset,
+        _Out_writes_bytes_(size) void* destination,
+        size_t size
+    );
+
+    uint64_t GetDataSize(
+        std::wstring const& filename
+    );
+
+    // Maps the file read-only instead of copying it into memory. The returned
+    // view must outlive any use of its data.
+    MappedFile MapData(
+        std::wstring const& filename
+    );
+
     std::future<std::vector<byte>> ReadDataAsync(
         std::wstring const& filename
     );
 
+    // With compressed, the data is written as a compressed stream, which the
+    // read methods unpack transparently. WriteData returns the bytes written.
     uint32_t WriteData(
         std::wstring const& filename,
-        std::vector<byte> fileData
+        std::vector<byte> fileData,
+        bool compressed = false
     );
 
     winrt::Windows::Foundation::IAsyncAction WriteDataAsync(
         std::wstring const& filename,
-        std::vector<byte> fileData
+        std::vector<byte> fileData,
+        bool compressed = false
     );
 };
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+
+// Source annotation language (SAL) shim for headers and sources that do not
+// depend on Windows headers. MSVC builds get the real annotations from
+// <sal.h>; other toolchains see empty definitions.
+
+#if defined(_MSC_VER)
+#include <sal.h>
+#else
+#define _In_
+#define _In_opt_
+#define _In_z_
+#define _In_reads_(size)
+#define _In_reads_opt_(size)
+#define _In_reads_bytes_(size)
+#define _In_reads_bytes_opt_(size)
+#define _Out_
+#define _Out_opt_
+#define _Out_writes_(size)
+#define _Out_writes_opt_(size)
+#define _Out_writes_bytes_(size)
+#define _Out_writes_bytes_opt_(size)
+#define _Out_writes_all_(size)
+#define _Outptr_
+#define _Outptr_opt_
+#define _Outptr_result_bytebuffer_(size)
+#define _Inout_
+#define _Inout_opt_
+#define _Inout_updates_(size)
+#define _Inout_updates_bytes_(size)
+#define _Ret_maybenull_
+#define _Success_(expr)
+#define _Use_decl_annotations_
+#define _Analysis_assume_(expr)
+#endif
@@ -1,5 +1,6 @@
 #include "pch.h"
 #include "BasicShapes.h"
+#include "MeshOptimizer.h"
 
 BasicShapes::BasicShapes(ID3D11Device* d3dDevice)
 {
@@ -107,170 +108,99 @@ void BasicShapes::CreateTangentVertexBuffer(
     *vertexBuffer = vertexBufferInternal.detach();
 }
 
-void BasicShapes::CreateCube(
+template <class Generator>
+void BasicShapes::CreateShape(
+    ShapeSize size,
+    Generator generate,
+    bool optimize,
     _Out_ ID3D11Buffer** vertexBuffer,
     _Out_ ID3D11Buffer** indexBuffer,
     _Out_opt_ unsigned int* vertexCount,
     _Out_opt_ unsigned int* indexCount
 )
 {
-    BasicVertex cubeVertices[] =
-    {
-        { float3(-0.5f, 0.5f, -0.5f), float3(0.0f, 1.0f, 0.0f), float2(0.0f, 0.0f) }, // +Y (top face)
-        { float3(0.5f, 0.5f, -0.5f), float3(0.0f, 1.0f, 0.0f), float2(1.0f, 0.0f) },
-        { float3(0.5f, 0.5f,  0.5f), float3(0.0f, 1.0f, 0.0f), float2(1.0f, 1.0f) },
-        { float3(-0.5f, 0.5f,  0.5f), float3(0.0f, 1.0f, 0.0f), float2(0.0f, 1.0f) },
-
-        { float3(-0.5f, -0.5f,  0.5f), float3(0.0f, -1.0f, 0.0f), float2(0.0f, 0.0f) }, // -Y (bottom face)
-        { float3(0.5f, -0.5f,  0.5f), float3(0.0f, -1.0f, 0.0f), float2(1.0f, 0.0f) },
-        { float3(0.5f, -0.5f, -0.5f), float3(0.0f, -1.0f, 0.0f), float2(1.0f, 1.0f) },
-        { float3(-0.5f, -0.5f, -0.5f), float3(0.0f, -1.0f, 0.0f), float2(0.0f, 1.0f) },
-
-        { float3(0.5f,  0.5f,  0.5f), float3(1.0f, 0.0f, 0.0f), float2(0.0f, 0.0f) }, // +X (right face)
-        { float3(0.5f,  0.5f, -0.5f), float3(1.0f, 0.0f, 0.0f), float2(1.0f, 0.0f) },
-        { float3(0.5f, -0.5f, -0.5f), float3(1.0f, 0.0f, 0.0f), float2(1.0f, 1.0f) },
-        { float3(0.5f, -0.5f,  0.5f), float3(1.0f, 0.0f, 0.0f), float2(0.0f, 1.0f) },
-
-        { float3(-0.5f,  0.5f, -0.5f), float3(-1.0f, 0.0f, 0.0f), float2(0.0f, 0.0f) }, // -X (left face)
-        { float3(-0.5f,  0.5f,  0.5f), float3(-1.0f, 0.0f, 0.0f), float2(1.0f, 0.0f) },
-        { float3(-0.5f, -0.5f,  0.5f), float3(-1.0f, 0.0f, 0.0f), float2(1.0f, 1.0f) },
-        { float3(-0.5f, -0.5f, -0.5f), float3(-1.0f, 0.0f, 0.0f), float2(0.0f, 1.0f) },
-
-        { float3(-0.5f,  0.5f, 0.5f), float3(0.0f, 0.0f, 1.0f), float2(0.0f, 0.0f) }, // +Z (front face)
-        { float3(0.5f,  0.5f, 0.5f), float3(0.0f, 0.0f, 1.0f), float2(1.0f, 0.0f) },
-        { float3(0.5f, -0.5f, 0.5f), float3(0.0f, 0.0f, 1.0f), float2(1.0f, 1.0f) },
-        { float3(-0.5f, -0.5f, 0.5f), float3(0.0f, 0.0f, 1.0f), float2(0.0f, 1.0f) },
-
-        { float3(0.5f,  0.5f, -0.5f), float3(0.0f, 0.0f, -1.0f), float2(0.0f, 0.0f) }, // -Z (back face)
-        { float3(-0.5f,  0.5f, -0.5f), float3(0.0f, 0.0f, -1.0f), float2(1.0f, 0.0f) },
-        { float3(-0.5f, -0.5f, -0.5f), float3(0.0f, 0.0f, -1.0f), float2(1.0f, 1.0f) },
-        { float3(0.5f, -0.5f, -0.5f), float3(0.0f, 0.0f, -1.0f), float2(0.0f, 1.0f) },
-    };
-
-    unsigned short cubeIndices[] =
+    m_vertices.resize(size.vertexCount);
+    m_indices.resize(size.indexCount);
+    if (size.vertexCount == 0 ||
+        !generate(m_vertices.data(), m_vertices.size(), m_indices.data(), m_indices.size()))
     {
-        0, 1, 2,
-        0, 2, 3,
-
-        4, 5, 6,
-        4, 6, 7,
-
-        8, 9, 10,
-        8, 10, 11,
-
-        12, 13, 14,
-        12, 14, 15,
-
-        16, 17, 18,
-        16, 18, 19,
+        throw winrt::hresult_error(E_INVALIDARG);
+    }
 
-        20, 21, 22,
-        20, 22, 23
-    };
+    // The generated shapes sweep their surface row by row, which shades each
+    // vertex about twice; reordering them for the vertex cache cuts that by
+    // about a third. Unused vertices, such as those at the poles of the UV
+    // sphere's seam, are dropped.
+    unsigned int numVertices = size.vertexCount;
+    if (optimize)
+    {
+        numVertices = static_cast<unsigned int>(
+            OptimizeMesh(m_vertices.data(), m_vertices.size(), sizeof(BasicVertex), m_indices.data(), m_indices.size())
+        );
+    }
 
     CreateVertexBuffer(
-        ARRAYSIZE(cubeVertices),
-        cubeVertices,
+        numVertices,
+        m_vertices.data(),
         vertexBuffer
     );
     if (vertexCount != nullptr)
     {
-        *vertexCount = ARRAYSIZE(cubeVertices);
+        *vertexCount = numVertices;
     }
 
     CreateIndexBuffer(
-        ARRAYSIZE(cubeIndices),
-        cubeIndices,
+        size.indexCount,
+        m_indices.data(),
         indexBuffer
     );
     if (indexCount != nullptr)
     {
-        *indexCount = ARRAYSIZE(cubeIndices);
+        *indexCount = size.indexCount;
     }
 }
 
-void BasicShapes::CreateBox(
-    float3 r,
+void BasicShapes::CreateCube(
     _Out_ ID3D11Buffer** vertexBuffer,
     _Out_ ID3D11Buffer** indexBuffer,
     _Out_opt_ unsigned int* vertexCount,
     _Out_opt_ unsigned int* indexCount
 )
 {
-    BasicVertex boxVertices[] =
-    {
-        // FLOOR
-        {float3(-r.x, -r.y,  r.z), float3(0.0f, 1.0f, 0.0f), float2(0.0f, 0.0f)},
-        {float3(r.x, -r.y,  r.z), float3(0.0f, 1.0f, 0.0f), float2(1.0f, 0.0f)},
-        {float3(-r.x, -r.y, -r.z), float3(0.0f, 1.0f, 0.0f), float2(0.0f, 1.5f)},
-        {float3(r.x, -r.y, -r.z), float3(0.0f, 1.0f, 0.0f), float2(1.0f, 1.5f)},
-        // WALL
-        {float3(-r.x,  r.y, r.z), float3(0.0f, 0.0f, -1.0f), float2(0.0f, 0.0f)},
-        {float3(r.x,  r.y, r.z), float3(0.0f, 0.0f, -1.0f), float2(2.0f, 0.0f)},
-        {float3(-r.x, -r.y, r.z), float3(0.0f, 0.0f, -1.0f), float2(0.0f, 1.5f)},
-        {float3(r.x, -r.y, r.z), float3(0.0f, 0.0f, -1.0f), float2(2.0f, 1.5f)},
-        // WALL
-        {float3(r.x,  r.y,  r.z), float3(-1.0f, 0.0f, 0.0f), float2(0.0f, 0.0f)},
-        {float3(r.x,  r.y, -r.z), float3(-1.0f, 0.0f, 0.0f), float2(r.y,  0.0f)},
-        {float3(r.x, -r.y,  r.z), float3(-1.0f, 0.0f, 0.0f), float2(0.0f, 1.5f)},
-        {float3(r.x, -r.y, -r.z), float3(-1.0f, 0.0f, 0.0f), float2(r.y,  1.5f)},
-        // WALL
-        {float3(r.x,  r.y, -r.z), float3(0.0f, 0.0f, 1.0f), float2(0.0f, 0.0f)},
-        {float3(-r.x,  r.y, -r.z), float3(0.0f, 0.0f, 1.0f), float2(2.0f, 0.0f)},
-        {float3(r.x, -r.y, -r.z), float3(0.0f, 0.0f, 1.0f), float2(0.0f, 1.5f)},
-        {float3(-r.x, -r.y, -r.z), float3(0.0f, 0.0f, 1.0f), float2(2.0f, 1.5f)},
-        // WALL
-        {float3(-r.x,  r.y, -r.z), float3(1.0f, 0.0f, 0.0f), float2(0.0f, 0.0f)},
-        {float3(-r.x,  r.y,  r.z), float3(1.0f, 0.0f, 0.0f), float2(r.y,  0.0f)},
-        {float3(-r.x, -r.y, -r.z), float3(1.0f, 0.0f, 0.0f), float2(0.0f, 1.5f)},
-        {float3(-r.x, -r.y,  r.z), float3(1.0f, 0.0f, 0.0f), float2(r.y,  1.5f)},
-        // CEILING
-        {float3(-r.x, r.y, -r.z), float3(0.0f, -1.0f, 0.0f), float2(-0.15f, 0.0f)},
-        {float3(r.x, r.y, -r.z), float3(0.0f, -1.0f, 0.0f), float2(1.25f, 0.0f)},
-        {float3(-r.x, r.y,  r.z), float3(0.0f, -1.0f, 0.0f), float2(-0.15f, 2.1f)},
-        {float3(r.x, r.y,  r.z), float3(0.0f, -1.0f, 0.0f), float2(1.25f, 2.1f)},
-    };
-
-    unsigned short boxIndices[] =
-    {
-        0, 2, 1,
-        1, 2, 3,
-
-        4, 6, 5,
-        5, 6, 7,
-
-        8, 10, 9,
-        9, 10, 11,
-
-        12, 14, 13,
-        13, 14, 15,
-
-        16, 18, 17,
-        17, 18, 19,
-
-        20, 22, 21,
-        21, 22, 23,
-    };
-
-    CreateVertexBuffer(
-        ARRAYSIZE(boxVertices),
-        boxVertices,
-        vertexBuffer
+    CreateShape(
+        GetCubeSize(),
+        [&](BasicVertex* vertices, size_t vertexCapacity, unsigned short* indices, size_t indexCapacity)
+        {
+            return GenerateCube(vertices, vertexCapacity, indices, indexCapacity);
+        },
+        false,
+        vertexBuffer,
+        indexBuffer,
+        vertexCount,
+        indexCount
     );
-    if (vertexCount != nullptr)
-    {
-        *vertexCount = ARRAYSIZE(boxVertices);
-    }
+}
 
-    CreateIndexBuffer(
-        ARRAYSIZE(boxIndices),
-        boxIndices,
-        indexBuffer
+void BasicShapes::CreateBox(
+    float3 radii,
+    _Out_ ID3D11Buffer** vertexBuffer,
+    _Out_ ID3D11Buffer** indexBuffer,
+    _Out_opt_ unsigned int* vertexCount,
+    _Out_opt_ unsigned int* indexCount
+)
+{
+    CreateShape(
+        GetBoxSize(),
+        [&](BasicVertex* vertices, size_t vertexCapacity, unsigned short* indices, size_t indexCapacity)
+        {
+            return GenerateBox(radii, vertices, vertexCapacity, indices, indexCapacity);
+        },
+        false,
+        vertexBuffer,
+        indexBuffer,
+        vertexCount,
+        indexCount
     );
-    if (indexCount != nullptr)
-    {
-        *indexCount = ARRAYSIZE(boxIndices);
-    }
 }
 
 void BasicShapes::CreateSphere(
@@ -280,316 +210,189 @@ void BasicShapes::CreateSphere(
     _Out_opt_ unsigned int* indexCount
 )
 {
-    const int numSegments = 64;
-    const int numSlices = numSegments / 2;
-
-    const int numVertices = (numSlices + 1) * (numSegments + 1);
-    std::unique_ptr<BasicVertex[]> sphereVertices(new BasicVertex[numVertices]);
+    CreateSphere(SphereDesc(), vertexBuffer, indexBuffer, vertexCount, indexCount);
+}
 
-    for (int slice = 0; slice <= numSlices; slice++)
-    {
-        float v = (float)slice / (float)numSlices;
-        float inclination = v * PI_F;
-        float y = cos(inclination);
-        float r = sin(inclination);
-        for (int segment = 0; segment <= numSegments; segment++)
+void BasicShapes::CreateSphere(
+    const SphereDesc& desc,
+    _Out_ ID3D11Buffer** vertexBuffer,
+    _Out_ ID3D11Buffer** indexBuffer,
+    _Out_opt_ unsigned int* vertexCount,
+    _Out_opt_ unsigned int* indexCount
+)
+{
+    CreateShape(
+        GetSphereSize(desc),
+        [&](BasicVertex* vertices, size_t vertexCapacity, unsigned short* indices, size_t indexCapacity)
         {
-            float u = (float)segment / (float)numSegments;
-            float azimuth = u * PI_F * 2.0f;
-            int index = slice * (numSegments + 1) + segment;
-            sphereVertices[index].pos = float3(r * sin(azimuth), y, r * cos(azimuth));
-            sphereVertices[index].norm = sphereVertices[index].pos;
-            sphereVertices[index].tex = float2(u, v);
-        }
-    }
+            return GenerateSphere(desc, vertices, vertexCapacity, indices, indexCapacity);
+        },
+        true,
+        vertexBuffer,
+        indexBuffer,
+        vertexCount,
+        indexCount
+    );
+}
 
-    const int numIndices = numSlices * (numSegments - 2) * 6;
-    std::unique_ptr<unsigned short[]> sphereIndices(new unsigned short[numIndices]);
+void BasicShapes::CreateTangentSphere(
+    _Out_ ID3D11Buffer** vertexBuffer,
+    _Out_ ID3D11Buffer** indexBuffer,
+    _Out_opt_ unsigned int* vertexCount,
+    _Out_opt_ unsigned int* indexCount
+)
+{
+    CreateTangentSphere(SphereDesc(), vertexBuffer, indexBuffer, vertexCount, indexCount);
+}
 
-    unsigned int index = 0;
-    for (int slice = 0; slice < numSlices; slice++)
+void BasicShapes::CreateTangentSphere(
+    const SphereDesc& desc,
+    _Out_ ID3D11Buffer** vertexBuffer,
+    _Out_ ID3D11Buffer** indexBuffer,
+    _Out_opt_ unsigned int* vertexCount,
+    _Out_opt_ unsigned int* indexCount
+)
+{
+    ShapeSize size = GetSphereSize(desc);
+    m_tangentVertices.resize(size.vertexCount);
+    m_indices.resize(size.indexCount);
+    if (size.vertexCount == 0 ||
+        !GenerateTangentSphere(desc, m_tangentVertices.data(), m_tangentVertices.size(), m_indices.data(), m_indices.size()))
     {
-        unsigned short sliceBase0 = (unsigned short)((slice) * (numSegments + 1));
-        unsigned short sliceBase1 = (unsigned short)((slice + 1) * (numSegments + 1));
-        for (int segment = 0; segment < numSegments; segment++)
-        {
-            if (slice > 0)
-            {
-                sphereIndices[index++] = sliceBase0 + segment;
-                sphereIndices[index++] = sliceBase0 + segment + 1;
-                sphereIndices[index++] = sliceBase1 + segment + 1;
-            }
-            if (slice < numSlices - 1)
-            {
-                sphereIndices[index++] = sliceBase0 + segment;
-                sphereIndices[index++] = sliceBase1 + segment + 1;
-                sphereIndices[index++] = sliceBase1 + segment;
-            }
-        }
+        throw winrt::hresult_error(E_INVALIDARG);
     }
 
-    CreateVertexBuffer(
-        numVertices,
-        sphereVertices.get(),
+    // Reordered for the vertex cache, as in CreateShape.
+    unsigned int numOptimizedVertices = static_cast<unsigned int>(
+        OptimizeMesh(m_tangentVertices.data(), m_tangentVertices.size(), sizeof(TangentVertex), m_indices.data(), m_indices.size())
+    );
+
+    CreateTangentVertexBuffer(
+        numOptimizedVertices,
+        m_tangentVertices.data(),
         vertexBuffer
     );
     if (vertexCount != nullptr)
     {
-        *vertexCount = numVertices;
+        *vertexCount = numOptimizedVertices;
     }
 
     CreateIndexBuffer(
-        numIndices,
-        sphereIndices.get(),
+        size.indexCount,
+        m_indices.data(),
         indexBuffer
     );
     if (indexCount != nullptr)
     {
-        *indexCount = numIndices;
+        *indexCount = size.indexCount;
     }
 }
-void BasicShapes::CreateTangentSphere(
+
+void BasicShapes::CreateIcosphere(
+    const IcosphereDesc& desc,
     _Out_ ID3D11Buffer** vertexBuffer,
     _Out_ ID3D11Buffer** indexBuffer,
     _Out_opt_ unsigned int* vertexCount,
     _Out_opt_ unsigned int* indexCount
 )
 {
-    const int numSegments = 64;
-    const int numSlices = numSegments / 2;
-
-    const int numVertices = (numSlices + 1) * (numSegments + 1);
-    std::unique_ptr<TangentVertex[]> sphereVertices(new TangentVertex[numVertices]);
-
-    for (int slice = 0; slice <= numSlices; slice++)
-    {
-        float v = (float)slice / (float)numSlices;
-        float inclination = v * PI_F;
-        float y = cos(inclination);
-        float r = sin(inclination);
-        for (int segment = 0; segment <= numSegments; segment++)
+    CreateShape(
+        GetIcosphereSize(desc),
+        [&](BasicVertex* vertices, size_t vertexCapacity, unsigned short* indices, size_t indexCapacity)
         {
-            float u = (float)segment / (float)numSegments;
-            float azimuth = u * PI_F * 2.0f;
-            int index = slice * (numSegments + 1) + segment;
-            sphereVertices[index].pos = float3(r * sin(azimuth), y, r * cos(azimuth));
-            sphereVertices[index].tex = float2(u, v);
-            sphereVertices[index].uTan = float3(cos(azimuth), 0, -sin(azimuth));
-            sphereVertices[index].vTan = float3(cos(inclination) * sin(azimuth), -sin(inclination), cos(inclination) * cos(azimuth));
-
-        }
-    }
-
-    const int numIndices = numSlices * (numSegments - 2) * 6;
-    std::unique_ptr<unsigned short[]> sphereIndices(new unsigned short[numIndices]);
+            return GenerateIcosphere(desc, vertices, vertexCapacity, indices, indexCapacity);
+        },
+        true,
+        vertexBuffer,
+        indexBuffer,
+        vertexCount,
+        indexCount
+    );
+}
 
-    unsigned int index = 0;
-    for (int slice = 0; slice < numSlices; slice++)
-    {
-        unsigned short sliceBase0 = (unsigned short)((slice) * (numSegments + 1));
-        unsigned short sliceBase1 = (unsigned short)((slice + 1) * (numSegments + 1));
-        for (int segment = 0; segment < numSegments; segment++)
+void BasicShapes::CreateCylinder(
+    const CylinderDesc& desc,
+    _Out_ ID3D11Buffer** vertexBuffer,
+    _Out_ ID3D11Buffer** indexBuffer,
+    _Out_opt_ unsigned int* vertexCount,
+    _Out_opt_ unsigned int* indexCount
+)
+{
+    CreateShape(
+        GetCylinderSize(desc),
+        [&](BasicVertex* vertices, size_t vertexCapacity, unsigned short* indices, size_t indexCapacity)
         {
-            if (slice > 0)
-            {
-                sphereIndices[index++] = sliceBase0 + segment;
-                sphereIndices[index++] = sliceBase0 + segment + 1;
-                sphereIndices[index++] = sliceBase1 + segment + 1;
-            }
-            if (slice < numSlices - 1)
-            {
-                sphereIndices[index++] = sliceBase0 + segment;
-                sphereIndices[index++] = sliceBase1 + segment + 1;
-                sphereIndices[index++] = sliceBase1 + segment;
-            }
-        }
-    }
-
-    CreateTangentVertexBuffer(
-        numVertices,
-        sphereVertices.get(),
-        vertexBuffer
+            return GenerateCylinder(desc, vertices, vertexCapacity, indices, indexCapacity);
+        },
+        true,
+        vertexBuffer,
+        indexBuffer,
+        vertexCount,
+        indexCount
     );
-    if (vertexCount != nullptr)
-    {
-        *vertexCount = numVertices;
-    }
+}
 
-    CreateIndexBuffer(
-        numIndices,
-        sphereIndices.get(),
-        indexBuffer
+void BasicShapes::CreateTorus(
+    const TorusDesc& desc,
+    _Out_ ID3D11Buffer** vertexBuffer,
+    _Out_ ID3D11Buffer** indexBuffer,
+    _Out_opt_ unsigned int* vertexCount,
+    _Out_opt_ unsigned int* indexCount
+)
+{
+    CreateShape(
+        GetTorusSize(desc),
+        [&](BasicVertex* vertices, size_t vertexCapacity, unsigned short* indices, size_t indexCapacity)
+        {
+            return GenerateTorus(desc, vertices, vertexCapacity, indices, indexCapacity);
+        },
+        true,
+        vertexBuffer,
+        indexBuffer,
+        vertexCount,
+        indexCount
     );
-    if (indexCount != nullptr)
-    {
-        *indexCount = numIndices;
-    }
 }
 
-void BasicShapes::CreateReferenceAxis(
+void BasicShapes::CreateGrid(
+    const GridDesc& desc,
     _Out_ ID3D11Buffer** vertexBuffer,
     _Out_ ID3D11Buffer** indexBuffer,
     _Out_opt_ unsigned int* vertexCount,
     _Out_opt_ unsigned int* indexCount
 )
 {
-    BasicVertex axisVertices[] =
-    {
-        { float3(0.500f, 0.000f, 0.000f), float3(0.125f, 0.500f, 0.500f), float2(0.250f, 0.250f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(0.125f, 0.500f, 0.500f), float2(0.250f, 0.250f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(0.125f, 0.500f, 0.500f), float2(0.250f, 0.250f) },
-        { float3(0.500f, 0.000f, 0.000f), float3(0.125f,-0.500f, 0.500f), float2(0.250f, 0.250f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(0.125f,-0.500f, 0.500f), float2(0.250f, 0.250f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(0.125f,-0.500f, 0.500f), float2(0.250f, 0.250f) },
-        { float3(0.500f, 0.000f, 0.000f), float3(0.125f,-0.500f,-0.500f), float2(0.250f, 0.250f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(0.125f,-0.500f,-0.500f), float2(0.250f, 0.250f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(0.125f,-0.500f,-0.500f), float2(0.250f, 0.250f) },
-        { float3(0.500f, 0.000f, 0.000f), float3(0.125f, 0.500f,-0.500f), float2(0.250f, 0.250f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(0.125f, 0.500f,-0.500f), float2(0.250f, 0.250f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(0.125f, 0.500f,-0.500f), float2(0.250f, 0.250f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(-0.125f, 0.000f, 0.000f), float2(0.250f, 0.250f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(-0.125f, 0.000f, 0.000f), float2(0.250f, 0.250f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(-0.125f, 0.000f, 0.000f), float2(0.250f, 0.250f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(-0.125f, 0.000f, 0.000f), float2(0.250f, 0.250f) },
-        { float3(-0.500f, 0.000f, 0.000f), float3(-0.125f, 0.500f, 0.500f), float2(0.250f, 0.500f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(-0.125f, 0.500f, 0.500f), float2(0.250f, 0.500f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(-0.125f, 0.500f, 0.500f), float2(0.250f, 0.500f) },
-        { float3(-0.500f, 0.000f, 0.000f), float3(-0.125f, 0.500f,-0.500f), float2(0.250f, 0.500f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(-0.125f, 0.500f,-0.500f), float2(0.250f, 0.500f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(-0.125f, 0.500f,-0.500f), float2(0.250f, 0.500f) },
-        { float3(-0.500f, 0.000f, 0.000f), float3(-0.125f,-0.500f,-0.500f), float2(0.250f, 0.500f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(-0.125f,-0.500f,-0.500f), float2(0.250f, 0.500f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(-0.125f,-0.500f,-0.500f), float2(0.250f, 0.500f) },
-        { float3(-0.500f, 0.000f, 0.000f), float3(-0.125f,-0.500f, 0.500f), float2(0.250f, 0.500f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(-0.125f,-0.500f, 0.500f), float2(0.250f, 0.500f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(-0.125f,-0.500f, 0.500f), float2(0.250f, 0.500f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(0.125f, 0.000f, 0.000f), float2(0.250f, 0.500f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(0.125f, 0.000f, 0.000f), float2(0.250f, 0.500f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(0.125f, 0.000f, 0.000f), float2(0.250f, 0.500f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(0.125f, 0.000f, 0.000f), float2(0.250f, 0.500f) },
-        { float3(0.000f, 0.500f, 0.000f), float3(0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
-        { float3(0.000f, 0.500f, 0.000f), float3(0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
-        { float3(0.000f, 0.500f, 0.000f), float3(-0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(-0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
-        { float3(0.000f, 0.500f, 0.000f), float3(-0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(-0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.000f,-0.125f, 0.000f), float2(0.500f, 0.250f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(0.000f,-0.125f, 0.000f), float2(0.500f, 0.250f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(0.000f,-0.125f, 0.000f), float2(0.500f, 0.250f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(0.000f,-0.125f, 0.000f), float2(0.500f, 0.250f) },
-        { float3(0.000f,-0.500f, 0.000f), float3(0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
-        { float3(0.000f,-0.500f, 0.000f), float3(-0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(-0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
-        { float3(0.000f,-0.500f, 0.000f), float3(-0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(-0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
-        { float3(0.000f,-0.500f, 0.000f), float3(0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
-        { float3(0.000f, 0.000f,-0.125f), float3(0.000f, 0.125f, 0.000f), float2(0.500f, 0.500f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(0.000f, 0.125f, 0.000f), float2(0.500f, 0.500f) },
-        { float3(0.000f, 0.000f, 0.125f), float3(0.000f, 0.125f, 0.000f), float2(0.500f, 0.500f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.000f, 0.125f, 0.000f), float2(0.500f, 0.500f) },
-        { float3(0.000f, 0.000f, 0.500f), float3(0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(0.000f, 0.000f, 0.500f), float3(-0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(-0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(0.000f, 0.000f, 0.500f), float3(-0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(-0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(0.000f, 0.000f, 0.500f), float3(0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.000f, 0.000f,-0.125f), float2(0.750f, 0.250f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(0.000f, 0.000f,-0.125f), float2(0.750f, 0.250f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(0.000f, 0.000f,-0.125f), float2(0.750f, 0.250f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(0.000f, 0.000f,-0.125f), float2(0.750f, 0.250f) },
-        { float3(0.000f, 0.000f,-0.500f), float3(0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(0.000f, 0.000f,-0.500f), float3(0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(0.000f, 0.000f,-0.500f), float3(-0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(-0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(0.000f, 0.000f,-0.500f), float3(-0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(-0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
-        { float3(0.000f, 0.125f, 0.000f), float3(0.000f, 0.000f, 0.125f), float2(0.750f, 0.500f) },
-        { float3(-0.125f, 0.000f, 0.000f), float3(0.000f, 0.000f, 0.125f), float2(0.750f, 0.500f) },
-        { float3(0.000f,-0.125f, 0.000f), float3(0.000f, 0.000f, 0.125f), float2(0.750f, 0.500f) },
-        { float3(0.125f, 0.000f, 0.000f), float3(0.000f, 0.000f, 0.125f), float2(0.750f, 0.500f) },
-    };
-
-    unsigned short axisIndices[] =
-    {
-         0,  2,  1,
-         3,  5,  4,
-         6,  8,  7,
-         9, 11, 10,
-        12, 14, 13,
-        12, 15, 14,
-        16, 18, 17,
-        19, 21, 20,
-        22, 24, 23,
-        25, 27, 26,
-        28, 30, 29,
-        28, 31, 30,
-        32, 34, 33,
-        35, 37, 36,
-        38, 40, 39,
-        41, 43, 42,
-        44, 46, 45,
-        44, 47, 46,
-        48, 50, 49,
-        51, 53, 52,
-        54, 56, 55,
-        57, 59, 58,
-        60, 62, 61,
-        60, 63, 62,
-        64, 66, 65,
-        67, 69, 68,
-        70, 72, 71,
-        73, 75, 74,
-        76, 78, 77,
-        76, 79, 78,
-        80, 82, 81,
-        83, 85, 84,
-        86, 88, 87,
-        89, 91, 90,
-        92, 94, 93,
-        92, 95, 94,
-    };
-
-    CreateVertexBuffer(
-        ARRAYSIZE(axisVertices),
-        axisVertices,
-        vertexBuffer
+    CreateShape(
+        GetGridSize(desc),
+        [&](BasicVertex* vertices, size_t vertexCapacity, unsigned short* indices, size_t indexCapacity)
+        {
+            return GenerateGrid(desc, vertices, vertexCapacity, indices, indexCapacity);
+        },
+        true,
+        vertexBuffer,
+        indexBuffer,
+        vertexCount,
+        indexCount
     );
-    if (vertexCount != nullptr)
-    {
-        *vertexCount = ARRAYSIZE(axisVertices);
-    }
+}
 
-    CreateIndexBuffer(
-        ARRAYSIZE(axisIndices),
-        axisIndices,
-        indexBuffer
+void BasicShapes::CreateReferenceAxis(
+    _Out_ ID3D11Buffer** vertexBuffer,
+    _Out_ ID3D11Buffer** indexBuffer,
+    _Out_opt_ unsigned int* vertexCount,
+    _Out_opt_ unsigned int* indexCount
+)
+{
+    CreateShape(
+        GetReferenceAxisSize(),
+        [&](BasicVertex* vertices, size_t vertexCapacity, unsigned short* indices, size_t indexCapacity)
+        {
+            return GenerateReferenceAxis(vertices, vertexCapacity, indices, indexCapacity);
+        },
+        false,
+        vertexBuffer,
+        indexBuffer,
+        vertexCount,
+        indexCount
     );
-    if (indexCount != nullptr)
-    {
-        *indexCount = ARRAYSIZE(axisIndices);
-    }
 }
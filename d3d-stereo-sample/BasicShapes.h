@@ -1,25 +1,15 @@
 #pragma once
-#include "BasicMath.h"
-
-// Defines the vertex format for the shapes generated in the functions below.
-struct BasicVertex
-{
-    float3 pos;  // position
-    float3 norm; // surface normal vector
-    float2 tex;  // texture coordinate
-};
-
-// Defines the vertex format for all shapes generated in the functions below.
-struct TangentVertex
-{
-    float3 pos;  // position
-    float2 tex;  // texture coordinate
-    float3 uTan; // texture coordinate u-tangent vector
-    float3 vTan; // texture coordinate v-tangent vector
-};
+#include <vector>
+#include "BasicVertex.h"
+#include "ShapeGenerator.h"
 
 // A helper class that provides convenient functions for creating common
-// geometrical shapes used by DirectX SDK samples.
+// geometrical shapes used by DirectX SDK samples. The geometry itself comes
+// from ShapeGenerator; these functions upload it with 16-bit indices and
+// throw E_INVALIDARG for descs that are invalid or need more than 65536
+// vertices. The parametric shapes are reordered with OptimizeMesh, which can
+// drop unused vertices, so vertexCount may be below the size from
+// ShapeGenerator.
 class BasicShapes
 {
 public:
@@ -37,13 +27,56 @@ public:
         _Out_opt_ unsigned int* vertexCount,
         _Out_opt_ unsigned int* indexCount
     );
+    // The spheres without a desc use the default SphereDesc.
     void CreateSphere(
         _Out_ ID3D11Buffer** vertexBuffer,
         _Out_ ID3D11Buffer** indexBuffer,
         _Out_opt_ unsigned int* vertexCount,
         _Out_opt_ unsigned int* indexCount
     );
+    void CreateSphere(
+        const SphereDesc& desc,
+        _Out_ ID3D11Buffer** vertexBuffer,
+        _Out_ ID3D11Buffer** indexBuffer,
+        _Out_opt_ unsigned int* vertexCount,
+        _Out_opt_ unsigned int* indexCount
+    );
+    void CreateTangentSphere(
+        _Out_ ID3D11Buffer** vertexBuffer,
+        _Out_ ID3D11Buffer** indexBuffer,
+        _Out_opt_ unsigned int* vertexCount,
+        _Out_opt_ unsigned int* indexCount
+    );
     void CreateTangentSphere(
+        const SphereDesc& desc,
+        _Out_ ID3D11Buffer** vertexBuffer,
+        _Out_ ID3D11Buffer** indexBuffer,
+        _Out_opt_ unsigned int* vertexCount,
+        _Out_opt_ unsigned int* indexCount
+    );
+    void CreateIcosphere(
+        const IcosphereDesc& desc,
+        _Out_ ID3D11Buffer** vertexBuffer,
+        _Out_ ID3D11Buffer** indexBuffer,
+        _Out_opt_ unsigned int* vertexCount,
+        _Out_opt_ unsigned int* indexCount
+    );
+    void CreateCylinder(
+        const CylinderDesc& desc,
+        _Out_ ID3D11Buffer** vertexBuffer,
+        _Out_ ID3D11Buffer** indexBuffer,
+        _Out_opt_ unsigned int* vertexCount,
+        _Out_opt_ unsigned int* indexCount
+    );
+    void CreateTorus(
+        const TorusDesc& desc,
+        _Out_ ID3D11Buffer** vertexBuffer,
+        _Out_ ID3D11Buffer** indexBuffer,
+        _Out_opt_ unsigned int* vertexCount,
+        _Out_opt_ unsigned int* indexCount
+    );
+    void CreateGrid(
+        const GridDesc& desc,
         _Out_ ID3D11Buffer** vertexBuffer,
         _Out_ ID3D11Buffer** indexBuffer,
         _Out_opt_ unsigned int* vertexCount,
@@ -59,6 +92,23 @@ public:
 private:
     winrt::com_ptr<ID3D11Device> m_d3dDevice;
 
+    // Scratch arrays that shapes are generated into, kept between calls so
+    // that creating several shapes reuses one allocation.
+    std::vector<BasicVertex> m_vertices;
+    std::vector<TangentVertex> m_tangentVertices;
+    std::vector<unsigned short> m_indices;
+
+    template <class Generator>
+    void CreateShape(
+        ShapeSize size,
+        Generator generate,
+        bool optimize,
+        _Out_ ID3D11Buffer** vertexBuffer,
+        _Out_ ID3D11Buffer** indexBuffer,
+        _Out_opt_ unsigned int* vertexCount,
+        _Out_opt_ unsigned int* indexCount
+    );
+
     void CreateVertexBuffer(
         _In_ unsigned int numVertices,
         _In_ BasicVertex* vertexData,
@@ -0,0 +1,20 @@
+#pragma once
+#include "BasicMath.h"
+
+// Defines the vertex format for the shapes generated by BasicShapes and the
+// meshes loaded by BasicLoader.
+struct BasicVertex
+{
+    float3 pos;  // position
+    float3 norm; // surface normal vector
+    float2 tex;  // texture coordinate
+};
+
+// Defines the vertex format for the tangent-space shapes generated by BasicShapes.
+struct TangentVertex
+{
+    float3 pos;  // position
+    float2 tex;  // texture coordinate
+    float3 uTan; // texture coordinate u-tangent vector
+    float3 vTan; // texture coordinate v-tangent vector
+};
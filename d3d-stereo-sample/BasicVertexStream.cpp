@@ -0,0 +1,297 @@
+#include "BasicVertexStream.h"
+#include <float.h>
+
+BasicVertexStream::BasicVertexStream()
+{
+}
+
+BasicVertexStream::BasicVertexStream(
+    _In_reads_(count) const BasicVertex* vertices,
+    size_t count
+)
+{
+    Assign(vertices, count);
+}
+
+void BasicVertexStream::Assign(
+    _In_reads_(count) const BasicVertex* vertices,
+    size_t count
+)
+{
+    Resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Set(i, vertices[i]);
+    }
+}
+
+void BasicVertexStream::CopyTo(
+    _Out_writes_(Size()) BasicVertex* vertices
+) const
+{
+    for (size_t i = 0; i < m_posX.size(); i++)
+    {
+        vertices[i] = Get(i);
+    }
+}
+
+void BasicVertexStream::Resize(size_t count)
+{
+    m_posX.resize(count);
+    m_posY.resize(count);
+    m_posZ.resize(count);
+    m_normX.resize(count);
+    m_normY.resize(count);
+    m_normZ.resize(count);
+    m_texU.resize(count);
+    m_texV.resize(count);
+}
+
+size_t BasicVertexStream::Size() const
+{
+    return m_posX.size();
+}
+
+BasicVertex BasicVertexStream::Get(size_t index) const
+{
+    BasicVertex vertex;
+    vertex.pos = float3(m_posX[index], m_posY[index], m_posZ[index]);
+    vertex.norm = float3(m_normX[index], m_normY[index], m_normZ[index]);
+    vertex.tex = float2(m_texU[index], m_texV[index]);
+    return vertex;
+}
+
+void BasicVertexStream::Set(size_t index, const BasicVertex& vertex)
+{
+    m_posX[index] = vertex.pos.x;
+    m_posY[index] = vertex.pos.y;
+    m_posZ[index] = vertex.pos.z;
+    m_normX[index] = vertex.norm.x;
+    m_normY[index] = vertex.norm.y;
+    m_normZ[index] = vertex.norm.z;
+    m_texU[index] = vertex.tex.x;
+    m_texV[index] = vertex.tex.y;
+}
+
+PositionStream BasicVertexStream::Positions() const
+{
+    PositionStream positions;
+    positions.x = m_posX.data();
+    positions.y = m_posY.data();
+    positions.z = m_posZ.data();
+    positions.count = m_posX.size();
+    return positions;
+}
+
+void PositionArrays::Resize(size_t count)
+{
+    m_x.resize(count);
+    m_y.resize(count);
+    m_z.resize(count);
+}
+
+size_t PositionArrays::Size() const
+{
+    return m_x.size();
+}
+
+void PositionArrays::Assign(
+    _In_reads_(count) const BasicVertex* vertices,
+    size_t count
+)
+{
+    Resize(count);
+    ExtractPositions(vertices, count, m_x.data(), m_y.data(), m_z.data());
+}
+
+PositionStream PositionArrays::Positions() const
+{
+    PositionStream positions;
+    positions.x = m_x.data();
+    positions.y = m_y.data();
+    positions.z = m_z.data();
+    positions.count = m_x.size();
+    return positions;
+}
+
+void ExtractPositions(
+    _In_reads_(count) const BasicVertex* vertices,
+    size_t count,
+    _Out_writes_(count) float* x,
+    _Out_writes_(count) float* y,
+    _Out_writes_(count) float* z
+)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        x[i] = vertices[i].pos.x;
+        y[i] = vertices[i].pos.y;
+        z[i] = vertices[i].pos.z;
+    }
+}
+
+// Each component is reduced separately so that the compiler can vectorize
+// the loops over the contiguous arrays.
+static void ComputeRange(
+    _In_reads_(count) const float* values,
+    size_t count,
+    _Out_ float* minimum,
+    _Out_ float* maximum
+)
+{
+    float lo = FLT_MAX;
+    float hi = -FLT_MAX;
+    for (size_t i = 0; i < count; i++)
+    {
+        lo = values[i] < lo ? values[i] : lo;
+        hi = values[i] > hi ? values[i] : hi;
+    }
+    *minimum = lo;
+    *maximum = hi;
+}
+
+void ComputeBounds(
+    const PositionStream& positions,
+    _Out_ float3* minimum,
+    _Out_ float3* maximum
+)
+{
+    if (positions.count == 0)
+    {
+        *minimum = float3();
+        *maximum = float3();
+        return;
+    }
+
+    ComputeRange(positions.x, positions.count, &minimum->x, &maximum->x);
+    ComputeRange(positions.y, positions.count, &minimum->y, &maximum->y);
+    ComputeRange(positions.z, positions.count, &minimum->z, &maximum->z);
+}
+
+AABB ComputeBoundingBox(const PositionStream& positions)
+{
+    float3 minimum;
+    float3 maximum;
+    ComputeBounds(positions, &minimum, &maximum);
+
+    AABB box;
+    box.center = (minimum + maximum) * 0.5f;
+    box.extents = (maximum - minimum) * 0.5f;
+    return box;
+}
+
+float ComputeBoundingRadius(
+    const PositionStream& positions,
+    float3 center
+)
+{
+    float maxDistanceSquared = 0.0f;
+    for (size_t i = 0; i < positions.count; i++)
+    {
+        float dx = positions.x[i] - center.x;
+        float dy = positions.y[i] - center.y;
+        float dz = positions.z[i] - center.z;
+        float distanceSquared = dx * dx + dy * dy + dz * dz;
+        maxDistanceSquared = distanceSquared > maxDistanceSquared ? distanceSquared : maxDistanceSquared;
+    }
+    return sqrtf(maxDistanceSquared);
+}
+
+void ComputeBoundingSphere(
+    const PositionStream& positions,
+    _Out_ float3* center,
+    _Out_ float* radius
+)
+{
+    *center = ComputeBoundingBox(positions).center;
+    *radius = ComputeBoundingRadius(positions, *center);
+}
+
+// Moller-Trumbore ray/triangle intersection against every triangle.
+template <class IndexType>
+static bool IntersectRayImpl(
+    const PositionStream& positions,
+    _In_reads_(indexCount) const IndexType* indices,
+    size_t indexCount,
+    float3 origin,
+    float3 direction,
+    _Out_ float* distance,
+    _Out_opt_ size_t* triangle
+)
+{
+    const float epsilon = 1e-7f;
+
+    bool hit = false;
+    float nearest = FLT_MAX;
+    size_t nearestTriangle = 0;
+
+    for (size_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        float3 v0 = positions[indices[i]];
+        float3 e1 = positions[indices[i + 1]] - v0;
+        float3 e2 = positions[indices[i + 2]] - v0;
+
+        float3 p = cross(direction, e2);
+        float det = dot(e1, p);
+        if (det > -epsilon && det < epsilon)
+        {
+            continue;
+        }
+
+        float invDet = 1.0f / det;
+        float3 s = origin - v0;
+        float u = dot(s, p) * invDet;
+        if (u < 0.0f || u > 1.0f)
+        {
+            continue;
+        }
+
+        float3 q = cross(s, e1);
+        float v = dot(direction, q) * invDet;
+        if (v < 0.0f || u + v > 1.0f)
+        {
+            continue;
+        }
+
+        float t = dot(e2, q) * invDet;
+        if (t > epsilon && t < nearest)
+        {
+            hit = true;
+            nearest = t;
+            nearestTriangle = i / 3;
+        }
+    }
+
+    *distance = hit ? nearest : 0.0f;
+    if (triangle != nullptr)
+    {
+        *triangle = nearestTriangle;
+    }
+    return hit;
+}
+
+bool IntersectRay(
+    const PositionStream& positions,
+    _In_reads_(indexCount) const uint16_t* indices,
+    size_t indexCount,
+    float3 origin,
+    float3 direction,
+    _Out_ float* distance,
+    _Out_opt_ size_t* triangle
+)
+{
+    return IntersectRayImpl(positions, indices, indexCount, origin, direction, distance, triangle);
+}
+
+bool IntersectRay(
+    const PositionStream& positions,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    float3 origin,
+    float3 direction,
+    _Out_ float* distance,
+    _Out_opt_ size_t* triangle
+)
+{
+    return IntersectRayImpl(positions, indices, indexCount, origin, direction, distance, triangle);
+}
@@ -0,0 +1,183 @@
+#pragma once
+#include <vector>
+#include <stdint.h>
+#include "BasicSal.h"
+#include "BasicVertex.h"
+#include "FrustumCulling.h"
+
+// A read-only view of vertex positions stored as one array per component.
+// CPU passes that only need positions (bounds, culling, picking) walk these
+// 12 bytes per vertex instead of the full 32-byte BasicVertex record.
+struct PositionStream
+{
+    const float* x;
+    const float* y;
+    const float* z;
+    size_t count;
+
+    float3 operator[](size_t index) const
+    {
+        return float3(x[index], y[index], z[index]);
+    }
+
+    // The positions of vertices first to first + rangeCount - 1, such as
+    // those of one submesh.
+    PositionStream Range(size_t first, size_t rangeCount) const
+    {
+        return PositionStream{ x + first, y + first, z + first, rangeCount };
+    }
+};
+
+// Owns the arrays behind a PositionStream, for position-only passes over
+// vertices stored in another layout: positions are gathered once and then
+// walked as often as needed.
+class PositionArrays
+{
+public:
+    void Resize(size_t count);
+    size_t Size() const;
+
+    // Gathers the positions of an array of BasicVertex records.
+    void Assign(
+        _In_reads_(count) const BasicVertex* vertices,
+        size_t count
+    );
+
+    void Set(size_t index, float3 position)
+    {
+        m_x[index] = position.x;
+        m_y[index] = position.y;
+        m_z[index] = position.z;
+    }
+
+    PositionStream Positions() const;
+
+private:
+    std::vector<float> m_x;
+    std::vector<float> m_y;
+    std::vector<float> m_z;
+};
+
+// A structure-of-arrays counterpart to an array of BasicVertex records. Each
+// vertex attribute component lives in its own contiguous array.
+class BasicVertexStream
+{
+public:
+    BasicVertexStream();
+    BasicVertexStream(
+        _In_reads_(count) const BasicVertex* vertices,
+        size_t count
+    );
+
+    // Converts an array of BasicVertex records into this stream.
+    void Assign(
+        _In_reads_(count) const BasicVertex* vertices,
+        size_t count
+    );
+
+    // Converts this stream back into an array of Size() BasicVertex records.
+    void CopyTo(
+        _Out_writes_(Size()) BasicVertex* vertices
+    ) const;
+
+    void Resize(size_t count);
+    size_t Size() const;
+
+    BasicVertex Get(size_t index) const;
+    void Set(size_t index, const BasicVertex& vertex);
+
+    PositionStream Positions() const;
+
+    float* PositionX() { return m_posX.data(); }
+    float* PositionY() { return m_posY.data(); }
+    float* PositionZ() { return m_posZ.data(); }
+    float* NormalX() { return m_normX.data(); }
+    float* NormalY() { return m_normY.data(); }
+    float* NormalZ() { return m_normZ.data(); }
+    float* TexU() { return m_texU.data(); }
+    float* TexV() { return m_texV.data(); }
+
+    // Invokes func(index, position) for every vertex.
+    template <class Func>
+    void ForEachPosition(Func func) const
+    {
+        for (size_t i = 0; i < m_posX.size(); i++)
+        {
+            func(i, float3(m_posX[i], m_posY[i], m_posZ[i]));
+        }
+    }
+
+    // Invokes func(index, vertex) for every vertex.
+    template <class Func>
+    void ForEachVertex(Func func) const
+    {
+        for (size_t i = 0; i < m_posX.size(); i++)
+        {
+            func(i, Get(i));
+        }
+    }
+
+private:
+    std::vector<float> m_posX;
+    std::vector<float> m_posY;
+    std::vector<float> m_posZ;
+    std::vector<float> m_normX;
+    std::vector<float> m_normY;
+    std::vector<float> m_normZ;
+    std::vector<float> m_texU;
+    std::vector<float> m_texV;
+};
+
+// Copies only the positions out of an array of BasicVertex records.
+void ExtractPositions(
+    _In_reads_(count) const BasicVertex* vertices,
+    size_t count,
+    _Out_writes_(count) float* x,
+    _Out_writes_(count) float* y,
+    _Out_writes_(count) float* z
+);
+
+// Computes the axis-aligned bounds of a position stream.
+void ComputeBounds(
+    const PositionStream& positions,
+    _Out_ float3* minimum,
+    _Out_ float3* maximum
+);
+
+// The axis-aligned bounds of a position stream as a box, of zero size at the
+// origin for an empty stream.
+AABB ComputeBoundingBox(const PositionStream& positions);
+
+// The distance from center to the farthest position.
+float ComputeBoundingRadius(
+    const PositionStream& positions,
+    float3 center
+);
+
+// Computes a bounding sphere centered on the axis-aligned bounds.
+void ComputeBoundingSphere(
+    const PositionStream& positions,
+    _Out_ float3* center,
+    _Out_ float* radius
+);
+
+// Finds the nearest triangle hit by a ray. Returns false when nothing is hit.
+bool IntersectRay(
+    const PositionStream& positions,
+    _In_reads_(indexCount) const uint16_t* indices,
+    size_t indexCount,
+    float3 origin,
+    float3 direction,
+    _Out_ float* distance,
+    _Out_opt_ size_t* triangle
+);
+
+bool IntersectRay(
+    const PositionStream& positions,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    float3 origin,
+    float3 direction,
+    _Out_ float* distance,
+    _Out_opt_ size_t* triangle
+);
@@ -0,0 +1,298 @@
+#include "CompressedStream.h"
+#include "LZ4Block.h"
+#include <string.h>
+#include <atomic>
+#include <thread>
+
+namespace
+{
+    uint32_t ReadChunkEntry(const uint8_t* table, size_t chunk)
+    {
+        uint32_t value;
+        memcpy(&value, table + chunk * sizeof(uint32_t), sizeof(value));
+        return value;
+    }
+
+    // Runs work(index) for every index below count, with threads taking the
+    // next index as they finish, so chunks that unpack slowly do not hold up
+    // a whole band. The calling thread takes part.
+    template <typename Work>
+    void ForEachChunk(size_t count, unsigned int threadCount, Work work)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+        if (threadCount > count)
+        {
+            threadCount = static_cast<unsigned int>(count);
+        }
+
+        std::atomic<size_t> next(0);
+        auto worker = [&next, count, &work]()
+        {
+            for (size_t index = next++; index < count; index = next++)
+            {
+                work(index);
+            }
+        };
+
+        std::vector<std::thread> threads;
+        for (unsigned int t = 1; t < threadCount; t++)
+        {
+            threads.emplace_back(worker);
+        }
+        worker();
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    bool ReadHeader(const uint8_t* data, size_t size, CompressedStreamHeader* header)
+    {
+        if (!data || size < sizeof(CompressedStreamHeader))
+        {
+            return false;
+        }
+
+        memcpy(header, data, sizeof(*header));
+        if (header->magic != CompressedStreamMagic || header->version != CompressedStreamVersion ||
+            header->codec != static_cast<uint16_t>(CompressedStreamCodec::LZ4) ||
+            header->chunkSize == 0 || header->chunkSize >= CompressedStreamStoredChunk)
+        {
+            return false;
+        }
+
+        if (header->size > SIZE_MAX)
+        {
+            return false;
+        }
+
+        // Rounding up as size + chunkSize - 1 would wrap for a crafted size
+        // near 2^64 and let an empty chunk table through.
+        uint64_t expectedChunks = header->size / header->chunkSize + (header->size % header->chunkSize != 0 ? 1 : 0);
+        return header->chunkCount == expectedChunks &&
+            header->chunkCount <= (size - sizeof(CompressedStreamHeader)) / sizeof(uint32_t);
+    }
+}
+
+bool IsCompressedStream(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size
+)
+{
+    CompressedStreamHeader header;
+    return ReadHeader(data, size, &header);
+}
+
+void CompressStream(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    uint32_t chunkSize,
+    unsigned int threadCount,
+    _Out_ std::vector<uint8_t>* stream
+)
+{
+    if (chunkSize == 0 || chunkSize >= CompressedStreamStoredChunk)
+    {
+        chunkSize = CompressedStreamDefaultChunkSize;
+    }
+
+    size_t chunkCount = (size + chunkSize - 1) / chunkSize;
+    std::vector<std::vector<uint8_t>> chunks(chunkCount);
+    std::vector<uint32_t> chunkEntries(chunkCount);
+
+    ForEachChunk(chunkCount, threadCount, [&](size_t chunk)
+    {
+        const uint8_t* source = data + chunk * chunkSize;
+        size_t sourceSize = (chunk + 1 < chunkCount) ? chunkSize : size - chunk * chunkSize;
+
+        std::vector<uint8_t>& compressed = chunks[chunk];
+        compressed.resize(LZ4CompressBound(sourceSize));
+        size_t compressedSize = LZ4CompressBlock(source, sourceSize, compressed.data(), compressed.size());
+        if (compressedSize != 0 && compressedSize < sourceSize)
+        {
+            compressed.resize(compressedSize);
+            chunkEntries[chunk] = static_cast<uint32_t>(compressedSize);
+        }
+        else
+        {
+            compressed.assign(source, source + sourceSize);
+            chunkEntries[chunk] = static_cast<uint32_t>(sourceSize) | CompressedStreamStoredChunk;
+        }
+    });
+
+    CompressedStreamHeader header = {};
+    header.magic = CompressedStreamMagic;
+    header.version = CompressedStreamVersion;
+    header.codec = static_cast<uint16_t>(CompressedStreamCodec::LZ4);
+    header.chunkSize = chunkSize;
+    header.chunkCount = static_cast<uint32_t>(chunkCount);
+    header.size = size;
+
+    size_t totalSize = sizeof(header) + chunkCount * sizeof(uint32_t);
+    for (const auto& chunk : chunks)
+    {
+        totalSize += chunk.size();
+    }
+
+    stream->resize(totalSize);
+    uint8_t* out = stream->data();
+    memcpy(out, &header, sizeof(header));
+    out += sizeof(header);
+    if (chunkCount)
+    {
+        memcpy(out, chunkEntries.data(), chunkCount * sizeof(uint32_t));
+        out += chunkCount * sizeof(uint32_t);
+    }
+    for (const auto& chunk : chunks)
+    {
+        memcpy(out, chunk.data(), chunk.size());
+        out += chunk.size();
+    }
+}
+
+CompressedStreamReader::CompressedStreamReader() :
+    m_data(nullptr),
+    m_size(0),
+    m_chunkSize(0),
+    m_chunkTable(nullptr)
+{
+}
+
+bool CompressedStreamReader::Open(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size
+)
+{
+    m_data = nullptr;
+    m_size = 0;
+    m_chunkOffsets.clear();
+
+    CompressedStreamHeader header;
+    if (!ReadHeader(data, size, &header))
+    {
+        return false;
+    }
+
+    m_chunkSize = header.chunkSize;
+    m_size = header.size;
+    m_chunkTable = data + sizeof(header);
+
+    // Chunk offsets are the running total of the stored sizes; checking each
+    // chunk here lets the decompression trust them.
+    std::vector<uint64_t> offsets(header.chunkCount + 1);
+    uint64_t offset = sizeof(header) + static_cast<uint64_t>(header.chunkCount) * sizeof(uint32_t);
+    for (size_t chunk = 0; chunk < header.chunkCount; chunk++)
+    {
+        uint32_t entry = ReadChunkEntry(m_chunkTable, chunk);
+        uint32_t storedSize = entry & ~CompressedStreamStoredChunk;
+        size_t unpackedSize = GetChunkSize(chunk);
+
+        bool valid = (entry & CompressedStreamStoredChunk)
+            ? storedSize == unpackedSize
+            : storedSize != 0 && unpackedSize / 255 <= storedSize;
+        if (!valid || storedSize > size - offset)
+        {
+            m_size = 0;
+            return false;
+        }
+
+        offsets[chunk] = offset;
+        offset += storedSize;
+    }
+    offsets[header.chunkCount] = offset;
+
+    m_data = data;
+    m_chunkOffsets.swap(offsets);
+    return true;
+}
+
+size_t CompressedStreamReader::GetChunkSize(size_t chunk) const
+{
+    uint64_t start = static_cast<uint64_t>(chunk) * m_chunkSize;
+    return static_cast<size_t>((m_size - start < m_chunkSize) ? m_size - start : m_chunkSize);
+}
+
+bool CompressedStreamReader::DecompressChunk(size_t chunk, _Out_ uint8_t* destination) const
+{
+    uint32_t entry = ReadChunkEntry(m_chunkTable, chunk);
+    const uint8_t* source = m_data + m_chunkOffsets[chunk];
+    size_t storedSize = entry & ~CompressedStreamStoredChunk;
+
+    if (entry & CompressedStreamStoredChunk)
+    {
+        memcpy(destination, source, storedSize);
+        return true;
+    }
+    return LZ4DecompressBlock(source, storedSize, destination, GetChunkSize(chunk));
+}
+
+bool CompressedStreamReader::Decompress(
+    _Out_writes_bytes_(destinationSize) uint8_t* destination,
+    size_t destinationSize,
+    unsigned int threadCount
+) const
+{
+    if (!m_data || (!destination && m_size) || destinationSize < m_size)
+    {
+        return false;
+    }
+
+    std::atomic<bool> failed(false);
+    ForEachChunk(GetChunkCount(), threadCount, [&](size_t chunk)
+    {
+        if (!failed && !DecompressChunk(chunk, destination + chunk * static_cast<size_t>(m_chunkSize)))
+        {
+            failed = true;
+        }
+    });
+    return !failed;
+}
+
+bool CompressedStreamReader::DecompressRange(
+    uint64_t offset,
+    size_t size,
+    _Out_writes_bytes_(size) uint8_t* destination
+) const
+{
+    if (!m_data || offset > m_size || size > m_size - offset || (!destination && size))
+    {
+        return false;
+    }
+
+    // Chunks wholly inside the range unpack in place; the partial chunks at
+    // either end go through a scratch buffer.
+    std::vector<uint8_t> scratch;
+    uint64_t end = offset + size;
+    for (size_t chunk = static_cast<size_t>(offset / m_chunkSize); offset < end; chunk++)
+    {
+        uint64_t chunkStart = static_cast<uint64_t>(chunk) * m_chunkSize;
+        size_t chunkSize = GetChunkSize(chunk);
+        size_t skip = static_cast<size_t>(offset - chunkStart);
+        size_t count = static_cast<size_t>((end - offset < chunkSize - skip) ? end - offset : chunkSize - skip);
+
+        if (skip == 0 && count == chunkSize)
+        {
+            if (!DecompressChunk(chunk, destination))
+            {
+                return false;
+            }
+        }
+        else
+        {
+            scratch.resize(chunkSize);
+            if (!DecompressChunk(chunk, scratch.data()))
+            {
+                return false;
+            }
+            memcpy(destination, scratch.data() + skip, count);
+        }
+
+        destination += count;
+        offset += count;
+    }
+    return true;
+}
@@ -0,0 +1,105 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "BasicSal.h"
+
+// A compressed stream splits its data into fixed-size chunks and compresses
+// each one on its own as an LZ4 block (see LZ4Block.h), so that chunks can be
+// unpacked in any order: all at once on several threads straight into the
+// destination, or only those that cover a range being read. Layout, all
+// integers little-endian:
+//
+//   CompressedStreamHeader
+//   uint32_t chunkSizes[chunkCount]     stored bytes of each chunk; the top
+//                                       bit marks a chunk stored as-is
+//   chunk data, in order
+//
+// Every chunk but the last unpacks to exactly chunkSize bytes.
+
+const uint32_t CompressedStreamMagic = 0x5A434341; // "ACCZ"
+const uint16_t CompressedStreamVersion = 1;
+const uint32_t CompressedStreamDefaultChunkSize = 256 * 1024;
+const uint32_t CompressedStreamStoredChunk = 0x80000000;
+
+enum class CompressedStreamCodec : uint16_t
+{
+    LZ4 = 1,
+};
+
+#pragma pack(push, 1)
+struct CompressedStreamHeader
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t codec;             // a CompressedStreamCodec
+    uint32_t chunkSize;
+    uint32_t chunkCount;
+    uint64_t size;              // bytes once unpacked
+};
+#pragma pack(pop)
+
+static_assert(sizeof(CompressedStreamHeader) == 24, "CompressedStreamHeader must match the file layout");
+
+// Returns true if data starts with a well-formed compressed stream header and
+// chunk table that fit in size bytes.
+bool IsCompressedStream(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size
+);
+
+// Compresses data into a stream of chunkSize chunks, compressing chunks on
+// threadCount threads (0 uses one per hardware thread). Chunks that do not
+// shrink are stored as-is.
+void CompressStream(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    uint32_t chunkSize,
+    unsigned int threadCount,
+    _Out_ std::vector<uint8_t>* stream
+);
+
+// Reads a compressed stream held in memory, such as a file mapping, which must
+// outlive the reader. All const methods may be called from several threads.
+class CompressedStreamReader
+{
+public:
+    CompressedStreamReader();
+
+    // Validates the header and chunk table. Returns false for anything that is
+    // not a well-formed stream of size bytes or less.
+    bool Open(
+        _In_reads_bytes_(size) const uint8_t* data,
+        size_t size
+    );
+
+    uint64_t GetSize() const { return m_size; }
+    size_t GetChunkCount() const { return m_chunkOffsets.empty() ? 0 : m_chunkOffsets.size() - 1; }
+
+    // Unpacks the whole stream into destination, which must hold GetSize()
+    // bytes. Threads take chunks in turn and write them in place, so there is
+    // no copy after decompression. Returns false if any chunk is corrupt.
+    bool Decompress(
+        _Out_writes_bytes_(destinationSize) uint8_t* destination,
+        size_t destinationSize,
+        unsigned int threadCount
+    ) const;
+
+    // Unpacks size bytes starting at offset, touching only the chunks that
+    // cover them.
+    bool DecompressRange(
+        uint64_t offset,
+        size_t size,
+        _Out_writes_bytes_(size) uint8_t* destination
+    ) const;
+
+private:
+    bool DecompressChunk(size_t chunk, _Out_ uint8_t* destination) const;
+    size_t GetChunkSize(size_t chunk) const;
+
+    const uint8_t* m_data;
+    uint64_t m_size;
+    uint32_t m_chunkSize;
+    const uint8_t* m_chunkTable;
+    std::vector<uint64_t> m_chunkOffsets;   // chunkCount + 1 entries
+};
@@ -0,0 +1,247 @@
+#include "pch.h"
+#include "D3DTextureResidencyBackend.h"
+
+namespace
+{
+    void ThrowIfFailed(DDSResult result)
+    {
+        switch (result)
+        {
+        case DDSResult::Ok:
+            return;
+
+        case DDSResult::InvalidArgument:
+            throw winrt::hresult_invalid_argument();
+
+        case DDSResult::OutOfBounds:
+            throw winrt::hresult_out_of_bounds();
+
+        default:
+            throw winrt::hresult_error(E_FAIL);
+        }
+    }
+}
+
+D3DTextureResidencyBackend::D3DTextureResidencyBackend(_In_ ID3D11Device* d3dDevice)
+{
+    m_d3dDevice.copy_from(d3dDevice);
+}
+
+TextureResidencyId D3DTextureResidencyBackend::AddTexture(
+    TextureResidencyManager& manager,
+    MappedFile&& ddsFile)
+{
+    auto source = std::make_unique<TextureSource>();
+    source->file = std::move(ddsFile);
+
+    const uint8_t* ddsData = source->file.Data();
+    size_t ddsDataSize = source->file.Size();
+    return AddSource(manager, std::move(source), ddsData, ddsDataSize);
+}
+
+TextureResidencyId D3DTextureResidencyBackend::AddTexture(
+    TextureResidencyManager& manager,
+    std::vector<byte>&& ddsData)
+{
+    auto source = std::make_unique<TextureSource>();
+    source->data = std::move(ddsData);
+
+    const uint8_t* data = source->data.data();
+    size_t dataSize = source->data.size();
+    return AddSource(manager, std::move(source), data, dataSize);
+}
+
+TextureResidencyId D3DTextureResidencyBackend::AddSource(
+    TextureResidencyManager& manager,
+    std::unique_ptr<TextureSource> source,
+    _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+    _In_ size_t ddsDataSize)
+{
+    if (!ddsData)
+    {
+        throw winrt::hresult_invalid_argument();
+    }
+
+    ThrowIfFailed(ParseDDS(ddsData, ddsDataSize, &source->info));
+    if (source->info.dimension != DDS_DIMENSION_TEXTURE2D)
+    {
+        throw winrt::hresult_not_implemented();
+    }
+
+    source->subresources.resize(source->info.mipCount * source->info.arraySize);
+    ThrowIfFailed(GetDDSSubresources(source->info, 0, source->subresources.data(), &source->mipRange));
+
+    TextureResidencyId id = manager.Register(source->info);
+    if (id >= m_sources.size())
+    {
+        m_sources.resize(id + 1);
+    }
+    m_sources[id] = std::move(source);
+    return id;
+}
+
+void D3DTextureResidencyBackend::RemoveTexture(
+    TextureResidencyManager& manager,
+    TextureResidencyId id)
+{
+    manager.Unregister(id);
+    m_sources[id] = nullptr;
+}
+
+ID3D11ShaderResourceView* D3DTextureResidencyBackend::GetShaderResourceView(TextureResidencyId id) const
+{
+    return m_sources[id]->textureView.get();
+}
+
+bool D3DTextureResidencyBackend::MakeResident(TextureResidencyId id, size_t firstMip)
+{
+    TextureSource& source = *m_sources[id];
+    const DDSTextureInfo& info = source.info;
+    size_t mipCount = source.mipRange.mipCount;
+    size_t residentMipCount = mipCount - firstMip;
+
+    std::unique_ptr<D3D11_SUBRESOURCE_DATA[]> initData(new D3D11_SUBRESOURCE_DATA[residentMipCount * info.arraySize]);
+    size_t index = 0;
+    for (size_t slice = 0; slice < info.arraySize; slice++)
+    {
+        for (size_t mip = firstMip; mip < mipCount; mip++)
+        {
+            const DDSSubresource& subresource = source.subresources[slice * mipCount + mip];
+            initData[index].pSysMem = subresource.data;
+            initData[index].SysMemPitch = static_cast<UINT>(subresource.rowPitch);
+            initData[index].SysMemSlicePitch = static_cast<UINT>(subresource.slicePitch);
+            index++;
+        }
+    }
+
+    const DDSSubresource& top = source.subresources[firstMip];
+
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = static_cast<UINT>(top.width);
+    desc.Height = static_cast<UINT>(top.height);
+    desc.MipLevels = static_cast<UINT>(residentMipCount);
+    desc.ArraySize = static_cast<UINT>(info.arraySize);
+    desc.Format = static_cast<DXGI_FORMAT>(info.format);
+    desc.SampleDesc.Count = 1;
+    desc.SampleDesc.Quality = 0;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.MiscFlags = info.isCubeMap ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0;
+
+    // Allocation failures are reported to the manager rather than thrown, so
+    // that it can keep the previous levels.
+    winrt::com_ptr<ID3D11Texture2D> texture;
+    if (FAILED(m_d3dDevice->CreateTexture2D(&desc, initData.get(), texture.put())))
+    {
+        return false;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+    srvDesc.Format = desc.Format;
+    if (info.isCubeMap)
+    {
+        if (info.arraySize > 6)
+        {
+            srvDesc.ViewDimension = D3D_SRV_DIMENSION_TEXTURECUBEARRAY;
+            srvDesc.TextureCubeArray.MipLevels = desc.MipLevels;
+            srvDesc.TextureCubeArray.NumCubes = static_cast<UINT>(info.arraySize / 6);
+        }
+        else
+        {
+            srvDesc.ViewDimension = D3D_SRV_DIMENSION_TEXTURECUBE;
+            srvDesc.TextureCube.MipLevels = desc.MipLevels;
+        }
+    }
+    else if (info.arraySize > 1)
+    {
+        srvDesc.ViewDimension = D3D_SRV_DIMENSION_TEXTURE2DARRAY;
+        srvDesc.Texture2DArray.MipLevels = desc.MipLevels;
+        srvDesc.Texture2DArray.ArraySize = static_cast<UINT>(info.arraySize);
+    }
+    else
+    {
+        srvDesc.ViewDimension = D3D_SRV_DIMENSION_TEXTURE2D;
+        srvDesc.Texture2D.MipLevels = desc.MipLevels;
+    }
+
+    winrt::com_ptr<ID3D11ShaderResourceView> textureView;
+    if (FAILED(m_d3dDevice->CreateShaderResourceView(texture.get(), &srvDesc, textureView.put())))
+    {
+        return false;
+    }
+
+    source.texture = texture;
+    source.textureView = textureView;
+    return true;
+}
+
+void D3DTextureResidencyBackend::Evict(TextureResidencyId id)
+{
+    TextureSource& source = *m_sources[id];
+    source.textureView = nullptr;
+    source.texture = nullptr;
+}
+
+TextureResidencyId RegisterResidentTexture(
+    TextureResidencyManager& manager,
+    _In_ ID3D11Resource* texture)
+{
+    if (!texture)
+    {
+        throw winrt::hresult_invalid_argument();
+    }
+
+    DDSTextureInfo info = {};
+    info.depth = 1;
+    info.height = 1;
+
+    D3D11_RESOURCE_DIMENSION dimension;
+    texture->GetType(&dimension);
+    switch (dimension)
+    {
+    case D3D11_RESOURCE_DIMENSION_TEXTURE1D:
+        {
+            D3D11_TEXTURE1D_DESC desc;
+            static_cast<ID3D11Texture1D*>(texture)->GetDesc(&desc);
+            info.dimension = DDS_DIMENSION_TEXTURE1D;
+            info.format = static_cast<DDS_FORMAT>(desc.Format);
+            info.width = desc.Width;
+            info.mipCount = desc.MipLevels;
+            info.arraySize = desc.ArraySize;
+        }
+        break;
+
+    case D3D11_RESOURCE_DIMENSION_TEXTURE2D:
+        {
+            D3D11_TEXTURE2D_DESC desc;
+            static_cast<ID3D11Texture2D*>(texture)->GetDesc(&desc);
+            info.dimension = DDS_DIMENSION_TEXTURE2D;
+            info.format = static_cast<DDS_FORMAT>(desc.Format);
+            info.width = desc.Width;
+            info.height = desc.Height;
+            info.mipCount = desc.MipLevels;
+            info.arraySize = desc.ArraySize;
+            info.isCubeMap = (desc.MiscFlags & D3D11_RESOURCE_MISC_TEXTURECUBE) != 0;
+        }
+        break;
+
+    case D3D11_RESOURCE_DIMENSION_TEXTURE3D:
+        {
+            D3D11_TEXTURE3D_DESC desc;
+            static_cast<ID3D11Texture3D*>(texture)->GetDesc(&desc);
+            info.dimension = DDS_DIMENSION_TEXTURE3D;
+            info.format = static_cast<DDS_FORMAT>(desc.Format);
+            info.width = desc.Width;
+            info.height = desc.Height;
+            info.depth = desc.Depth;
+            info.mipCount = desc.MipLevels;
+            info.arraySize = 1;
+        }
+        break;
+
+    default:
+        throw winrt::hresult_invalid_argument();
+    }
+
+    return manager.RegisterResident(info);
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include "MappedFile.h"
+#include "TextureResidencyManager.h"
+
+// A TextureResidencyBackend that keeps the DDS data of each texture and
+// creates a Direct3D texture holding just the resident levels. Dropping or
+// restoring top mips recreates the texture, so the view returned by
+// GetShaderResourceView changes whenever residency does; look it up each
+// frame rather than caching it. Supports 2D textures, including arrays and
+// cube maps.
+class D3DTextureResidencyBackend : public TextureResidencyBackend
+{
+public:
+    D3DTextureResidencyBackend(_In_ ID3D11Device* d3dDevice);
+
+    // Parses the DDS data and registers the texture with the manager. The
+    // backend keeps the data so that evicted levels can be recreated.
+    TextureResidencyId AddTexture(
+        TextureResidencyManager& manager,
+        MappedFile&& ddsFile
+    );
+
+    TextureResidencyId AddTexture(
+        TextureResidencyManager& manager,
+        std::vector<byte>&& ddsData
+    );
+
+    // Unregisters the texture from the manager and releases its data.
+    void RemoveTexture(
+        TextureResidencyManager& manager,
+        TextureResidencyId id
+    );
+
+    // The view of the resident levels, or null when the texture is evicted.
+    ID3D11ShaderResourceView* GetShaderResourceView(TextureResidencyId id) const;
+
+    bool MakeResident(TextureResidencyId id, size_t firstMip) override;
+    void Evict(TextureResidencyId id) override;
+
+private:
+    struct TextureSource
+    {
+        MappedFile file;
+        std::vector<byte> data;
+        DDSTextureInfo info;
+        DDSMipRange mipRange;
+        std::vector<DDSSubresource> subresources;
+        winrt::com_ptr<ID3D11Texture2D> texture;
+        winrt::com_ptr<ID3D11ShaderResourceView> textureView;
+    };
+
+    winrt::com_ptr<ID3D11Device> m_d3dDevice;
+    std::vector<std::unique_ptr<TextureSource>> m_sources;
+
+    TextureResidencyId AddSource(
+        TextureResidencyManager& manager,
+        std::unique_ptr<TextureSource> source,
+        _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+        _In_ size_t ddsDataSize
+    );
+};
+
+// Registers a texture created elsewhere, such as by BasicLoader or
+// DDSTextureStreamer, as resident with the manager (see
+// TextureResidencyManager::RegisterResident), with level sizes from its
+// description.
+TextureResidencyId RegisterResidentTexture(
+    TextureResidencyManager& manager,
+    _In_ ID3D11Resource* texture
+);
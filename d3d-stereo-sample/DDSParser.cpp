@@ -0,0 +1,1189 @@
+//--------------------------------------------------------------------------------------
+// File: DDSParser.cpp
+//
+// Device-independent DDS file parsing and header writing.
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//--------------------------------------------------------------------------------------
+
+#include "DDSParser.h"
+#include <atomic>
+#include <string.h>
+#include <thread>
+#include <vector>
+
+//--------------------------------------------------------------------------------------
+// Macros
+//--------------------------------------------------------------------------------------
+#ifndef MAKEFOURCC
+#define MAKEFOURCC(ch0, ch1, ch2, ch3)                              \
+                ((uint32_t)(uint8_t)(ch0) | ((uint32_t)(uint8_t)(ch1) << 8) |       \
+                ((uint32_t)(uint8_t)(ch2) << 16) | ((uint32_t)(uint8_t)(ch3) << 24))
+#endif /* defined(MAKEFOURCC) */
+
+//--------------------------------------------------------------------------------------
+// DDS file structure definitions
+//
+// See DDS.h in the 'Texconv' sample and the 'DirectXTex' library
+//--------------------------------------------------------------------------------------
+#pragma pack(push, 1)
+
+#define DDS_MAGIC 0x20534444 // "DDS "
+
+struct DDS_PIXELFORMAT
+{
+    uint32_t  size;
+    uint32_t  flags;
+    uint32_t  fourCC;
+    uint32_t  RGBBitCount;
+    uint32_t  RBitMask;
+    uint32_t  GBitMask;
+    uint32_t  BBitMask;
+    uint32_t  ABitMask;
+};
+
+#define DDS_FOURCC      0x00000004  // DDPF_FOURCC
+#define DDS_RGB         0x00000040  // DDPF_RGB
+#define DDS_RGBA        0x00000041  // DDPF_RGB | DDPF_ALPHAPIXELS
+#define DDS_LUMINANCE   0x00020000  // DDPF_LUMINANCE
+#define DDS_LUMINANCEA  0x00020001  // DDPF_LUMINANCE | DDPF_ALPHAPIXELS
+#define DDS_ALPHA       0x00000002  // DDPF_ALPHA
+#define DDS_PAL8        0x00000020  // DDPF_PALETTEINDEXED8
+
+#define DDS_HEADER_FLAGS_TEXTURE        0x00001007  // DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT
+#define DDS_HEADER_FLAGS_MIPMAP         0x00020000  // DDSD_MIPMAPCOUNT
+#define DDS_HEADER_FLAGS_VOLUME         0x00800000  // DDSD_DEPTH
+#define DDS_HEADER_FLAGS_PITCH          0x00000008  // DDSD_PITCH
+#define DDS_HEADER_FLAGS_LINEARSIZE     0x00080000  // DDSD_LINEARSIZE
+
+#define DDS_HEIGHT 0x00000002 // DDSD_HEIGHT
+#define DDS_WIDTH  0x00000004 // DDSD_WIDTH
+
+#define DDS_SURFACE_FLAGS_TEXTURE 0x00001000 // DDSCAPS_TEXTURE
+#define DDS_SURFACE_FLAGS_MIPMAP  0x00400008 // DDSCAPS_COMPLEX | DDSCAPS_MIPMAP
+#define DDS_SURFACE_FLAGS_CUBEMAP 0x00000008 // DDSCAPS_COMPLEX
+
+#define DDS_CUBEMAP_POSITIVEX 0x00000600 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEX
+#define DDS_CUBEMAP_NEGATIVEX 0x00000a00 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEX
+#define DDS_CUBEMAP_POSITIVEY 0x00001200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEY
+#define DDS_CUBEMAP_NEGATIVEY 0x00002200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEY
+#define DDS_CUBEMAP_POSITIVEZ 0x00004200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_POSITIVEZ
+#define DDS_CUBEMAP_NEGATIVEZ 0x00008200 // DDSCAPS2_CUBEMAP | DDSCAPS2_CUBEMAP_NEGATIVEZ
+
+#define DDS_CUBEMAP_ALLFACES (DDS_CUBEMAP_POSITIVEX | DDS_CUBEMAP_NEGATIVEX |\
+                              DDS_CUBEMAP_POSITIVEY | DDS_CUBEMAP_NEGATIVEY |\
+                              DDS_CUBEMAP_POSITIVEZ | DDS_CUBEMAP_NEGATIVEZ)
+
+#define DDS_CUBEMAP 0x00000200 // DDSCAPS2_CUBEMAP
+
+#define DDS_FLAGS_VOLUME 0x00200000 // DDSCAPS2_VOLUME
+
+enum DDS_MISC_FLAGS2
+{
+    DDS_MISC_FLAGS2_ALPHA_MODE_MASK = 0x7L,
+};
+
+typedef struct
+{
+    uint32_t          size;
+    uint32_t          flags;
+    uint32_t          height;
+    uint32_t          width;
+    uint32_t          pitchOrLinearSize;
+    uint32_t          depth; // only if DDS_HEADER_FLAGS_VOLUME is set in flags
+    uint32_t          mipMapCount;
+    uint32_t          reserved1[11];
+    DDS_PIXELFORMAT ddspf;
+    uint32_t          caps;
+    uint32_t          caps2;
+    uint32_t          caps3;
+    uint32_t          caps4;
+    uint32_t          reserved2;
+} DDS_HEADER;
+
+typedef struct
+{
+    DDS_FORMAT    dxgiFormat;
+    uint32_t      resourceDimension;
+    uint32_t      miscFlag; // see D3D11_RESOURCE_MISC_FLAG
+    uint32_t      arraySize;
+    uint32_t      miscFlags2;
+} DDS_HEADER_DXT10;
+
+#pragma pack(pop)
+
+//--------------------------------------------------------------------------------------
+// Direct3D 11 resource limits (the D3D11_REQ_* values in d3d11.h)
+//--------------------------------------------------------------------------------------
+#define DDS_REQ_MIP_LEVELS                      15
+#define DDS_REQ_TEXTURE1D_ARRAY_AXIS_DIMENSION  2048
+#define DDS_REQ_TEXTURE1D_U_DIMENSION           16384
+#define DDS_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION  2048
+#define DDS_REQ_TEXTURE2D_U_OR_V_DIMENSION      16384
+#define DDS_REQ_TEXTURECUBE_DIMENSION           16384
+#define DDS_REQ_TEXTURE3D_U_V_OR_W_DIMENSION    2048
+
+#define DDS_RESOURCE_MISC_TEXTURECUBE           0x4L // D3D11_RESOURCE_MISC_TEXTURECUBE
+
+//--------------------------------------------------------------------------------------
+// Return the BPP for a particular format
+//--------------------------------------------------------------------------------------
+size_t DDSBitsPerPixel(_In_ DDS_FORMAT fmt)
+{
+    switch (fmt)
+    {
+    case DDS_FORMAT_R32G32B32A32_TYPELESS:
+    case DDS_FORMAT_R32G32B32A32_FLOAT:
+    case DDS_FORMAT_R32G32B32A32_UINT:
+    case DDS_FORMAT_R32G32B32A32_SINT:
+        return 128;
+
+    case DDS_FORMAT_R32G32B32_TYPELESS:
+    case DDS_FORMAT_R32G32B32_FLOAT:
+    case DDS_FORMAT_R32G32B32_UINT:
+    case DDS_FORMAT_R32G32B32_SINT:
+        return 96;
+
+    case DDS_FORMAT_R16G16B16A16_TYPELESS:
+    case DDS_FORMAT_R16G16B16A16_FLOAT:
+    case DDS_FORMAT_R16G16B16A16_UNORM:
+    case DDS_FORMAT_R16G16B16A16_UINT:
+    case DDS_FORMAT_R16G16B16A16_SNORM:
+    case DDS_FORMAT_R16G16B16A16_SINT:
+    case DDS_FORMAT_R32G32_TYPELESS:
+    case DDS_FORMAT_R32G32_FLOAT:
+    case DDS_FORMAT_R32G32_UINT:
+    case DDS_FORMAT_R32G32_SINT:
+    case DDS_FORMAT_R32G8X24_TYPELESS:
+    case DDS_FORMAT_D32_FLOAT_S8X24_UINT:
+    case DDS_FORMAT_R32_FLOAT_X8X24_TYPELESS:
+    case DDS_FORMAT_X32_TYPELESS_G8X24_UINT:
+        return 64;
+
+    case DDS_FORMAT_R10G10B10A2_TYPELESS:
+    case DDS_FORMAT_R10G10B10A2_UNORM:
+    case DDS_FORMAT_R10G10B10A2_UINT:
+    case DDS_FORMAT_R11G11B10_FLOAT:
+    case DDS_FORMAT_R8G8B8A8_TYPELESS:
+    case DDS_FORMAT_R8G8B8A8_UNORM:
+    case DDS_FORMAT_R8G8B8A8_UNORM_SRGB:
+    case DDS_FORMAT_R8G8B8A8_UINT:
+    case DDS_FORMAT_R8G8B8A8_SNORM:
+    case DDS_FORMAT_R8G8B8A8_SINT:
+    case DDS_FORMAT_R16G16_TYPELESS:
+    case DDS_FORMAT_R16G16_FLOAT:
+    case DDS_FORMAT_R16G16_UNORM:
+    case DDS_FORMAT_R16G16_UINT:
+    case DDS_FORMAT_R16G16_SNORM:
+    case DDS_FORMAT_R16G16_SINT:
+    case DDS_FORMAT_R32_TYPELESS:
+    case DDS_FORMAT_D32_FLOAT:
+    case DDS_FORMAT_R32_FLOAT:
+    case DDS_FORMAT_R32_UINT:
+    case DDS_FORMAT_R32_SINT:
+    case DDS_FORMAT_R24G8_TYPELESS:
+    case DDS_FORMAT_D24_UNORM_S8_UINT:
+    case DDS_FORMAT_R24_UNORM_X8_TYPELESS:
+    case DDS_FORMAT_X24_TYPELESS_G8_UINT:
+    case DDS_FORMAT_R9G9B9E5_SHAREDEXP:
+    case DDS_FORMAT_R8G8_B8G8_UNORM:
+    case DDS_FORMAT_G8R8_G8B8_UNORM:
+    case DDS_FORMAT_B8G8R8A8_UNORM:
+    case DDS_FORMAT_B8G8R8X8_UNORM:
+    case DDS_FORMAT_R10G10B10_XR_BIAS_A2_UNORM:
+    case DDS_FORMAT_B8G8R8A8_TYPELESS:
+    case DDS_FORMAT_B8G8R8A8_UNORM_SRGB:
+    case DDS_FORMAT_B8G8R8X8_TYPELESS:
+    case DDS_FORMAT_B8G8R8X8_UNORM_SRGB:
+        return 32;
+
+    case DDS_FORMAT_R8G8_TYPELESS:
+    case DDS_FORMAT_R8G8_UNORM:
+    case DDS_FORMAT_R8G8_UINT:
+    case DDS_FORMAT_R8G8_SNORM:
+    case DDS_FORMAT_R8G8_SINT:
+    case DDS_FORMAT_R16_TYPELESS:
+    case DDS_FORMAT_R16_FLOAT:
+    case DDS_FORMAT_D16_UNORM:
+    case DDS_FORMAT_R16_UNORM:
+    case DDS_FORMAT_R16_UINT:
+    case DDS_FORMAT_R16_SNORM:
+    case DDS_FORMAT_R16_SINT:
+    case DDS_FORMAT_B5G6R5_UNORM:
+    case DDS_FORMAT_B5G5R5A1_UNORM:
+    case DDS_FORMAT_B4G4R4A4_UNORM:
+        return 16;
+
+    case DDS_FORMAT_R8_TYPELESS:
+    case DDS_FORMAT_R8_UNORM:
+    case DDS_FORMAT_R8_UINT:
+    case DDS_FORMAT_R8_SNORM:
+    case DDS_FORMAT_R8_SINT:
+    case DDS_FORMAT_A8_UNORM:
+        return 8;
+
+    case DDS_FORMAT_R1_UNORM:
+        return 1;
+
+    case DDS_FORMAT_BC1_TYPELESS:
+    case DDS_FORMAT_BC1_UNORM:
+    case DDS_FORMAT_BC1_UNORM_SRGB:
+    case DDS_FORMAT_BC4_TYPELESS:
+    case DDS_FORMAT_BC4_UNORM:
+    case DDS_FORMAT_BC4_SNORM:
+        return 4;
+
+    case DDS_FORMAT_BC2_TYPELESS:
+    case DDS_FORMAT_BC2_UNORM:
+    case DDS_FORMAT_BC2_UNORM_SRGB:
+    case DDS_FORMAT_BC3_TYPELESS:
+    case DDS_FORMAT_BC3_UNORM:
+    case DDS_FORMAT_BC3_UNORM_SRGB:
+    case DDS_FORMAT_BC5_TYPELESS:
+    case DDS_FORMAT_BC5_UNORM:
+    case DDS_FORMAT_BC5_SNORM:
+    case DDS_FORMAT_BC6H_TYPELESS:
+    case DDS_FORMAT_BC6H_UF16:
+    case DDS_FORMAT_BC6H_SF16:
+    case DDS_FORMAT_BC7_TYPELESS:
+    case DDS_FORMAT_BC7_UNORM:
+    case DDS_FORMAT_BC7_UNORM_SRGB:
+        return 8;
+
+    default:
+        return 0;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+// Get surface information for a particular format
+//--------------------------------------------------------------------------------------
+void DDSGetSurfaceInfo(
+    _In_ size_t width,
+    _In_ size_t height,
+    _In_ DDS_FORMAT fmt,
+    _Out_opt_ size_t* outNumBytes,
+    _Out_opt_ size_t* outRowBytes,
+    _Out_opt_ size_t* outNumRows
+)
+{
+    size_t numBytes = 0;
+    size_t rowBytes = 0;
+    size_t numRows = 0;
+
+    bool bc = false;
+    bool packed = false;
+    size_t bcnumBytesPerBlock = 0;
+    switch (fmt)
+    {
+    case DDS_FORMAT_BC1_TYPELESS:
+    case DDS_FORMAT_BC1_UNORM:
+    case DDS_FORMAT_BC1_UNORM_SRGB:
+    case DDS_FORMAT_BC4_TYPELESS:
+    case DDS_FORMAT_BC4_UNORM:
+    case DDS_FORMAT_BC4_SNORM:
+        bc = true;
+        bcnumBytesPerBlock = 8;
+        break;
+
+    case DDS_FORMAT_BC2_TYPELESS:
+    case DDS_FORMAT_BC2_UNORM:
+    case DDS_FORMAT_BC2_UNORM_SRGB:
+    case DDS_FORMAT_BC3_TYPELESS:
+    case DDS_FORMAT_BC3_UNORM:
+    case DDS_FORMAT_BC3_UNORM_SRGB:
+    case DDS_FORMAT_BC5_TYPELESS:
+    case DDS_FORMAT_BC5_UNORM:
+    case DDS_FORMAT_BC5_SNORM:
+    case DDS_FORMAT_BC6H_TYPELESS:
+    case DDS_FORMAT_BC6H_UF16:
+    case DDS_FORMAT_BC6H_SF16:
+    case DDS_FORMAT_BC7_TYPELESS:
+    case DDS_FORMAT_BC7_UNORM:
+    case DDS_FORMAT_BC7_UNORM_SRGB:
+        bc = true;
+        bcnumBytesPerBlock = 16;
+        break;
+
+    case DDS_FORMAT_R8G8_B8G8_UNORM:
+    case DDS_FORMAT_G8R8_G8B8_UNORM:
+        packed = true;
+        break;
+
+    default:
+        break;
+    }
+
+    if (bc)
+    {
+        size_t numBlocksWide = 0;
+        if (width > 0)
+        {
+            numBlocksWide = (width + 3) / 4;
+        }
+        size_t numBlocksHigh = 0;
+        if (height > 0)
+        {
+            numBlocksHigh = (height + 3) / 4;
+        }
+        rowBytes = numBlocksWide * bcnumBytesPerBlock;
+        numRows = numBlocksHigh;
+    }
+    else if (packed)
+    {
+        rowBytes = ((width + 1) >> 1) * 4;
+        numRows = height;
+    }
+    else
+    {
+        size_t bpp = DDSBitsPerPixel(fmt);
+        rowBytes = (width * bpp + 7) / 8; // round up to nearest byte
+        numRows = height;
+    }
+
+    numBytes = rowBytes * numRows;
+    if (outNumBytes)
+    {
+        *outNumBytes = numBytes;
+    }
+    if (outRowBytes)
+    {
+        *outRowBytes = rowBytes;
+    }
+    if (outNumRows)
+    {
+        *outNumRows = numRows;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+#define ISBITMASK(r, g, b, a) (ddpf.RBitMask == r && ddpf.GBitMask == g && ddpf.BBitMask == b && ddpf.ABitMask == a)
+
+static DDS_FORMAT GetDDSFormat(const DDS_PIXELFORMAT& ddpf)
+{
+    if (ddpf.flags & DDS_RGB)
+    {
+        // Note that sRGB formats are written using the "DX10" extended header
+
+        switch (ddpf.RGBBitCount)
+        {
+        case 32:
+            if (ISBITMASK(0x000000ff, 0x0000ff00, 0x00ff0000, 0xff000000))
+            {
+                return DDS_FORMAT_R8G8B8A8_UNORM;
+            }
+
+            if (ISBITMASK(0x00ff0000, 0x0000ff00, 0x000000ff, 0xff000000))
+            {
+                return DDS_FORMAT_B8G8R8A8_UNORM;
+            }
+
+            if (ISBITMASK(0x00ff0000, 0x0000ff00, 0x000000ff, 0x00000000))
+            {
+                return DDS_FORMAT_B8G8R8X8_UNORM;
+            }
+
+            // No DXGI format maps to ISBITMASK(0x000000ff, 0x0000ff00, 0x00ff0000, 0x00000000) aka D3DFMT_X8B8G8R8
+
+            // Note that many common DDS reader/writers (including D3DX) swap the
+            // the RED/BLUE masks for 10:10:10:2 formats. We assumme
+            // below that the 'backwards' header mask is being used since it is most
+            // likely written by D3DX. The more robust solution is to use the 'DX10'
+            // header extension and specify the DDS_FORMAT_R10G10B10A2_UNORM format directly
+
+            // For 'correct' writers, this should be 0x000003ff, 0x000ffc00, 0x3ff00000 for RGB data
+            if (ISBITMASK(0x3ff00000, 0x000ffc00, 0x000003ff, 0xc0000000))
+            {
+                return DDS_FORMAT_R10G10B10A2_UNORM;
+            }
+
+            // No DXGI format maps to ISBITMASK(0x000003ff, 0x000ffc00, 0x3ff00000, 0xc0000000) aka D3DFMT_A2R10G10B10
+
+            if (ISBITMASK(0x0000ffff, 0xffff0000, 0x00000000, 0x00000000))
+            {
+                return DDS_FORMAT_R16G16_UNORM;
+            }
+
+            if (ISBITMASK(0xffffffff, 0x00000000, 0x00000000, 0x00000000))
+            {
+                // Only 32-bit color channel format in D3D9 was R32F
+                return DDS_FORMAT_R32_FLOAT; // D3DX writes this out as a FourCC of 114
+            }
+            break;
+
+        case 24:
+            // No 24bpp DXGI formats aka D3DFMT_R8G8B8
+            break;
+
+        case 16:
+            if (ISBITMASK(0x7c00, 0x03e0, 0x001f, 0x8000))
+            {
+                return DDS_FORMAT_B5G5R5A1_UNORM;
+            }
+            if (ISBITMASK(0xf800, 0x07e0, 0x001f, 0x0000))
+            {
+                return DDS_FORMAT_B5G6R5_UNORM;
+            }
+
+            // No DXGI format maps to ISBITMASK(0x7c00, 0x03e0, 0x001f, 0x0000) aka D3DFMT_X1R5G5B5
+            if (ISBITMASK(0x0f00, 0x00f0, 0x000f, 0xf000))
+            {
+                return DDS_FORMAT_B4G4R4A4_UNORM;
+            }
+
+            // No DXGI format maps to ISBITMASK(0x0f00, 0x00f0, 0x000f, 0x0000) aka D3DFMT_X4R4G4B4
+
+            // No 3:3:2, 3:3:2:8, or paletted DXGI formats aka D3DFMT_A8R3G3B2, D3DFMT_R3G3B2, D3DFMT_P8, D3DFMT_A8P8, etc.
+            break;
+        }
+    }
+    else if (ddpf.flags & DDS_LUMINANCE)
+    {
+        if (8 == ddpf.RGBBitCount)
+        {
+            if (ISBITMASK(0x000000ff, 0x00000000, 0x00000000, 0x00000000))
+            {
+                return DDS_FORMAT_R8_UNORM; // D3DX10/11 writes this out as DX10 extension
+            }
+
+            // No DXGI format maps to ISBITMASK(0x0f, 0x00, 0x00, 0xf0) aka D3DFMT_A4L4
+        }
+
+        if (16 == ddpf.RGBBitCount)
+        {
+            if (ISBITMASK(0x0000ffff, 0x00000000, 0x00000000, 0x00000000))
+            {
+                return DDS_FORMAT_R16_UNORM; // D3DX10/11 writes this out as DX10 extension
+            }
+            if (ISBITMASK(0x000000ff, 0x00000000, 0x00000000, 0x0000ff00))
+            {
+                return DDS_FORMAT_R8G8_UNORM; // D3DX10/11 writes this out as DX10 extension
+            }
+        }
+    }
+    else if (ddpf.flags & DDS_ALPHA)
+    {
+        if (8 == ddpf.RGBBitCount)
+        {
+            return DDS_FORMAT_A8_UNORM;
+        }
+    }
+    else if (ddpf.flags & DDS_FOURCC)
+    {
+        if (MAKEFOURCC('D', 'X', 'T', '1') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_BC1_UNORM;
+        }
+        if (MAKEFOURCC('D', 'X', 'T', '3') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_BC2_UNORM;
+        }
+        if (MAKEFOURCC('D', 'X', 'T', '5') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_BC3_UNORM;
+        }
+
+        // While pre-mulitplied alpha isn't directly supported by the DXGI formats,
+        // they are basically the same as these BC formats so they can be mapped
+        if (MAKEFOURCC('D', 'X', 'T', '2') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_BC2_UNORM;
+        }
+        if (MAKEFOURCC('D', 'X', 'T', '4') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_BC3_UNORM;
+        }
+
+        if (MAKEFOURCC('A', 'T', 'I', '1') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_BC4_UNORM;
+        }
+        if (MAKEFOURCC('B', 'C', '4', 'U') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_BC4_UNORM;
+        }
+        if (MAKEFOURCC('B', 'C', '4', 'S') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_BC4_SNORM;
+        }
+
+        if (MAKEFOURCC('A', 'T', 'I', '2') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_BC5_UNORM;
+        }
+        if (MAKEFOURCC('B', 'C', '5', 'U') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_BC5_UNORM;
+        }
+        if (MAKEFOURCC('B', 'C', '5', 'S') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_BC5_SNORM;
+        }
+
+        // BC6H and BC7 are written using the "DX10" extended header
+
+        if (MAKEFOURCC('R', 'G', 'B', 'G') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_R8G8_B8G8_UNORM;
+        }
+        if (MAKEFOURCC('G', 'R', 'G', 'B') == ddpf.fourCC)
+        {
+            return DDS_FORMAT_G8R8_G8B8_UNORM;
+        }
+
+        // Check for D3DFORMAT enums being set here
+        switch (ddpf.fourCC)
+        {
+        case 36: // D3DFMT_A16B16G16R16
+            return DDS_FORMAT_R16G16B16A16_UNORM;
+
+        case 110: // D3DFMT_Q16W16V16U16
+            return DDS_FORMAT_R16G16B16A16_SNORM;
+
+        case 111: // D3DFMT_R16F
+            return DDS_FORMAT_R16_FLOAT;
+
+        case 112: // D3DFMT_G16R16F
+            return DDS_FORMAT_R16G16_FLOAT;
+
+        case 113: // D3DFMT_A16B16G16R16F
+            return DDS_FORMAT_R16G16B16A16_FLOAT;
+
+        case 114: // D3DFMT_R32F
+            return DDS_FORMAT_R32_FLOAT;
+
+        case 115: // D3DFMT_G32R32F
+            return DDS_FORMAT_R32G32_FLOAT;
+
+        case 116: // D3DFMT_A32B32G32R32F
+            return DDS_FORMAT_R32G32B32A32_FLOAT;
+        }
+    }
+
+    return DDS_FORMAT_UNKNOWN;
+}
+
+
+//--------------------------------------------------------------------------------------
+DDS_FORMAT DDSMakeSRGB(_In_ DDS_FORMAT format)
+{
+    switch (format)
+    {
+    case DDS_FORMAT_R8G8B8A8_UNORM:
+        return DDS_FORMAT_R8G8B8A8_UNORM_SRGB;
+
+    case DDS_FORMAT_BC1_UNORM:
+        return DDS_FORMAT_BC1_UNORM_SRGB;
+
+    case DDS_FORMAT_BC2_UNORM:
+        return DDS_FORMAT_BC2_UNORM_SRGB;
+
+    case DDS_FORMAT_BC3_UNORM:
+        return DDS_FORMAT_BC3_UNORM_SRGB;
+
+    case DDS_FORMAT_B8G8R8A8_UNORM:
+        return DDS_FORMAT_B8G8R8A8_UNORM_SRGB;
+
+    case DDS_FORMAT_B8G8R8X8_UNORM:
+        return DDS_FORMAT_B8G8R8X8_UNORM_SRGB;
+
+    case DDS_FORMAT_BC7_UNORM:
+        return DDS_FORMAT_BC7_UNORM_SRGB;
+
+    default:
+        return format;
+    }
+}
+
+
+//--------------------------------------------------------------------------------------
+static DDS_ALPHA_MODE GetAlphaMode(_In_ const DDS_HEADER& header, _In_opt_ const DDS_HEADER_DXT10* d3d10ext)
+{
+    if (header.ddspf.flags & DDS_FOURCC)
+    {
+        if (d3d10ext)
+        {
+            switch (d3d10ext->miscFlags2 & DDS_MISC_FLAGS2_ALPHA_MODE_MASK)
+            {
+            case DDS_ALPHA_MODE_STRAIGHT:
+            case DDS_ALPHA_MODE_PREMULTIPLIED:
+            case DDS_ALPHA_MODE_OPAQUE:
+            case DDS_ALPHA_MODE_CUSTOM:
+                return static_cast<DDS_ALPHA_MODE>(d3d10ext->miscFlags2 & DDS_MISC_FLAGS2_ALPHA_MODE_MASK);
+            }
+        }
+        else if ((MAKEFOURCC('D', 'X', 'T', '2') == header.ddspf.fourCC)
+            || (MAKEFOURCC('D', 'X', 'T', '4') == header.ddspf.fourCC))
+        {
+            return DDS_ALPHA_MODE_PREMULTIPLIED;
+        }
+        // DXT1, DXT3, and DXT5 legacy files could be straight alpha or something else, so return "Unknown" to leave it up to the app
+    }
+
+    return DDS_ALPHA_MODE_UNKNOWN;
+}
+
+
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+DDSResult ParseDDS(
+    const uint8_t* ddsData,
+    size_t ddsDataSize,
+    DDSTextureInfo* info
+)
+{
+    if (!ddsData || !info)
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    memset(info, 0, sizeof(*info));
+
+    // Validate DDS file in memory
+    if (ddsDataSize < (sizeof(uint32_t) + sizeof(DDS_HEADER)))
+    {
+        return DDSResult::InvalidData;
+    }
+
+    uint32_t dwMagicNumber;
+    memcpy(&dwMagicNumber, ddsData, sizeof(uint32_t));
+    if (dwMagicNumber != DDS_MAGIC)
+    {
+        return DDSResult::InvalidData;
+    }
+
+    // The headers are copied out because the file data need not be aligned.
+    DDS_HEADER header;
+    memcpy(&header, ddsData + sizeof(uint32_t), sizeof(DDS_HEADER));
+
+    // Verify header to validate DDS file
+    if (header.size != sizeof(DDS_HEADER) ||
+        header.ddspf.size != sizeof(DDS_PIXELFORMAT))
+    {
+        return DDSResult::InvalidData;
+    }
+
+    // Check for DX10 extension
+    DDS_HEADER_DXT10 d3d10ext;
+    bool bDXT10Header = false;
+    if ((header.ddspf.flags & DDS_FOURCC) &&
+        (MAKEFOURCC('D', 'X', '1', '0') == header.ddspf.fourCC))
+    {
+        // Must be long enough for both headers and magic value
+        if (ddsDataSize < (sizeof(DDS_HEADER) + sizeof(uint32_t) + sizeof(DDS_HEADER_DXT10)))
+        {
+            return DDSResult::InvalidData;
+        }
+
+        memcpy(&d3d10ext, ddsData + sizeof(uint32_t) + sizeof(DDS_HEADER), sizeof(DDS_HEADER_DXT10));
+        bDXT10Header = true;
+    }
+
+    size_t offset = sizeof(uint32_t) + sizeof(DDS_HEADER) + (bDXT10Header ? sizeof(DDS_HEADER_DXT10) : 0);
+
+    size_t width = header.width;
+    size_t height = header.height;
+    size_t depth = header.depth;
+
+    DDS_DIMENSION resDim = DDS_DIMENSION_UNKNOWN;
+    size_t arraySize = 1;
+    DDS_FORMAT format = DDS_FORMAT_UNKNOWN;
+    bool isCubeMap = false;
+
+    size_t mipCount = header.mipMapCount;
+    if (0 == mipCount)
+    {
+        mipCount = 1;
+    }
+
+    if (bDXT10Header)
+    {
+        arraySize = d3d10ext.arraySize;
+        if (arraySize == 0)
+        {
+            return DDSResult::InvalidData;
+        }
+
+        if (DDSBitsPerPixel(d3d10ext.dxgiFormat) == 0)
+        {
+            return DDSResult::InvalidData;
+        }
+
+        format = d3d10ext.dxgiFormat;
+
+        switch (d3d10ext.resourceDimension)
+        {
+        case DDS_DIMENSION_TEXTURE1D:
+            // D3DX writes 1D textures with a fixed Height of 1
+            if ((header.flags & DDS_HEIGHT) && height != 1)
+            {
+                return DDSResult::InvalidData;
+            }
+            height = depth = 1;
+            break;
+
+        case DDS_DIMENSION_TEXTURE2D:
+            if (d3d10ext.miscFlag & DDS_RESOURCE_MISC_TEXTURECUBE)
+            {
+                arraySize *= 6;
+                isCubeMap = true;
+            }
+            depth = 1;
+            break;
+
+        case DDS_DIMENSION_TEXTURE3D:
+            if (!(header.flags & DDS_HEADER_FLAGS_VOLUME))
+            {
+                return DDSResult::InvalidData;
+            }
+
+            if (arraySize > 1)
+            {
+                return DDSResult::InvalidData;
+            }
+            break;
+
+        default:
+            return DDSResult::InvalidData;
+        }
+
+        resDim = static_cast<DDS_DIMENSION>(d3d10ext.resourceDimension);
+    }
+    else
+    {
+        format = GetDDSFormat(header.ddspf);
+
+        if (format == DDS_FORMAT_UNKNOWN)
+        {
+            return DDSResult::InvalidData;
+        }
+
+        if (header.flags & DDS_HEADER_FLAGS_VOLUME)
+        {
+            resDim = DDS_DIMENSION_TEXTURE3D;
+        }
+        else
+        {
+            if (header.caps2 & DDS_CUBEMAP)
+            {
+                // We require all six faces to be defined
+                if ((header.caps2 & DDS_CUBEMAP_ALLFACES) != DDS_CUBEMAP_ALLFACES)
+                {
+                    return DDSResult::InvalidData;
+                }
+
+                arraySize = 6;
+                isCubeMap = true;
+            }
+
+            depth = 1;
+            resDim = DDS_DIMENSION_TEXTURE2D;
+
+            // Note there's no way for a legacy Direct3D 9 DDS to express a '1D' texture
+        }
+    }
+
+    // Bound sizes (for security purposes we don't trust DDS file metadata larger than the D3D 11.x hardware requirements)
+    if (mipCount > DDS_REQ_MIP_LEVELS)
+    {
+        return DDSResult::InvalidData;
+    }
+
+    switch (resDim)
+    {
+    case DDS_DIMENSION_TEXTURE1D:
+        if ((arraySize > DDS_REQ_TEXTURE1D_ARRAY_AXIS_DIMENSION) ||
+            (width > DDS_REQ_TEXTURE1D_U_DIMENSION))
+        {
+            return DDSResult::InvalidData;
+        }
+        break;
+
+    case DDS_DIMENSION_TEXTURE2D:
+        if (isCubeMap)
+        {
+            // This is the right bound because we set arraySize to (NumCubes*6) above
+            if ((arraySize > DDS_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION) ||
+                (width > DDS_REQ_TEXTURECUBE_DIMENSION) ||
+                (height > DDS_REQ_TEXTURECUBE_DIMENSION))
+            {
+                return DDSResult::InvalidData;
+            }
+        }
+        else if ((arraySize > DDS_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION) ||
+            (width > DDS_REQ_TEXTURE2D_U_OR_V_DIMENSION) ||
+            (height > DDS_REQ_TEXTURE2D_U_OR_V_DIMENSION))
+        {
+            return DDSResult::InvalidData;
+        }
+        break;
+
+    case DDS_DIMENSION_TEXTURE3D:
+        if ((arraySize > 1) ||
+            (width > DDS_REQ_TEXTURE3D_U_V_OR_W_DIMENSION) ||
+            (height > DDS_REQ_TEXTURE3D_U_V_OR_W_DIMENSION) ||
+            (depth > DDS_REQ_TEXTURE3D_U_V_OR_W_DIMENSION))
+        {
+            return DDSResult::InvalidData;
+        }
+        break;
+
+    default:
+        return DDSResult::InvalidData;
+    }
+
+    info->format = format;
+    info->dimension = resDim;
+    info->width = width;
+    info->height = height;
+    info->depth = depth;
+    info->mipCount = mipCount;
+    info->arraySize = arraySize;
+    info->isCubeMap = isCubeMap;
+    info->alphaMode = GetAlphaMode(header, bDXT10Header ? &d3d10ext : nullptr);
+    info->bitData = ddsData + offset;
+    info->bitSize = ddsDataSize - offset;
+
+    return DDSResult::Ok;
+}
+
+
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+DDSResult GetDDSMipLayout(
+    const DDSTextureInfo& info,
+    DDSMipLayout* layout,
+    size_t* sliceSize
+)
+{
+    if (!info.bitData || !layout || !sliceSize)
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    if (!info.mipCount || !info.arraySize)
+    {
+        return DDSResult::InvalidData;
+    }
+
+    size_t offset = 0;
+    size_t w = info.width;
+    size_t h = info.height;
+    size_t d = info.depth;
+    for (size_t i = 0; i < info.mipCount; i++)
+    {
+        size_t NumBytes = 0;
+        size_t RowBytes = 0;
+        size_t NumRows = 0;
+        DDSGetSurfaceInfo(w, h, info.format, &NumBytes, &RowBytes, &NumRows);
+
+        layout[i].offset = offset;
+        layout[i].rowPitch = RowBytes;
+        layout[i].slicePitch = NumBytes;
+        layout[i].numRows = NumRows;
+        layout[i].width = w;
+        layout[i].height = h;
+        layout[i].depth = d;
+
+        if (!NumBytes)
+        {
+            return DDSResult::InvalidData;
+        }
+
+        // Written as a division so that a huge depth cannot overflow.
+        if (d > (info.bitSize - offset) / NumBytes)
+        {
+            return DDSResult::OutOfBounds;
+        }
+        offset += NumBytes * d;
+
+        w = (w > 1) ? w >> 1 : 1;
+        h = (h > 1) ? h >> 1 : 1;
+        d = (d > 1) ? d >> 1 : 1;
+    }
+
+    // Every slice has the same size, so one comparison covers all of them.
+    if (!offset || info.arraySize > info.bitSize / offset)
+    {
+        return DDSResult::OutOfBounds;
+    }
+
+    *sliceSize = offset;
+    return DDSResult::Ok;
+}
+
+
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+DDSResult GetDDSMipRange(
+    const DDSTextureInfo& info,
+    const DDSMipLayout* layout,
+    size_t maxsize,
+    DDSMipRange* mipRange
+)
+{
+    if (!layout || !mipRange)
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    memset(mipRange, 0, sizeof(*mipRange));
+
+    // Sizes only shrink down the chain, so the levels that are too large are
+    // always at the top.
+    size_t skipMip = 0;
+    if ((info.mipCount > 1) && maxsize)
+    {
+        while (skipMip < info.mipCount &&
+            (layout[skipMip].width > maxsize || layout[skipMip].height > maxsize || layout[skipMip].depth > maxsize))
+        {
+            ++skipMip;
+        }
+    }
+
+    if (skipMip == info.mipCount)
+    {
+        return DDSResult::InvalidData;
+    }
+
+    mipRange->skipMip = skipMip;
+    mipRange->mipCount = info.mipCount - skipMip;
+    mipRange->width = layout[skipMip].width;
+    mipRange->height = layout[skipMip].height;
+    mipRange->depth = layout[skipMip].depth;
+    return DDSResult::Ok;
+}
+
+
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+DDSResult GetDDSSubresources(
+    const DDSTextureInfo& info,
+    size_t maxsize,
+    DDSSubresource* subresources,
+    DDSMipRange* mipRange
+)
+{
+    if (!info.bitData || !subresources || !mipRange)
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    if (info.mipCount > DDS_REQ_MIP_LEVELS)
+    {
+        return DDSResult::InvalidData;
+    }
+
+    DDSMipLayout layout[DDS_REQ_MIP_LEVELS];
+    size_t sliceSize;
+    DDSResult result = GetDDSMipLayout(info, layout, &sliceSize);
+    if (result != DDSResult::Ok)
+    {
+        return result;
+    }
+
+    result = GetDDSMipRange(info, layout, maxsize, mipRange);
+    if (result != DDSResult::Ok)
+    {
+        return result;
+    }
+
+    // With the layout known and the bounds checked, each subresource is just
+    // an offset from its slice.
+    size_t index = 0;
+    const uint8_t* slice = info.bitData;
+    for (size_t j = 0; j < info.arraySize; j++, slice += sliceSize)
+    {
+        for (size_t i = mipRange->skipMip; i < info.mipCount; i++, index++)
+        {
+            subresources[index].data = slice + layout[i].offset;
+            subresources[index].rowPitch = layout[i].rowPitch;
+            subresources[index].slicePitch = layout[i].slicePitch;
+            subresources[index].numRows = layout[i].numRows;
+            subresources[index].width = layout[i].width;
+            subresources[index].height = layout[i].height;
+            subresources[index].depth = layout[i].depth;
+        }
+    }
+
+    return DDSResult::Ok;
+}
+
+
+//--------------------------------------------------------------------------------------
+// PageInDDSSlices stores what it reads here, so that the reads are not optimized away.
+static std::atomic<uint8_t> s_pageInSum;
+
+_Use_decl_annotations_
+DDSResult PageInDDSSlices(
+    const DDSTextureInfo& info,
+    size_t maxsize,
+    unsigned int threadCount,
+    DDSMipRange* mipRange
+)
+{
+    if (!info.bitData || !mipRange)
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    if (info.mipCount > DDS_REQ_MIP_LEVELS)
+    {
+        return DDSResult::InvalidData;
+    }
+
+    DDSMipLayout layout[DDS_REQ_MIP_LEVELS];
+    size_t sliceSize;
+    DDSResult result = GetDDSMipLayout(info, layout, &sliceSize);
+    if (result != DDSResult::Ok)
+    {
+        return result;
+    }
+
+    result = GetDDSMipRange(info, layout, maxsize, mipRange);
+    if (result != DDSResult::Ok)
+    {
+        return result;
+    }
+
+    // The kept levels of a slice are contiguous in the source. 4 KiB is the
+    // smallest page size of the platforms the sample runs on.
+    const size_t pageSize = 4096;
+    size_t keptOffset = layout[mipRange->skipMip].offset;
+    size_t keptSize = sliceSize - keptOffset;
+
+    auto pageInSlices = [&info, sliceSize, keptOffset, keptSize](size_t first, size_t last, uint8_t* sum)
+    {
+        uint8_t value = 0;
+        for (size_t j = first; j < last; j++)
+        {
+            const uint8_t* slice = info.bitData + j * sliceSize + keptOffset;
+            for (size_t offset = 0; offset < keptSize; offset += pageSize)
+            {
+                value ^= slice[offset];
+            }
+            value ^= slice[keptSize - 1];
+        }
+        *sum = value;
+    };
+
+    if (threadCount == 0)
+    {
+        threadCount = std::thread::hardware_concurrency();
+    }
+    if (threadCount > info.arraySize)
+    {
+        threadCount = static_cast<unsigned int>(info.arraySize);
+    }
+
+    if (threadCount <= 1)
+    {
+        uint8_t value;
+        pageInSlices(0, info.arraySize, &value);
+        s_pageInSum.store(value, std::memory_order_relaxed);
+        return DDSResult::Ok;
+    }
+
+    std::vector<uint8_t> sums(threadCount);
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (unsigned int t = 0; t + 1 < threadCount; t++)
+    {
+        threads.emplace_back(pageInSlices, info.arraySize * t / threadCount, info.arraySize * (t + 1) / threadCount, &sums[t]);
+    }
+    pageInSlices(info.arraySize * (threadCount - 1) / threadCount, info.arraySize, &sums[threadCount - 1]);
+
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+
+    uint8_t value = 0;
+    for (uint8_t threadSum : sums)
+    {
+        value ^= threadSum;
+    }
+    s_pageInSum.store(value, std::memory_order_relaxed);
+
+    return DDSResult::Ok;
+}
+
+
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+DDSResult WriteDDSHeaders(
+    const DDSTextureInfo& info,
+    uint8_t* header
+)
+{
+    if (!header)
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    if (DDSBitsPerPixel(info.format) == 0 || !info.width || !info.height || !info.depth ||
+        !info.mipCount || !info.arraySize || (info.isCubeMap && (info.arraySize % 6) != 0))
+    {
+        return DDSResult::InvalidData;
+    }
+
+    if (info.dimension != DDS_DIMENSION_TEXTURE1D &&
+        info.dimension != DDS_DIMENSION_TEXTURE2D &&
+        info.dimension != DDS_DIMENSION_TEXTURE3D)
+    {
+        return DDSResult::InvalidData;
+    }
+
+    size_t numBytes;
+    size_t rowBytes;
+    DDSGetSurfaceInfo(info.width, info.height, info.format, &numBytes, &rowBytes, nullptr);
+
+    // Block-compressed formats record the size of the top level, others its pitch.
+    bool compressed = (info.format >= DDS_FORMAT_BC1_TYPELESS && info.format <= DDS_FORMAT_BC5_SNORM) ||
+        (info.format >= DDS_FORMAT_BC6H_TYPELESS && info.format <= DDS_FORMAT_BC7_UNORM_SRGB);
+    bool volume = info.dimension == DDS_DIMENSION_TEXTURE3D;
+
+    DDS_HEADER ddsHeader;
+    memset(&ddsHeader, 0, sizeof(ddsHeader));
+    ddsHeader.size = sizeof(DDS_HEADER);
+    ddsHeader.flags = DDS_HEADER_FLAGS_TEXTURE |
+        (compressed ? DDS_HEADER_FLAGS_LINEARSIZE : DDS_HEADER_FLAGS_PITCH) |
+        (info.mipCount > 1 ? DDS_HEADER_FLAGS_MIPMAP : 0) |
+        (volume ? DDS_HEADER_FLAGS_VOLUME : 0);
+    ddsHeader.height = static_cast<uint32_t>(info.height);
+    ddsHeader.width = static_cast<uint32_t>(info.width);
+    ddsHeader.pitchOrLinearSize = static_cast<uint32_t>(compressed ? numBytes : rowBytes);
+    ddsHeader.depth = volume ? static_cast<uint32_t>(info.depth) : 0;
+    ddsHeader.mipMapCount = static_cast<uint32_t>(info.mipCount);
+    ddsHeader.ddspf.size = sizeof(DDS_PIXELFORMAT);
+    ddsHeader.ddspf.flags = DDS_FOURCC;
+    ddsHeader.ddspf.fourCC = MAKEFOURCC('D', 'X', '1', '0');
+    ddsHeader.caps = DDS_SURFACE_FLAGS_TEXTURE |
+        (info.mipCount > 1 ? DDS_SURFACE_FLAGS_MIPMAP : 0) |
+        (info.isCubeMap ? DDS_SURFACE_FLAGS_CUBEMAP : 0);
+    ddsHeader.caps2 = (info.isCubeMap ? DDS_CUBEMAP_ALLFACES : 0) | (volume ? DDS_FLAGS_VOLUME : 0);
+
+    DDS_HEADER_DXT10 d3d10ext;
+    memset(&d3d10ext, 0, sizeof(d3d10ext));
+    d3d10ext.dxgiFormat = info.format;
+    d3d10ext.resourceDimension = info.dimension;
+    d3d10ext.miscFlag = info.isCubeMap ? DDS_RESOURCE_MISC_TEXTURECUBE : 0;
+    d3d10ext.arraySize = static_cast<uint32_t>(info.isCubeMap ? info.arraySize / 6 : info.arraySize);
+    d3d10ext.miscFlags2 = info.alphaMode & DDS_MISC_FLAGS2_ALPHA_MODE_MASK;
+
+    uint32_t magic = DDS_MAGIC;
+    memcpy(header, &magic, sizeof(uint32_t));
+    memcpy(header + sizeof(uint32_t), &ddsHeader, sizeof(DDS_HEADER));
+    memcpy(header + sizeof(uint32_t) + sizeof(DDS_HEADER), &d3d10ext, sizeof(DDS_HEADER_DXT10));
+
+    static_assert(sizeof(uint32_t) + sizeof(DDS_HEADER) + sizeof(DDS_HEADER_DXT10) == DDS_WRITTEN_HEADER_SIZE,
+        "DDS_WRITTEN_HEADER_SIZE must match the written headers");
+    return DDSResult::Ok;
+}
@@ -0,0 +1,290 @@
+//--------------------------------------------------------------------------------------
+// File: DDSParser.h
+//
+// Device-independent DDS file parsing. Reads the DDS headers, validates them against
+// the Direct3D 11 resource limits and locates every subresource in the file, without
+// Windows headers or a Direct3D device. DDSTextureLoader builds on this to create
+// Direct3D 11 resources. Also writes the headers for textures built in memory.
+//
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Copyright (c) Microsoft Corporation. All rights reserved.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "BasicSal.h"
+
+//--------------------------------------------------------------------------------------
+// Pixel formats. The values match DXGI_FORMAT, so the two can be cast to each other.
+//--------------------------------------------------------------------------------------
+enum DDS_FORMAT : uint32_t
+{
+    DDS_FORMAT_UNKNOWN                      = 0,
+    DDS_FORMAT_R32G32B32A32_TYPELESS        = 1,
+    DDS_FORMAT_R32G32B32A32_FLOAT           = 2,
+    DDS_FORMAT_R32G32B32A32_UINT            = 3,
+    DDS_FORMAT_R32G32B32A32_SINT            = 4,
+    DDS_FORMAT_R32G32B32_TYPELESS           = 5,
+    DDS_FORMAT_R32G32B32_FLOAT              = 6,
+    DDS_FORMAT_R32G32B32_UINT               = 7,
+    DDS_FORMAT_R32G32B32_SINT               = 8,
+    DDS_FORMAT_R16G16B16A16_TYPELESS        = 9,
+    DDS_FORMAT_R16G16B16A16_FLOAT           = 10,
+    DDS_FORMAT_R16G16B16A16_UNORM           = 11,
+    DDS_FORMAT_R16G16B16A16_UINT            = 12,
+    DDS_FORMAT_R16G16B16A16_SNORM           = 13,
+    DDS_FORMAT_R16G16B16A16_SINT            = 14,
+    DDS_FORMAT_R32G32_TYPELESS              = 15,
+    DDS_FORMAT_R32G32_FLOAT                 = 16,
+    DDS_FORMAT_R32G32_UINT                  = 17,
+    DDS_FORMAT_R32G32_SINT                  = 18,
+    DDS_FORMAT_R32G8X24_TYPELESS            = 19,
+    DDS_FORMAT_D32_FLOAT_S8X24_UINT         = 20,
+    DDS_FORMAT_R32_FLOAT_X8X24_TYPELESS     = 21,
+    DDS_FORMAT_X32_TYPELESS_G8X24_UINT      = 22,
+    DDS_FORMAT_R10G10B10A2_TYPELESS         = 23,
+    DDS_FORMAT_R10G10B10A2_UNORM            = 24,
+    DDS_FORMAT_R10G10B10A2_UINT             = 25,
+    DDS_FORMAT_R11G11B10_FLOAT              = 26,
+    DDS_FORMAT_R8G8B8A8_TYPELESS            = 27,
+    DDS_FORMAT_R8G8B8A8_UNORM               = 28,
+    DDS_FORMAT_R8G8B8A8_UNORM_SRGB          = 29,
+    DDS_FORMAT_R8G8B8A8_UINT                = 30,
+    DDS_FORMAT_R8G8B8A8_SNORM               = 31,
+    DDS_FORMAT_R8G8B8A8_SINT                = 32,
+    DDS_FORMAT_R16G16_TYPELESS              = 33,
+    DDS_FORMAT_R16G16_FLOAT                 = 34,
+    DDS_FORMAT_R16G16_UNORM                 = 35,
+    DDS_FORMAT_R16G16_UINT                  = 36,
+    DDS_FORMAT_R16G16_SNORM                 = 37,
+    DDS_FORMAT_R16G16_SINT                  = 38,
+    DDS_FORMAT_R32_TYPELESS                 = 39,
+    DDS_FORMAT_D32_FLOAT                    = 40,
+    DDS_FORMAT_R32_FLOAT                    = 41,
+    DDS_FORMAT_R32_UINT                     = 42,
+    DDS_FORMAT_R32_SINT                     = 43,
+    DDS_FORMAT_R24G8_TYPELESS               = 44,
+    DDS_FORMAT_D24_UNORM_S8_UINT            = 45,
+    DDS_FORMAT_R24_UNORM_X8_TYPELESS        = 46,
+    DDS_FORMAT_X24_TYPELESS_G8_UINT         = 47,
+    DDS_FORMAT_R8G8_TYPELESS                = 48,
+    DDS_FORMAT_R8G8_UNORM                   = 49,
+    DDS_FORMAT_R8G8_UINT                    = 50,
+    DDS_FORMAT_R8G8_SNORM                   = 51,
+    DDS_FORMAT_R8G8_SINT                    = 52,
+    DDS_FORMAT_R16_TYPELESS                 = 53,
+    DDS_FORMAT_R16_FLOAT                    = 54,
+    DDS_FORMAT_D16_UNORM                    = 55,
+    DDS_FORMAT_R16_UNORM                    = 56,
+    DDS_FORMAT_R16_UINT                     = 57,
+    DDS_FORMAT_R16_SNORM                    = 58,
+    DDS_FORMAT_R16_SINT                     = 59,
+    DDS_FORMAT_R8_TYPELESS                  = 60,
+    DDS_FORMAT_R8_UNORM                     = 61,
+    DDS_FORMAT_R8_UINT                      = 62,
+    DDS_FORMAT_R8_SNORM                     = 63,
+    DDS_FORMAT_R8_SINT                      = 64,
+    DDS_FORMAT_A8_UNORM                     = 65,
+    DDS_FORMAT_R1_UNORM                     = 66,
+    DDS_FORMAT_R9G9B9E5_SHAREDEXP           = 67,
+    DDS_FORMAT_R8G8_B8G8_UNORM              = 68,
+    DDS_FORMAT_G8R8_G8B8_UNORM              = 69,
+    DDS_FORMAT_BC1_TYPELESS                 = 70,
+    DDS_FORMAT_BC1_UNORM                    = 71,
+    DDS_FORMAT_BC1_UNORM_SRGB               = 72,
+    DDS_FORMAT_BC2_TYPELESS                 = 73,
+    DDS_FORMAT_BC2_UNORM                    = 74,
+    DDS_FORMAT_BC2_UNORM_SRGB               = 75,
+    DDS_FORMAT_BC3_TYPELESS                 = 76,
+    DDS_FORMAT_BC3_UNORM                    = 77,
+    DDS_FORMAT_BC3_UNORM_SRGB               = 78,
+    DDS_FORMAT_BC4_TYPELESS                 = 79,
+    DDS_FORMAT_BC4_UNORM                    = 80,
+    DDS_FORMAT_BC4_SNORM                    = 81,
+    DDS_FORMAT_BC5_TYPELESS                 = 82,
+    DDS_FORMAT_BC5_UNORM                    = 83,
+    DDS_FORMAT_BC5_SNORM                    = 84,
+    DDS_FORMAT_B5G6R5_UNORM                 = 85,
+    DDS_FORMAT_B5G5R5A1_UNORM               = 86,
+    DDS_FORMAT_B8G8R8A8_UNORM               = 87,
+    DDS_FORMAT_B8G8R8X8_UNORM               = 88,
+    DDS_FORMAT_R10G10B10_XR_BIAS_A2_UNORM   = 89,
+    DDS_FORMAT_B8G8R8A8_TYPELESS            = 90,
+    DDS_FORMAT_B8G8R8A8_UNORM_SRGB          = 91,
+    DDS_FORMAT_B8G8R8X8_TYPELESS            = 92,
+    DDS_FORMAT_B8G8R8X8_UNORM_SRGB          = 93,
+    DDS_FORMAT_BC6H_TYPELESS                = 94,
+    DDS_FORMAT_BC6H_UF16                    = 95,
+    DDS_FORMAT_BC6H_SF16                    = 96,
+    DDS_FORMAT_BC7_TYPELESS                 = 97,
+    DDS_FORMAT_BC7_UNORM                    = 98,
+    DDS_FORMAT_BC7_UNORM_SRGB               = 99,
+    DDS_FORMAT_B4G4R4A4_UNORM               = 115,
+};
+
+//--------------------------------------------------------------------------------------
+// Resource dimensions. The values match D3D11_RESOURCE_DIMENSION.
+//--------------------------------------------------------------------------------------
+enum DDS_DIMENSION : uint32_t
+{
+    DDS_DIMENSION_UNKNOWN   = 0,
+    DDS_DIMENSION_TEXTURE1D = 2,
+    DDS_DIMENSION_TEXTURE2D = 3,
+    DDS_DIMENSION_TEXTURE3D = 4,
+};
+
+enum DDS_ALPHA_MODE
+{
+    DDS_ALPHA_MODE_UNKNOWN = 0,
+    DDS_ALPHA_MODE_STRAIGHT = 1,
+    DDS_ALPHA_MODE_PREMULTIPLIED = 2,
+    DDS_ALPHA_MODE_OPAQUE = 3,
+    DDS_ALPHA_MODE_CUSTOM = 4,
+};
+
+enum class DDSResult
+{
+    Ok,
+    InvalidArgument,    // a null pointer or an empty buffer was passed
+    InvalidData,        // the headers are malformed, unsupported or exceed the D3D 11 limits
+    OutOfBounds,        // the pixel data is shorter than the headers describe
+};
+
+//--------------------------------------------------------------------------------------
+// The properties of a DDS texture as described by its headers.
+//--------------------------------------------------------------------------------------
+struct DDSTextureInfo
+{
+    DDS_FORMAT format;
+    DDS_DIMENSION dimension;
+    size_t width;
+    size_t height;
+    size_t depth;
+    size_t mipCount;
+    size_t arraySize;               // six per cube for cube maps
+    bool isCubeMap;
+    DDS_ALPHA_MODE alphaMode;
+    const uint8_t* bitData;         // the pixel data that follows the headers
+    size_t bitSize;
+};
+
+//--------------------------------------------------------------------------------------
+// One mip level of one array slice within the pixel data.
+//--------------------------------------------------------------------------------------
+struct DDSSubresource
+{
+    const uint8_t* data;
+    size_t rowPitch;                // bytes per row of pixels or blocks
+    size_t slicePitch;              // bytes per depth slice
+    size_t numRows;                 // rows of pixels or blocks
+    size_t width;
+    size_t height;
+    size_t depth;
+};
+
+//--------------------------------------------------------------------------------------
+// The mip levels kept by GetDDSSubresources.
+//--------------------------------------------------------------------------------------
+struct DDSMipRange
+{
+    size_t skipMip;                 // levels dropped from the top of the chain
+    size_t mipCount;                // levels kept for each array slice
+    size_t width;                   // size of the largest kept level
+    size_t height;
+    size_t depth;
+};
+
+//--------------------------------------------------------------------------------------
+// Where one mip level sits within an array slice. Every slice has the same layout,
+// so slice j of mip i starts at bitData + j * sliceSize + layout[i].offset.
+//--------------------------------------------------------------------------------------
+struct DDSMipLayout
+{
+    size_t offset;                  // from the start of the slice
+    size_t rowPitch;                // bytes per row of pixels or blocks
+    size_t slicePitch;              // bytes per depth slice
+    size_t numRows;                 // rows of pixels or blocks
+    size_t width;
+    size_t height;
+    size_t depth;
+};
+
+size_t DDSBitsPerPixel(_In_ DDS_FORMAT fmt);
+
+void DDSGetSurfaceInfo(
+    _In_ size_t width,
+    _In_ size_t height,
+    _In_ DDS_FORMAT fmt,
+    _Out_opt_ size_t* outNumBytes,
+    _Out_opt_ size_t* outRowBytes,
+    _Out_opt_ size_t* outNumRows
+);
+
+DDS_FORMAT DDSMakeSRGB(_In_ DDS_FORMAT format);
+
+// Reads and validates the headers of a DDS file held in memory.
+DDSResult ParseDDS(
+    _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+    _In_ size_t ddsDataSize,
+    _Out_ DDSTextureInfo* info
+);
+
+// Locates the subresources of a parsed texture in slice-major order (all kept
+// mips of slice 0, then slice 1, ...). Levels larger than maxsize in any
+// dimension are skipped unless maxsize is 0 or the texture has a single mip.
+// subresources must hold info.mipCount * info.arraySize entries.
+DDSResult GetDDSSubresources(
+    _In_ const DDSTextureInfo& info,
+    _In_ size_t maxsize,
+    _Out_writes_(info.mipCount * info.arraySize) DDSSubresource* subresources,
+    _Out_ DDSMipRange* mipRange
+);
+
+// Computes the layout of each mip level of one array slice and the size of a whole
+// slice, once for all slices, and checks in one step that info.bitData holds every
+// slice. layout must hold info.mipCount entries.
+DDSResult GetDDSMipLayout(
+    _In_ const DDSTextureInfo& info,
+    _Out_writes_(info.mipCount) DDSMipLayout* layout,
+    _Out_ size_t* sliceSize
+);
+
+// Finds the levels GetDDSSubresources keeps for maxsize, from a layout made by
+// GetDDSMipLayout.
+DDSResult GetDDSMipRange(
+    _In_ const DDSTextureInfo& info,
+    _In_reads_(info.mipCount) const DDSMipLayout* layout,
+    _In_ size_t maxsize,
+    _Out_ DDSMipRange* mipRange
+);
+
+// Reads one byte from every page of the mips GetDDSSubresources would keep for
+// maxsize, splitting the array slices across threadCount threads (0 uses one per
+// hardware thread); the kept range is returned in mipRange. Nothing is copied: a
+// large texture array in a file mapping takes its page faults on several threads
+// at once, and can then be uploaded straight from the mapping.
+DDSResult PageInDDSSlices(
+    _In_ const DDSTextureInfo& info,
+    _In_ size_t maxsize,
+    _In_ unsigned int threadCount,
+    _Out_ DDSMipRange* mipRange
+);
+
+//--------------------------------------------------------------------------------------
+// The size of the headers written by WriteDDSHeaders: the magic value, DDS_HEADER and
+// the DX10 extension header, which together can describe every DDS_FORMAT.
+//--------------------------------------------------------------------------------------
+#define DDS_WRITTEN_HEADER_SIZE 148
+
+// Writes the headers of a DDS file for the texture described by info; bitData and
+// bitSize are ignored. The pixel data must follow in the order GetDDSSubresources
+// reads it, with the pitches that DDSGetSurfaceInfo reports.
+DDSResult WriteDDSHeaders(
+    _In_ const DDSTextureInfo& info,
+    _Out_writes_bytes_(DDS_WRITTEN_HEADER_SIZE) uint8_t* header
+);
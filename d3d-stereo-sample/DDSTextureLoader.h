@@ -44,3 +44,18 @@ void CreateDDSTextureFromMemoryEx(
     _Outptr_opt_ ID3D11ShaderResourceView** textureView,
     _Out_opt_ D2D1_ALPHA_MODE* alphaMode = nullptr
 );
+
+// Like CreateDDSTextureFromMemory, for texture arrays and cube maps whose data is
+// slow to touch, such as a file mapping that is not yet paged in. The slices are
+// first paged in on threadCount threads (0 uses one per hardware thread), so the
+// page faults are taken in parallel instead of one at a time inside the driver; the
+// texture is then created from ddsData without a copy. Textures with a single slice
+// are created directly.
+void CreateDDSTextureFromMemoryParallel(
+    _In_ ID3D11Device* d3dDevice,
+    _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+    _In_ size_t ddsDataSize,
+    _Outptr_opt_ ID3D11Resource** texture,
+    _Outptr_opt_ ID3D11ShaderResourceView** textureView,
+    _In_ unsigned int threadCount = 0
+);
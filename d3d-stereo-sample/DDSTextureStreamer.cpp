@@ -0,0 +1,343 @@
+#include "pch.h"
+#include "DDSTextureStreamer.h"
+#include "DDSTextureLoader.h"
+#include <algorithm>
+
+namespace
+{
+    // The smallest page size of the platforms the sample runs on; touching
+    // one byte per page is enough to fault the whole page in.
+    const size_t PrefetchStride = 4096;
+
+    const size_t DefaultMipTailSize = 64 * 1024;
+
+    void ThrowIfFailed(DDSResult result)
+    {
+        switch (result)
+        {
+        case DDSResult::Ok:
+            return;
+
+        case DDSResult::InvalidArgument:
+            throw winrt::hresult_invalid_argument();
+
+        case DDSResult::OutOfBounds:
+            throw winrt::hresult_out_of_bounds();
+
+        default:
+            throw winrt::hresult_error(E_FAIL);
+        }
+    }
+
+    // The bytes of one level across every array slice.
+    size_t GetLevelSize(
+        const DDSTextureInfo& info,
+        const std::vector<DDSSubresource>& subresources,
+        size_t mip)
+    {
+        return subresources[mip].slicePitch * subresources[mip].depth * info.arraySize;
+    }
+
+    void TouchPages(const uint8_t* data, size_t size)
+    {
+        volatile uint8_t sink = 0;
+        for (size_t offset = 0; offset < size; offset += PrefetchStride)
+        {
+            sink = sink + data[offset];
+        }
+        if (size > 0)
+        {
+            sink = sink + data[size - 1];
+        }
+    }
+}
+
+DDSTextureStreamer::DDSTextureStreamer(
+    _In_ ID3D11Device* d3dDevice,
+    _In_ ID3D11DeviceContext* d3dContext) :
+        m_mipTailSize(DefaultMipTailSize),
+        m_stopping(false)
+{
+    m_d3dDevice.copy_from(d3dDevice);
+    m_d3dContext.copy_from(d3dContext);
+    m_prefetchThread = std::thread([this] { PrefetchLoop(); });
+}
+
+DDSTextureStreamer::~DDSTextureStreamer()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_prefetchNeeded.notify_all();
+    m_prefetchThread.join();
+}
+
+void DDSTextureStreamer::SetMipTailSize(size_t mipTailSize)
+{
+    m_mipTailSize = mipTailSize;
+}
+
+void DDSTextureStreamer::LoadTexture(
+    MappedFile&& ddsFile,
+    _Outptr_opt_ ID3D11Resource** texture,
+    _Outptr_opt_ ID3D11ShaderResourceView** textureView)
+{
+    auto streamingTexture = std::make_unique<StreamingTexture>();
+    streamingTexture->file = std::move(ddsFile);
+
+    const uint8_t* ddsData = streamingTexture->file.Data();
+    size_t ddsDataSize = streamingTexture->file.Size();
+    StartStreaming(std::move(streamingTexture), ddsData, ddsDataSize, texture, textureView);
+}
+
+void DDSTextureStreamer::LoadTexture(
+    std::vector<byte>&& ddsData,
+    _Outptr_opt_ ID3D11Resource** texture,
+    _Outptr_opt_ ID3D11ShaderResourceView** textureView)
+{
+    auto streamingTexture = std::make_unique<StreamingTexture>();
+    streamingTexture->data = std::move(ddsData);
+
+    const uint8_t* data = streamingTexture->data.data();
+    size_t dataSize = streamingTexture->data.size();
+    StartStreaming(std::move(streamingTexture), data, dataSize, texture, textureView);
+}
+
+void DDSTextureStreamer::StartStreaming(
+    std::unique_ptr<StreamingTexture> streamingTexture,
+    _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+    _In_ size_t ddsDataSize,
+    _Outptr_opt_ ID3D11Resource** texture,
+    _Outptr_opt_ ID3D11ShaderResourceView** textureView)
+{
+    if (texture)
+    {
+        *texture = nullptr;
+    }
+    if (textureView)
+    {
+        *textureView = nullptr;
+    }
+
+    if (!ddsData || (!texture && !textureView))
+    {
+        throw winrt::hresult_invalid_argument();
+    }
+
+    StreamingTexture& entry = *streamingTexture;
+    ThrowIfFailed(ParseDDS(ddsData, ddsDataSize, &entry.info));
+
+    const DDSTextureInfo& info = entry.info;
+    if (info.dimension != DDS_DIMENSION_TEXTURE2D || info.mipCount <= 1)
+    {
+        CreateDDSTextureFromMemory(m_d3dDevice.get(), ddsData, ddsDataSize, texture, textureView);
+        return;
+    }
+
+    entry.subresources.resize(info.mipCount * info.arraySize);
+    ThrowIfFailed(GetDDSSubresources(info, 0, entry.subresources.data(), &entry.mipRange));
+
+    const DDSMipRange& mipRange = entry.mipRange;
+
+    // Create the whole chain without initial data; the levels are filled in
+    // by UploadLevel, smallest first.
+    D3D11_TEXTURE2D_DESC desc = {};
+    desc.Width = static_cast<UINT>(mipRange.width);
+    desc.Height = static_cast<UINT>(mipRange.height);
+    desc.MipLevels = static_cast<UINT>(mipRange.mipCount);
+    desc.ArraySize = static_cast<UINT>(info.arraySize);
+    desc.Format = static_cast<DXGI_FORMAT>(info.format);
+    desc.SampleDesc.Count = 1;
+    desc.SampleDesc.Quality = 0;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+    desc.MiscFlags = info.isCubeMap ? D3D11_RESOURCE_MISC_TEXTURECUBE : 0;
+
+    winrt::check_hresult(
+        m_d3dDevice->CreateTexture2D(&desc, nullptr, entry.texture.put())
+    );
+
+    if (textureView)
+    {
+        D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc = {};
+        srvDesc.Format = desc.Format;
+
+        if (info.isCubeMap)
+        {
+            if (info.arraySize > 6)
+            {
+                srvDesc.ViewDimension = D3D_SRV_DIMENSION_TEXTURECUBEARRAY;
+                srvDesc.TextureCubeArray.MipLevels = desc.MipLevels;
+                srvDesc.TextureCubeArray.NumCubes = static_cast<UINT>(info.arraySize / 6);
+            }
+            else
+            {
+                srvDesc.ViewDimension = D3D_SRV_DIMENSION_TEXTURECUBE;
+                srvDesc.TextureCube.MipLevels = desc.MipLevels;
+            }
+        }
+        else if (info.arraySize > 1)
+        {
+            srvDesc.ViewDimension = D3D_SRV_DIMENSION_TEXTURE2DARRAY;
+            srvDesc.Texture2DArray.MipLevels = desc.MipLevels;
+            srvDesc.Texture2DArray.ArraySize = static_cast<UINT>(info.arraySize);
+        }
+        else
+        {
+            srvDesc.ViewDimension = D3D_SRV_DIMENSION_TEXTURE2D;
+            srvDesc.Texture2D.MipLevels = desc.MipLevels;
+        }
+
+        winrt::check_hresult(
+            m_d3dDevice->CreateShaderResourceView(entry.texture.get(), &srvDesc, textureView)
+        );
+    }
+
+    // Upload the mip tail now. It is read straight from the source, which
+    // is small enough that paging it in on this thread is not a concern.
+    size_t mip = mipRange.mipCount - 1;
+    size_t tailBytes = UploadLevel(entry, mip);
+    while (mip > 0 && tailBytes + GetLevelSize(entry.info, entry.subresources, mip - 1) <= m_mipTailSize)
+    {
+        mip--;
+        tailBytes += UploadLevel(entry, mip);
+    }
+
+    entry.residentMip = mip;
+    entry.prefetchedMip = mip;
+    m_d3dContext->SetResourceMinLOD(entry.texture.get(), static_cast<FLOAT>(mip));
+
+    if (texture)
+    {
+        entry.texture.as<ID3D11Resource>().copy_to(texture);
+    }
+
+    if (mip > 0)
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_textures.push_back(std::move(streamingTexture));
+        }
+        m_prefetchNeeded.notify_one();
+    }
+}
+
+size_t DDSTextureStreamer::UploadLevel(StreamingTexture& streamingTexture, size_t mip)
+{
+    size_t mipCount = streamingTexture.mipRange.mipCount;
+    size_t bytes = 0;
+
+    for (size_t slice = 0; slice < streamingTexture.info.arraySize; slice++)
+    {
+        const DDSSubresource& subresource = streamingTexture.subresources[slice * mipCount + mip];
+        m_d3dContext->UpdateSubresource(
+            streamingTexture.texture.get(),
+            D3D11CalcSubresource(static_cast<UINT>(mip), static_cast<UINT>(slice), static_cast<UINT>(mipCount)),
+            nullptr,
+            subresource.data,
+            static_cast<UINT>(subresource.rowPitch),
+            static_cast<UINT>(subresource.slicePitch)
+        );
+        bytes += subresource.slicePitch * subresource.depth;
+    }
+
+    return bytes;
+}
+
+size_t DDSTextureStreamer::Update(size_t byteBudget)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    size_t uploaded = 0;
+    bool progress = true;
+    while (progress)
+    {
+        progress = false;
+        for (auto& streamingTexture : m_textures)
+        {
+            if (streamingTexture->prefetchedMip >= streamingTexture->residentMip)
+            {
+                continue;
+            }
+
+            size_t mip = streamingTexture->residentMip - 1;
+            size_t levelSize = GetLevelSize(streamingTexture->info, streamingTexture->subresources, mip);
+            if (uploaded > 0 && uploaded + levelSize > byteBudget)
+            {
+                continue;
+            }
+
+            uploaded += UploadLevel(*streamingTexture, mip);
+            streamingTexture->residentMip = mip;
+            m_d3dContext->SetResourceMinLOD(streamingTexture->texture.get(), static_cast<FLOAT>(mip));
+            progress = true;
+        }
+    }
+
+    // Fully resident textures no longer need their source data.
+    m_textures.erase(
+        std::remove_if(
+            m_textures.begin(),
+            m_textures.end(),
+            [](const std::unique_ptr<StreamingTexture>& streamingTexture) { return streamingTexture->residentMip == 0; }
+        ),
+        m_textures.end()
+    );
+
+    if (uploaded > 0)
+    {
+        m_prefetchNeeded.notify_one();
+    }
+
+    return uploaded;
+}
+
+bool DDSTextureStreamer::IsIdle()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_textures.empty();
+}
+
+void DDSTextureStreamer::PrefetchLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+
+    while (!m_stopping)
+    {
+        // Page in the next level of each texture that has uploaded the last
+        // one, so that Update never blocks on file I/O. Entries are only
+        // removed once fully resident, so the one being read stays alive
+        // while the lock is released.
+        StreamingTexture* next = nullptr;
+        for (auto& streamingTexture : m_textures)
+        {
+            if (streamingTexture->prefetchedMip == streamingTexture->residentMip &&
+                streamingTexture->prefetchedMip > 0)
+            {
+                next = streamingTexture.get();
+                break;
+            }
+        }
+
+        if (next == nullptr)
+        {
+            m_prefetchNeeded.wait(lock);
+            continue;
+        }
+
+        size_t mip = next->prefetchedMip - 1;
+        size_t mipCount = next->mipRange.mipCount;
+        size_t arraySize = next->info.arraySize;
+
+        lock.unlock();
+        for (size_t slice = 0; slice < arraySize; slice++)
+        {
+            const DDSSubresource& subresource = next->subresources[slice * mipCount + mip];
+            TouchPages(subresource.data, subresource.slicePitch * subresource.depth);
+        }
+        lock.lock();
+
+        next->prefetchedMip = mip;
+    }
+}
@@ -0,0 +1,91 @@
+#pragma once
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "DDSParser.h"
+#include "MappedFile.h"
+
+// Streams 2D DDS textures (including arrays and cube maps) smallest mip first.
+// LoadTexture creates the full mip chain but uploads only the mip tail, the
+// smallest levels that together fit in the tail size, and clamps sampling to
+// them with SetResourceMinLOD. The handle it returns is usable immediately.
+// A background thread pages in the source data for the next larger level of
+// each texture, and Update uploads those levels on the rendering thread,
+// within a per-call byte budget, lowering the clamp as each level lands.
+//
+// 1D and 3D textures and textures with a single mip have nothing to stream;
+// they are created in full by LoadTexture.
+class DDSTextureStreamer
+{
+public:
+    DDSTextureStreamer(
+        _In_ ID3D11Device* d3dDevice,
+        _In_ ID3D11DeviceContext* d3dContext
+    );
+    ~DDSTextureStreamer();
+
+    DDSTextureStreamer(const DDSTextureStreamer&) = delete;
+    DDSTextureStreamer& operator=(const DDSTextureStreamer&) = delete;
+
+    // The number of bytes of the smallest levels that LoadTexture uploads
+    // before returning. The smallest level is always uploaded.
+    void SetMipTailSize(size_t mipTailSize);
+
+    // The streamer keeps the source until the texture is fully resident.
+    void LoadTexture(
+        MappedFile&& ddsFile,
+        _Outptr_opt_ ID3D11Resource** texture,
+        _Outptr_opt_ ID3D11ShaderResourceView** textureView
+    );
+
+    void LoadTexture(
+        std::vector<byte>&& ddsData,
+        _Outptr_opt_ ID3D11Resource** texture,
+        _Outptr_opt_ ID3D11ShaderResourceView** textureView
+    );
+
+    // Uploads levels that the background thread has paged in, one level per
+    // texture per pass, until byteBudget would be exceeded. At least one level
+    // is uploaded when one is ready, so that levels larger than the budget
+    // still arrive. Must be called on the thread that owns the device
+    // context. Returns the number of bytes uploaded.
+    size_t Update(size_t byteBudget);
+
+    // True when every texture is fully resident.
+    bool IsIdle();
+
+private:
+    struct StreamingTexture
+    {
+        MappedFile file;
+        std::vector<byte> data;
+        DDSTextureInfo info;
+        DDSMipRange mipRange;
+        std::vector<DDSSubresource> subresources;
+        winrt::com_ptr<ID3D11Texture2D> texture;
+        size_t residentMip;         // the largest level that has been uploaded
+        size_t prefetchedMip;       // the largest level that has been paged in
+    };
+
+    winrt::com_ptr<ID3D11Device> m_d3dDevice;
+    winrt::com_ptr<ID3D11DeviceContext> m_d3dContext;
+    size_t m_mipTailSize;
+
+    std::vector<std::unique_ptr<StreamingTexture>> m_textures;
+    std::mutex m_mutex;
+    std::condition_variable m_prefetchNeeded;
+    std::thread m_prefetchThread;
+    bool m_stopping;
+
+    void StartStreaming(
+        std::unique_ptr<StreamingTexture> streamingTexture,
+        _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+        _In_ size_t ddsDataSize,
+        _Outptr_opt_ ID3D11Resource** texture,
+        _Outptr_opt_ ID3D11ShaderResourceView** textureView
+    );
+
+    size_t UploadLevel(StreamingTexture& streamingTexture, size_t mip);
+    void PrefetchLoop();
+};
@@ -0,0 +1,312 @@
+#include "FrustumCulling.h"
+#include <float.h>
+
+using namespace BasicMathSimd;
+
+namespace
+{
+    // A plane with a zero normal is the far plane at infinity; it is kept as
+    // (0, 0, 0, 1) so that every bound passes it.
+    float4 NormalizePlane(float4 plane)
+    {
+        float length = sqrtf(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        return (length > 0.0f) ? plane / length : float4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+
+    float4 Row(const float4x4& m, unsigned int index)
+    {
+        return float4(m[index][0], m[index][1], m[index][2], m[index][3]);
+    }
+
+    // Signed distance of a bound from a plane, where the bound is pushed
+    // towards the plane by its extents (boxes) or radius (spheres).
+    float PlaneDistance(const float4& plane, float3 center, float3 extents, float radius)
+    {
+        return plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w +
+            fabsf(plane.x) * extents.x + fabsf(plane.y) * extents.y + fabsf(plane.z) * extents.z +
+            radius;
+    }
+
+    // Tests blockCount bounds, where blockCount is WideWidth or less. Either
+    // the extents or the radius arrays are null.
+    size_t CullBlock(
+        const Frustum& frustum,
+        const float* centerX, const float* centerY, const float* centerZ,
+        const float* extentX, const float* extentY, const float* extentZ,
+        const float* radius,
+        uint8_t* visible,
+        size_t blockCount
+    )
+    {
+        size_t visibleCount = 0;
+
+        if (blockCount == WideWidth)
+        {
+            WideFloat cx = WideLoad(centerX);
+            WideFloat cy = WideLoad(centerY);
+            WideFloat cz = WideLoad(centerZ);
+            WideFloat ex = WideSplat(0.0f), ey = WideSplat(0.0f), ez = WideSplat(0.0f), r = WideSplat(0.0f);
+            if (extentX != nullptr)
+            {
+                ex = WideLoad(extentX);
+                ey = WideLoad(extentY);
+                ez = WideLoad(extentZ);
+            }
+            else
+            {
+                r = WideLoad(radius);
+            }
+
+            WideFloat minDistance = WideSplat(FLT_MAX);
+            for (const float4& plane : frustum.planes)
+            {
+                WideFloat distance = WideMad(
+                    WideSplat(plane.x), cx,
+                    WideMad(WideSplat(plane.y), cy, WideMad(WideSplat(plane.z), cz, WideAdd(WideSplat(plane.w), r)))
+                );
+                distance = WideMad(WideSplat(fabsf(plane.x)), ex, distance);
+                distance = WideMad(WideSplat(fabsf(plane.y)), ey, distance);
+                distance = WideMad(WideSplat(fabsf(plane.z)), ez, distance);
+                minDistance = WideMin(minDistance, distance);
+            }
+
+            float distances[WideWidth];
+            WideStore(distances, minDistance);
+            for (size_t i = 0; i < WideWidth; i++)
+            {
+                visible[i] = distances[i] >= 0.0f ? 1 : 0;
+                visibleCount += visible[i];
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < blockCount; i++)
+            {
+                float3 center(centerX[i], centerY[i], centerZ[i]);
+                float3 extents = extentX ? float3(extentX[i], extentY[i], extentZ[i]) : float3();
+                float r = radius ? radius[i] : 0.0f;
+
+                visible[i] = 1;
+                for (const float4& plane : frustum.planes)
+                {
+                    if (PlaneDistance(plane, center, extents, r) < 0.0f)
+                    {
+                        visible[i] = 0;
+                        break;
+                    }
+                }
+                visibleCount += visible[i];
+            }
+        }
+
+        return visibleCount;
+    }
+}
+
+Frustum ExtractFrustumPlanes(
+    const float4x4& viewProjection,
+    StereoDepthMode depthMode
+)
+{
+    // Clip space is bounded by -w <= x <= w, -w <= y <= w and 0 <= z <= w.
+    // Reverse-Z swaps the roles of the z >= 0 and z <= w planes.
+    float4 x = Row(viewProjection, 0);
+    float4 y = Row(viewProjection, 1);
+    float4 z = Row(viewProjection, 2);
+    float4 w = Row(viewProjection, 3);
+
+    Frustum frustum;
+    frustum.planes[Frustum::Left] = NormalizePlane(w + x);
+    frustum.planes[Frustum::Right] = NormalizePlane(w - x);
+    frustum.planes[Frustum::Bottom] = NormalizePlane(w + y);
+    frustum.planes[Frustum::Top] = NormalizePlane(w - y);
+    frustum.planes[Frustum::Near] = NormalizePlane(IsReverseZ(depthMode) ? w - z : z);
+    frustum.planes[Frustum::Far] = NormalizePlane(IsReverseZ(depthMode) ? z : w - z);
+    return frustum;
+}
+
+Frustum CreateStereoFrustum(
+    const StereoParameters& parameters,
+    float nearZ,
+    float farZ,
+    const float4x4& view
+)
+{
+    float yScale = 2.f * parameters.viewerDistance / parameters.viewportHeight;
+    float xScale = 2.f * parameters.viewerDistance / parameters.viewportWidth;
+    float shift = fabsf(parameters.interocularDistance / parameters.viewportWidth);
+
+    // At view depth d = -z, an eye with offset m sees x when
+    // -d <= xScale * x + m * (viewerDistance - d) <= d. Over both eyes,
+    // m = +/-shift, so the union satisfies
+    // xScale * |x| <= d + shift * |viewerDistance - d|. The right-hand side
+    // is convex in d, so the chord through d = nearZ and d = farZ lies on or
+    // above it and gives a plane that contains both frusta. Without a far
+    // plane, the line from d = nearZ with the steepest slope of the
+    // right-hand side bounds it instead.
+    bool infiniteFar = isinf(farZ);
+    float nearOffset = shift * fabsf(parameters.viewerDistance - nearZ);
+    float farOffset = infiniteFar ? 0.0f : shift * fabsf(parameters.viewerDistance - farZ);
+    float slope = infiniteFar ? shift : (farOffset - nearOffset) / (farZ - nearZ);
+    float offset = nearOffset - slope * nearZ;
+
+    float4 farPlane = infiniteFar ? float4(0.0f, 0.0f, 0.0f, 1.0f) : float4(0.0f, 0.0f, 1.0f, farZ);
+
+    // View-space planes; d = -z because the view looks down -z.
+    float4 planes[Frustum::PlaneCount] =
+    {
+        float4(xScale, 0.0f, -(1.0f + slope), offset),  // left
+        float4(-xScale, 0.0f, -(1.0f + slope), offset), // right
+        float4(0.0f, yScale, -1.0f, 0.0f),              // bottom
+        float4(0.0f, -yScale, -1.0f, 0.0f),             // top
+        float4(0.0f, 0.0f, -1.0f, -nearZ),              // near
+        farPlane,                                       // far
+    };
+
+    // A plane p in view space is transpose(view) * p in world space.
+    float4x4 viewTranspose = transpose(view);
+
+    Frustum frustum;
+    for (int i = 0; i < Frustum::PlaneCount; i++)
+    {
+        frustum.planes[i] = NormalizePlane(mul(viewTranspose, planes[i]));
+    }
+    return frustum;
+}
+
+bool IsVisible(const Frustum& frustum, const Sphere& sphere)
+{
+    for (const float4& plane : frustum.planes)
+    {
+        if (PlaneDistance(plane, sphere.center, float3(), sphere.radius) < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool IsVisible(const Frustum& frustum, const AABB& box)
+{
+    for (const float4& plane : frustum.planes)
+    {
+        if (PlaneDistance(plane, box.center, box.extents, 0.0f) < 0.0f)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t CullSpheres(
+    const Frustum& frustum,
+    _In_reads_(count) const Sphere* spheres,
+    _Out_writes_(count) uint8_t* visible,
+    size_t count
+)
+{
+    float x[WideWidth], y[WideWidth], z[WideWidth], r[WideWidth];
+    size_t visibleCount = 0;
+
+    for (size_t i = 0; i < count; i += WideWidth)
+    {
+        size_t blockCount = (count - i < WideWidth) ? count - i : WideWidth;
+        for (size_t j = 0; j < blockCount; j++)
+        {
+            x[j] = spheres[i + j].center.x;
+            y[j] = spheres[i + j].center.y;
+            z[j] = spheres[i + j].center.z;
+            r[j] = spheres[i + j].radius;
+        }
+        visibleCount += CullBlock(frustum, x, y, z, nullptr, nullptr, nullptr, r, visible + i, blockCount);
+    }
+
+    return visibleCount;
+}
+
+size_t CullSpheres(
+    const Frustum& frustum,
+    _In_reads_(count) const float* centerX,
+    _In_reads_(count) const float* centerY,
+    _In_reads_(count) const float* centerZ,
+    _In_reads_(count) const float* radius,
+    _Out_writes_(count) uint8_t* visible,
+    size_t count
+)
+{
+    size_t visibleCount = 0;
+
+    for (size_t i = 0; i < count; i += WideWidth)
+    {
+        size_t blockCount = (count - i < WideWidth) ? count - i : WideWidth;
+        visibleCount += CullBlock(
+            frustum,
+            centerX + i, centerY + i, centerZ + i,
+            nullptr, nullptr, nullptr,
+            radius + i,
+            visible + i,
+            blockCount
+        );
+    }
+
+    return visibleCount;
+}
+
+size_t CullAABBs(
+    const Frustum& frustum,
+    _In_reads_(count) const AABB* boxes,
+    _Out_writes_(count) uint8_t* visible,
+    size_t count
+)
+{
+    float cx[WideWidth], cy[WideWidth], cz[WideWidth];
+    float ex[WideWidth], ey[WideWidth], ez[WideWidth];
+    size_t visibleCount = 0;
+
+    for (size_t i = 0; i < count; i += WideWidth)
+    {
+        size_t blockCount = (count - i < WideWidth) ? count - i : WideWidth;
+        for (size_t j = 0; j < blockCount; j++)
+        {
+            cx[j] = boxes[i + j].center.x;
+            cy[j] = boxes[i + j].center.y;
+            cz[j] = boxes[i + j].center.z;
+            ex[j] = boxes[i + j].extents.x;
+            ey[j] = boxes[i + j].extents.y;
+            ez[j] = boxes[i + j].extents.z;
+        }
+        visibleCount += CullBlock(frustum, cx, cy, cz, ex, ey, ez, nullptr, visible + i, blockCount);
+    }
+
+    return visibleCount;
+}
+
+size_t CullAABBs(
+    const Frustum& frustum,
+    _In_reads_(count) const float* centerX,
+    _In_reads_(count) const float* centerY,
+    _In_reads_(count) const float* centerZ,
+    _In_reads_(count) const float* extentX,
+    _In_reads_(count) const float* extentY,
+    _In_reads_(count) const float* extentZ,
+    _Out_writes_(count) uint8_t* visible,
+    size_t count
+)
+{
+    size_t visibleCount = 0;
+
+    for (size_t i = 0; i < count; i += WideWidth)
+    {
+        size_t blockCount = (count - i < WideWidth) ? count - i : WideWidth;
+        visibleCount += CullBlock(
+            frustum,
+            centerX + i, centerY + i, centerZ + i,
+            extentX + i, extentY + i, extentZ + i,
+            nullptr,
+            visible + i,
+            blockCount
+        );
+    }
+
+    return visibleCount;
+}
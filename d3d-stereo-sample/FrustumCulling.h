@@ -0,0 +1,104 @@
+#pragma once
+#include <stdint.h>
+#include "BasicMath.h"
+#include "BasicSal.h"
+#include "StereoDepth.h"
+#include "StereoParameters.h"
+
+// An axis-aligned bounding box stored as its center and half-size.
+struct AABB
+{
+    float3 center;
+    float3 extents;
+};
+
+struct Sphere
+{
+    float3 center;
+    float radius;
+};
+
+// Six planes (a, b, c, d) with unit normals pointing into the volume, so that
+// a point p is inside when dot(plane.xyz, p) + plane.w >= 0 for every plane.
+struct Frustum
+{
+    enum Plane
+    {
+        Left,
+        Right,
+        Bottom,
+        Top,
+        Near,
+        Far,
+        PlaneCount
+    };
+
+    float4 planes[PlaneCount];
+};
+
+// Extracts the frustum planes of a combined view-projection matrix that maps
+// depth to [0, 1] (Direct3D convention). The matrix is for column vectors, as
+// in BasicMath; pass the transpose of a DirectXMath matrix, which is what the
+// sample already stores in its constant buffer. The planes are in the space
+// that the matrix transforms from. With an infinite far plane the far plane
+// is returned as (0, 0, 0, 1), which every bound passes.
+Frustum ExtractFrustumPlanes(
+    const float4x4& viewProjection,
+    StereoDepthMode depthMode = StereoDepthMode::Standard
+);
+
+// Builds one frustum that contains both eye frusta of the projections made by
+// StereoProjectionFieldOfViewRightHand, so that the scene can be culled once
+// for both eyes. The eye frusta cross at the screen plane, which makes their
+// union non-convex; the left and right planes here are the tightest planes
+// that bound it between nearZ and farZ. farZ may be INFINITY for the infinite
+// depth modes. view is the world-to-view matrix for column vectors, and the
+// planes are returned in world space.
+Frustum CreateStereoFrustum(
+    const StereoParameters& parameters,
+    float nearZ,
+    float farZ,
+    const float4x4& view
+);
+
+bool IsVisible(const Frustum& frustum, const Sphere& sphere);
+bool IsVisible(const Frustum& frustum, const AABB& box);
+
+// Batched visibility tests. Each writes visible[i] = 1 when bound i may be
+// inside the frustum and 0 when it is certainly outside, and returns the
+// number of visible bounds. The SoA forms take one array per component.
+size_t CullSpheres(
+    const Frustum& frustum,
+    _In_reads_(count) const Sphere* spheres,
+    _Out_writes_(count) uint8_t* visible,
+    size_t count
+);
+
+size_t CullSpheres(
+    const Frustum& frustum,
+    _In_reads_(count) const float* centerX,
+    _In_reads_(count) const float* centerY,
+    _In_reads_(count) const float* centerZ,
+    _In_reads_(count) const float* radius,
+    _Out_writes_(count) uint8_t* visible,
+    size_t count
+);
+
+size_t CullAABBs(
+    const Frustum& frustum,
+    _In_reads_(count) const AABB* boxes,
+    _Out_writes_(count) uint8_t* visible,
+    size_t count
+);
+
+size_t CullAABBs(
+    const Frustum& frustum,
+    _In_reads_(count) const float* centerX,
+    _In_reads_(count) const float* centerY,
+    _In_reads_(count) const float* centerZ,
+    _In_reads_(count) const float* extentX,
+    _In_reads_(count) const float* extentY,
+    _In_reads_(count) const float* extentZ,
+    _Out_writes_(count) uint8_t* visible,
+    size_t count
+);
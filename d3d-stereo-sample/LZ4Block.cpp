@@ -0,0 +1,290 @@
+//--------------------------------------------------------------------------------------
+// File: LZ4Block.cpp
+//
+// A compressor and decompressor for the LZ4 block format.
+//
+// A block is a series of sequences, each a token byte (literal length in the high
+// nibble, match length minus 4 in the low), extra length bytes for either length
+// when its nibble is 15, the literals, and a 16-bit little-endian offset back to
+// the match. The final sequence has literals only. The format requires the last 5
+// bytes to be literals and the last match to start at least 12 bytes from the end.
+//--------------------------------------------------------------------------------------
+
+#include "LZ4Block.h"
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    const size_t MinMatch = 4;
+    const size_t LastLiterals = 5;
+    const size_t MatchStartLimit = 12;
+    const size_t MaxOffset = 65535;
+    const unsigned int HashBits = 16;
+
+    uint32_t Read32(const uint8_t* p)
+    {
+        uint32_t value;
+        memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    // Hashes the five bytes at p. Five bytes separate texels of 32-bit images
+    // whose fourth byte rarely changes far better than four do. Reads eight
+    // bytes, which the match start limit keeps inside the source.
+    uint32_t Hash(const uint8_t* p)
+    {
+        uint64_t value;
+        memcpy(&value, p, sizeof(value));
+        return static_cast<uint32_t>(((value << 24) * 889523592379ull) >> (64 - HashBits));
+    }
+
+    // Writes a length of 15 or more as the run of extra bytes that follows its
+    // token nibble.
+    uint8_t* WriteLength(uint8_t* out, size_t length)
+    {
+        for (length -= 15; length >= 255; length -= 255)
+        {
+            *out++ = 255;
+        }
+        *out++ = static_cast<uint8_t>(length);
+        return out;
+    }
+
+    bool ReadLength(const uint8_t*& in, const uint8_t* end, size_t* length)
+    {
+        uint8_t extra;
+        do
+        {
+            if (in >= end)
+            {
+                return false;
+            }
+            extra = *in++;
+            *length += extra;
+        } while (extra == 255);
+        return true;
+    }
+
+    // Emits literals [literals, literals + literalCount) and, unless matchLength is
+    // 0, a match. Returns nullptr when the sequence does not fit.
+    uint8_t* WriteSequence(
+        uint8_t* out,
+        uint8_t* outEnd,
+        const uint8_t* literals,
+        size_t literalCount,
+        size_t offset,
+        size_t matchLength)
+    {
+        // Token, worst-case length bytes, literals and offset.
+        size_t worstCase = 1 + (literalCount / 255 + 1) + literalCount + 2 + (matchLength / 255 + 1);
+        if (worstCase > static_cast<size_t>(outEnd - out))
+        {
+            return nullptr;
+        }
+
+        uint8_t* token = out++;
+        *token = static_cast<uint8_t>((literalCount >= 15 ? 15 : literalCount) << 4);
+        if (literalCount >= 15)
+        {
+            out = WriteLength(out, literalCount);
+        }
+        if (literalCount)
+        {
+            memcpy(out, literals, literalCount);
+            out += literalCount;
+        }
+
+        if (matchLength)
+        {
+            *out++ = static_cast<uint8_t>(offset);
+            *out++ = static_cast<uint8_t>(offset >> 8);
+
+            size_t code = matchLength - MinMatch;
+            *token |= static_cast<uint8_t>(code >= 15 ? 15 : code);
+            if (code >= 15)
+            {
+                out = WriteLength(out, code);
+            }
+        }
+        return out;
+    }
+}
+
+//--------------------------------------------------------------------------------------
+size_t LZ4CompressBound(_In_ size_t sourceSize)
+{
+    return sourceSize + sourceSize / 255 + 16;
+}
+
+//--------------------------------------------------------------------------------------
+size_t LZ4CompressBlock(
+    _In_reads_bytes_(sourceSize) const uint8_t* source,
+    _In_ size_t sourceSize,
+    _Out_writes_bytes_(destinationCapacity) uint8_t* destination,
+    _In_ size_t destinationCapacity
+)
+{
+    if ((!source && sourceSize) || !destination)
+    {
+        return 0;
+    }
+
+    uint8_t* out = destination;
+    uint8_t* outEnd = destination + destinationCapacity;
+    size_t anchor = 0;
+
+    if (sourceSize > MatchStartLimit)
+    {
+        // Positions are stored plus one so that zero means empty.
+        std::vector<uint32_t> table(size_t(1) << HashBits, 0);
+
+        size_t matchStartEnd = sourceSize - MatchStartLimit;
+        size_t matchEnd = sourceSize - LastLiterals;
+        size_t position = 0;
+        size_t misses = 0;
+
+        while (position < matchStartEnd)
+        {
+            uint32_t sequence = Read32(source + position);
+            uint32_t& slot = table[Hash(source + position)];
+            size_t candidate = slot;
+            slot = static_cast<uint32_t>(position + 1);
+
+            if (candidate == 0 || position - (candidate - 1) > MaxOffset || Read32(source + candidate - 1) != sequence)
+            {
+                // Step faster through data that keeps failing to match.
+                position += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+
+            size_t match = candidate - 1;
+            size_t length = MinMatch;
+            while (position + length < matchEnd && source[match + length] == source[position + length])
+            {
+                length++;
+            }
+
+            // Pull the match back over literals that also match.
+            while (position > anchor && match > 0 && source[position - 1] == source[match - 1])
+            {
+                position--;
+                match--;
+                length++;
+            }
+
+            out = WriteSequence(out, outEnd, source + anchor, position - anchor, position - match, length);
+            if (!out)
+            {
+                return 0;
+            }
+
+            position += length;
+            anchor = position;
+
+            // Index a position inside the match so that runs chain together.
+            if (position - 2 < matchStartEnd)
+            {
+                table[Hash(source + position - 2)] = static_cast<uint32_t>(position - 2 + 1);
+            }
+        }
+    }
+
+    out = WriteSequence(out, outEnd, source + anchor, sourceSize - anchor, 0, 0);
+    if (!out)
+    {
+        return 0;
+    }
+    return static_cast<size_t>(out - destination);
+}
+
+//--------------------------------------------------------------------------------------
+bool LZ4DecompressBlock(
+    _In_reads_bytes_(sourceSize) const uint8_t* source,
+    _In_ size_t sourceSize,
+    _Out_writes_bytes_(destinationSize) uint8_t* destination,
+    _In_ size_t destinationSize
+)
+{
+    if (!source || !sourceSize || (!destination && destinationSize))
+    {
+        return false;
+    }
+
+    const uint8_t* in = source;
+    const uint8_t* inEnd = source + sourceSize;
+    uint8_t* out = destination;
+    uint8_t* outEnd = destination + destinationSize;
+
+    for (;;)
+    {
+        if (in >= inEnd)
+        {
+            return false;
+        }
+        uint8_t token = *in++;
+
+        size_t literalCount = token >> 4;
+        if (literalCount == 15 && !ReadLength(in, inEnd, &literalCount))
+        {
+            return false;
+        }
+        if (literalCount > static_cast<size_t>(inEnd - in) || literalCount > static_cast<size_t>(outEnd - out))
+        {
+            return false;
+        }
+        // An empty block decodes into a null destination, which memcpy must
+        // not be given even for zero bytes.
+        if (literalCount)
+        {
+            memcpy(out, in, literalCount);
+            in += literalCount;
+            out += literalCount;
+        }
+
+        // The last sequence ends with its literals.
+        if (in == inEnd)
+        {
+            return out == outEnd;
+        }
+
+        if (inEnd - in < 2)
+        {
+            return false;
+        }
+        size_t offset = in[0] | (in[1] << 8);
+        in += 2;
+        if (offset == 0 || offset > static_cast<size_t>(out - destination))
+        {
+            return false;
+        }
+
+        size_t matchLength = token & 15;
+        if (matchLength == 15 && !ReadLength(in, inEnd, &matchLength))
+        {
+            return false;
+        }
+        matchLength += MinMatch;
+        if (matchLength > static_cast<size_t>(outEnd - out))
+        {
+            return false;
+        }
+
+        // Overlapping matches repeat the bytes just written, so they are copied
+        // forward one byte at a time.
+        const uint8_t* match = out - offset;
+        if (offset >= matchLength)
+        {
+            memcpy(out, match, matchLength);
+            out += matchLength;
+        }
+        else
+        {
+            for (size_t i = 0; i < matchLength; i++)
+            {
+                *out++ = match[i];
+            }
+        }
+    }
+}
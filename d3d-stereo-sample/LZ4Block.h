@@ -0,0 +1,37 @@
+//--------------------------------------------------------------------------------------
+// File: LZ4Block.h
+//
+// A compressor and decompressor for the LZ4 block format, for asset data that is
+// written once offline and decompressed at load time. Blocks are compatible with the
+// reference implementation's LZ4_compress_default and LZ4_decompress_safe; the
+// compressor is a plain greedy matcher, which trades some ratio for simplicity.
+// Needs no Windows headers.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include "BasicSal.h"
+
+// The largest compressed size of sourceSize bytes, for sizing the destination of
+// LZ4CompressBlock. Incompressible data grows by a little under 0.4%.
+size_t LZ4CompressBound(_In_ size_t sourceSize);
+
+// Compresses source into destination and returns the compressed size, or 0 if
+// destination is too small (it never is at LZ4CompressBound bytes).
+size_t LZ4CompressBlock(
+    _In_reads_bytes_(sourceSize) const uint8_t* source,
+    _In_ size_t sourceSize,
+    _Out_writes_bytes_(destinationCapacity) uint8_t* destination,
+    _In_ size_t destinationCapacity
+);
+
+// Decompresses a block that must expand to exactly destinationSize bytes. Returns
+// false for malformed or truncated input, without reading or writing out of bounds.
+bool LZ4DecompressBlock(
+    _In_reads_bytes_(sourceSize) const uint8_t* source,
+    _In_ size_t sourceSize,
+    _Out_writes_bytes_(destinationSize) uint8_t* destination,
+    _In_ size_t destinationSize
+);
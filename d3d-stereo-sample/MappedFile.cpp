@@ -0,0 +1,172 @@
+#include "MappedFile.h"
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile() :
+    m_data(nullptr),
+    m_size(0),
+    m_mapped(false)
+{
+}
+
+MappedFile::MappedFile(
+    _In_ std::shared_ptr<const void> owner,
+    _In_reads_bytes_(size) const uint8_t* data,
+    _In_ size_t size) :
+    m_data(owner ? data : nullptr),
+    m_size(owner ? size : 0),
+    m_owner(std::move(owner)),
+    m_mapped(false)
+{
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept :
+    m_data(std::exchange(other.m_data, nullptr)),
+    m_size(std::exchange(other.m_size, 0)),
+    m_owner(std::move(other.m_owner)),
+    m_mapped(std::exchange(other.m_mapped, false))
+{
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+        m_owner = std::move(other.m_owner);
+        m_mapped = std::exchange(other.m_mapped, false);
+    }
+    return *this;
+}
+
+#if defined(_WIN32)
+
+bool MappedFile::Open(_In_z_ const PathChar* path)
+{
+    Close();
+
+    CREATEFILE2_EXTENDED_PARAMETERS extendedParams = {};
+    extendedParams.dwSize = sizeof(CREATEFILE2_EXTENDED_PARAMETERS);
+    extendedParams.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+    extendedParams.dwSecurityQosFlags = SECURITY_ANONYMOUS;
+
+    // No access pattern hint: views are read out of order, as when
+    // DDSTextureStreamer uploads the mip tail first and the top mips later.
+    HANDLE file = CreateFile2(path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, &extendedParams);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart <= 0 ||
+        static_cast<unsigned long long>(fileSize.QuadPart) > SIZE_MAX)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    // The view keeps its own reference to the section, and the section to
+    // the file, so both handles can be closed as soon as the view exists.
+    HANDLE mapping = CreateFileMappingFromApp(file, nullptr, PAGE_READONLY, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr)
+    {
+        return false;
+    }
+
+    void* view = MapViewOfFileFromApp(mapping, FILE_MAP_READ, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr)
+    {
+        return false;
+    }
+
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<size_t>(fileSize.QuadPart);
+    m_mapped = true;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    // Only views created by Open are unmapped; the memory of other views
+    // belongs to their owner.
+    if (m_mapped)
+    {
+        UnmapViewOfFile(m_data);
+    }
+    m_owner.reset();
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
+
+#else
+
+bool MappedFile::Open(_In_z_ const PathChar* path)
+{
+    Close();
+
+    int file = open(path, O_RDONLY);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat fileInfo;
+    if (fstat(file, &fileInfo) != 0 || fileInfo.st_size <= 0 ||
+        static_cast<unsigned long long>(fileInfo.st_size) > SIZE_MAX)
+    {
+        close(file);
+        return false;
+    }
+
+    // The mapping holds its own reference to the file.
+    size_t size = static_cast<size_t>(fileInfo.st_size);
+    void* view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    close(file);
+    if (view == MAP_FAILED)
+    {
+        return false;
+    }
+
+    // No madvise hint: views are read out of order, as when
+    // DDSTextureStreamer uploads the mip tail first and the top mips later,
+    // and MADV_SEQUENTIAL would let the kernel drop pages it revisits.
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = size;
+    m_mapped = true;
+    return true;
+}
+
+void MappedFile::Close()
+{
+    // Only views created by Open are unmapped; the memory of other views
+    // belongs to their owner.
+    if (m_mapped)
+    {
+        munmap(const_cast<uint8_t*>(m_data), m_size);
+    }
+    m_owner.reset();
+    m_data = nullptr;
+    m_size = 0;
+    m_mapped = false;
+}
+
+#endif
@@ -0,0 +1,56 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <memory>
+#include "BasicSal.h"
+
+// A read-only view of a whole file, mapped into the address space instead of
+// being read into a heap buffer. Pages are brought in by the OS as they are
+// touched, so a loader that parses the view in place never copies the file.
+// The view stays valid until Close is called or the object is destroyed.
+//
+// A MappedFile can also stand for part of a file that is mapped elsewhere, such
+// as one entry of an asset pack, or for data unpacked into memory. It then keeps
+// whatever owns that memory alive instead of owning a mapping itself, so code
+// that takes a MappedFile does not need to know where its bytes came from.
+// Such a view needs an owner; without one the view is left empty, since
+// nothing would keep its memory valid.
+class MappedFile
+{
+public:
+#if defined(_WIN32)
+    typedef wchar_t PathChar;
+#else
+    typedef char PathChar;
+#endif
+
+    MappedFile();
+    MappedFile(
+        _In_ std::shared_ptr<const void> owner,
+        _In_reads_bytes_(size) const uint8_t* data,
+        _In_ size_t size
+    );
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Maps the file at path, closing any view this object already holds.
+    // Returns false if the file cannot be opened, is empty, or cannot be
+    // mapped.
+    bool Open(_In_z_ const PathChar* path);
+    void Close();
+
+    const uint8_t* Data() const { return m_data; }
+    size_t Size() const { return m_size; }
+    bool IsOpen() const { return m_data != nullptr; }
+
+private:
+    const uint8_t* m_data;
+    size_t m_size;
+    std::shared_ptr<const void> m_owner;
+    bool m_mapped;      // whether Open mapped m_data, so that Close unmaps it
+};
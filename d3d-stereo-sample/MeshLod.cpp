@@ -0,0 +1,49 @@
+#include "MeshLod.h"
+
+float ComputeLodScale(
+    const StereoParameters& parameters,
+    float viewportHeightInPixels
+)
+{
+    // Clip space y spans 2 over the viewport height, and the projection
+    // scales y by 2 * viewerDistance / viewportHeight before the divide by
+    // depth.
+    return parameters.viewerDistance / parameters.viewportHeight * viewportHeightInPixels;
+}
+
+float ComputeLodDepth(
+    const float4x4& view,
+    const Sphere& bounds,
+    float minDepth
+)
+{
+    // The view looks down -z.
+    float4 center = mul(view, float4(bounds.center.x, bounds.center.y, bounds.center.z, 1.0f));
+    float depth = -center.z - bounds.radius;
+    return (depth > minDepth) ? depth : minDepth;
+}
+
+uint32_t SelectSubmeshLod(
+    _In_reads_(submeshCount) const BasicMeshSubmesh* submeshes,
+    uint32_t submeshCount,
+    uint32_t baseSubmesh,
+    float lodScale,
+    float depth,
+    float worldScale,
+    float maxPixelError
+)
+{
+    // The largest error, in mesh units, that stays within maxPixelError.
+    float allowedError = maxPixelError * depth / (lodScale * worldScale);
+
+    uint32_t selected = baseSubmesh;
+    for (uint32_t s = baseSubmesh + 1; s < submeshCount && submeshes[s].lodError != 0.0f; s++)
+    {
+        if (submeshes[s].lodError > allowedError)
+        {
+            break;
+        }
+        selected = s;
+    }
+    return selected;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <stdint.h>
+#include "BasicMath.h"
+#include "BasicMeshFormat.h"
+#include "FrustumCulling.h"
+#include "StereoParameters.h"
+
+// Runtime level-of-detail selection for meshes with levels made by
+// GenerateBasicMeshLods. A level is chosen from how large its error would
+// look on screen: error * lodScale / depth pixels, where depth is the view
+// depth of the object.
+
+// The number of pixels one world unit covers at a view depth of 1 with the
+// projections of StereoProjectionFieldOfViewRightHand. The two eyes only
+// differ by a horizontal shear, so this is the same for both, and selecting
+// once per object gives both eyes the same geometry; eyes that disagree on
+// the level would show it as shimmer in depth.
+float ComputeLodScale(
+    const StereoParameters& parameters,
+    float viewportHeightInPixels
+);
+
+// The view depth of the nearest point of a bounding sphere, for a
+// right-handed world-to-view matrix for column vectors, as CreateStereoFrustum
+// takes. Spheres around or behind the viewer get minDepth.
+float ComputeLodDepth(
+    const float4x4& view,
+    const Sphere& bounds,
+    float minDepth
+);
+
+// Returns the index of the submesh to draw in place of the full-detail
+// submesh at baseSubmesh: the coarsest of its levels whose error, times
+// worldScale (world units per mesh unit, from the model matrix), covers at
+// most maxPixelError pixels at depth. Returns baseSubmesh when no level is
+// coarse enough, or when it has none.
+uint32_t SelectSubmeshLod(
+    _In_reads_(submeshCount) const BasicMeshSubmesh* submeshes,
+    uint32_t submeshCount,
+    uint32_t baseSubmesh,
+    float lodScale,
+    float depth,
+    float worldScale,
+    float maxPixelError
+);
@@ -0,0 +1,520 @@
+#include "MeshOptimizer.h"
+#include "BasicMath.h"
+#include <string.h>
+#include <algorithm>
+
+namespace
+{
+    const uint32_t NotRemapped = UINT32_MAX;
+
+    // The triangles that use each vertex, in compressed rows: the triangles of
+    // vertex v are triangles[offsets[v]] up to triangles[offsets[v + 1]].
+    struct VertexTriangles
+    {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> triangles;
+
+        VertexTriangles(const uint32_t* indices, size_t indexCount, size_t vertexCount) :
+            offsets(vertexCount + 1, 0),
+            triangles(indexCount)
+        {
+            for (size_t i = 0; i < indexCount; i++)
+            {
+                offsets[indices[i] + 1]++;
+            }
+            for (size_t v = 0; v < vertexCount; v++)
+            {
+                offsets[v + 1] += offsets[v];
+            }
+
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indexCount; i++)
+            {
+                triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+    };
+
+    // A FIFO post-transform cache simulated with timestamps: a vertex is in
+    // the cache when fewer than cacheSize misses have happened since it was
+    // last shaded. Returns the number of misses for one triangle.
+    class CacheSimulator
+    {
+    public:
+        CacheSimulator(size_t vertexCount, uint32_t cacheSize) :
+            m_timestamps(vertexCount, 0),
+            m_time(cacheSize + 1),
+            m_cacheSize(cacheSize)
+        {
+        }
+
+        uint32_t AddTriangle(const uint32_t* triangle)
+        {
+            uint32_t misses = 0;
+            for (int i = 0; i < 3; i++)
+            {
+                if (m_time - m_timestamps[triangle[i]] > m_cacheSize)
+                {
+                    m_timestamps[triangle[i]] = m_time++;
+                    misses++;
+                }
+            }
+            return misses;
+        }
+
+        // Empties the cache by moving time past every entry.
+        void Flush()
+        {
+            m_time += m_cacheSize + 1;
+        }
+
+    private:
+        std::vector<uint32_t> m_timestamps;
+        uint32_t m_time;
+        uint32_t m_cacheSize;
+    };
+
+    float3 ReadPosition(const float* positions, size_t positionStride, uint32_t index)
+    {
+        const float* position = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) + index * positionStride);
+        return float3(position[0], position[1], position[2]);
+    }
+}
+
+VertexCacheStatistics AnalyzeVertexCache(
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    size_t vertexCount,
+    uint32_t cacheSize
+)
+{
+    VertexCacheStatistics statistics = {};
+    CacheSimulator cache(vertexCount, cacheSize);
+    std::vector<bool> referenced(vertexCount, false);
+
+    for (size_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        statistics.vertexTransforms += cache.AddTriangle(indices + i);
+        statistics.triangleCount++;
+        for (int j = 0; j < 3; j++)
+        {
+            if (!referenced[indices[i + j]])
+            {
+                referenced[indices[i + j]] = true;
+                statistics.referencedVertices++;
+            }
+        }
+    }
+
+    if (statistics.triangleCount != 0)
+    {
+        statistics.acmr = static_cast<float>(statistics.vertexTransforms) / statistics.triangleCount;
+        statistics.atvr = static_cast<float>(statistics.vertexTransforms) / statistics.referencedVertices;
+    }
+    return statistics;
+}
+
+void OptimizeVertexCache(
+    _Out_writes_(indexCount) uint32_t* destination,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    size_t vertexCount,
+    uint32_t cacheSize
+)
+{
+    size_t triangleCount = indexCount / 3;
+    VertexTriangles adjacency(indices, triangleCount * 3, vertexCount);
+
+    // live[v] counts the triangles of v not yet emitted; cacheTime is the
+    // simulated time at which v was last shaded.
+    std::vector<uint32_t> live(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        live[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+    }
+    std::vector<uint32_t> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<uint32_t> deadEnd;
+    std::vector<uint32_t> candidates;
+
+    uint32_t time = cacheSize + 1;
+    size_t cursor = 0;
+    size_t outputCount = 0;
+
+    // Each step fans out from one vertex, emitting all of its remaining
+    // triangles, then moves to the vertex among those just touched that will
+    // stay in the cache longest while still having triangles left.
+    size_t fan = 0;
+    while (fan < vertexCount)
+    {
+        candidates.clear();
+        for (uint32_t k = adjacency.offsets[fan]; k < adjacency.offsets[fan + 1]; k++)
+        {
+            uint32_t triangle = adjacency.triangles[k];
+            if (emitted[triangle])
+            {
+                continue;
+            }
+            emitted[triangle] = true;
+
+            for (int j = 0; j < 3; j++)
+            {
+                uint32_t v = indices[triangle * 3 + j];
+                destination[outputCount++] = v;
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                live[v]--;
+                if (time - cacheTime[v] > cacheSize)
+                {
+                    cacheTime[v] = time++;
+                }
+            }
+        }
+
+        // A candidate scores its age in the cache if its remaining triangles
+        // would still find it there, and 0 otherwise; the oldest such vertex
+        // is the one about to be lost.
+        size_t next = vertexCount;
+        int bestScore = -1;
+        for (uint32_t v : candidates)
+        {
+            if (live[v] == 0)
+            {
+                continue;
+            }
+            int score = 0;
+            if (time - cacheTime[v] + 2 * live[v] <= cacheSize)
+            {
+                score = static_cast<int>(time - cacheTime[v]);
+            }
+            if (score > bestScore)
+            {
+                bestScore = score;
+                next = v;
+            }
+        }
+
+        // At a dead end, go back to a recently used vertex with triangles
+        // left, and failing that to the next such vertex in input order.
+        while (next == vertexCount && !deadEnd.empty())
+        {
+            uint32_t v = deadEnd.back();
+            deadEnd.pop_back();
+            if (live[v] != 0)
+            {
+                next = v;
+            }
+        }
+        while (next == vertexCount && cursor < vertexCount)
+        {
+            if (live[cursor] != 0)
+            {
+                next = cursor;
+            }
+            cursor++;
+        }
+
+        fan = next;
+    }
+
+    // A trailing partial triangle is kept where it was.
+    for (size_t i = triangleCount * 3; i < indexCount; i++)
+    {
+        destination[i] = indices[i];
+    }
+}
+
+void OptimizeOverdraw(
+    _Out_writes_(indexCount) uint32_t* destination,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    _In_ const float* positions,
+    size_t positionStride,
+    size_t vertexCount,
+    float threshold,
+    uint32_t cacheSize
+)
+{
+    size_t triangleCount = indexCount / 3;
+    if (triangleCount == 0)
+    {
+        std::copy(indices, indices + indexCount, destination);
+        return;
+    }
+
+    // Hard boundaries are where a triangle misses on all three vertices: the
+    // cache order has jumped to a new part of the mesh, so breaking there
+    // costs nothing.
+    std::vector<size_t> hardBoundaries;
+    {
+        CacheSimulator cache(vertexCount, cacheSize);
+        for (size_t t = 0; t < triangleCount; t++)
+        {
+            if (cache.AddTriangle(indices + t * 3) == 3 || t == 0)
+            {
+                hardBoundaries.push_back(t);
+            }
+        }
+        hardBoundaries.push_back(triangleCount);
+    }
+
+    // Soft boundaries split a hard cluster wherever the part since the last
+    // split, simulated from an empty cache as it will be once clusters are
+    // shuffled, has reached an ACMR within threshold of the whole cluster's.
+    std::vector<size_t> clusters;
+    CacheSimulator cache(vertexCount, cacheSize);
+    for (size_t c = 0; c + 1 < hardBoundaries.size(); c++)
+    {
+        size_t start = hardBoundaries[c];
+        size_t end = hardBoundaries[c + 1];
+
+        uint32_t clusterMisses = 0;
+        cache.Flush();
+        for (size_t t = start; t < end; t++)
+        {
+            clusterMisses += cache.AddTriangle(indices + t * 3);
+        }
+        float clusterThreshold = threshold * clusterMisses / (end - start);
+
+        clusters.push_back(start);
+        uint32_t misses = 0;
+        size_t partStart = start;
+        cache.Flush();
+        for (size_t t = start; t < end; t++)
+        {
+            misses += cache.AddTriangle(indices + t * 3);
+            if (t + 1 < end && static_cast<float>(misses) / (t + 1 - partStart) <= clusterThreshold)
+            {
+                clusters.push_back(t + 1);
+                misses = 0;
+                partStart = t + 1;
+                cache.Flush();
+            }
+        }
+    }
+    clusters.push_back(triangleCount);
+
+    // Each cluster is sorted by how far its area-weighted centroid lies along
+    // its area-weighted normal from the centroid of the mesh: outer surfaces
+    // facing away from the center come first.
+    size_t clusterCount = clusters.size() - 1;
+    std::vector<float3> clusterCentroids(clusterCount);
+    std::vector<float3> clusterNormals(clusterCount);
+    float3 meshCentroid;
+    float meshArea = 0.0f;
+
+    for (size_t c = 0; c < clusterCount; c++)
+    {
+        float3 centroid;
+        float3 normal;
+        float area = 0.0f;
+        for (size_t t = clusters[c]; t < clusters[c + 1]; t++)
+        {
+            float3 p0 = ReadPosition(positions, positionStride, indices[t * 3]);
+            float3 p1 = ReadPosition(positions, positionStride, indices[t * 3 + 1]);
+            float3 p2 = ReadPosition(positions, positionStride, indices[t * 3 + 2]);
+            float3 n = cross(p1 - p0, p2 - p0);
+            float triangleArea = length(n);
+
+            centroid = centroid + (p0 + p1 + p2) * (triangleArea / 3.0f);
+            normal = normal + n;
+            area += triangleArea;
+        }
+
+        meshCentroid = meshCentroid + centroid;
+        meshArea += area;
+        clusterCentroids[c] = (area > 0.0f) ? centroid / area : centroid;
+        clusterNormals[c] = normal;
+    }
+    if (meshArea > 0.0f)
+    {
+        meshCentroid = meshCentroid / meshArea;
+    }
+
+    std::vector<float> sortKeys(clusterCount);
+    std::vector<size_t> order(clusterCount);
+    for (size_t c = 0; c < clusterCount; c++)
+    {
+        float normalLength = length(clusterNormals[c]);
+        float3 normal = (normalLength > 0.0f) ? clusterNormals[c] / normalLength : float3();
+        sortKeys[c] = dot(clusterCentroids[c] - meshCentroid, normal);
+        order[c] = c;
+    }
+    std::stable_sort(order.begin(), order.end(), [&sortKeys](size_t a, size_t b) { return sortKeys[a] > sortKeys[b]; });
+
+    size_t outputCount = 0;
+    for (size_t c : order)
+    {
+        size_t count = (clusters[c + 1] - clusters[c]) * 3;
+        memcpy(destination + outputCount, indices + clusters[c] * 3, count * sizeof(uint32_t));
+        outputCount += count;
+    }
+    for (size_t i = triangleCount * 3; i < indexCount; i++)
+    {
+        destination[i] = indices[i];
+    }
+}
+
+size_t OptimizeVertexFetchRemap(
+    _Out_writes_(vertexCount) uint32_t* remap,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    size_t vertexCount
+)
+{
+    std::fill(remap, remap + vertexCount, NotRemapped);
+
+    uint32_t nextVertex = 0;
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        if (remap[indices[i]] == NotRemapped)
+        {
+            remap[indices[i]] = nextVertex++;
+        }
+    }
+    return nextVertex;
+}
+
+void RemapIndices(
+    _Out_writes_(indexCount) uint32_t* destination,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    _In_ const uint32_t* remap
+)
+{
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        destination[i] = remap[indices[i]];
+    }
+}
+
+void RemapVertices(
+    _Out_ void* destination,
+    _In_ const void* vertices,
+    size_t vertexCount,
+    size_t vertexSize,
+    _In_reads_(vertexCount) const uint32_t* remap
+)
+{
+    uint8_t* out = static_cast<uint8_t*>(destination);
+    const uint8_t* in = static_cast<const uint8_t*>(vertices);
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        if (remap[v] != NotRemapped)
+        {
+            memcpy(out + remap[v] * vertexSize, in + v * vertexSize, vertexSize);
+        }
+    }
+}
+
+size_t OptimizeMesh(
+    _Inout_ void* vertices,
+    size_t vertexCount,
+    size_t vertexSize,
+    _Inout_updates_(indexCount) uint32_t* indices,
+    size_t indexCount
+)
+{
+    std::vector<uint32_t> cacheOrder(indexCount);
+    OptimizeVertexCache(cacheOrder.data(), indices, indexCount, vertexCount);
+    OptimizeOverdraw(indices, cacheOrder.data(), indexCount, static_cast<const float*>(vertices), vertexSize, vertexCount);
+
+    std::vector<uint32_t> remap(vertexCount);
+    size_t keptCount = OptimizeVertexFetchRemap(remap.data(), indices, indexCount, vertexCount);
+    RemapIndices(indices, indices, indexCount, remap.data());
+
+    std::vector<uint8_t> original(static_cast<uint8_t*>(vertices), static_cast<uint8_t*>(vertices) + vertexCount * vertexSize);
+    RemapVertices(vertices, original.data(), vertexCount, vertexSize, remap.data());
+    return keptCount;
+}
+
+BasicMeshResult OptimizeBasicMesh(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    _Out_ std::vector<uint8_t>* file
+)
+{
+    BasicMeshInfo info;
+    BasicMeshResult result = ParseBasicMesh(data, size, &info);
+    if (result != BasicMeshResult::Ok)
+    {
+        return result;
+    }
+    if (info.indexCount == 0)
+    {
+        file->assign(data, data + size);
+        return BasicMeshResult::Ok;
+    }
+
+    std::vector<uint32_t> indices(info.indexCount);
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        indices[i] = GetMeshIndex(info, i);
+        if (indices[i] >= info.vertexCount)
+        {
+            return BasicMeshResult::InvalidData;
+        }
+    }
+
+    const BasicMeshAttribute* position = FindMeshAttribute(info, MeshSemantic::Position);
+    bool floatPositions = static_cast<MeshAttributeFormat>(position->format) == MeshAttributeFormat::Float3 ||
+        static_cast<MeshAttributeFormat>(position->format) == MeshAttributeFormat::Float4;
+
+    // The vertices are copied out so that positions are read aligned.
+    std::vector<uint8_t> vertices(info.vertexData, info.vertexData + static_cast<size_t>(info.vertexCount) * info.vertexStride);
+    std::vector<uint32_t> cacheOrder;
+    for (uint32_t s = 0; s < info.submeshCount; s++)
+    {
+        const BasicMeshSubmesh& submesh = info.submeshes[s];
+        uint32_t* submeshIndices = indices.data() + submesh.indexStart;
+
+        cacheOrder.resize(submesh.indexCount);
+        OptimizeVertexCache(cacheOrder.data(), submeshIndices, submesh.indexCount, info.vertexCount);
+        if (floatPositions)
+        {
+            OptimizeOverdraw(
+                submeshIndices, cacheOrder.data(), submesh.indexCount,
+                reinterpret_cast<const float*>(vertices.data() + position->offset), info.vertexStride,
+                info.vertexCount
+            );
+        }
+        else
+        {
+            std::copy(cacheOrder.begin(), cacheOrder.end(), submeshIndices);
+        }
+    }
+
+    std::vector<uint32_t> remap(info.vertexCount);
+    size_t keptCount = OptimizeVertexFetchRemap(remap.data(), indices.data(), indices.size(), info.vertexCount);
+    RemapIndices(indices.data(), indices.data(), indices.size(), remap.data());
+
+    std::vector<uint8_t> remapped(keptCount * info.vertexStride);
+    RemapVertices(remapped.data(), vertices.data(), info.vertexCount, info.vertexStride, remap.data());
+
+    std::vector<BasicMeshSubmesh> submeshes = GetMeshSubmeshes(info);
+    for (BasicMeshSubmesh& submesh : submeshes)
+    {
+        uint32_t low = UINT32_MAX;
+        uint32_t high = 0;
+        for (uint32_t i = submesh.indexStart; i < submesh.indexStart + submesh.indexCount; i++)
+        {
+            low = std::min(low, indices[i]);
+            high = std::max(high, indices[i]);
+        }
+        submesh.vertexStart = (submesh.indexCount != 0) ? low : 0;
+        submesh.vertexCount = (submesh.indexCount != 0) ? high - low + 1 : 0;
+    }
+
+    BasicMeshDesc desc = {};
+    desc.vertices = remapped.data();
+    desc.vertexCount = static_cast<uint32_t>(keptCount);
+    desc.vertexStride = info.vertexStride;
+    desc.attributes = info.attributes;
+    desc.attributeCount = info.attributeCount;
+    desc.indices = indices.data();
+    desc.indexCount = info.indexCount;
+    desc.submeshes = submeshes.data();
+    desc.submeshCount = info.submeshCount;
+    desc.positionBounds = &info.bounds;
+    return WriteBasicMesh(desc, file);
+}
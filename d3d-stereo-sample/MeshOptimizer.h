@@ -0,0 +1,138 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "BasicMeshFormat.h"
+#include "BasicSal.h"
+
+// Reorders triangle lists and vertex buffers for the GPU. The usual order is
+// OptimizeVertexCache, then OptimizeOverdraw, then OptimizeVertexFetchRemap
+// with RemapIndices and RemapVertices; OptimizeMesh does all three. None of
+// these change the triangles themselves or their winding, only their order
+// and the order of the vertices.
+
+// Post-transform cache size assumed by default. Hardware since D3D10 behaves
+// roughly like a FIFO of 16 to 32 entries; optimizing for the small end does
+// well on all of them.
+const uint32_t DefaultVertexCacheSize = 16;
+
+// acmr is the average number of vertices shaded per triangle (0.5 at best
+// for a large regular grid, 3 at worst) and atvr the average number of times
+// each referenced vertex is shaded (1 at best). Both are from a simulated FIFO
+// cache of the given size.
+struct VertexCacheStatistics
+{
+    uint32_t vertexTransforms;
+    uint32_t triangleCount;
+    uint32_t referencedVertices;
+    float acmr;
+    float atvr;
+};
+
+VertexCacheStatistics AnalyzeVertexCache(
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    size_t vertexCount,
+    uint32_t cacheSize = DefaultVertexCacheSize
+);
+
+// Orders the triangles so that consecutive ones share vertices while they are
+// still in the post-transform cache, with the Tipsify algorithm (Sander,
+// Nehab and Barczak, "Fast Triangle Reordering for Vertex Locality and
+// Reduced Overdraw", 2007). Runs in time linear in the index count.
+// destination must not alias indices.
+void OptimizeVertexCache(
+    _Out_writes_(indexCount) uint32_t* destination,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    size_t vertexCount,
+    uint32_t cacheSize = DefaultVertexCacheSize
+);
+
+// Takes indices already ordered by OptimizeVertexCache and reorders clusters
+// of them so that those facing outwards from the mesh center are drawn first,
+// where they are most likely to occlude the rest. Clusters are split where the
+// cache order allows it, so the cache efficiency drops by at most a factor of
+// threshold. positions is the float3 position of vertex i at
+// positions + i * positionStride bytes. destination must not alias indices.
+void OptimizeOverdraw(
+    _Out_writes_(indexCount) uint32_t* destination,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    _In_ const float* positions,
+    size_t positionStride,
+    size_t vertexCount,
+    float threshold = 1.05f,
+    uint32_t cacheSize = DefaultVertexCacheSize
+);
+
+// Computes a vertex order in which vertices are stored in the order the
+// indices first use them, so that fetches walk the vertex buffer forwards.
+// remap[old] is the new index of each vertex, or UINT32_MAX for vertices that
+// no index uses. Returns the number of vertices that are kept.
+size_t OptimizeVertexFetchRemap(
+    _Out_writes_(vertexCount) uint32_t* remap,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    size_t vertexCount
+);
+
+// Applies a remap to indices. destination may alias indices.
+void RemapIndices(
+    _Out_writes_(indexCount) uint32_t* destination,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    _In_ const uint32_t* remap
+);
+
+// Applies a remap to vertices of vertexSize bytes each; vertices that are
+// not kept are dropped. destination must not alias vertices.
+void RemapVertices(
+    _Out_ void* destination,
+    _In_ const void* vertices,
+    size_t vertexCount,
+    size_t vertexSize,
+    _In_reads_(vertexCount) const uint32_t* remap
+);
+
+// Runs the three optimizations on an indexed triangle list in place, where
+// each vertex starts with its float3 position, as BasicVertex and
+// TangentVertex do. Unused vertices are dropped; returns the number kept.
+size_t OptimizeMesh(
+    _Inout_ void* vertices,
+    size_t vertexCount,
+    size_t vertexSize,
+    _Inout_updates_(indexCount) uint32_t* indices,
+    size_t indexCount
+);
+
+// OptimizeMesh for other index types, such as the 16-bit indices of
+// BasicShapes.
+template <class Index>
+size_t OptimizeMesh(
+    _Inout_ void* vertices,
+    size_t vertexCount,
+    size_t vertexSize,
+    _Inout_updates_(indexCount) Index* indices,
+    size_t indexCount
+)
+{
+    std::vector<uint32_t> wideIndices(indices, indices + indexCount);
+    size_t keptCount = OptimizeMesh(vertices, vertexCount, vertexSize, wideIndices.data(), indexCount);
+    for (size_t i = 0; i < indexCount; i++)
+    {
+        indices[i] = static_cast<Index>(wideIndices[i]);
+    }
+    return keptCount;
+}
+
+// Optimizes a BasicMesh version 2 or 3 file into a new one. Each submesh is
+// reordered on its own, so submeshes keep their index ranges; their vertex
+// ranges follow the new vertex order. Overdraw ordering needs float3
+// positions and is skipped for other position formats. Returns InvalidData
+// if any index is out of range.
+BasicMeshResult OptimizeBasicMesh(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    _Out_ std::vector<uint8_t>* file
+);
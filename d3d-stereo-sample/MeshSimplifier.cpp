@@ -0,0 +1,543 @@
+#include "MeshSimplifier.h"
+#include "BasicMath.h"
+#include <float.h>
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+
+namespace
+{
+    const uint32_t NotCollapsed = UINT32_MAX;
+
+    // The cosine of the largest turn a merge may give the normal of any
+    // triangle around it.
+    const float MaximumNormalTurn = 0.25f;
+
+    // Levels that keep more than this share of the triangles of the level
+    // before them are not worth their index data.
+    const float MinimumLodReduction = 0.85f;
+
+    // The symmetric matrix of the quadric form sum(w * (n.p + d)^2) over the
+    // planes (n, d) it has absorbed, with w the sum of the plane weights.
+    // Evaluated in double precision, since the form is a difference of large
+    // terms near its minimum.
+    struct Quadric
+    {
+        double a00, a01, a02, a03;
+        double a11, a12, a13;
+        double a22, a23;
+        double a33;
+        double weight;
+
+        void AddPlane(float3 normal, float distance, double planeWeight)
+        {
+            double n[4] = { normal.x, normal.y, normal.z, distance };
+            a00 += planeWeight * n[0] * n[0];
+            a01 += planeWeight * n[0] * n[1];
+            a02 += planeWeight * n[0] * n[2];
+            a03 += planeWeight * n[0] * n[3];
+            a11 += planeWeight * n[1] * n[1];
+            a12 += planeWeight * n[1] * n[2];
+            a13 += planeWeight * n[1] * n[3];
+            a22 += planeWeight * n[2] * n[2];
+            a23 += planeWeight * n[2] * n[3];
+            a33 += planeWeight * n[3] * n[3];
+            weight += planeWeight;
+        }
+
+        void Add(const Quadric& other)
+        {
+            a00 += other.a00; a01 += other.a01; a02 += other.a02; a03 += other.a03;
+            a11 += other.a11; a12 += other.a12; a13 += other.a13;
+            a22 += other.a22; a23 += other.a23;
+            a33 += other.a33;
+            weight += other.weight;
+        }
+
+        // The weighted mean squared distance of p from the planes.
+        double Evaluate(float3 p) const
+        {
+            double x = p.x;
+            double y = p.y;
+            double z = p.z;
+            double sum =
+                a00 * x * x + a11 * y * y + a22 * z * z + a33 +
+                2.0 * (a01 * x * y + a02 * x * z + a12 * y * z + a03 * x + a13 * y + a23 * z);
+            return (weight > 0.0) ? std::max(sum, 0.0) / weight : 0.0;
+        }
+    };
+
+    // The triangles that use each vertex, in compressed rows, as in
+    // MeshOptimizer: the triangles of vertex v are triangles[offsets[v]] up
+    // to triangles[offsets[v + 1]].
+    struct VertexTriangles
+    {
+        std::vector<uint32_t> offsets;
+        std::vector<uint32_t> triangles;
+
+        VertexTriangles(const uint32_t* indices, size_t indexCount, size_t vertexCount) :
+            offsets(vertexCount + 1, 0),
+            triangles(indexCount)
+        {
+            for (size_t i = 0; i < indexCount; i++)
+            {
+                offsets[indices[i] + 1]++;
+            }
+            for (size_t v = 0; v < vertexCount; v++)
+            {
+                offsets[v + 1] += offsets[v];
+            }
+
+            std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+            for (size_t i = 0; i < indexCount; i++)
+            {
+                triangles[fill[indices[i]]++] = static_cast<uint32_t>(i / 3);
+            }
+        }
+    };
+
+    struct Collapse
+    {
+        uint32_t from;
+        uint32_t to;
+        double error;
+    };
+
+    float3 ReadPosition(const float* positions, size_t positionStride, uint32_t index)
+    {
+        const float* position = reinterpret_cast<const float*>(reinterpret_cast<const uint8_t*>(positions) + index * positionStride);
+        return float3(position[0], position[1], position[2]);
+    }
+
+    // Marks the vertices that must stay: those that share their position with
+    // another vertex, and those on an edge used by only one triangle.
+    std::vector<uint8_t> FindLockedVertices(
+        const uint32_t* indices,
+        size_t indexCount,
+        const std::vector<float3>& positions
+    )
+    {
+        std::vector<uint8_t> locked(positions.size(), 0);
+
+        std::vector<uint32_t> order(positions.size());
+        for (size_t v = 0; v < order.size(); v++)
+        {
+            order[v] = static_cast<uint32_t>(v);
+        }
+        auto less = [&](uint32_t a, uint32_t b)
+        {
+            const float3& p = positions[a];
+            const float3& q = positions[b];
+            return (p.x != q.x) ? p.x < q.x : (p.y != q.y) ? p.y < q.y : p.z < q.z;
+        };
+        std::sort(order.begin(), order.end(), less);
+        for (size_t i = 1; i < order.size(); i++)
+        {
+            if (!less(order[i - 1], order[i]))
+            {
+                locked[order[i - 1]] = 1;
+                locked[order[i]] = 1;
+            }
+        }
+
+        // Edge a -> b is interior when some triangle of a has the edge b -> a.
+        VertexTriangles adjacency(indices, indexCount, positions.size());
+        for (size_t i = 0; i < indexCount; i++)
+        {
+            uint32_t a = indices[i];
+            uint32_t b = indices[i - i % 3 + (i + 1) % 3];
+            bool interior = false;
+            for (uint32_t k = adjacency.offsets[a]; k < adjacency.offsets[a + 1] && !interior; k++)
+            {
+                const uint32_t* triangle = indices + adjacency.triangles[k] * 3;
+                for (int e = 0; e < 3; e++)
+                {
+                    if (triangle[e] == b && triangle[(e + 1) % 3] == a)
+                    {
+                        interior = true;
+                    }
+                }
+            }
+            if (!interior)
+            {
+                locked[a] = 1;
+                locked[b] = 1;
+            }
+        }
+        return locked;
+    }
+
+    // Appends the vertices that share a triangle with v, other than v, to
+    // neighbors, which may then hold duplicates.
+    void GatherNeighbors(
+        const uint32_t* indices,
+        const VertexTriangles& adjacency,
+        uint32_t v,
+        std::vector<uint32_t>* neighbors
+    )
+    {
+        for (uint32_t k = adjacency.offsets[v]; k < adjacency.offsets[v + 1]; k++)
+        {
+            const uint32_t* triangle = indices + adjacency.triangles[k] * 3;
+            for (int e = 0; e < 3; e++)
+            {
+                if (triangle[e] != v)
+                {
+                    neighbors->push_back(triangle[e]);
+                }
+            }
+        }
+    }
+
+    // Checks that moving from onto to keeps the surface a manifold, which
+    // holds when the two share exactly the two neighbors of the triangles on
+    // their edge, and that no remaining triangle of from turns too far.
+    bool IsCollapseValid(
+        const uint32_t* indices,
+        const VertexTriangles& adjacency,
+        const std::vector<float3>& positions,
+        const std::vector<float3>& originalNormals,
+        uint32_t from,
+        uint32_t to,
+        std::vector<uint32_t>* fromNeighbors,
+        std::vector<uint32_t>* toNeighbors
+    )
+    {
+        fromNeighbors->clear();
+        toNeighbors->clear();
+        GatherNeighbors(indices, adjacency, from, fromNeighbors);
+        GatherNeighbors(indices, adjacency, to, toNeighbors);
+        std::sort(fromNeighbors->begin(), fromNeighbors->end());
+        fromNeighbors->erase(std::unique(fromNeighbors->begin(), fromNeighbors->end()), fromNeighbors->end());
+        std::sort(toNeighbors->begin(), toNeighbors->end());
+        toNeighbors->erase(std::unique(toNeighbors->begin(), toNeighbors->end()), toNeighbors->end());
+
+        size_t shared = 0;
+        for (uint32_t v : *fromNeighbors)
+        {
+            shared += std::binary_search(toNeighbors->begin(), toNeighbors->end(), v) ? 1 : 0;
+        }
+        if (shared != 2)
+        {
+            return false;
+        }
+
+        for (uint32_t k = adjacency.offsets[from]; k < adjacency.offsets[from + 1]; k++)
+        {
+            const uint32_t* triangle = indices + adjacency.triangles[k] * 3;
+            if (triangle[0] == to || triangle[1] == to || triangle[2] == to)
+            {
+                continue;
+            }
+
+            float3 before[3];
+            float3 after[3];
+            for (int e = 0; e < 3; e++)
+            {
+                before[e] = positions[triangle[e]];
+                after[e] = positions[(triangle[e] == from) ? to : triangle[e]];
+            }
+            float3 normalBefore = cross(before[1] - before[0], before[2] - before[0]);
+            float3 normalAfter = cross(after[1] - after[0], after[2] - after[0]);
+            // Turning by more than about 75 degrees is as bad as flipping, and
+            // also catches triangles collapsing to slivers, whose normals
+            // swing wildly.
+            float lengths = length(normalBefore) * length(normalAfter);
+            if (dot(normalBefore, normalAfter) < MaximumNormalTurn * lengths || lengths == 0.0f)
+            {
+                return false;
+            }
+
+            // Small turns can add up over many merges, so the triangle must
+            // also still face about the way the surface at its corners first
+            // did.
+            for (int e = 0; e < 3; e++)
+            {
+                const float3& original = originalNormals[(triangle[e] == from) ? to : triangle[e]];
+                if (dot(normalAfter, original) < MaximumNormalTurn * length(normalAfter) * length(original))
+                {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+}
+
+size_t SimplifyMesh(
+    _Out_writes_(indexCount) uint32_t* destination,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    _In_ const float* positions,
+    size_t positionStride,
+    size_t vertexCount,
+    size_t targetIndexCount,
+    float targetError,
+    _Out_opt_ float* resultError
+)
+{
+    std::vector<uint32_t> current(indices, indices + indexCount);
+    std::vector<float3> points(vertexCount);
+    for (size_t v = 0; v < vertexCount; v++)
+    {
+        points[v] = ReadPosition(positions, positionStride, static_cast<uint32_t>(v));
+    }
+
+    // Each vertex starts with the planes of its triangles, weighted by area so
+    // that slivers do not outweigh the surface around them.
+    // The area-weighted normals of the original surface at each vertex serve
+    // as a reference for which way it faces.
+    std::vector<Quadric> quadrics(vertexCount, Quadric());
+    std::vector<float3> originalNormals(vertexCount, float3(0.0f, 0.0f, 0.0f));
+    for (size_t i = 0; i + 2 < current.size(); i += 3)
+    {
+        float3 p0 = points[current[i]];
+        float3 normal = cross(points[current[i + 1]] - p0, points[current[i + 2]] - p0);
+        float area = length(normal);
+        if (area == 0.0f)
+        {
+            continue;
+        }
+        for (int e = 0; e < 3; e++)
+        {
+            originalNormals[current[i + e]] = originalNormals[current[i + e]] + normal;
+        }
+        normal = normal * (1.0f / area);
+        for (int e = 0; e < 3; e++)
+        {
+            quadrics[current[i + e]].AddPlane(normal, -dot(normal, p0), 0.5 * area);
+        }
+    }
+
+    std::vector<uint8_t> locked = FindLockedVertices(current.data(), current.size(), points);
+    double errorLimit = static_cast<double>(targetError) * targetError;
+    double largestError = 0.0;
+
+    // Each pass collapses the cheapest edges whose neighborhoods do not
+    // overlap, so that every collapse sees the mesh as it is, then rebuilds
+    // the adjacency.
+    std::vector<Collapse> collapses;
+    std::vector<uint32_t> collapseTarget(vertexCount);
+    std::vector<uint8_t> touched(vertexCount);
+    std::vector<uint32_t> fromNeighbors;
+    std::vector<uint32_t> toNeighbors;
+    while (current.size() > targetIndexCount)
+    {
+        VertexTriangles adjacency(current.data(), current.size(), vertexCount);
+
+        collapses.clear();
+        for (size_t i = 0; i < current.size(); i++)
+        {
+            uint32_t a = current[i];
+            uint32_t b = current[i - i % 3 + (i + 1) % 3];
+            if (a > b || (locked[a] && locked[b]))
+            {
+                continue;
+            }
+
+            Quadric merged = quadrics[a];
+            merged.Add(quadrics[b]);
+            double errorAtA = locked[a] ? 0.0 : merged.Evaluate(points[a]);
+            double errorAtB = locked[b] ? 0.0 : merged.Evaluate(points[b]);
+            if (locked[a] || (!locked[b] && errorAtB < errorAtA))
+            {
+                collapses.push_back({ b, a, errorAtA });
+            }
+            else
+            {
+                collapses.push_back({ a, b, errorAtB });
+            }
+        }
+
+        // Only the cheapest third are tried in one pass; the rest are priced
+        // again once the mesh around them has changed.
+        size_t tried = std::max<size_t>(collapses.size() / 3, 1);
+        tried = std::min(tried, collapses.size());
+        std::partial_sort(collapses.begin(), collapses.begin() + tried, collapses.end(),
+            [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+        std::fill(collapseTarget.begin(), collapseTarget.end(), NotCollapsed);
+        std::fill(touched.begin(), touched.end(), static_cast<uint8_t>(0));
+        size_t removedIndices = 0;
+        size_t collapsed = 0;
+        for (size_t c = 0; c < tried && current.size() - removedIndices > targetIndexCount; c++)
+        {
+            const Collapse& collapse = collapses[c];
+            if (collapse.error > errorLimit)
+            {
+                break;
+            }
+            if (touched[collapse.from] || touched[collapse.to] ||
+                !IsCollapseValid(current.data(), adjacency, points, originalNormals, collapse.from, collapse.to, &fromNeighbors, &toNeighbors))
+            {
+                continue;
+            }
+
+            collapseTarget[collapse.from] = collapse.to;
+            quadrics[collapse.to].Add(quadrics[collapse.from]);
+            largestError = std::max(largestError, collapse.error);
+            collapsed++;
+
+            // The triangles around from change, so nothing else in them may
+            // move this pass.
+            touched[collapse.from] = 1;
+            touched[collapse.to] = 1;
+            for (uint32_t v : fromNeighbors)
+            {
+                touched[v] = 1;
+            }
+            for (uint32_t k = adjacency.offsets[collapse.from]; k < adjacency.offsets[collapse.from + 1]; k++)
+            {
+                const uint32_t* triangle = current.data() + adjacency.triangles[k] * 3;
+                if (triangle[0] == collapse.to || triangle[1] == collapse.to || triangle[2] == collapse.to)
+                {
+                    removedIndices += 3;
+                }
+            }
+        }
+        if (collapsed == 0)
+        {
+            break;
+        }
+
+        size_t kept = 0;
+        for (size_t i = 0; i < current.size(); i += 3)
+        {
+            uint32_t triangle[3];
+            for (int e = 0; e < 3; e++)
+            {
+                uint32_t v = current[i + e];
+                triangle[e] = (collapseTarget[v] != NotCollapsed) ? collapseTarget[v] : v;
+            }
+            if (triangle[0] != triangle[1] && triangle[1] != triangle[2] && triangle[0] != triangle[2])
+            {
+                current[kept++] = triangle[0];
+                current[kept++] = triangle[1];
+                current[kept++] = triangle[2];
+            }
+        }
+        current.resize(kept);
+    }
+
+    std::copy(current.begin(), current.end(), destination);
+    if (resultError)
+    {
+        *resultError = static_cast<float>(sqrt(largestError));
+    }
+    return current.size();
+}
+
+BasicMeshResult GenerateBasicMeshLods(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    uint32_t levelCount,
+    float reduction,
+    _Out_ std::vector<uint8_t>* file
+)
+{
+    if (!(reduction > 0.0f && reduction < 1.0f))
+    {
+        return BasicMeshResult::InvalidArgument;
+    }
+
+    BasicMeshInfo info;
+    BasicMeshResult result = ParseBasicMesh(data, size, &info);
+    if (result != BasicMeshResult::Ok)
+    {
+        return result;
+    }
+
+    const BasicMeshAttribute* position = FindMeshAttribute(info, MeshSemantic::Position);
+    if (static_cast<MeshAttributeFormat>(position->format) != MeshAttributeFormat::Float3)
+    {
+        return BasicMeshResult::InvalidData;
+    }
+
+    std::vector<uint32_t> sourceIndices(info.indexCount);
+    for (size_t i = 0; i < sourceIndices.size(); i++)
+    {
+        sourceIndices[i] = GetMeshIndex(info, i);
+        if (sourceIndices[i] >= info.vertexCount)
+        {
+            return BasicMeshResult::InvalidData;
+        }
+    }
+
+    // The vertices are copied out so that positions are read aligned.
+    std::vector<uint8_t> vertices(info.vertexData, info.vertexData + static_cast<size_t>(info.vertexCount) * info.vertexStride);
+    const float* positions = reinterpret_cast<const float*>(vertices.data() + position->offset);
+
+    // Each full-detail submesh is written with its indices followed by those
+    // of its levels; levels from the input are dropped.
+    std::vector<BasicMeshSubmesh> sourceSubmeshes = GetMeshSubmeshes(info);
+    std::vector<uint32_t> indices;
+    std::vector<BasicMeshSubmesh> submeshes;
+    std::vector<uint32_t> simplified;
+    for (uint32_t s = 0; s < info.submeshCount; s++)
+    {
+        BasicMeshSubmesh submesh = sourceSubmeshes[s];
+        if (submesh.lodError != 0.0f)
+        {
+            continue;
+        }
+
+        const uint32_t* baseIndices = sourceIndices.data() + submesh.indexStart;
+        submesh.indexStart = static_cast<uint32_t>(indices.size());
+        submeshes.push_back(submesh);
+        indices.insert(indices.end(), baseIndices, baseIndices + submesh.indexCount);
+
+        // Every level is simplified from the full detail, so that its error
+        // is measured against the original surface.
+        simplified.resize(submesh.indexCount);
+        size_t previousCount = submesh.indexCount;
+        float previousError = 0.0f;
+        for (uint32_t level = 0; level < levelCount; level++)
+        {
+            size_t target = static_cast<size_t>(previousCount / 3 * reduction) * 3;
+            float error = 0.0f;
+            size_t count = SimplifyMesh(
+                simplified.data(), baseIndices, submesh.indexCount,
+                positions, info.vertexStride, info.vertexCount,
+                target, FLT_MAX, &error
+            );
+            if (count == 0 || count > previousCount * MinimumLodReduction ||
+                indices.size() + count > UINT32_MAX)
+            {
+                break;
+            }
+
+            // A level without error, as when a flat mesh loses vertices
+            // inside its faces, would mark full detail and is no use as a
+            // level: it is dropped, and the next level tries for fewer
+            // triangles still.
+            previousCount = count;
+            if (error == 0.0f)
+            {
+                continue;
+            }
+
+            // Levels are ordered by error.
+            previousError = std::max(error, previousError);
+
+            BasicMeshSubmesh lod = submesh;
+            lod.indexStart = static_cast<uint32_t>(indices.size());
+            lod.indexCount = static_cast<uint32_t>(count);
+            lod.lodError = previousError;
+            submeshes.push_back(lod);
+            indices.insert(indices.end(), simplified.begin(), simplified.begin() + count);
+        }
+    }
+
+    BasicMeshDesc desc = {};
+    desc.vertices = vertices.data();
+    desc.vertexCount = info.vertexCount;
+    desc.vertexStride = info.vertexStride;
+    desc.attributes = info.attributes;
+    desc.attributeCount = info.attributeCount;
+    desc.indices = indices.data();
+    desc.indexCount = static_cast<uint32_t>(indices.size());
+    desc.submeshes = submeshes.data();
+    desc.submeshCount = static_cast<uint32_t>(submeshes.size());
+    desc.positionBounds = &info.bounds;
+    return WriteBasicMesh(desc, file);
+}
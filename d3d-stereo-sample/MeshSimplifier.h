@@ -0,0 +1,51 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "BasicMeshFormat.h"
+#include "BasicSal.h"
+
+// Mesh simplification for levels of detail, by quadric error edge collapse
+// (Garland and Heckbert, "Surface Simplification Using Quadric Error
+// Metrics", 1997). Vertices are only merged into one another, never moved or
+// created, so every level shares the vertex buffer of the full-detail mesh
+// and needs only its own indices.
+//
+// The error of a level estimates how far, in mesh units, its surface departs
+// from the original: the root of the area-weighted mean squared distance of
+// each merged vertex from the planes of the triangles it absorbed, taking
+// the largest over all merges.
+
+// Simplifies an indexed triangle list until it has at most targetIndexCount
+// indices, or until the next merge would have an error above targetError,
+// whichever comes first. Vertices on open borders and vertices that share
+// their position with another, as along texture seams, are never merged
+// away, so borders and seams stay closed; merges that would flip a triangle
+// or pinch the surface are skipped. positions is the float3 position of
+// vertex i at positions + i * positionStride bytes. Returns the number of
+// indices written to destination, which needs room for indexCount, and the
+// error of the result in resultError.
+size_t SimplifyMesh(
+    _Out_writes_(indexCount) uint32_t* destination,
+    _In_reads_(indexCount) const uint32_t* indices,
+    size_t indexCount,
+    _In_ const float* positions,
+    size_t positionStride,
+    size_t vertexCount,
+    size_t targetIndexCount,
+    float targetError,
+    _Out_opt_ float* resultError = nullptr
+);
+
+// Rewrites a BasicMesh version 2 or 3 file with up to levelCount levels of detail
+// after each full-detail submesh (see BasicMeshSubmesh::lodError), each with
+// about reduction times the triangles of the one before. A submesh gets fewer
+// levels once simplifying it stops paying off. Levels already in the file are
+// replaced. Positions must be float3; simplify before quantizing.
+BasicMeshResult GenerateBasicMeshLods(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    uint32_t levelCount,
+    float reduction,
+    _Out_ std::vector<uint8_t>* file
+);
@@ -0,0 +1,462 @@
+//--------------------------------------------------------------------------------------
+// File: MipmapGenerator.cpp
+//
+// Builds full mip chains for 8-bit, four-channel images on the CPU.
+//
+// Every level is resampled from the one above it with a separable filter: a
+// horizontal pass into a temporary image, then a vertical pass into the level. The
+// filter taps for each destination column and row are computed once per level, with
+// the weights of texels past the edges folded onto the edge texels, so the inner
+// loops are plain weighted sums of four-channel texels. Those sums run on SSE2 or
+// NEON, one texel per vector.
+//--------------------------------------------------------------------------------------
+
+#include "MipmapGenerator.h"
+#include "BasicMath.h"
+#include <math.h>
+#include <string.h>
+#include <thread>
+
+namespace
+{
+    const float KaiserWidth = 3.0f;
+    const float KaiserAlpha = 4.0f;
+
+    // Below this many rows per thread, starting threads costs more than it saves.
+    const size_t MinRowsPerThread = 16;
+
+#if defined(BASICMATH_SSE2)
+    typedef __m128 Texel;
+
+    Texel TexelZero() { return _mm_setzero_ps(); }
+    Texel TexelLoad(const float* source) { return _mm_loadu_ps(source); }
+    void TexelStore(float* destination, Texel value) { _mm_storeu_ps(destination, value); }
+    Texel TexelMad(Texel value, float weight, Texel sum) { return _mm_add_ps(_mm_mul_ps(value, _mm_set1_ps(weight)), sum); }
+#elif defined(BASICMATH_NEON)
+    typedef float32x4_t Texel;
+
+    Texel TexelZero() { return vdupq_n_f32(0.0f); }
+    Texel TexelLoad(const float* source) { return vld1q_f32(source); }
+    void TexelStore(float* destination, Texel value) { vst1q_f32(destination, value); }
+    Texel TexelMad(Texel value, float weight, Texel sum) { return vmlaq_n_f32(sum, value, weight); }
+#else
+    struct Texel
+    {
+        float v[4];
+    };
+
+    Texel TexelZero() { return Texel{ { 0.0f, 0.0f, 0.0f, 0.0f } }; }
+    Texel TexelLoad(const float* source) { Texel t; memcpy(t.v, source, sizeof(t.v)); return t; }
+    void TexelStore(float* destination, Texel value) { memcpy(destination, value.v, sizeof(value.v)); }
+    Texel TexelMad(Texel value, float weight, Texel sum)
+    {
+        for (int c = 0; c < 4; c++)
+        {
+            sum.v[c] += value.v[c] * weight;
+        }
+        return sum;
+    }
+#endif
+
+    float SRGBToLinear(float value)
+    {
+        return (value <= 0.04045f) ? value / 12.92f : powf((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float LinearToSRGB(float value)
+    {
+        return (value <= 0.0031308f) ? value * 12.92f : 1.055f * powf(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    // Decoding goes through a table of the 256 possible values. Encoding finds the
+    // nearest 8-bit value by searching the linear values halfway between codes,
+    // which rounds exactly as encoding with powf and then rounding would.
+    struct ColorTables
+    {
+        float unormToFloat[256];
+        float srgbToLinear[256];
+        float srgbThresholds[255];
+
+        ColorTables()
+        {
+            for (int i = 0; i < 256; i++)
+            {
+                unormToFloat[i] = i / 255.0f;
+                srgbToLinear[i] = SRGBToLinear(i / 255.0f);
+            }
+            for (int i = 0; i < 255; i++)
+            {
+                srgbThresholds[i] = SRGBToLinear((i + 0.5f) / 255.0f);
+            }
+        }
+    };
+
+    const ColorTables& GetColorTables()
+    {
+        static const ColorTables tables;
+        return tables;
+    }
+
+    uint8_t EncodeUNorm(float value)
+    {
+        value = fminf(fmaxf(value, 0.0f), 1.0f);
+        return static_cast<uint8_t>(value * 255.0f + 0.5f);
+    }
+
+    uint8_t EncodeSRGB(const ColorTables& tables, float value)
+    {
+        int low = 0;
+        int high = 255;
+        while (low < high)
+        {
+            int middle = (low + high) / 2;
+            if (value < tables.srgbThresholds[middle])
+            {
+                high = middle;
+            }
+            else
+            {
+                low = middle + 1;
+            }
+        }
+        return static_cast<uint8_t>(low);
+    }
+
+    float BesselI0(float x)
+    {
+        float sum = 1.0f;
+        float term = 1.0f;
+        float halfX = x * 0.5f;
+        for (int k = 1; k < 32; k++)
+        {
+            term *= (halfX / k) * (halfX / k);
+            sum += term;
+            if (term < sum * 1e-7f)
+            {
+                break;
+            }
+        }
+        return sum;
+    }
+
+    float Kaiser(float t)
+    {
+        if (fabsf(t) >= KaiserWidth)
+        {
+            return 0.0f;
+        }
+
+        float sinc = (t == 0.0f) ? 1.0f : sinf(PI_F * t) / (PI_F * t);
+        float ratio = t / KaiserWidth;
+        return sinc * BesselI0(KaiserAlpha * sqrtf(1.0f - ratio * ratio)) / BesselI0(KaiserAlpha);
+    }
+
+    // The source texels and weights that make up each destination texel along one
+    // axis, tapCount of each per destination texel.
+    struct FilterTaps
+    {
+        size_t tapCount;
+        std::vector<uint32_t> indices;
+        std::vector<float> weights;
+    };
+
+    void BuildFilterTaps(size_t sourceSize, size_t destinationSize, MipFilter filter, FilterTaps* taps)
+    {
+        float scale = static_cast<float>(sourceSize) / destinationSize;
+        float radius = (filter == MipFilter::Box) ? scale * 0.5f : KaiserWidth * scale;
+
+        taps->tapCount = static_cast<size_t>(ceilf(radius * 2.0f)) + 1;
+        taps->indices.assign(destinationSize * taps->tapCount, 0);
+        taps->weights.assign(destinationSize * taps->tapCount, 0.0f);
+
+        for (size_t d = 0; d < destinationSize; d++)
+        {
+            uint32_t* indices = &taps->indices[d * taps->tapCount];
+            float* weights = &taps->weights[d * taps->tapCount];
+
+            float center = (d + 0.5f) * scale;
+            long first = static_cast<long>(floorf(center - radius));
+            float total = 0.0f;
+
+            for (size_t tap = 0; tap < taps->tapCount; tap++)
+            {
+                long s = first + static_cast<long>(tap);
+
+                float weight;
+                if (filter == MipFilter::Box)
+                {
+                    weight = fmaxf(0.0f, fminf(s + 1.0f, center + radius) - fmaxf(static_cast<float>(s), center - radius));
+                }
+                else
+                {
+                    weight = Kaiser((s + 0.5f - center) / scale);
+                }
+
+                long clamped = s < 0 ? 0 : (s >= static_cast<long>(sourceSize) ? static_cast<long>(sourceSize) - 1 : s);
+                indices[tap] = static_cast<uint32_t>(clamped);
+                weights[tap] = weight;
+                total += weight;
+            }
+
+            for (size_t tap = 0; tap < taps->tapCount; tap++)
+            {
+                weights[tap] /= total;
+            }
+        }
+    }
+
+    // Runs function(firstRow, lastRow) over bands of rows, the last band on the
+    // calling thread.
+    template <typename Function>
+    void ForEachRowBand(size_t rows, unsigned int threadCount, Function function)
+    {
+        if (threadCount == 0)
+        {
+            threadCount = std::thread::hardware_concurrency();
+        }
+        size_t maxThreads = (rows + MinRowsPerThread - 1) / MinRowsPerThread;
+        if (threadCount > maxThreads)
+        {
+            threadCount = static_cast<unsigned int>(maxThreads);
+        }
+
+        if (threadCount <= 1)
+        {
+            function(size_t(0), rows);
+            return;
+        }
+
+        std::vector<std::thread> threads;
+        threads.reserve(threadCount - 1);
+        for (unsigned int t = 0; t + 1 < threadCount; t++)
+        {
+            threads.emplace_back(function, rows * t / threadCount, rows * (t + 1) / threadCount);
+        }
+        function(rows * (threadCount - 1) / threadCount, rows);
+
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+    }
+
+    void FilterRow(const float* source, const FilterTaps& taps, size_t width, float* destination)
+    {
+        for (size_t x = 0; x < width; x++)
+        {
+            const uint32_t* indices = &taps.indices[x * taps.tapCount];
+            const float* weights = &taps.weights[x * taps.tapCount];
+
+            Texel sum = TexelZero();
+            for (size_t tap = 0; tap < taps.tapCount; tap++)
+            {
+                sum = TexelMad(TexelLoad(source + indices[tap] * 4), weights[tap], sum);
+            }
+            TexelStore(destination + x * 4, sum);
+        }
+    }
+
+    // Filtering happens on linear values premultiplied by alpha, which is what
+    // premultiplied images hold already unless their colors are sRGB-encoded. Opaque
+    // texels go through the tables; the others are unpremultiplied for the sRGB
+    // curve, which applies to the straight color.
+    void DecodeRow(const ColorTables& tables, const MipmapOptions& options, const uint8_t* source, size_t width, float* destination)
+    {
+        const float* colorTable = options.srgb ? tables.srgbToLinear : tables.unormToFloat;
+        bool unpremultiply = options.srgb && options.premultipliedAlpha;
+        for (size_t x = 0; x < width; x++)
+        {
+            uint8_t alpha = source[x * 4 + 3];
+            destination[x * 4 + 3] = tables.unormToFloat[alpha];
+
+            if (!unpremultiply || alpha == 255)
+            {
+                destination[x * 4] = colorTable[source[x * 4]];
+                destination[x * 4 + 1] = colorTable[source[x * 4 + 1]];
+                destination[x * 4 + 2] = colorTable[source[x * 4 + 2]];
+            }
+            else
+            {
+                for (size_t c = 0; c < 3; c++)
+                {
+                    float straight = alpha ? fminf(static_cast<float>(source[x * 4 + c]) / alpha, 1.0f) : 0.0f;
+                    destination[x * 4 + c] = SRGBToLinear(straight) * tables.unormToFloat[alpha];
+                }
+            }
+        }
+    }
+
+    void EncodeRow(const ColorTables& tables, const MipmapOptions& options, const float* source, size_t width, uint8_t* destination)
+    {
+        bool premultiply = options.srgb && options.premultipliedAlpha;
+        for (size_t x = 0; x < width; x++)
+        {
+            uint8_t alpha = EncodeUNorm(source[x * 4 + 3]);
+            destination[x * 4 + 3] = alpha;
+
+            if (!options.srgb)
+            {
+                for (size_t c = 0; c < 3; c++)
+                {
+                    destination[x * 4 + c] = EncodeUNorm(source[x * 4 + c]);
+                }
+            }
+            else if (!premultiply)
+            {
+                for (size_t c = 0; c < 3; c++)
+                {
+                    destination[x * 4 + c] = EncodeSRGB(tables, source[x * 4 + c]);
+                }
+            }
+            else
+            {
+                // The color is divided by the filtered alpha and multiplied by the
+                // stored one, so that it never exceeds alpha.
+                float filteredAlpha = source[x * 4 + 3];
+                for (size_t c = 0; c < 3; c++)
+                {
+                    float straight = (filteredAlpha > 0.0f) ? fminf(fmaxf(source[x * 4 + c] / filteredAlpha, 0.0f), 1.0f) : 0.0f;
+                    destination[x * 4 + c] = (alpha == 255)
+                        ? EncodeSRGB(tables, straight)
+                        : EncodeUNorm(LinearToSRGB(straight) * tables.unormToFloat[alpha]);
+                }
+            }
+        }
+    }
+}
+
+//--------------------------------------------------------------------------------------
+size_t GetMipCount(_In_ size_t width, _In_ size_t height)
+{
+    size_t count = 1;
+    while (width > 1 || height > 1)
+    {
+        width = (width > 1) ? width / 2 : 1;
+        height = (height > 1) ? height / 2 : 1;
+        count++;
+    }
+    return count;
+}
+
+//--------------------------------------------------------------------------------------
+DDSResult GenerateMipChain(
+    _In_ const uint8_t* pixels,
+    _In_ size_t rowPitch,
+    _In_ size_t width,
+    _In_ size_t height,
+    _In_ size_t mipCount,
+    _In_ const MipmapOptions& options,
+    _Out_ std::vector<uint8_t>* chain,
+    _Out_ std::vector<DDSSubresource>* levels
+)
+{
+    if (!pixels || !chain || !levels || !width || !height || rowPitch < width * 4 ||
+        !mipCount || mipCount > GetMipCount(width, height))
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    // Lay out the chain first so that the level entries can point into it.
+    levels->resize(mipCount);
+    size_t totalBytes = 0;
+    for (size_t mip = 0, w = width, h = height; mip < mipCount; mip++, w = (w > 1) ? w / 2 : 1, h = (h > 1) ? h / 2 : 1)
+    {
+        DDSSubresource& level = (*levels)[mip];
+        level.rowPitch = w * 4;
+        level.slicePitch = w * h * 4;
+        level.numRows = h;
+        level.width = w;
+        level.height = h;
+        level.depth = 1;
+        totalBytes += level.slicePitch;
+    }
+
+    chain->resize(totalBytes);
+    uint8_t* output = chain->data();
+    for (auto& level : *levels)
+    {
+        level.data = output;
+        output += level.slicePitch;
+    }
+
+    uint8_t* level0 = chain->data();
+    for (size_t y = 0; y < height; y++)
+    {
+        memcpy(level0 + y * width * 4, pixels + y * rowPitch, width * 4);
+    }
+
+    const ColorTables& tables = GetColorTables();
+
+    // The previous level in floating point; empty while the previous level is
+    // level 0, which is decoded a row at a time instead.
+    std::vector<float> source;
+    std::vector<float> destination;
+    std::vector<float> horizontal;
+    FilterTaps columnTaps;
+    FilterTaps rowTaps;
+
+    for (size_t mip = 1; mip < mipCount; mip++)
+    {
+        const DDSSubresource& above = (*levels)[mip - 1];
+        const DDSSubresource& level = (*levels)[mip];
+
+        BuildFilterTaps(above.width, level.width, options.filter, &columnTaps);
+        BuildFilterTaps(above.height, level.height, options.filter, &rowTaps);
+
+        // Horizontal pass: every row of the level above, narrowed to this width.
+        horizontal.resize(level.width * above.height * 4);
+        ForEachRowBand(above.height, options.threadCount, [&](size_t firstRow, size_t lastRow)
+        {
+            std::vector<float> decoded;
+            if (source.empty())
+            {
+                decoded.resize(above.width * 4);
+            }
+
+            for (size_t y = firstRow; y < lastRow; y++)
+            {
+                const float* row;
+                if (source.empty())
+                {
+                    DecodeRow(tables, options, above.data + y * above.rowPitch, above.width, decoded.data());
+                    row = decoded.data();
+                }
+                else
+                {
+                    row = source.data() + y * above.width * 4;
+                }
+                FilterRow(row, columnTaps, level.width, horizontal.data() + y * level.width * 4);
+            }
+        });
+
+        // Vertical pass: each row of this level is a weighted sum of rows of the
+        // horizontal pass, accumulated a whole row at a time.
+        destination.resize(level.width * level.height * 4);
+        ForEachRowBand(level.height, options.threadCount, [&](size_t firstRow, size_t lastRow)
+        {
+            for (size_t y = firstRow; y < lastRow; y++)
+            {
+                const uint32_t* indices = &rowTaps.indices[y * rowTaps.tapCount];
+                const float* weights = &rowTaps.weights[y * rowTaps.tapCount];
+                float* row = destination.data() + y * level.width * 4;
+
+                for (size_t x = 0; x < level.width; x++)
+                {
+                    Texel sum = TexelZero();
+                    for (size_t tap = 0; tap < rowTaps.tapCount; tap++)
+                    {
+                        const float* texel = horizontal.data() + (indices[tap] * level.width + x) * 4;
+                        sum = TexelMad(TexelLoad(texel), weights[tap], sum);
+                    }
+                    TexelStore(row + x * 4, sum);
+                }
+
+                EncodeRow(tables, options, row, level.width, const_cast<uint8_t*>(level.data) + y * level.rowPitch);
+            }
+        });
+
+        source.swap(destination);
+    }
+
+    return DDSResult::Ok;
+}
@@ -0,0 +1,71 @@
+//--------------------------------------------------------------------------------------
+// File: MipmapGenerator.h
+//
+// Builds full mip chains for 8-bit, four-channel images on the CPU, so textures that
+// arrive without mips (anything decoded through WIC) can be created with every level
+// filled in. Needs no Windows headers or device.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "BasicSal.h"
+#include "DDSParser.h"
+
+//--------------------------------------------------------------------------------------
+// The reconstruction filters. Box averages the texels each destination texel covers
+// and is the cheapest. Kaiser is a Kaiser-windowed sinc (width 3, alpha 4) that keeps
+// more detail in the smaller levels at the cost of a wider footprint.
+//--------------------------------------------------------------------------------------
+enum class MipFilter
+{
+    Box,
+    Kaiser,
+};
+
+struct MipmapOptions
+{
+    MipFilter filter = MipFilter::Box;
+
+    // When true, the first three channels hold sRGB-encoded values and are filtered
+    // in linear space; the fourth channel is always filtered as stored. Turn it off
+    // for data such as normal maps.
+    bool srgb = true;
+
+    // When true, the first three channels are premultiplied by the fourth, as in the
+    // PBGRA and PRGBA formats WIC converts to. With srgb, they are divided by alpha
+    // before they are decoded and multiplied by it again after they are encoded, so
+    // that the levels hold premultiplied sRGB values like the image does.
+    bool premultipliedAlpha = false;
+
+    // Threads for each filter pass; 0 uses one per hardware thread.
+    unsigned int threadCount = 0;
+};
+
+//--------------------------------------------------------------------------------------
+// The number of levels in a full chain down to 1x1.
+//--------------------------------------------------------------------------------------
+size_t GetMipCount(_In_ size_t width, _In_ size_t height);
+
+//--------------------------------------------------------------------------------------
+// Builds the first mipCount levels of the chain for an image with four 8-bit channels
+// per texel (RGBA or BGRA; only the fourth channel is treated as alpha). Level 0 is a
+// copy of the image. chain receives every level tightly packed, and levels receives
+// one entry per level pointing into chain, in the order D3D11_SUBRESOURCE_DATA wants
+// them for a single texture.
+//
+// Each level is filtered from the previous one in floating point, without rounding
+// to 8 bits between levels. Texels past the edges repeat the edge texels.
+//--------------------------------------------------------------------------------------
+DDSResult GenerateMipChain(
+    _In_ const uint8_t* pixels,
+    _In_ size_t rowPitch,
+    _In_ size_t width,
+    _In_ size_t height,
+    _In_ size_t mipCount,
+    _In_ const MipmapOptions& options,
+    _Out_ std::vector<uint8_t>* chain,
+    _Out_ std::vector<DDSSubresource>* levels
+);
@@ -0,0 +1,197 @@
+#if !defined(_WIN32) && !defined(_FILE_OFFSET_BITS)
+// off_t must be 64 bits for files over 2 GB on 32-bit POSIX builds.
+#define _FILE_OFFSET_BITS 64
+#endif
+
+#include "PlatformFile.h"
+#include <utility>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+PlatformFile::PlatformFile() :
+    m_handle(InvalidHandle),
+    m_size(0)
+{
+}
+
+PlatformFile::~PlatformFile()
+{
+    Close();
+}
+
+PlatformFile::PlatformFile(PlatformFile&& other) noexcept :
+    m_handle(std::exchange(other.m_handle, InvalidHandle)),
+    m_size(std::exchange(other.m_size, 0))
+{
+}
+
+PlatformFile& PlatformFile::operator=(PlatformFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        Close();
+        m_handle = std::exchange(other.m_handle, InvalidHandle);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+#if defined(_WIN32)
+
+bool PlatformFile::Open(
+    _In_z_ const PathChar* path,
+    Access access)
+{
+    Close();
+
+    CREATEFILE2_EXTENDED_PARAMETERS extendedParams = {};
+    extendedParams.dwSize = sizeof(CREATEFILE2_EXTENDED_PARAMETERS);
+    extendedParams.dwFileAttributes = FILE_ATTRIBUTE_NORMAL;
+    extendedParams.dwFileFlags = (access == Access::Random) ? FILE_FLAG_RANDOM_ACCESS : FILE_FLAG_SEQUENTIAL_SCAN;
+    extendedParams.dwSecurityQosFlags = SECURITY_ANONYMOUS;
+
+    HANDLE file = CreateFile2(path, GENERIC_READ, FILE_SHARE_READ, OPEN_EXISTING, &extendedParams);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize = {};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart < 0)
+    {
+        CloseHandle(file);
+        return false;
+    }
+
+    m_handle = reinterpret_cast<intptr_t>(file);
+    m_size = static_cast<uint64_t>(fileSize.QuadPart);
+    return true;
+}
+
+void PlatformFile::Close()
+{
+    if (m_handle != InvalidHandle)
+    {
+        CloseHandle(reinterpret_cast<HANDLE>(m_handle));
+        m_handle = InvalidHandle;
+        m_size = 0;
+    }
+}
+
+bool PlatformFile::Read(
+    uint64_t offset,
+    _Out_writes_bytes_(size) void* buffer,
+    size_t size) const
+{
+    if (m_handle == InvalidHandle || offset > m_size || size > m_size - offset)
+    {
+        return false;
+    }
+
+    uint8_t* destination = static_cast<uint8_t*>(buffer);
+    while (size > 0)
+    {
+        // The offset in the OVERLAPPED makes this a positional read even on a
+        // handle opened for synchronous I/O.
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+        DWORD chunk = static_cast<DWORD>((size < ReadChunkSize) ? size : ReadChunkSize);
+        DWORD bytesRead = 0;
+        if (!ReadFile(reinterpret_cast<HANDLE>(m_handle), destination, chunk, &bytesRead, &overlapped) ||
+            bytesRead == 0)
+        {
+            return false;
+        }
+
+        destination += bytesRead;
+        offset += bytesRead;
+        size -= bytesRead;
+    }
+    return true;
+}
+
+#else
+
+bool PlatformFile::Open(
+    _In_z_ const PathChar* path,
+    Access access)
+{
+    Close();
+
+    int file = open(path, O_RDONLY | O_CLOEXEC);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    struct stat fileInfo;
+    if (fstat(file, &fileInfo) != 0 || fileInfo.st_size < 0)
+    {
+        close(file);
+        return false;
+    }
+
+#if defined(POSIX_FADV_SEQUENTIAL)
+    // Sequential doubles the kernel's read-ahead window; random turns it off
+    // so that small reads into a large archive do not pull in unused pages.
+    posix_fadvise(file, 0, 0, (access == Access::Random) ? POSIX_FADV_RANDOM : POSIX_FADV_SEQUENTIAL);
+#else
+    (void)access;
+#endif
+
+    m_handle = file;
+    m_size = static_cast<uint64_t>(fileInfo.st_size);
+    return true;
+}
+
+void PlatformFile::Close()
+{
+    if (m_handle != InvalidHandle)
+    {
+        close(static_cast<int>(m_handle));
+        m_handle = InvalidHandle;
+        m_size = 0;
+    }
+}
+
+bool PlatformFile::Read(
+    uint64_t offset,
+    _Out_writes_bytes_(size) void* buffer,
+    size_t size) const
+{
+    if (m_handle == InvalidHandle || offset > m_size || size > m_size - offset)
+    {
+        return false;
+    }
+
+    uint8_t* destination = static_cast<uint8_t*>(buffer);
+    while (size > 0)
+    {
+        size_t chunk = (size < ReadChunkSize) ? size : ReadChunkSize;
+        ssize_t bytesRead = pread(static_cast<int>(m_handle), destination, chunk, static_cast<off_t>(offset));
+        if (bytesRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (bytesRead <= 0)
+        {
+            return false;
+        }
+
+        destination += bytesRead;
+        offset += static_cast<uint64_t>(bytesRead);
+        size -= static_cast<size_t>(bytesRead);
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,66 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "BasicSal.h"
+
+// A read-only file handle with positional reads and 64-bit sizes. It is the
+// part of file loading that differs between platforms: CreateFile2 and
+// ReadFile on Windows, open, pread and posix_fadvise elsewhere. Unlike a
+// MappedFile it never needs address space for the whole file, so it can read
+// pieces of files larger than 4 GB on any build.
+class PlatformFile
+{
+public:
+#if defined(_WIN32)
+    typedef wchar_t PathChar;
+#else
+    typedef char PathChar;
+#endif
+
+    // How the file will be read, passed on to the OS cache manager.
+    enum class Access
+    {
+        Sequential,
+        Random,
+    };
+
+    // The most any single read call asks the OS for. Larger reads are split,
+    // because ReadFile takes a 32-bit count and pread may return early.
+    static constexpr size_t ReadChunkSize = 64 * 1024 * 1024;
+
+    PlatformFile();
+    ~PlatformFile();
+
+    PlatformFile(PlatformFile&& other) noexcept;
+    PlatformFile& operator=(PlatformFile&& other) noexcept;
+
+    PlatformFile(const PlatformFile&) = delete;
+    PlatformFile& operator=(const PlatformFile&) = delete;
+
+    // Opens the file at path for reading, closing any file this object
+    // already holds. Returns false if the file cannot be opened.
+    bool Open(
+        _In_z_ const PathChar* path,
+        Access access = Access::Sequential
+    );
+    void Close();
+
+    bool IsOpen() const { return m_handle != InvalidHandle; }
+    uint64_t GetSize() const { return m_size; }
+
+    // Reads exactly size bytes starting at offset into buffer, in chunks of at
+    // most ReadChunkSize. Reads do not share a file position, so several
+    // threads may read one file at once. Returns false on an I/O error or if
+    // the range runs past the end of the file.
+    bool Read(
+        uint64_t offset,
+        _Out_writes_bytes_(size) void* buffer,
+        size_t size
+    ) const;
+
+private:
+    static constexpr intptr_t InvalidHandle = -1;
+
+    intptr_t m_handle;      // a HANDLE on Windows, a file descriptor elsewhere
+    uint64_t m_size;
+};
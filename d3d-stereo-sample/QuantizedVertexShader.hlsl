@@ -0,0 +1,59 @@
+// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+// PARTICULAR PURPOSE.
+//
+// Copyright (c) Microsoft Corporation. All rights reserved
+//----------------------------------------------------------------------
+
+// SimpleVertexShader for QuantizedVertex meshes (see VertexQuantization.h).
+
+cbuffer SimpleConstantBuffer : register(b0)
+{
+    matrix model;
+    matrix view;
+    matrix projection;
+};
+
+// The bounds the positions were quantized against, from
+// LoadedMeshInfo.bounds. w is unused.
+cbuffer QuantizationConstantBuffer : register(b1)
+{
+    float4 positionCenter;
+    float4 positionExtents;
+};
+
+struct sVSInput
+{
+    float4 pos : POSITION;
+    float2 norm : NORMAL;
+    float2 tex : TEXCOORD0;
+};
+
+struct sPSInput
+{
+    float4 pos : SV_POSITION;
+    float3 norm : NORMAL;
+    float2 tex : TEXCOORD0;
+};
+
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 normal = float3(encoded, 1.0f - abs(encoded.x) - abs(encoded.y));
+    float fold = saturate(-normal.z);
+    normal.xy += (normal.xy >= 0.0f) ? -fold : fold;
+    return normalize(normal);
+}
+
+sPSInput main(sVSInput input)
+{
+    sPSInput output;
+    float4 temp = float4(positionCenter.xyz + positionExtents.xyz * input.pos.xyz, 1.0f);
+    temp = mul(temp, model);
+    temp = mul(temp, view);
+    temp = mul(temp, projection);
+    output.pos = temp;
+    output.tex = input.tex;
+    output.norm = mul(float4(DecodeOctahedral(input.norm), 1.0f), model).xyz;
+    return output;
+}
@@ -0,0 +1,905 @@
+#include "ShapeGenerator.h"
+#include <math.h>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+namespace
+{
+    const BasicVertex CubeVertices[] =
+    {
+        { float3(-0.5f, 0.5f, -0.5f), float3(0.0f, 1.0f, 0.0f), float2(0.0f, 0.0f) }, // +Y (top face)
+        { float3(0.5f, 0.5f, -0.5f), float3(0.0f, 1.0f, 0.0f), float2(1.0f, 0.0f) },
+        { float3(0.5f, 0.5f,  0.5f), float3(0.0f, 1.0f, 0.0f), float2(1.0f, 1.0f) },
+        { float3(-0.5f, 0.5f,  0.5f), float3(0.0f, 1.0f, 0.0f), float2(0.0f, 1.0f) },
+
+        { float3(-0.5f, -0.5f,  0.5f), float3(0.0f, -1.0f, 0.0f), float2(0.0f, 0.0f) }, // -Y (bottom face)
+        { float3(0.5f, -0.5f,  0.5f), float3(0.0f, -1.0f, 0.0f), float2(1.0f, 0.0f) },
+        { float3(0.5f, -0.5f, -0.5f), float3(0.0f, -1.0f, 0.0f), float2(1.0f, 1.0f) },
+        { float3(-0.5f, -0.5f, -0.5f), float3(0.0f, -1.0f, 0.0f), float2(0.0f, 1.0f) },
+
+        { float3(0.5f,  0.5f,  0.5f), float3(1.0f, 0.0f, 0.0f), float2(0.0f, 0.0f) }, // +X (right face)
+        { float3(0.5f,  0.5f, -0.5f), float3(1.0f, 0.0f, 0.0f), float2(1.0f, 0.0f) },
+        { float3(0.5f, -0.5f, -0.5f), float3(1.0f, 0.0f, 0.0f), float2(1.0f, 1.0f) },
+        { float3(0.5f, -0.5f,  0.5f), float3(1.0f, 0.0f, 0.0f), float2(0.0f, 1.0f) },
+
+        { float3(-0.5f,  0.5f, -0.5f), float3(-1.0f, 0.0f, 0.0f), float2(0.0f, 0.0f) }, // -X (left face)
+        { float3(-0.5f,  0.5f,  0.5f), float3(-1.0f, 0.0f, 0.0f), float2(1.0f, 0.0f) },
+        { float3(-0.5f, -0.5f,  0.5f), float3(-1.0f, 0.0f, 0.0f), float2(1.0f, 1.0f) },
+        { float3(-0.5f, -0.5f, -0.5f), float3(-1.0f, 0.0f, 0.0f), float2(0.0f, 1.0f) },
+
+        { float3(-0.5f,  0.5f, 0.5f), float3(0.0f, 0.0f, 1.0f), float2(0.0f, 0.0f) }, // +Z (front face)
+        { float3(0.5f,  0.5f, 0.5f), float3(0.0f, 0.0f, 1.0f), float2(1.0f, 0.0f) },
+        { float3(0.5f, -0.5f, 0.5f), float3(0.0f, 0.0f, 1.0f), float2(1.0f, 1.0f) },
+        { float3(-0.5f, -0.5f, 0.5f), float3(0.0f, 0.0f, 1.0f), float2(0.0f, 1.0f) },
+
+        { float3(0.5f,  0.5f, -0.5f), float3(0.0f, 0.0f, -1.0f), float2(0.0f, 0.0f) }, // -Z (back face)
+        { float3(-0.5f,  0.5f, -0.5f), float3(0.0f, 0.0f, -1.0f), float2(1.0f, 0.0f) },
+        { float3(-0.5f, -0.5f, -0.5f), float3(0.0f, 0.0f, -1.0f), float2(1.0f, 1.0f) },
+        { float3(0.5f, -0.5f, -0.5f), float3(0.0f, 0.0f, -1.0f), float2(0.0f, 1.0f) },
+    };
+
+    const uint16_t CubeIndices[] =
+    {
+        0, 1, 2,
+        0, 2, 3,
+
+        4, 5, 6,
+        4, 6, 7,
+
+        8, 9, 10,
+        8, 10, 11,
+
+        12, 13, 14,
+        12, 14, 15,
+
+        16, 17, 18,
+        16, 18, 19,
+
+        20, 21, 22,
+        20, 22, 23
+    };
+
+    const uint16_t BoxIndices[] =
+    {
+        0, 2, 1,
+        1, 2, 3,
+
+        4, 6, 5,
+        5, 6, 7,
+
+        8, 10, 9,
+        9, 10, 11,
+
+        12, 14, 13,
+        13, 14, 15,
+
+        16, 18, 17,
+        17, 18, 19,
+
+        20, 22, 21,
+        21, 22, 23,
+    };
+
+    const BasicVertex AxisVertices[] =
+    {
+        { float3(0.500f, 0.000f, 0.000f), float3(0.125f, 0.500f, 0.500f), float2(0.250f, 0.250f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(0.125f, 0.500f, 0.500f), float2(0.250f, 0.250f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(0.125f, 0.500f, 0.500f), float2(0.250f, 0.250f) },
+        { float3(0.500f, 0.000f, 0.000f), float3(0.125f,-0.500f, 0.500f), float2(0.250f, 0.250f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(0.125f,-0.500f, 0.500f), float2(0.250f, 0.250f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(0.125f,-0.500f, 0.500f), float2(0.250f, 0.250f) },
+        { float3(0.500f, 0.000f, 0.000f), float3(0.125f,-0.500f,-0.500f), float2(0.250f, 0.250f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(0.125f,-0.500f,-0.500f), float2(0.250f, 0.250f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(0.125f,-0.500f,-0.500f), float2(0.250f, 0.250f) },
+        { float3(0.500f, 0.000f, 0.000f), float3(0.125f, 0.500f,-0.500f), float2(0.250f, 0.250f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(0.125f, 0.500f,-0.500f), float2(0.250f, 0.250f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(0.125f, 0.500f,-0.500f), float2(0.250f, 0.250f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(-0.125f, 0.000f, 0.000f), float2(0.250f, 0.250f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(-0.125f, 0.000f, 0.000f), float2(0.250f, 0.250f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(-0.125f, 0.000f, 0.000f), float2(0.250f, 0.250f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(-0.125f, 0.000f, 0.000f), float2(0.250f, 0.250f) },
+        { float3(-0.500f, 0.000f, 0.000f), float3(-0.125f, 0.500f, 0.500f), float2(0.250f, 0.500f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(-0.125f, 0.500f, 0.500f), float2(0.250f, 0.500f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(-0.125f, 0.500f, 0.500f), float2(0.250f, 0.500f) },
+        { float3(-0.500f, 0.000f, 0.000f), float3(-0.125f, 0.500f,-0.500f), float2(0.250f, 0.500f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(-0.125f, 0.500f,-0.500f), float2(0.250f, 0.500f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(-0.125f, 0.500f,-0.500f), float2(0.250f, 0.500f) },
+        { float3(-0.500f, 0.000f, 0.000f), float3(-0.125f,-0.500f,-0.500f), float2(0.250f, 0.500f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(-0.125f,-0.500f,-0.500f), float2(0.250f, 0.500f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(-0.125f,-0.500f,-0.500f), float2(0.250f, 0.500f) },
+        { float3(-0.500f, 0.000f, 0.000f), float3(-0.125f,-0.500f, 0.500f), float2(0.250f, 0.500f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(-0.125f,-0.500f, 0.500f), float2(0.250f, 0.500f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(-0.125f,-0.500f, 0.500f), float2(0.250f, 0.500f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(0.125f, 0.000f, 0.000f), float2(0.250f, 0.500f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(0.125f, 0.000f, 0.000f), float2(0.250f, 0.500f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(0.125f, 0.000f, 0.000f), float2(0.250f, 0.500f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(0.125f, 0.000f, 0.000f), float2(0.250f, 0.500f) },
+        { float3(0.000f, 0.500f, 0.000f), float3(0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
+        { float3(0.000f, 0.500f, 0.000f), float3(0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
+        { float3(0.000f, 0.500f, 0.000f), float3(-0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(-0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f, 0.125f,-0.500f), float2(0.500f, 0.250f) },
+        { float3(0.000f, 0.500f, 0.000f), float3(-0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(-0.500f, 0.125f, 0.500f), float2(0.500f, 0.250f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.000f,-0.125f, 0.000f), float2(0.500f, 0.250f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(0.000f,-0.125f, 0.000f), float2(0.500f, 0.250f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(0.000f,-0.125f, 0.000f), float2(0.500f, 0.250f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(0.000f,-0.125f, 0.000f), float2(0.500f, 0.250f) },
+        { float3(0.000f,-0.500f, 0.000f), float3(0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
+        { float3(0.000f,-0.500f, 0.000f), float3(-0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(-0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f,-0.125f, 0.500f), float2(0.500f, 0.500f) },
+        { float3(0.000f,-0.500f, 0.000f), float3(-0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(-0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
+        { float3(0.000f,-0.500f, 0.000f), float3(0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.500f,-0.125f,-0.500f), float2(0.500f, 0.500f) },
+        { float3(0.000f, 0.000f,-0.125f), float3(0.000f, 0.125f, 0.000f), float2(0.500f, 0.500f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(0.000f, 0.125f, 0.000f), float2(0.500f, 0.500f) },
+        { float3(0.000f, 0.000f, 0.125f), float3(0.000f, 0.125f, 0.000f), float2(0.500f, 0.500f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.000f, 0.125f, 0.000f), float2(0.500f, 0.500f) },
+        { float3(0.000f, 0.000f, 0.500f), float3(0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(0.000f, 0.000f, 0.500f), float3(-0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(-0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f, 0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(0.000f, 0.000f, 0.500f), float3(-0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(-0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(0.000f, 0.000f, 0.500f), float3(0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.500f,-0.500f, 0.125f), float2(0.750f, 0.250f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.000f, 0.000f,-0.125f), float2(0.750f, 0.250f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(0.000f, 0.000f,-0.125f), float2(0.750f, 0.250f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(0.000f, 0.000f,-0.125f), float2(0.750f, 0.250f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(0.000f, 0.000f,-0.125f), float2(0.750f, 0.250f) },
+        { float3(0.000f, 0.000f,-0.500f), float3(0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(0.000f, 0.000f,-0.500f), float3(0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(0.000f, 0.000f,-0.500f), float3(-0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(-0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f,-0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(0.000f, 0.000f,-0.500f), float3(-0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(-0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(-0.500f, 0.500f,-0.125f), float2(0.750f, 0.500f) },
+        { float3(0.000f, 0.125f, 0.000f), float3(0.000f, 0.000f, 0.125f), float2(0.750f, 0.500f) },
+        { float3(-0.125f, 0.000f, 0.000f), float3(0.000f, 0.000f, 0.125f), float2(0.750f, 0.500f) },
+        { float3(0.000f,-0.125f, 0.000f), float3(0.000f, 0.000f, 0.125f), float2(0.750f, 0.500f) },
+        { float3(0.125f, 0.000f, 0.000f), float3(0.000f, 0.000f, 0.125f), float2(0.750f, 0.500f) },
+    };
+
+    const uint16_t AxisIndices[] =
+    {
+         0,  2,  1,
+         3,  5,  4,
+         6,  8,  7,
+         9, 11, 10,
+        12, 14, 13,
+        12, 15, 14,
+        16, 18, 17,
+        19, 21, 20,
+        22, 24, 23,
+        25, 27, 26,
+        28, 30, 29,
+        28, 31, 30,
+        32, 34, 33,
+        35, 37, 36,
+        38, 40, 39,
+        41, 43, 42,
+        44, 46, 45,
+        44, 47, 46,
+        48, 50, 49,
+        51, 53, 52,
+        54, 56, 55,
+        57, 59, 58,
+        60, 62, 61,
+        60, 63, 62,
+        64, 66, 65,
+        67, 69, 68,
+        70, 72, 71,
+        73, 75, 74,
+        76, 78, 77,
+        76, 79, 78,
+        80, 82, 81,
+        83, 85, 84,
+        86, 88, 87,
+        89, 91, 90,
+        92, 94, 93,
+        92, 95, 94,
+    };
+
+    const uint32_t BoxVertexCount = 24;
+
+    // The icosahedron that IcosphereDesc subdivides: the corners are the
+    // cyclic permutations of (0, +-1, +-golden ratio), normalized when used.
+    const float IcosahedronCorners[12][3] =
+    {
+        { -1.0f,  1.618034f, 0.0f }, { 1.0f,  1.618034f, 0.0f }, { -1.0f, -1.618034f, 0.0f }, { 1.0f, -1.618034f, 0.0f },
+        { 0.0f, -1.0f,  1.618034f }, { 0.0f, 1.0f,  1.618034f }, { 0.0f, -1.0f, -1.618034f }, { 0.0f, 1.0f, -1.618034f },
+        { 1.618034f, 0.0f, -1.0f }, { 1.618034f, 0.0f,  1.0f }, { -1.618034f, 0.0f, -1.0f }, { -1.618034f, 0.0f,  1.0f },
+    };
+
+    const uint8_t IcosahedronFaces[20][3] =
+    {
+        { 0, 5, 11 }, { 0, 1, 5 }, { 0, 7, 1 }, { 0, 10, 7 }, { 0, 11, 10 },
+        { 1, 9, 5 }, { 5, 4, 11 }, { 11, 2, 10 }, { 10, 6, 7 }, { 7, 8, 1 },
+        { 3, 4, 9 }, { 3, 2, 4 }, { 3, 6, 2 }, { 3, 8, 6 }, { 3, 9, 8 },
+        { 4, 5, 9 }, { 2, 11, 4 }, { 6, 10, 2 }, { 8, 7, 6 }, { 9, 1, 8 },
+    };
+
+    const uint32_t IcosahedronEdgeCount = 30;
+
+    ShapeSize MakeSize(uint64_t vertexCount, uint64_t indexCount)
+    {
+        if (vertexCount > UINT32_MAX || indexCount > UINT32_MAX)
+        {
+            return ShapeSize{ 0, 0 };
+        }
+        return ShapeSize{ static_cast<uint32_t>(vertexCount), static_cast<uint32_t>(indexCount) };
+    }
+
+    template <class Index>
+    bool CanGenerate(ShapeSize size, size_t vertexCapacity, size_t indexCapacity)
+    {
+        return size.vertexCount != 0 &&
+            vertexCapacity >= size.vertexCount && indexCapacity >= size.indexCount &&
+            size.vertexCount - 1 <= std::numeric_limits<Index>::max();
+    }
+
+    template <class Index>
+    bool CopyShape(
+        const BasicVertex* sourceVertices,
+        size_t vertexCount,
+        const uint16_t* sourceIndices,
+        size_t indexCount,
+        BasicVertex* vertices,
+        size_t vertexCapacity,
+        Index* indices,
+        size_t indexCapacity
+    )
+    {
+        ShapeSize size = MakeSize(vertexCount, indexCount);
+        if (!CanGenerate<Index>(size, vertexCapacity, indexCapacity))
+        {
+            return false;
+        }
+        std::copy(sourceVertices, sourceVertices + vertexCount, vertices);
+        std::copy(sourceIndices, sourceIndices + indexCount, indices);
+        return true;
+    }
+
+    // Writes the two triangles of each cell of a grid of rows + 1 by
+    // columns + 1 vertices stored row by row, with the winding of the UV
+    // sphere: row r + 1 lies below row r as seen from the front.
+    template <class Index>
+    Index* WriteGridIndices(Index* indices, uint32_t rows, uint32_t columns)
+    {
+        for (uint32_t row = 0; row < rows; row++)
+        {
+            uint32_t rowBase0 = row * (columns + 1);
+            uint32_t rowBase1 = rowBase0 + columns + 1;
+            for (uint32_t column = 0; column < columns; column++)
+            {
+                *indices++ = static_cast<Index>(rowBase0 + column);
+                *indices++ = static_cast<Index>(rowBase0 + column + 1);
+                *indices++ = static_cast<Index>(rowBase1 + column + 1);
+                *indices++ = static_cast<Index>(rowBase0 + column);
+                *indices++ = static_cast<Index>(rowBase1 + column + 1);
+                *indices++ = static_cast<Index>(rowBase1 + column);
+            }
+        }
+        return indices;
+    }
+
+    // The sphere's rings skip the triangles that would collapse into the
+    // poles, leaving a fan around each pole.
+    template <class Index>
+    void WriteSphereIndices(Index* indices, uint32_t segments, uint32_t slices)
+    {
+        for (uint32_t slice = 0; slice < slices; slice++)
+        {
+            uint32_t sliceBase0 = slice * (segments + 1);
+            uint32_t sliceBase1 = (slice + 1) * (segments + 1);
+            for (uint32_t segment = 0; segment < segments; segment++)
+            {
+                if (slice > 0)
+                {
+                    *indices++ = static_cast<Index>(sliceBase0 + segment);
+                    *indices++ = static_cast<Index>(sliceBase0 + segment + 1);
+                    *indices++ = static_cast<Index>(sliceBase1 + segment + 1);
+                }
+                if (slice < slices - 1)
+                {
+                    *indices++ = static_cast<Index>(sliceBase0 + segment);
+                    *indices++ = static_cast<Index>(sliceBase1 + segment + 1);
+                    *indices++ = static_cast<Index>(sliceBase1 + segment);
+                }
+            }
+        }
+    }
+
+    // Finds the icosahedron edges, each as its lower corner then its higher
+    // one, in the order the faces first use them.
+    void FindIcosahedronEdges(uint8_t edges[IcosahedronEdgeCount][2])
+    {
+        uint32_t edgeCount = 0;
+        for (const uint8_t* face : IcosahedronFaces)
+        {
+            for (int e = 0; e < 3; e++)
+            {
+                uint8_t low = std::min(face[e], face[(e + 1) % 3]);
+                uint8_t high = std::max(face[e], face[(e + 1) % 3]);
+                bool found = false;
+                for (uint32_t i = 0; i < edgeCount && !found; i++)
+                {
+                    found = edges[i][0] == low && edges[i][1] == high;
+                }
+                if (!found)
+                {
+                    edges[edgeCount][0] = low;
+                    edges[edgeCount][1] = high;
+                    edgeCount++;
+                }
+            }
+        }
+    }
+
+    // Numbers the vertices of the subdivided icosahedron without a lookup
+    // table: the 12 corners first, then frequency - 1 vertices along each
+    // edge, counted from its lower corner, then the interior vertices of
+    // each face, row by row.
+    class IcosphereIndexer
+    {
+    public:
+        IcosphereIndexer(uint32_t frequency) :
+            m_frequency(frequency)
+        {
+            FindIcosahedronEdges(m_edges);
+        }
+
+        const uint8_t* GetEdge(uint32_t edge) const
+        {
+            return m_edges[edge];
+        }
+
+        uint32_t EdgeVertex(uint32_t edge, uint32_t step) const
+        {
+            return 12 + edge * (m_frequency - 1) + (step - 1);
+        }
+
+        uint32_t InteriorVertex(uint32_t face, uint32_t row, uint32_t column) const
+        {
+            uint32_t perFace = (m_frequency - 1) * (m_frequency - 2) / 2;
+            return 12 + IcosahedronEdgeCount * (m_frequency - 1) + face * perFace +
+                (row - 2) * (row - 1) / 2 + (column - 1);
+        }
+
+        // The vertex at step of frequency from corner a to corner b.
+        uint32_t AlongEdge(uint32_t a, uint32_t b, uint32_t step) const
+        {
+            if (step == 0)
+            {
+                return a;
+            }
+            if (step == m_frequency)
+            {
+                return b;
+            }
+            for (uint32_t edge = 0; edge < IcosahedronEdgeCount; edge++)
+            {
+                if (m_edges[edge][0] == std::min(a, b) && m_edges[edge][1] == std::max(a, b))
+                {
+                    return EdgeVertex(edge, (a < b) ? step : m_frequency - step);
+                }
+            }
+            return 0;
+        }
+
+        // The vertex at row, column of face, where row runs from 0 at the
+        // first corner to frequency at the edge between the other two, and
+        // column from 0 to row along that row.
+        uint32_t FaceVertex(uint32_t face, uint32_t row, uint32_t column) const
+        {
+            const uint8_t* corners = IcosahedronFaces[face];
+            if (column == 0)
+            {
+                return AlongEdge(corners[0], corners[1], row);
+            }
+            if (column == row)
+            {
+                return AlongEdge(corners[0], corners[2], row);
+            }
+            if (row == m_frequency)
+            {
+                return AlongEdge(corners[1], corners[2], column);
+            }
+            return InteriorVertex(face, row, column);
+        }
+
+    private:
+        uint32_t m_frequency;
+        uint8_t m_edges[IcosahedronEdgeCount][2];
+    };
+
+    BasicVertex MakeIcosphereVertex(float3 direction, float radius)
+    {
+        float3 normal = normalize(direction);
+        BasicVertex vertex;
+        vertex.pos = normal * radius;
+        vertex.norm = normal;
+        vertex.tex = float2(
+            0.5f + atan2f(normal.x, normal.z) / (2.0f * PI_F),
+            acosf(std::max(-1.0f, std::min(normal.y, 1.0f))) / PI_F
+        );
+        return vertex;
+    }
+}
+
+ShapeSize GetCubeSize()
+{
+    return MakeSize(std::size(CubeVertices), std::size(CubeIndices));
+}
+
+ShapeSize GetBoxSize()
+{
+    return MakeSize(BoxVertexCount, std::size(BoxIndices));
+}
+
+ShapeSize GetReferenceAxisSize()
+{
+    return MakeSize(std::size(AxisVertices), std::size(AxisIndices));
+}
+
+ShapeSize GetSphereSize(const SphereDesc& desc)
+{
+    if (desc.segments < 3 || desc.slices < 2)
+    {
+        return ShapeSize{ 0, 0 };
+    }
+    return MakeSize(
+        (static_cast<uint64_t>(desc.slices) + 1) * (static_cast<uint64_t>(desc.segments) + 1),
+        static_cast<uint64_t>(desc.slices - 1) * desc.segments * 6
+    );
+}
+
+ShapeSize GetIcosphereSize(const IcosphereDesc& desc)
+{
+    if (desc.frequency < 1 || desc.frequency > 0x10000)
+    {
+        return ShapeSize{ 0, 0 };
+    }
+    uint64_t squared = static_cast<uint64_t>(desc.frequency) * desc.frequency;
+    return MakeSize(10 * squared + 2, 60 * squared);
+}
+
+ShapeSize GetCylinderSize(const CylinderDesc& desc)
+{
+    if (desc.segments < 3 || desc.stacks < 1)
+    {
+        return ShapeSize{ 0, 0 };
+    }
+    uint64_t segments = desc.segments;
+    uint64_t vertexCount = (static_cast<uint64_t>(desc.stacks) + 1) * (segments + 1);
+    uint64_t indexCount = static_cast<uint64_t>(desc.stacks) * segments * 6;
+    if (desc.caps)
+    {
+        // Each cap has its own center and rim, with the cap's normal.
+        vertexCount += 2 * (segments + 1);
+        indexCount += 2 * segments * 3;
+    }
+    return MakeSize(vertexCount, indexCount);
+}
+
+ShapeSize GetTorusSize(const TorusDesc& desc)
+{
+    if (desc.majorSegments < 3 || desc.minorSegments < 3)
+    {
+        return ShapeSize{ 0, 0 };
+    }
+    return MakeSize(
+        (static_cast<uint64_t>(desc.majorSegments) + 1) * (static_cast<uint64_t>(desc.minorSegments) + 1),
+        static_cast<uint64_t>(desc.majorSegments) * desc.minorSegments * 6
+    );
+}
+
+ShapeSize GetGridSize(const GridDesc& desc)
+{
+    if (desc.xDivisions < 1 || desc.zDivisions < 1)
+    {
+        return ShapeSize{ 0, 0 };
+    }
+    return MakeSize(
+        (static_cast<uint64_t>(desc.xDivisions) + 1) * (static_cast<uint64_t>(desc.zDivisions) + 1),
+        static_cast<uint64_t>(desc.xDivisions) * desc.zDivisions * 6
+    );
+}
+
+template <class Index>
+bool GenerateCube(
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+)
+{
+    return CopyShape(
+        CubeVertices, std::size(CubeVertices), CubeIndices, std::size(CubeIndices),
+        vertices, vertexCapacity, indices, indexCapacity
+    );
+}
+
+template <class Index>
+bool GenerateBox(
+    float3 r,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+)
+{
+    const BasicVertex boxVertices[] =
+    {
+        // FLOOR
+        {float3(-r.x, -r.y,  r.z), float3(0.0f, 1.0f, 0.0f), float2(0.0f, 0.0f)},
+        {float3(r.x, -r.y,  r.z), float3(0.0f, 1.0f, 0.0f), float2(1.0f, 0.0f)},
+        {float3(-r.x, -r.y, -r.z), float3(0.0f, 1.0f, 0.0f), float2(0.0f, 1.5f)},
+        {float3(r.x, -r.y, -r.z), float3(0.0f, 1.0f, 0.0f), float2(1.0f, 1.5f)},
+        // WALL
+        {float3(-r.x,  r.y, r.z), float3(0.0f, 0.0f, -1.0f), float2(0.0f, 0.0f)},
+        {float3(r.x,  r.y, r.z), float3(0.0f, 0.0f, -1.0f), float2(2.0f, 0.0f)},
+        {float3(-r.x, -r.y, r.z), float3(0.0f, 0.0f, -1.0f), float2(0.0f, 1.5f)},
+        {float3(r.x, -r.y, r.z), float3(0.0f, 0.0f, -1.0f), float2(2.0f, 1.5f)},
+        // WALL
+        {float3(r.x,  r.y,  r.z), float3(-1.0f, 0.0f, 0.0f), float2(0.0f, 0.0f)},
+        {float3(r.x,  r.y, -r.z), float3(-1.0f, 0.0f, 0.0f), float2(r.y,  0.0f)},
+        {float3(r.x, -r.y,  r.z), float3(-1.0f, 0.0f, 0.0f), float2(0.0f, 1.5f)},
+        {float3(r.x, -r.y, -r.z), float3(-1.0f, 0.0f, 0.0f), float2(r.y,  1.5f)},
+        // WALL
+        {float3(r.x,  r.y, -r.z), float3(0.0f, 0.0f, 1.0f), float2(0.0f, 0.0f)},
+        {float3(-r.x,  r.y, -r.z), float3(0.0f, 0.0f, 1.0f), float2(2.0f, 0.0f)},
+        {float3(r.x, -r.y, -r.z), float3(0.0f, 0.0f, 1.0f), float2(0.0f, 1.5f)},
+        {float3(-r.x, -r.y, -r.z), float3(0.0f, 0.0f, 1.0f), float2(2.0f, 1.5f)},
+        // WALL
+        {float3(-r.x,  r.y, -r.z), float3(1.0f, 0.0f, 0.0f), float2(0.0f, 0.0f)},
+        {float3(-r.x,  r.y,  r.z), float3(1.0f, 0.0f, 0.0f), float2(r.y,  0.0f)},
+        {float3(-r.x, -r.y, -r.z), float3(1.0f, 0.0f, 0.0f), float2(0.0f, 1.5f)},
+        {float3(-r.x, -r.y,  r.z), float3(1.0f, 0.0f, 0.0f), float2(r.y,  1.5f)},
+        // CEILING
+        {float3(-r.x, r.y, -r.z), float3(0.0f, -1.0f, 0.0f), float2(-0.15f, 0.0f)},
+        {float3(r.x, r.y, -r.z), float3(0.0f, -1.0f, 0.0f), float2(1.25f, 0.0f)},
+        {float3(-r.x, r.y,  r.z), float3(0.0f, -1.0f, 0.0f), float2(-0.15f, 2.1f)},
+        {float3(r.x, r.y,  r.z), float3(0.0f, -1.0f, 0.0f), float2(1.25f, 2.1f)},
+    };
+    return CopyShape(
+        boxVertices, std::size(boxVertices), BoxIndices, std::size(BoxIndices),
+        vertices, vertexCapacity, indices, indexCapacity
+    );
+}
+
+template <class Index>
+bool GenerateReferenceAxis(
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+)
+{
+    return CopyShape(
+        AxisVertices, std::size(AxisVertices), AxisIndices, std::size(AxisIndices),
+        vertices, vertexCapacity, indices, indexCapacity
+    );
+}
+
+template <class Index>
+bool GenerateSphere(
+    const SphereDesc& desc,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+)
+{
+    if (!CanGenerate<Index>(GetSphereSize(desc), vertexCapacity, indexCapacity))
+    {
+        return false;
+    }
+
+    for (uint32_t slice = 0; slice <= desc.slices; slice++)
+    {
+        float v = (float)slice / (float)desc.slices;
+        float inclination = v * PI_F;
+        float y = cos(inclination);
+        float r = sin(inclination);
+        for (uint32_t segment = 0; segment <= desc.segments; segment++)
+        {
+            float u = (float)segment / (float)desc.segments;
+            float azimuth = u * PI_F * 2.0f;
+            BasicVertex& vertex = vertices[slice * (desc.segments + 1) + segment];
+            vertex.norm = float3(r * sin(azimuth), y, r * cos(azimuth));
+            vertex.pos = vertex.norm * desc.radius;
+            vertex.tex = float2(u, v);
+        }
+    }
+
+    WriteSphereIndices(indices, desc.segments, desc.slices);
+    return true;
+}
+
+template <class Index>
+bool GenerateTangentSphere(
+    const SphereDesc& desc,
+    _Out_writes_(vertexCapacity) TangentVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+)
+{
+    if (!CanGenerate<Index>(GetSphereSize(desc), vertexCapacity, indexCapacity))
+    {
+        return false;
+    }
+
+    for (uint32_t slice = 0; slice <= desc.slices; slice++)
+    {
+        float v = (float)slice / (float)desc.slices;
+        float inclination = v * PI_F;
+        float y = cos(inclination);
+        float r = sin(inclination);
+        for (uint32_t segment = 0; segment <= desc.segments; segment++)
+        {
+            float u = (float)segment / (float)desc.segments;
+            float azimuth = u * PI_F * 2.0f;
+            TangentVertex& vertex = vertices[slice * (desc.segments + 1) + segment];
+            vertex.pos = float3(r * sin(azimuth), y, r * cos(azimuth)) * desc.radius;
+            vertex.tex = float2(u, v);
+            vertex.uTan = float3(cos(azimuth), 0, -sin(azimuth));
+            vertex.vTan = float3(cos(inclination) * sin(azimuth), -sin(inclination), cos(inclination) * cos(azimuth));
+        }
+    }
+
+    WriteSphereIndices(indices, desc.segments, desc.slices);
+    return true;
+}
+
+template <class Index>
+bool GenerateIcosphere(
+    const IcosphereDesc& desc,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+)
+{
+    if (!CanGenerate<Index>(GetIcosphereSize(desc), vertexCapacity, indexCapacity))
+    {
+        return false;
+    }
+
+    uint32_t frequency = desc.frequency;
+    IcosphereIndexer indexer(frequency);
+    auto corner = [](uint32_t i)
+    {
+        return float3(IcosahedronCorners[i][0], IcosahedronCorners[i][1], IcosahedronCorners[i][2]);
+    };
+
+    // Vertices shared between faces are written once, from the corners of
+    // their edge, so that both faces agree on them exactly.
+    for (uint32_t i = 0; i < 12; i++)
+    {
+        vertices[i] = MakeIcosphereVertex(corner(i), desc.radius);
+    }
+    for (uint32_t edge = 0; edge < IcosahedronEdgeCount; edge++)
+    {
+        float3 low = corner(indexer.GetEdge(edge)[0]);
+        float3 high = corner(indexer.GetEdge(edge)[1]);
+        for (uint32_t step = 1; step < frequency; step++)
+        {
+            float t = (float)step / (float)frequency;
+            vertices[indexer.EdgeVertex(edge, step)] = MakeIcosphereVertex(low + (high - low) * t, desc.radius);
+        }
+    }
+
+    Index* nextIndex = indices;
+    for (uint32_t face = 0; face < 20; face++)
+    {
+        float3 a = corner(IcosahedronFaces[face][0]);
+        float3 b = corner(IcosahedronFaces[face][1]);
+        float3 c = corner(IcosahedronFaces[face][2]);
+        for (uint32_t row = 2; row < frequency; row++)
+        {
+            for (uint32_t column = 1; column < row; column++)
+            {
+                float3 point = a + (b - a) * ((float)(row - column) / (float)frequency) + (c - a) * ((float)column / (float)frequency);
+                vertices[indexer.InteriorVertex(face, row, column)] = MakeIcosphereVertex(point, desc.radius);
+            }
+        }
+
+        for (uint32_t row = 0; row < frequency; row++)
+        {
+            for (uint32_t column = 0; column <= row; column++)
+            {
+                *nextIndex++ = static_cast<Index>(indexer.FaceVertex(face, row, column));
+                *nextIndex++ = static_cast<Index>(indexer.FaceVertex(face, row + 1, column));
+                *nextIndex++ = static_cast<Index>(indexer.FaceVertex(face, row + 1, column + 1));
+                if (column < row)
+                {
+                    *nextIndex++ = static_cast<Index>(indexer.FaceVertex(face, row, column));
+                    *nextIndex++ = static_cast<Index>(indexer.FaceVertex(face, row + 1, column + 1));
+                    *nextIndex++ = static_cast<Index>(indexer.FaceVertex(face, row, column + 1));
+                }
+            }
+        }
+    }
+    return true;
+}
+
+template <class Index>
+bool GenerateCylinder(
+    const CylinderDesc& desc,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+)
+{
+    if (!CanGenerate<Index>(GetCylinderSize(desc), vertexCapacity, indexCapacity))
+    {
+        return false;
+    }
+
+    // The side, from the top down, with the texture wrapped around it once.
+    float halfHeight = 0.5f * desc.height;
+    for (uint32_t stack = 0; stack <= desc.stacks; stack++)
+    {
+        float v = (float)stack / (float)desc.stacks;
+        for (uint32_t segment = 0; segment <= desc.segments; segment++)
+        {
+            float u = (float)segment / (float)desc.segments;
+            float azimuth = u * PI_F * 2.0f;
+            BasicVertex& vertex = vertices[stack * (desc.segments + 1) + segment];
+            vertex.norm = float3(sin(azimuth), 0.0f, cos(azimuth));
+            vertex.pos = float3(desc.radius * vertex.norm.x, halfHeight - v * desc.height, desc.radius * vertex.norm.z);
+            vertex.tex = float2(u, v);
+        }
+    }
+    Index* nextIndex = WriteGridIndices(indices, desc.stacks, desc.segments);
+
+    if (desc.caps)
+    {
+        // Each cap is a center and a rim of segments vertices, with the
+        // texture mapped straight down onto it.
+        uint32_t capBase = (desc.stacks + 1) * (desc.segments + 1);
+        for (uint32_t cap = 0; cap < 2; cap++)
+        {
+            float side = (cap == 0) ? 1.0f : -1.0f;
+            uint32_t center = capBase + cap * (desc.segments + 1);
+            vertices[center].pos = float3(0.0f, side * halfHeight, 0.0f);
+            vertices[center].norm = float3(0.0f, side, 0.0f);
+            vertices[center].tex = float2(0.5f, 0.5f);
+            for (uint32_t segment = 0; segment < desc.segments; segment++)
+            {
+                float azimuth = (float)segment / (float)desc.segments * PI_F * 2.0f;
+                BasicVertex& vertex = vertices[center + 1 + segment];
+                vertex.pos = float3(desc.radius * sin(azimuth), side * halfHeight, desc.radius * cos(azimuth));
+                vertex.norm = vertices[center].norm;
+                vertex.tex = float2(0.5f + 0.5f * sin(azimuth), 0.5f - 0.5f * side * cos(azimuth));
+            }
+
+            // Going around by increasing azimuth is clockwise seen from
+            // below, so the top cap is wound the other way.
+            for (uint32_t segment = 0; segment < desc.segments; segment++)
+            {
+                uint32_t rim0 = center + 1 + segment;
+                uint32_t rim1 = center + 1 + (segment + 1) % desc.segments;
+                *nextIndex++ = static_cast<Index>(center);
+                *nextIndex++ = static_cast<Index>((cap == 0) ? rim1 : rim0);
+                *nextIndex++ = static_cast<Index>((cap == 0) ? rim0 : rim1);
+            }
+        }
+    }
+    return true;
+}
+
+template <class Index>
+bool GenerateTorus(
+    const TorusDesc& desc,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+)
+{
+    if (!CanGenerate<Index>(GetTorusSize(desc), vertexCapacity, indexCapacity))
+    {
+        return false;
+    }
+
+    // Rows go around the tube, starting from its top, and columns around the
+    // y axis, like the rings of the sphere.
+    for (uint32_t minor = 0; minor <= desc.minorSegments; minor++)
+    {
+        float v = (float)minor / (float)desc.minorSegments;
+        float tubeAngle = v * PI_F * 2.0f;
+        float outwards = sin(tubeAngle);
+        float up = cos(tubeAngle);
+        for (uint32_t major = 0; major <= desc.majorSegments; major++)
+        {
+            float u = (float)major / (float)desc.majorSegments;
+            float azimuth = u * PI_F * 2.0f;
+            float3 radial(sin(azimuth), 0.0f, cos(azimuth));
+            BasicVertex& vertex = vertices[minor * (desc.majorSegments + 1) + major];
+            vertex.norm = float3(outwards * radial.x, up, outwards * radial.z);
+            vertex.pos = radial * desc.majorRadius + vertex.norm * desc.minorRadius;
+            vertex.tex = float2(u, v);
+        }
+    }
+
+    WriteGridIndices(indices, desc.minorSegments, desc.majorSegments);
+    return true;
+}
+
+template <class Index>
+bool GenerateGrid(
+    const GridDesc& desc,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+)
+{
+    if (!CanGenerate<Index>(GetGridSize(desc), vertexCapacity, indexCapacity))
+    {
+        return false;
+    }
+
+    // Rows run from -z to +z, so that seen from above row r + 1 lies below
+    // row r as WriteGridIndices expects.
+    for (uint32_t row = 0; row <= desc.zDivisions; row++)
+    {
+        float v = (float)row / (float)desc.zDivisions;
+        for (uint32_t column = 0; column <= desc.xDivisions; column++)
+        {
+            float u = (float)column / (float)desc.xDivisions;
+            BasicVertex& vertex = vertices[row * (desc.xDivisions + 1) + column];
+            vertex.pos = float3((u - 0.5f) * desc.width, 0.0f, (v - 0.5f) * desc.depth);
+            vertex.norm = float3(0.0f, 1.0f, 0.0f);
+            vertex.tex = float2(u, v);
+        }
+    }
+
+    WriteGridIndices(indices, desc.zDivisions, desc.xDivisions);
+    return true;
+}
+
+// The index types that BasicShapes and BasicMesh files use.
+template bool GenerateCube<uint16_t>(BasicVertex*, size_t, uint16_t*, size_t);
+template bool GenerateBox<uint16_t>(float3, BasicVertex*, size_t, uint16_t*, size_t);
+template bool GenerateReferenceAxis<uint16_t>(BasicVertex*, size_t, uint16_t*, size_t);
+template bool GenerateSphere<uint16_t>(const SphereDesc&, BasicVertex*, size_t, uint16_t*, size_t);
+template bool GenerateTangentSphere<uint16_t>(const SphereDesc&, TangentVertex*, size_t, uint16_t*, size_t);
+template bool GenerateIcosphere<uint16_t>(const IcosphereDesc&, BasicVertex*, size_t, uint16_t*, size_t);
+template bool GenerateCylinder<uint16_t>(const CylinderDesc&, BasicVertex*, size_t, uint16_t*, size_t);
+template bool GenerateTorus<uint16_t>(const TorusDesc&, BasicVertex*, size_t, uint16_t*, size_t);
+template bool GenerateGrid<uint16_t>(const GridDesc&, BasicVertex*, size_t, uint16_t*, size_t);
+template bool GenerateCube<uint32_t>(BasicVertex*, size_t, uint32_t*, size_t);
+template bool GenerateBox<uint32_t>(float3, BasicVertex*, size_t, uint32_t*, size_t);
+template bool GenerateReferenceAxis<uint32_t>(BasicVertex*, size_t, uint32_t*, size_t);
+template bool GenerateSphere<uint32_t>(const SphereDesc&, BasicVertex*, size_t, uint32_t*, size_t);
+template bool GenerateTangentSphere<uint32_t>(const SphereDesc&, TangentVertex*, size_t, uint32_t*, size_t);
+template bool GenerateIcosphere<uint32_t>(const IcosphereDesc&, BasicVertex*, size_t, uint32_t*, size_t);
+template bool GenerateCylinder<uint32_t>(const CylinderDesc&, BasicVertex*, size_t, uint32_t*, size_t);
+template bool GenerateTorus<uint32_t>(const TorusDesc&, BasicVertex*, size_t, uint32_t*, size_t);
+template bool GenerateGrid<uint32_t>(const GridDesc&, BasicVertex*, size_t, uint32_t*, size_t);
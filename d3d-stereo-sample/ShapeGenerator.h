@@ -0,0 +1,172 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "BasicSal.h"
+#include "BasicVertex.h"
+
+// Device-independent geometry for the shapes of BasicShapes. Each shape has a
+// Get...Size function that reports how many vertices and indices it needs and
+// a Generate... function that writes them into caller-provided arrays, so the
+// caller decides where the data lives: a pooled buffer, a mapped upload
+// buffer, or memory owned by a worker thread. Nothing here allocates, so
+// shapes with different descs can be generated in parallel.
+//
+// Indices form triangle lists wound like the rest of the sample: clockwise
+// when seen from the front, as Direct3D culls by default. Generate functions
+// are instantiated for 16- and 32-bit indices; they return false, writing
+// nothing, when the desc is invalid, the arrays are too small, or a vertex
+// index would not fit in Index.
+
+struct ShapeSize
+{
+    uint32_t vertexCount;
+    uint32_t indexCount;
+};
+
+// The UV sphere of BasicShapes: slices rings of latitude from pole to pole,
+// each of segments + 1 vertices so that the texture seam can be split. The
+// vertices come in ring order; run OptimizeMesh to reorder them for the
+// vertex cache, which also drops the two unused seam vertices at the poles.
+struct SphereDesc
+{
+    uint32_t segments = 64;     // around the equator, at least 3
+    uint32_t slices = 32;       // from pole to pole, at least 2
+    float radius = 1.0f;
+};
+
+// A sphere made by subdividing each face of an icosahedron into
+// frequency * frequency triangles, which gives triangles of nearly equal
+// size, unlike the UV sphere's crowded poles. It has no texture seam, so its
+// spherical texture coordinates wrap across the triangles along the -z
+// meridian; prefer SphereDesc for textured spheres.
+struct IcosphereDesc
+{
+    uint32_t frequency = 8;     // at least 1
+    float radius = 1.0f;
+};
+
+// A cylinder around the y axis, centered on the origin, optionally closed
+// with flat caps.
+struct CylinderDesc
+{
+    uint32_t segments = 32;     // around the axis, at least 3
+    uint32_t stacks = 1;        // along the axis, at least 1
+    float radius = 0.5f;
+    float height = 1.0f;
+    bool caps = true;
+};
+
+// A torus around the y axis, centered on the origin.
+struct TorusDesc
+{
+    uint32_t majorSegments = 48;    // around the y axis, at least 3
+    uint32_t minorSegments = 24;    // around the tube, at least 3
+    float majorRadius = 0.5f;       // from the origin to the center of the tube
+    float minorRadius = 0.2f;       // of the tube
+};
+
+// A flat grid in the xz plane, centered on the origin and facing +y, with
+// texture coordinates from 0 to 1 across it.
+struct GridDesc
+{
+    uint32_t xDivisions = 16;   // at least 1
+    uint32_t zDivisions = 16;   // at least 1
+    float width = 1.0f;         // along x
+    float depth = 1.0f;         // along z
+};
+
+// Sizes are 0 for invalid descs and for shapes with more than 2^32 - 1
+// vertices or indices.
+ShapeSize GetCubeSize();
+ShapeSize GetBoxSize();
+ShapeSize GetReferenceAxisSize();
+ShapeSize GetSphereSize(const SphereDesc& desc);
+ShapeSize GetIcosphereSize(const IcosphereDesc& desc);
+ShapeSize GetCylinderSize(const CylinderDesc& desc);
+ShapeSize GetTorusSize(const TorusDesc& desc);
+ShapeSize GetGridSize(const GridDesc& desc);
+
+// A cube of side 1 centered on the origin.
+template <class Index>
+bool GenerateCube(
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+);
+
+// The inside of a box with the given half-sizes: a room whose faces point
+// inwards.
+template <class Index>
+bool GenerateBox(
+    float3 radii,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+);
+
+// Arrows along the three axes, each colored by its texture coordinates.
+template <class Index>
+bool GenerateReferenceAxis(
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+);
+
+template <class Index>
+bool GenerateSphere(
+    const SphereDesc& desc,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+);
+
+// The sphere with the tangents of its texture coordinates in place of the
+// normal; it has the size of GetSphereSize.
+template <class Index>
+bool GenerateTangentSphere(
+    const SphereDesc& desc,
+    _Out_writes_(vertexCapacity) TangentVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+);
+
+template <class Index>
+bool GenerateIcosphere(
+    const IcosphereDesc& desc,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+);
+
+template <class Index>
+bool GenerateCylinder(
+    const CylinderDesc& desc,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+);
+
+template <class Index>
+bool GenerateTorus(
+    const TorusDesc& desc,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+);
+
+template <class Index>
+bool GenerateGrid(
+    const GridDesc& desc,
+    _Out_writes_(vertexCapacity) BasicVertex* vertices,
+    size_t vertexCapacity,
+    _Out_writes_(indexCapacity) Index* indices,
+    size_t indexCapacity
+);
@@ -10,46 +10,31 @@
 
 using namespace DirectX;
 
-StereoParameters CreateDefaultStereoParameters(
-    float viewportWidthInches,
-    float viewportHeightInches,
-    float worldScaleInInches,
-    float stereoExaggeration
+DirectX::XMMATRIX StereoProjectionFieldOfViewRightHand(
+    const StereoParameters& parameters,
+    float nearZ,
+    float farZ,
+    bool rightChannel
 )
 {
-    // The default stereo parameters produced by this method are based on two assumptions:
-    // 1. The viewer's eyes are 24 inches from the display, and
-    // 2. The viewer's eyes are separated by 1.25 inches (interocular distance.)
-    const float DEFAULT_VIEWER_DISTANCE_IN_INCHES = 24.0f;
-    const float DEFAULT_INTEROCULAR_DISTANCE_IN_INCHES = 1.25f;
-
-    StereoParameters parameters;
-    parameters.viewportWidth = viewportWidthInches / worldScaleInInches;
-    parameters.viewportHeight = viewportHeightInches / worldScaleInInches;
-    parameters.viewerDistance = DEFAULT_VIEWER_DISTANCE_IN_INCHES / worldScaleInInches;
-    parameters.interocularDistance = DEFAULT_INTEROCULAR_DISTANCE_IN_INCHES / worldScaleInInches * stereoExaggeration;
-
-    return parameters;
+    return StereoProjectionFieldOfViewRightHand(parameters, nearZ, farZ, rightChannel, StereoDepthMode::Standard);
 }
 
-DirectX::XMMATRIX StereoProjectionFieldOfViewRightHand(
+// Builds the projection for a view whose x:z shear is mFactor. The left and
+// right eyes use +/- interocularDistance / viewportWidth.
+static DirectX::XMMATRIX StereoProjectionForOffset(
     const StereoParameters& parameters,
     float nearZ,
     float farZ,
-    bool rightChannel
+    float mFactor,
+    StereoDepthMode depthMode
 )
 {
     float yScale = 2.f * parameters.viewerDistance / parameters.viewportHeight;
     float xScale = 2.f * parameters.viewerDistance / parameters.viewportWidth;
 
-    float mFactor = -parameters.interocularDistance / parameters.viewportWidth;
-
-    if (!rightChannel)
-    {
-        mFactor = -mFactor;
-    }
-
-    float m22 = farZ / (nearZ - farZ);
+    float m22, m32;
+    GetStereoDepthCoefficients(depthMode, nearZ, farZ, &m22, &m32);
 
     // Construct a stereo perspective projection matrix based on assumptions
     // about the viewer and specified stereo parameters. Note that compared
@@ -68,6 +53,48 @@ DirectX::XMMATRIX StereoProjectionFieldOfViewRightHand(
         xScale, 0, 0, 0,
         0, yScale, 0, 0,
         mFactor, 0, m22, -1,
-        parameters.viewerDistance * mFactor, 0, nearZ * m22, 0
+        parameters.viewerDistance * mFactor, 0, m32, 0
     );
 }
+
+DirectX::XMMATRIX StereoProjectionFieldOfViewRightHand(
+    const StereoParameters& parameters,
+    float nearZ,
+    float farZ,
+    bool rightChannel,
+    StereoDepthMode depthMode
+)
+{
+    float mFactor = -parameters.interocularDistance / parameters.viewportWidth;
+
+    if (!rightChannel)
+    {
+        mFactor = -mFactor;
+    }
+
+    return StereoProjectionForOffset(parameters, nearZ, farZ, mFactor, depthMode);
+}
+
+void StereoProjectionFieldOfViewRightHandMultiView(
+    const StereoParameters& parameters,
+    float nearZ,
+    float farZ,
+    StereoDepthMode depthMode,
+    bool transpose,
+    unsigned int viewCount,
+    _Out_writes_(viewCount) DirectX::XMFLOAT4X4* projections
+)
+{
+    // Views are centered on the viewer and spaced so that each neighbouring
+    // pair has the same separation as the left and right eyes of the
+    // two-view projection. With two views this reproduces it exactly.
+    float step = -parameters.interocularDistance / parameters.viewportWidth;
+    float center = 0.5f * static_cast<float>(viewCount - 1);
+
+    for (unsigned int i = 0; i < viewCount; i++)
+    {
+        float mFactor = 2.f * (static_cast<float>(i) - center) * step;
+        XMMATRIX projection = StereoProjectionForOffset(parameters, nearZ, farZ, mFactor, depthMode);
+        XMStoreFloat4x4(&projections[i], transpose ? XMMatrixTranspose(projection) : projection);
+    }
+}
@@ -6,26 +6,38 @@
 //// Copyright (c) Microsoft Corporation. All rights reserved
 
 #pragma once
+#include "StereoDepth.h"
+#include "StereoParameters.h"
 
-// Stereo parameters are in the same units as the world.
-struct StereoParameters
-{
-    float viewportWidth;        // viewport width
-    float viewportHeight;       // viewport height
-    float viewerDistance;       // distance from viewer
-    float interocularDistance;  // interocular distance
-};
-
-StereoParameters CreateDefaultStereoParameters(
-    float viewportWidthInches,
-    float viewportHeightInches,
-    float worldScaleInInches,
-    float stereoExaggeration
+DirectX::XMMATRIX StereoProjectionFieldOfViewRightHand(
+    const StereoParameters& parameters,
+    float nearZ,
+    float farZ,
+    bool rightChannel
 );
 
+// As above, with a choice of depth mapping. The reverse-Z modes need a
+// GREATER depth test and a depth clear value of 0; the infinite modes ignore
+// farZ.
 DirectX::XMMATRIX StereoProjectionFieldOfViewRightHand(
     const StereoParameters& parameters,
     float nearZ,
     float farZ,
-    bool rightChannel
+    bool rightChannel,
+    StereoDepthMode depthMode
+);
+
+// Generates projections for viewCount horizontally offset views, ordered from
+// the leftmost view to the rightmost, for multi-view (autostereoscopic)
+// displays and multi-camera capture. The matrices are written contiguously so
+// they can be uploaded to a constant buffer in one call; pass transpose = true
+// for HLSL's default column-major packing.
+void StereoProjectionFieldOfViewRightHandMultiView(
+    const StereoParameters& parameters,
+    float nearZ,
+    float farZ,
+    StereoDepthMode depthMode,
+    bool transpose,
+    unsigned int viewCount,
+    _Out_writes_(viewCount) DirectX::XMFLOAT4X4* projections
 );
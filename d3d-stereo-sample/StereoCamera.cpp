@@ -0,0 +1,132 @@
+#include "pch.h"
+#include "StereoCamera.h"
+
+using namespace DirectX;
+
+StereoCamera::StereoCamera()
+{
+    XMStoreFloat4x4(&m_viewTransposed, XMMatrixIdentity());
+}
+
+void StereoCamera::SetViewport(float widthInInches, float heightInInches)
+{
+    m_state.SetViewport(widthInInches, heightInInches);
+}
+
+void StereoCamera::SetWorldScale(float worldScaleInInches)
+{
+    m_state.SetWorldScale(worldScaleInInches);
+}
+
+void StereoCamera::SetStereoExaggeration(float stereoExaggeration)
+{
+    m_state.SetStereoExaggeration(stereoExaggeration);
+}
+
+void StereoCamera::SetStereoEnabled(bool stereoEnabled)
+{
+    m_state.SetStereoEnabled(stereoEnabled);
+}
+
+void StereoCamera::SetDepthRange(float nearZ, float farZ)
+{
+    m_state.SetDepthRange(nearZ, farZ);
+}
+
+void StereoCamera::SetDepthMode(StereoDepthMode depthMode)
+{
+    m_state.SetDepthMode(depthMode);
+}
+
+void StereoCamera::SetView(FXMMATRIX view)
+{
+    // The transposed DirectXMath view matrix is the column-vector form that
+    // BasicMath expects.
+    XMFLOAT4X4 viewTransposed;
+    XMStoreFloat4x4(&viewTransposed, XMMatrixTranspose(view));
+    float4x4 columnView;
+    memcpy(&columnView, &viewTransposed, sizeof(columnView));
+    m_state.SetView(columnView);
+}
+
+const XMFLOAT4X4& StereoCamera::GetView()
+{
+    Recompute();
+    return m_viewTransposed;
+}
+
+const XMFLOAT4X4& StereoCamera::GetProjection(unsigned int eyeIndex)
+{
+    Recompute();
+    return m_projection[eyeIndex ? 1 : 0];
+}
+
+const XMFLOAT4X4& StereoCamera::GetViewProjection(unsigned int eyeIndex)
+{
+    Recompute();
+    return m_viewProjection[eyeIndex ? 1 : 0];
+}
+
+const Frustum& StereoCamera::GetFrustum()
+{
+    Recompute();
+    return m_state.GetFrustum();
+}
+
+float StereoCamera::GetLodScale(float viewportHeightInPixels)
+{
+    return m_state.GetLodScale(viewportHeightInPixels);
+}
+
+float StereoCamera::GetLodDepth(const Sphere& bounds)
+{
+    return m_state.GetLodDepth(bounds);
+}
+
+unsigned int StereoCamera::GetRecomputeCount() const
+{
+    return m_state.GetRecomputeCount();
+}
+
+unsigned int StereoCamera::GetProjectionRecomputeCount() const
+{
+    return m_state.GetProjectionRecomputeCount();
+}
+
+void StereoCamera::Recompute()
+{
+    unsigned int changes = m_state.Update();
+    if (changes == StereoCameraState::ChangedNone)
+    {
+        return;
+    }
+
+    if (changes & StereoCameraState::ChangedView)
+    {
+        memcpy(&m_viewTransposed, &m_state.GetView(), sizeof(m_viewTransposed));
+    }
+
+    if (changes & StereoCameraState::ChangedProjection)
+    {
+        for (unsigned int eyeIndex = 0; eyeIndex < 2; eyeIndex++)
+        {
+            XMMATRIX projection = StereoProjectionFieldOfViewRightHand(
+                m_state.GetParameters(),
+                m_state.GetNearZ(),
+                m_state.GetFarZ(),
+                eyeIndex == 1,
+                m_state.GetDepthMode()
+            );
+            XMStoreFloat4x4(&m_projection[eyeIndex], XMMatrixTranspose(projection));
+        }
+    }
+
+    // (view * projection)^T = projection^T * view^T, so the cached transposed
+    // matrices combine directly.
+    XMMATRIX viewTransposed = XMLoadFloat4x4(&m_viewTransposed);
+    for (unsigned int eyeIndex = 0; eyeIndex < 2; eyeIndex++)
+    {
+        XMMATRIX projectionTransposed = XMLoadFloat4x4(&m_projection[eyeIndex]);
+        XMStoreFloat4x4(&m_viewProjection[eyeIndex], XMMatrixMultiply(projectionTransposed, viewTransposed));
+    }
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include "Stereo3DMatrixHelper.h"
+#include "StereoCameraState.h"
+
+// Owns the view and both eye projections for a stereo (or mono) camera.
+// The projections depend only on the viewport size, world scale, stereo
+// exaggeration and depth range, which change on resize or user input, so
+// they are cached and rebuilt only when one of those inputs changes; a view
+// change only rebuilds the view-projections and the frustum. The dirty
+// tracking lives in StereoCameraState.
+//
+// All matrices are returned transposed, ready to be copied into a constant
+// buffer.
+class StereoCamera
+{
+public:
+    StereoCamera();
+
+    void SetViewport(float widthInInches, float heightInInches);
+    void SetWorldScale(float worldScaleInInches);
+    void SetStereoExaggeration(float stereoExaggeration);
+    void SetStereoEnabled(bool stereoEnabled);
+    void SetDepthRange(float nearZ, float farZ);
+    void SetDepthMode(StereoDepthMode depthMode);
+    void SetView(DirectX::FXMMATRIX view);
+
+    const DirectX::XMFLOAT4X4& GetView();
+    const DirectX::XMFLOAT4X4& GetProjection(unsigned int eyeIndex);
+    const DirectX::XMFLOAT4X4& GetViewProjection(unsigned int eyeIndex);
+
+    // A world-space frustum that contains both eyes' view volumes.
+    const Frustum& GetFrustum();
+
+    // For mesh level-of-detail selection (see MeshLod.h): the pixels per
+    // world unit at a view depth of 1, which both eyes share, and the view
+    // depth of the nearest point of a world-space bounding sphere.
+    float GetLodScale(float viewportHeightInPixels);
+    float GetLodDepth(const Sphere& bounds);
+
+    // The number of times the cached matrices have been rebuilt, and how many
+    // of those rebuilt the projections.
+    unsigned int GetRecomputeCount() const;
+    unsigned int GetProjectionRecomputeCount() const;
+
+private:
+    void Recompute();
+
+    StereoCameraState       m_state;
+    DirectX::XMFLOAT4X4     m_viewTransposed;
+    DirectX::XMFLOAT4X4     m_projection[2];        // left, right
+    DirectX::XMFLOAT4X4     m_viewProjection[2];    // left, right
+};
@@ -0,0 +1,172 @@
+#include "StereoCameraState.h"
+#include "MeshLod.h"
+#include <string.h>
+
+StereoCameraState::StereoCameraState() :
+    m_widthInInches(1.0f),
+    m_heightInInches(1.0f),
+    m_worldScale(1.0f),
+    m_stereoExaggeration(1.0f),
+    m_stereoEnabled(false),
+    m_nearZ(0.01f),
+    m_farZ(100.0f),
+    m_depthMode(StereoDepthMode::Standard),
+    m_view(identity()),
+    m_changes(ChangedProjection | ChangedView),
+    m_recomputeCount(0),
+    m_projectionRecomputeCount(0),
+    m_parameters(),
+    m_frustum()
+{
+}
+
+void StereoCameraState::SetViewport(float widthInInches, float heightInInches)
+{
+    if (widthInInches != m_widthInInches || heightInInches != m_heightInInches)
+    {
+        m_widthInInches = widthInInches;
+        m_heightInInches = heightInInches;
+        m_changes |= ChangedProjection;
+    }
+}
+
+void StereoCameraState::SetWorldScale(float worldScaleInInches)
+{
+    if (worldScaleInInches != m_worldScale)
+    {
+        m_worldScale = worldScaleInInches;
+        m_changes |= ChangedProjection;
+    }
+}
+
+void StereoCameraState::SetStereoExaggeration(float stereoExaggeration)
+{
+    if (stereoExaggeration != m_stereoExaggeration)
+    {
+        m_stereoExaggeration = stereoExaggeration;
+
+        // Mono rendering ignores the exaggeration.
+        if (m_stereoEnabled)
+        {
+            m_changes |= ChangedProjection;
+        }
+    }
+}
+
+void StereoCameraState::SetStereoEnabled(bool stereoEnabled)
+{
+    if (stereoEnabled != m_stereoEnabled)
+    {
+        m_stereoEnabled = stereoEnabled;
+        m_changes |= ChangedProjection;
+    }
+}
+
+void StereoCameraState::SetDepthRange(float nearZ, float farZ)
+{
+    if (nearZ != m_nearZ || farZ != m_farZ)
+    {
+        m_nearZ = nearZ;
+        m_farZ = farZ;
+        m_changes |= ChangedProjection;
+    }
+}
+
+void StereoCameraState::SetDepthMode(StereoDepthMode depthMode)
+{
+    if (depthMode != m_depthMode)
+    {
+        m_depthMode = depthMode;
+        m_changes |= ChangedProjection;
+    }
+}
+
+void StereoCameraState::SetView(const float4x4& view)
+{
+    if (memcmp(&view, &m_view, sizeof(view)) != 0)
+    {
+        m_view = view;
+        m_changes |= ChangedView;
+    }
+}
+
+unsigned int StereoCameraState::Update()
+{
+    unsigned int changes = m_changes;
+    if (changes == ChangedNone)
+    {
+        return ChangedNone;
+    }
+
+    if (changes & ChangedProjection)
+    {
+        // Mono uses zero exaggeration, which makes both eyes identical.
+        m_parameters = CreateDefaultStereoParameters(
+            m_widthInInches,
+            m_heightInInches,
+            m_worldScale,
+            m_stereoEnabled ? m_stereoExaggeration : 0.0f
+        );
+        m_projectionRecomputeCount++;
+    }
+
+    // The frustum depends on both the projections and the view.
+    float farZ = IsInfiniteFar(m_depthMode) ? INFINITY : m_farZ;
+    m_frustum = CreateStereoFrustum(m_parameters, m_nearZ, farZ, m_view);
+
+    m_changes = ChangedNone;
+    m_recomputeCount++;
+    return changes;
+}
+
+const StereoParameters& StereoCameraState::GetParameters() const
+{
+    return m_parameters;
+}
+
+const float4x4& StereoCameraState::GetView() const
+{
+    return m_view;
+}
+
+const Frustum& StereoCameraState::GetFrustum() const
+{
+    return m_frustum;
+}
+
+float StereoCameraState::GetNearZ() const
+{
+    return m_nearZ;
+}
+
+float StereoCameraState::GetFarZ() const
+{
+    return m_farZ;
+}
+
+StereoDepthMode StereoCameraState::GetDepthMode() const
+{
+    return m_depthMode;
+}
+
+float StereoCameraState::GetLodScale(float viewportHeightInPixels) const
+{
+    // The scale does not depend on the eye separation.
+    StereoParameters parameters = CreateDefaultStereoParameters(m_widthInInches, m_heightInInches, m_worldScale, 0.0f);
+    return ComputeLodScale(parameters, viewportHeightInPixels);
+}
+
+float StereoCameraState::GetLodDepth(const Sphere& bounds) const
+{
+    return ComputeLodDepth(m_view, bounds, m_nearZ);
+}
+
+unsigned int StereoCameraState::GetRecomputeCount() const
+{
+    return m_recomputeCount;
+}
+
+unsigned int StereoCameraState::GetProjectionRecomputeCount() const
+{
+    return m_projectionRecomputeCount;
+}
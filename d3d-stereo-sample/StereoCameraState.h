@@ -0,0 +1,76 @@
+#pragma once
+#include "BasicMath.h"
+#include "FrustumCulling.h"
+#include "StereoDepth.h"
+#include "StereoParameters.h"
+
+// The inputs of a stereo camera and what can be derived from them without
+// building the projection matrices: the stereo parameters, the view and the
+// frustum that contains both eyes. StereoCamera adds the DirectXMath
+// matrices on top; keeping this part free of DirectXMath lets the dirty
+// tracking be tested on any platform.
+//
+// Setters only mark the state dirty when a value changes. Update brings the
+// stereo parameters and frustum up to date and reports what changed, so that
+// the caller rebuilds the projections only when their inputs changed, and
+// the view-projections when either the projections or the view did.
+class StereoCameraState
+{
+public:
+    enum Changes
+    {
+        ChangedNone         = 0,
+        ChangedProjection   = 1 << 0,   // the stereo parameters or the depth range or mode
+        ChangedView         = 1 << 1,
+    };
+
+    StereoCameraState();
+
+    void SetViewport(float widthInInches, float heightInInches);
+    void SetWorldScale(float worldScaleInInches);
+    void SetStereoExaggeration(float stereoExaggeration);
+    void SetStereoEnabled(bool stereoEnabled);
+    void SetDepthRange(float nearZ, float farZ);
+    void SetDepthMode(StereoDepthMode depthMode);
+
+    // The world-to-view matrix for column vectors, which is the transpose of
+    // a DirectXMath view matrix.
+    void SetView(const float4x4& view);
+
+    // Returns the Changes since the last call, or ChangedNone when nothing
+    // needs rebuilding.
+    unsigned int Update();
+
+    const StereoParameters& GetParameters() const;
+    const float4x4& GetView() const;
+    const Frustum& GetFrustum() const;
+    float GetNearZ() const;
+    float GetFarZ() const;
+    StereoDepthMode GetDepthMode() const;
+
+    // See MeshLod.h.
+    float GetLodScale(float viewportHeightInPixels) const;
+    float GetLodDepth(const Sphere& bounds) const;
+
+    // The number of Updates that found something to rebuild, and how many of
+    // them rebuilt the projections.
+    unsigned int GetRecomputeCount() const;
+    unsigned int GetProjectionRecomputeCount() const;
+
+private:
+    float               m_widthInInches;
+    float               m_heightInInches;
+    float               m_worldScale;
+    float               m_stereoExaggeration;
+    bool                m_stereoEnabled;
+    float               m_nearZ;
+    float               m_farZ;
+    StereoDepthMode     m_depthMode;
+    float4x4            m_view;
+
+    unsigned int        m_changes;
+    unsigned int        m_recomputeCount;
+    unsigned int        m_projectionRecomputeCount;
+    StereoParameters    m_parameters;
+    Frustum             m_frustum;
+};
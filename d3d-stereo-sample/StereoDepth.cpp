@@ -0,0 +1,135 @@
+#include "StereoDepth.h"
+#include <math.h>
+
+void GetStereoDepthCoefficients(
+    StereoDepthMode mode,
+    float nearZ,
+    float farZ,
+    _Out_ float* zScale,
+    _Out_ float* zOffset
+)
+{
+    switch (mode)
+    {
+    case StereoDepthMode::ReverseZ:
+        *zScale = nearZ / (farZ - nearZ);
+        *zOffset = nearZ * farZ / (farZ - nearZ);
+        break;
+
+    case StereoDepthMode::InfiniteFar:
+        *zScale = -1.0f;
+        *zOffset = -nearZ;
+        break;
+
+    case StereoDepthMode::InfiniteReverseZ:
+        *zScale = 0.0f;
+        *zOffset = nearZ;
+        break;
+
+    default:
+        *zScale = farZ / (nearZ - farZ);
+        *zOffset = nearZ * *zScale;
+        break;
+    }
+}
+
+float ProjectStereoDepth(
+    StereoDepthMode mode,
+    float nearZ,
+    float farZ,
+    float viewDistance
+)
+{
+    float zScale, zOffset;
+    GetStereoDepthCoefficients(mode, nearZ, farZ, &zScale, &zOffset);
+    return (zScale * -viewDistance + zOffset) / viewDistance;
+}
+
+namespace
+{
+    // Rounds a depth value to what the depth buffer format stores.
+    float QuantizeDepth(DepthBufferFormat format, float depth)
+    {
+        depth = fminf(fmaxf(depth, 0.0f), 1.0f);
+        switch (format)
+        {
+        case DepthBufferFormat::Unorm24:
+            return floorf(depth * 16777215.0f + 0.5f) / 16777215.0f;
+        case DepthBufferFormat::Unorm16:
+            return floorf(depth * 65535.0f + 0.5f) / 65535.0f;
+        default:
+            return depth;
+        }
+    }
+
+    // Returns the stored depth value one step further from the viewer.
+    float NextDepth(DepthBufferFormat format, float depth, bool reverseZ)
+    {
+        float target = reverseZ ? 0.0f : 1.0f;
+        switch (format)
+        {
+        case DepthBufferFormat::Unorm24:
+            return depth + (reverseZ ? -1.0f : 1.0f) / 16777215.0f;
+        case DepthBufferFormat::Unorm16:
+            return depth + (reverseZ ? -1.0f : 1.0f) / 65535.0f;
+        default:
+            return nextafterf(depth, target);
+        }
+    }
+
+    // Inverts ProjectStereoDepth in double precision.
+    double UnprojectDepth(StereoDepthMode mode, float nearZ, float farZ, double depth)
+    {
+        float zScale, zOffset;
+        GetStereoDepthCoefficients(mode, nearZ, farZ, &zScale, &zOffset);
+
+        // depth = -zScale + zOffset / distance
+        double denominator = depth + zScale;
+        return (denominator != 0.0) ? zOffset / denominator : HUGE_VAL;
+    }
+}
+
+void MeasureStereoDepthPrecision(
+    StereoDepthMode mode,
+    DepthBufferFormat format,
+    float nearZ,
+    float farZ,
+    float maxDistance,
+    _Out_writes_(sampleCount) DepthPrecisionSample* samples,
+    size_t sampleCount
+)
+{
+    bool reverseZ = IsReverseZ(mode);
+    double ratio = (sampleCount > 1) ? pow(maxDistance / nearZ, 1.0 / (sampleCount - 1)) : 1.0;
+
+    for (size_t i = 0; i < sampleCount; i++)
+    {
+        float distance = static_cast<float>(nearZ * pow(ratio, static_cast<double>(i)));
+        float depth = QuantizeDepth(format, ProjectStereoDepth(mode, nearZ, farZ, distance));
+        float next = NextDepth(format, depth, reverseZ);
+
+        double nextDistance = UnprojectDepth(mode, nearZ, farZ, next);
+        double thisDistance = UnprojectDepth(mode, nearZ, farZ, depth);
+
+        samples[i].viewDistance = distance;
+        samples[i].depth = depth;
+        samples[i].resolution = static_cast<float>(fabs(nextDistance - thisDistance));
+    }
+}
+
+float GetWorstRelativeDepthResolution(
+    _In_reads_(sampleCount) const DepthPrecisionSample* samples,
+    size_t sampleCount
+)
+{
+    float worst = 0.0f;
+    for (size_t i = 0; i < sampleCount; i++)
+    {
+        float relative = samples[i].resolution / samples[i].viewDistance;
+        if (!(relative <= worst))
+        {
+            worst = relative;
+        }
+    }
+    return worst;
+}
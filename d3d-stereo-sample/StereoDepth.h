@@ -0,0 +1,78 @@
+#pragma once
+#include <stddef.h>
+#include "BasicSal.h"
+
+// How view depth maps to the [0, 1] depth buffer range.
+enum class StereoDepthMode
+{
+    Standard,           // nearZ -> 0, farZ -> 1
+    ReverseZ,           // nearZ -> 1, farZ -> 0; use a GREATER depth test and clear to 0
+    InfiniteFar,        // nearZ -> 0, infinity -> 1; farZ is ignored
+    InfiniteReverseZ,   // nearZ -> 1, infinity -> 0; farZ is ignored
+};
+
+inline bool IsReverseZ(StereoDepthMode mode)
+{
+    return mode == StereoDepthMode::ReverseZ || mode == StereoDepthMode::InfiniteReverseZ;
+}
+
+inline bool IsInfiniteFar(StereoDepthMode mode)
+{
+    return mode == StereoDepthMode::InfiniteFar || mode == StereoDepthMode::InfiniteReverseZ;
+}
+
+// Returns the z:z and w:z terms of a right-handed projection, so that a
+// view-space z (negative in front of the viewer) maps to a depth buffer value
+// of (zScale * z + zOffset) / -z.
+void GetStereoDepthCoefficients(
+    StereoDepthMode mode,
+    float nearZ,
+    float farZ,
+    _Out_ float* zScale,
+    _Out_ float* zOffset
+);
+
+// Evaluates the depth buffer value for a point viewDistance units in front of
+// the viewer, in 32-bit float as the GPU computes it.
+float ProjectStereoDepth(
+    StereoDepthMode mode,
+    float nearZ,
+    float farZ,
+    float viewDistance
+);
+
+enum class DepthBufferFormat
+{
+    Float32,    // DXGI_FORMAT_D32_FLOAT
+    Unorm24,    // DXGI_FORMAT_D24_UNORM_S8_UINT
+    Unorm16,    // DXGI_FORMAT_D16_UNORM
+};
+
+struct DepthPrecisionSample
+{
+    float viewDistance;     // distance in front of the viewer
+    float depth;            // depth buffer value stored at that distance
+    float resolution;       // smallest distance change that changes the stored depth
+};
+
+// Samples depth precision at sampleCount distances spaced logarithmically
+// from nearZ to maxDistance. For each distance it finds the neighbouring
+// representable depth value and converts it back to a view distance, giving
+// the depth resolution there. Large resolutions relative to the distance mark
+// where surfaces will z-fight.
+void MeasureStereoDepthPrecision(
+    StereoDepthMode mode,
+    DepthBufferFormat format,
+    float nearZ,
+    float farZ,
+    float maxDistance,
+    _Out_writes_(sampleCount) DepthPrecisionSample* samples,
+    size_t sampleCount
+);
+
+// Returns the largest resolution / viewDistance ratio over the samples, a
+// single figure of merit for comparing depth modes.
+float GetWorstRelativeDepthResolution(
+    _In_reads_(sampleCount) const DepthPrecisionSample* samples,
+    size_t sampleCount
+);
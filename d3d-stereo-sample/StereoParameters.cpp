@@ -0,0 +1,30 @@
+//// THIS CODE AND INFORMATION IS PROVIDED "AS IS" WITHOUT WARRANTY OF
+//// ANY KIND, EITHER EXPRESSED OR IMPLIED, INCLUDING BUT NOT LIMITED TO
+//// THE IMPLIED WARRANTIES OF MERCHANTABILITY AND/OR FITNESS FOR A
+//// PARTICULAR PURPOSE.
+////
+//// Copyright (c) Microsoft Corporation. All rights reserved
+
+#include "StereoParameters.h"
+
+StereoParameters CreateDefaultStereoParameters(
+    float viewportWidthInches,
+    float viewportHeightInches,
+    float worldScaleInInches,
+    float stereoExaggeration
+)
+{
+    // The default stereo parameters produced by this method are based on two assumptions:
+    // 1. The viewer's eyes are 24 inches from the display, and
+    // 2. The viewer's eyes are separated by 1.25 inches (interocular distance.)
+    const float DEFAULT_VIEWER_DISTANCE_IN_INCHES = 24.0f;
+    const float DEFAULT_INTEROCULAR_DISTANCE_IN_INCHES = 1.25f;
+
+    StereoParameters parameters;
+    parameters.viewportWidth = viewportWidthInches / worldScaleInInches;
+    parameters.viewportHeight = viewportHeightInches / worldScaleInInches;
+    parameters.viewerDistance = DEFAULT_VIEWER_DISTANCE_IN_INCHES / worldScaleInInches;
+    parameters.interocularDistance = DEFAULT_INTEROCULAR_DISTANCE_IN_INCHES / worldScaleInInches * stereoExaggeration;
+
+    return parameters;
+}
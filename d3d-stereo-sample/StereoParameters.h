@@ -0,0 +1,20 @@
+#pragma once
+
+// Stereo parameters are in the same units as the world.
+struct StereoParameters
+{
+    float viewportWidth;        // viewport width
+    float viewportHeight;       // viewport height
+    float viewerDistance;       // distance from viewer
+    float interocularDistance;  // interocular distance
+};
+
+// Parameters for a viewer 24 inches from the display with eyes 1.25 inches
+// apart, scaled to world units. An exaggeration of 0 gives both eyes the same
+// view.
+StereoParameters CreateDefaultStereoParameters(
+    float viewportWidthInches,
+    float viewportHeightInches,
+    float worldScaleInInches,
+    float stereoExaggeration
+);
@@ -2,7 +2,7 @@
 #include "StereoSimpleD3D.h"
 #include "BasicLoader.h"
 #include "BasicShapes.h"
-#include "Stereo3DMatrixHelper.h"
+#include "BasicVertexStream.h"
 
 namespace winrt
 {
@@ -12,9 +12,18 @@ namespace winrt
     using namespace Windows::Graphics::Display;
 }
 
+// The most texture data uploaded by the streamer in one frame, in bytes.
+static const size_t TextureStreamingBudget = 256 * 1024;
+
+// The most memory that the sample's textures may hold, in bytes.
+static const uint64_t TextureMemoryBudget = 64 * 1024 * 1024;
+
 StereoSimpleD3D::StereoSimpleD3D()
 {
     m_stereoExaggerationFactor = 1.0f;
+    m_camera.SetStereoExaggeration(m_stereoExaggerationFactor);
+    m_cubeBounds = Sphere{ float3(0.0f, 0.0f, 0.0f), 0.0f };
+    m_cubeVisible = true;
 
     // Developer decided world unit: in this case, modeled in feet.
     // One world unit equals 1 foot. Therefore, m_worldScale * inches = 1 world unit.
@@ -67,6 +76,13 @@ void StereoSimpleD3D::CreateDeviceResources()
     winrt::com_ptr<IWICImagingFactory2> wicFactory;
     auto loader = std::make_unique<BasicLoader>(m_d3dDevice, wicFactory);
 
+    // Every texture the sample creates counts against one budget, including
+    // those created by the loader and the streamer, which are registered as
+    // resident.
+    m_textureResidencyBackend = std::make_unique<D3DTextureResidencyBackend>(m_d3dDevice.get());
+    m_textureResidency = std::make_unique<TextureResidencyManager>(*m_textureResidencyBackend, TextureMemoryBudget);
+    loader->SetTextureResidency(m_textureResidency.get());
+
     loader->LoadShader(
         L"SimpleVertexShader.cso",
         nullptr,
@@ -85,6 +101,15 @@ void StereoSimpleD3D::CreateDeviceResources()
         &m_indexCount
     );
 
+    // The cube only rotates about its center, so one bounding sphere taken
+    // from its model-space positions serves for culling every frame.
+    ShapeSize cubeSize = GetCubeSize();
+    std::vector<BasicVertex> cubeVertices(cubeSize.vertexCount);
+    std::vector<uint16_t> cubeIndices(cubeSize.indexCount);
+    GenerateCube(cubeVertices.data(), cubeVertices.size(), cubeIndices.data(), cubeIndices.size());
+    BasicVertexStream cubeStream(cubeVertices.data(), cubeVertices.size());
+    ComputeBoundingSphere(cubeStream.Positions(), &m_cubeBounds.center, &m_cubeBounds.radius);
+
     // Create the constant buffer for updating model and camera data.
     CD3D11_BUFFER_DESC constantBufferDescription(sizeof(ConstantBuffer), D3D11_BIND_CONSTANT_BUFFER);
     winrt::check_hresult(
@@ -100,11 +125,18 @@ void StereoSimpleD3D::CreateDeviceResources()
         m_pixelShader.put()
     );
 
-    loader->LoadTexture(
-        L"texture.dds",
-        nullptr,
+    // Stream the cube texture in smallest mip first. The view can be bound
+    // right away; Update uploads the larger levels over the next frames.
+    // The streamer allocates the whole mip chain up front, so all of it is
+    // resident as far as the budget is concerned.
+    m_textureStreamer = std::make_unique<DDSTextureStreamer>(m_d3dDevice.get(), m_d3dContext.get());
+    winrt::com_ptr<ID3D11Resource> texture;
+    m_textureStreamer->LoadTexture(
+        BasicReaderWriter().MapData(L"texture.dds"),
+        texture.put(),
         m_textureShaderResourceView.put()
     );
+    RegisterResidentTexture(*m_textureResidency, texture.get());
 
     // Create the sampler.
     D3D11_SAMPLER_DESC samplerDescription;
@@ -159,8 +191,7 @@ void StereoSimpleD3D::CreateWindowSizeDependentResources()
     DirectX::XMFLOAT3 Eye = DirectX::XMFLOAT3(0.0f, 2.0f, 5.0f);
     DirectX::XMFLOAT3 At = DirectX::XMFLOAT3(0.0f, 0.0f, 0.0f);
     DirectX::XMFLOAT3 Up = DirectX::XMFLOAT3(0.0f, 1.0f, 0.0f);
-    DirectX::XMStoreFloat4x4(
-        &m_constantBufferData.view,
+    m_camera.SetView(
         DirectX::XMMatrixLookAtRH(XMLoadFloat3(&Eye), XMLoadFloat3(&At), XMLoadFloat3(&Up))
     );
 
@@ -168,12 +199,11 @@ void StereoSimpleD3D::CreateWindowSizeDependentResources()
     m_widthInInches = m_renderTargetSize.Width / m_dpi;
     m_heightInInches = m_renderTargetSize.Height / m_dpi;
 
-    // Create the projection matrix parameters and set up the initial/mono projection matrix.
-    StereoParameters params = CreateDefaultStereoParameters(m_widthInInches, m_heightInInches, m_worldScale, 0); // Mono uses zero exaggeration.
-    DirectX::XMStoreFloat4x4(
-        &m_constantBufferData.projection,
-        StereoProjectionFieldOfViewRightHand(params, m_nearZ, m_farZ, false) // Channel parameter doesn't matter for mono.
-    );
+    // The camera rebuilds its projection matrices only when these change.
+    m_camera.SetViewport(m_widthInInches, m_heightInInches);
+    m_camera.SetWorldScale(m_worldScale);
+    m_camera.SetDepthRange(m_nearZ, m_farZ);
+    m_camera.SetStereoEnabled(m_stereoEnabled);
 
     m_sampleOverlay->UpdateForWindowSizeChange();
 }
@@ -273,12 +303,15 @@ void StereoSimpleD3D::RenderEye(_In_ unsigned int eyeIndex)
         &pSamplers
     );
 
-    // Draw the cube.
-    m_d3dContext->DrawIndexed(
-        m_indexCount,   // Draw all created vertices.
-        0,              // Start with the first vertex.
-        0               // Start with the first index.
-    );
+    // Draw the cube if it survived culling.
+    if (m_cubeVisible)
+    {
+        m_d3dContext->DrawIndexed(
+            m_indexCount,   // Draw all created vertices.
+            0,              // Start with the first vertex.
+            0               // Start with the first index.
+        );
+    }
 
     // Set the left/right Direct2D target bitmap.
     if (eyeIndex == 0)
@@ -328,47 +361,33 @@ void StereoSimpleD3D::Update(
     _In_ float timeDelta
 )
 {
+    ConstantBuffer constantBuffer;
+
     // Rotate the cube.
     DirectX::XMStoreFloat4x4(
-        &m_constantBufferData.model,
-        DirectX::XMMatrixRotationY(timeTotal)
+        &constantBuffer.model,
+        DirectX::XMMatrixTranspose(DirectX::XMMatrixRotationY(timeTotal))
     );
 
-    if (m_stereoEnabled)
+    // The view and projection matrices are cached by the camera and stored
+    // already transposed. Mono rendering always uses the left eye.
+    m_camera.SetStereoEnabled(m_stereoEnabled);
+    constantBuffer.view = m_camera.GetView();
+    constantBuffer.projection = m_camera.GetProjection(m_stereoEnabled ? eyeIndex : 0);
+
+    // Cull once per frame against a frustum that covers both eyes.
+    if (eyeIndex == 0)
     {
-        StereoParameters parameters = CreateDefaultStereoParameters(m_widthInInches, m_heightInInches, m_worldScale, m_stereoExaggerationFactor);
-        if (eyeIndex == 0)
-        {
-            DirectX::XMStoreFloat4x4(
-                &m_constantBufferData.projection,
-                StereoProjectionFieldOfViewRightHand(parameters, m_nearZ, m_farZ, false)
-            );
-        }
-        else
-        {
-            DirectX::XMStoreFloat4x4(
-                &m_constantBufferData.projection,
-                StereoProjectionFieldOfViewRightHand(parameters, m_nearZ, m_farZ, true)
-            );
-        }
+        m_cubeVisible = IsVisible(m_camera.GetFrustum(), m_cubeBounds);
     }
 
-    // Transpose the matrices in the constant buffer.
-    ConstantBuffer constantBuffer;
-    DirectX::XMStoreFloat4x4(
-        &constantBuffer.model,
-        DirectX::XMMatrixTranspose(DirectX::XMLoadFloat4x4(&m_constantBufferData.model))
-    );
-    DirectX::XMStoreFloat4x4(
-        &constantBuffer.view,
-        DirectX::XMMatrixTranspose(DirectX::XMLoadFloat4x4(&m_constantBufferData.view))
-    );
-    DirectX::XMStoreFloat4x4(
-        &constantBuffer.projection,
-        DirectX::XMMatrixTranspose(DirectX::XMLoadFloat4x4(&m_constantBufferData.projection))
-    );
-
     m_d3dContext->UpdateSubresource(m_constantBuffer.get(), 0, nullptr, &constantBuffer, 0, 0);
+
+    if (eyeIndex == 0)
+    {
+        m_textureResidency->BeginFrame();
+        m_textureStreamer->Update(TextureStreamingBudget);
+    }
 }
 
 float StereoSimpleD3D::GetStereoExaggeration()
@@ -381,4 +400,5 @@ void StereoSimpleD3D::SetStereoExaggeration(_In_ float currentExaggeration)
     currentExaggeration = min(currentExaggeration, 2.0f);
     currentExaggeration = max(currentExaggeration, 0.0f);
     m_stereoExaggerationFactor = currentExaggeration;
+    m_camera.SetStereoExaggeration(currentExaggeration);
 }
@@ -1,6 +1,9 @@
 #pragma once
 #include "DirectXBase.h"
 #include "SampleOverlay.h"
+#include "DDSTextureStreamer.h"
+#include "D3DTextureResidencyBackend.h"
+#include "StereoCamera.h"
 
 // The constant buffer that is used with the DirectXMath library to draw the cube.
 struct ConstantBuffer
@@ -27,6 +30,9 @@ public:
 
 private:
     std::unique_ptr<SampleOverlay> m_sampleOverlay;
+    std::unique_ptr<DDSTextureStreamer> m_textureStreamer;
+    std::unique_ptr<D3DTextureResidencyBackend> m_textureResidencyBackend;
+    std::unique_ptr<TextureResidencyManager> m_textureResidency;
     winrt::com_ptr<ID3D11InputLayout>           m_inputLayout;                // cube vertex input layout
     winrt::com_ptr<ID3D11Buffer>                m_vertexBuffer;               // cube vertex buffer
     winrt::com_ptr<ID3D11Buffer>                m_indexBuffer;                // cube index buffer
@@ -39,7 +45,9 @@ private:
     winrt::com_ptr<IDWriteTextFormat>           m_textFormat;                 // text format for message drawing
 
     unsigned int             m_indexCount;                  // cube index count
-    ConstantBuffer           m_constantBufferData;          // constant buffer resource data
+    Sphere                   m_cubeBounds;                  // cube bounding sphere in model space
+    bool                     m_cubeVisible;                 // whether the cube intersects the stereo frustum
+    StereoCamera             m_camera;                      // cached view and per-eye projections
     float                    m_projAspect;                  // aspect ratio for projection matrix
     float                    m_nearZ;                       // nearest Z-distance at which to draw vertices
     float                    m_farZ;                        // farthest Z-distance at which to draw vertices
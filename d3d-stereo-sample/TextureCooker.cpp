@@ -0,0 +1,92 @@
+//--------------------------------------------------------------------------------------
+// File: TextureCooker.cpp
+//
+// Builds block-compressed DDS files in memory from 8-bit RGBA images.
+//--------------------------------------------------------------------------------------
+
+#include "TextureCooker.h"
+#include "BCEncoder.h"
+
+//--------------------------------------------------------------------------------------
+DDSResult CookBCTexture(
+    _In_ const uint8_t* rgba,
+    _In_ size_t rgbaRowPitch,
+    _In_ size_t width,
+    _In_ size_t height,
+    _In_ DDS_FORMAT format,
+    _In_ DDS_ALPHA_MODE alphaMode,
+    _In_opt_ const MipmapOptions* mipOptions,
+    _In_ unsigned int threadCount,
+    _Out_ std::vector<uint8_t>* ddsFile
+)
+{
+    if (!rgba || !ddsFile || !IsBCEncodable(format) || !width || !height ||
+        (width % 4) != 0 || (height % 4) != 0 || rgbaRowPitch < width * 4)
+    {
+        return DDSResult::InvalidArgument;
+    }
+
+    std::vector<uint8_t> chain;
+    std::vector<DDSSubresource> levels;
+    if (mipOptions)
+    {
+        DDSResult result = GenerateMipChain(rgba, rgbaRowPitch, width, height, GetMipCount(width, height), *mipOptions, &chain, &levels);
+        if (result != DDSResult::Ok)
+        {
+            return result;
+        }
+    }
+    else
+    {
+        DDSSubresource level = {};
+        level.data = rgba;
+        level.rowPitch = rgbaRowPitch;
+        level.width = width;
+        level.height = height;
+        levels.push_back(level);
+    }
+
+    DDSTextureInfo info = {};
+    info.format = format;
+    info.dimension = DDS_DIMENSION_TEXTURE2D;
+    info.width = width;
+    info.height = height;
+    info.depth = 1;
+    info.mipCount = levels.size();
+    info.arraySize = 1;
+    info.alphaMode = alphaMode;
+
+    size_t totalBytes = DDS_WRITTEN_HEADER_SIZE;
+    for (const auto& level : levels)
+    {
+        size_t numBytes;
+        DDSGetSurfaceInfo(level.width, level.height, format, &numBytes, nullptr, nullptr);
+        totalBytes += numBytes;
+    }
+
+    ddsFile->resize(totalBytes);
+    uint8_t* output = ddsFile->data();
+
+    DDSResult result = WriteDDSHeaders(info, output);
+    if (result != DDSResult::Ok)
+    {
+        return result;
+    }
+    output += DDS_WRITTEN_HEADER_SIZE;
+
+    for (const auto& level : levels)
+    {
+        size_t numBytes;
+        size_t rowBytes;
+        DDSGetSurfaceInfo(level.width, level.height, format, &numBytes, &rowBytes, nullptr);
+
+        result = EncodeBCSurface(format, level.data, level.rowPitch, level.width, level.height, output, rowBytes, threadCount);
+        if (result != DDSResult::Ok)
+        {
+            return result;
+        }
+        output += numBytes;
+    }
+
+    return DDSResult::Ok;
+}
@@ -0,0 +1,37 @@
+//--------------------------------------------------------------------------------------
+// File: TextureCooker.h
+//
+// Builds block-compressed DDS files in memory from 8-bit RGBA images, either while
+// loading or ahead of time, so images that arrive in WIC formats reach the GPU at the
+// size of a DDS asset. Needs no Windows headers or device.
+//--------------------------------------------------------------------------------------
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "BasicSal.h"
+#include "DDSParser.h"
+#include "MipmapGenerator.h"
+
+//--------------------------------------------------------------------------------------
+// Encodes an RGBA image to format (see IsBCEncodable) and writes it as a complete DDS
+// file to ddsFile, replacing its contents. With mipOptions the file holds the full
+// chain down to 1x1, built by GenerateMipChain; without it, only the top level.
+//
+// Direct3D needs the top level of a block-compressed texture to be a multiple of four
+// in both dimensions; other sizes return DDSResult::InvalidArgument. threadCount is
+// passed to EncodeBCSurface for each level.
+//--------------------------------------------------------------------------------------
+DDSResult CookBCTexture(
+    _In_ const uint8_t* rgba,
+    _In_ size_t rgbaRowPitch,
+    _In_ size_t width,
+    _In_ size_t height,
+    _In_ DDS_FORMAT format,
+    _In_ DDS_ALPHA_MODE alphaMode,
+    _In_opt_ const MipmapOptions* mipOptions,
+    _In_ unsigned int threadCount,
+    _Out_ std::vector<uint8_t>* ddsFile
+);
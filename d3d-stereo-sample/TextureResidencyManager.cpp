@@ -0,0 +1,234 @@
+#include "TextureResidencyManager.h"
+
+TextureResidencyManager::TextureResidencyManager(
+    TextureResidencyBackend& backend,
+    uint64_t budgetBytes) :
+        m_backend(backend),
+        m_budget(budgetBytes),
+        m_residentBytes(0),
+        m_frame(0)
+{
+}
+
+namespace
+{
+    std::vector<uint64_t> GetLevelSizes(const DDSTextureInfo& info)
+    {
+        std::vector<uint64_t> levelSizes(info.mipCount);
+
+        size_t width = info.width;
+        size_t height = info.height;
+        size_t depth = info.depth;
+        for (size_t mip = 0; mip < info.mipCount; mip++)
+        {
+            size_t numBytes = 0;
+            DDSGetSurfaceInfo(width, height, info.format, &numBytes, nullptr, nullptr);
+            levelSizes[mip] = static_cast<uint64_t>(numBytes) * depth * info.arraySize;
+
+            width = (width > 1) ? width >> 1 : 1;
+            height = (height > 1) ? height >> 1 : 1;
+            depth = (depth > 1) ? depth >> 1 : 1;
+        }
+        return levelSizes;
+    }
+}
+
+TextureResidencyId TextureResidencyManager::Register(
+    _In_reads_(mipCount) const uint64_t* levelSizes,
+    size_t mipCount)
+{
+    return AddEntry(levelSizes, mipCount, false);
+}
+
+TextureResidencyId TextureResidencyManager::Register(const DDSTextureInfo& info)
+{
+    std::vector<uint64_t> levelSizes = GetLevelSizes(info);
+    return Register(levelSizes.data(), levelSizes.size());
+}
+
+TextureResidencyId TextureResidencyManager::RegisterResident(
+    _In_reads_(mipCount) const uint64_t* levelSizes,
+    size_t mipCount)
+{
+    TextureResidencyId id = AddEntry(levelSizes, mipCount, true);
+    MakeRoom(0, InvalidTextureResidencyId);
+    return id;
+}
+
+TextureResidencyId TextureResidencyManager::RegisterResident(const DDSTextureInfo& info)
+{
+    std::vector<uint64_t> levelSizes = GetLevelSizes(info);
+    return RegisterResident(levelSizes.data(), levelSizes.size());
+}
+
+TextureResidencyId TextureResidencyManager::AddEntry(
+    _In_reads_(mipCount) const uint64_t* levelSizes,
+    size_t mipCount,
+    bool external)
+{
+    Entry entry;
+    entry.registered = true;
+    entry.external = external;
+    entry.mipCount = mipCount;
+    entry.residentMip = external ? 0 : mipCount;
+    entry.lastUsedFrame = 0;
+
+    // residentSizes[m] is the memory needed to hold levels m onward.
+    entry.residentSizes.resize(mipCount + 1);
+    entry.residentSizes[mipCount] = 0;
+    for (size_t mip = mipCount; mip > 0; mip--)
+    {
+        entry.residentSizes[mip - 1] = entry.residentSizes[mip] + levelSizes[mip - 1];
+    }
+    m_residentBytes += entry.residentSizes[entry.residentMip];
+
+    TextureResidencyId id;
+    if (!m_freeIds.empty())
+    {
+        id = m_freeIds.back();
+        m_freeIds.pop_back();
+        m_entries[id] = std::move(entry);
+    }
+    else
+    {
+        id = static_cast<TextureResidencyId>(m_entries.size());
+        m_entries.push_back(std::move(entry));
+    }
+    return id;
+}
+
+void TextureResidencyManager::Unregister(TextureResidencyId id)
+{
+    Entry& entry = m_entries[id];
+    if (entry.external)
+    {
+        m_residentBytes -= entry.residentSizes[entry.residentMip];
+    }
+    else if (entry.residentMip < entry.mipCount)
+    {
+        SetResidentMip(id, entry.mipCount);
+    }
+
+    entry.registered = false;
+    entry.residentSizes.clear();
+    m_freeIds.push_back(id);
+}
+
+bool TextureResidencyManager::Request(TextureResidencyId id, size_t desiredMip)
+{
+    Entry& entry = m_entries[id];
+    entry.lastUsedFrame = m_frame;
+
+    if (desiredMip >= entry.mipCount)
+    {
+        desiredMip = entry.mipCount - 1;
+    }
+    if (entry.residentMip <= desiredMip)
+    {
+        return true;
+    }
+
+    uint64_t current = entry.residentSizes[entry.residentMip];
+    MakeRoom(entry.residentSizes[desiredMip] - current, id);
+
+    // Grant the largest level that fits in what is left of the budget.
+    uint64_t available = (m_budget > m_residentBytes) ? m_budget - m_residentBytes : 0;
+    size_t mip = desiredMip;
+    while (mip < entry.residentMip && entry.residentSizes[mip] - current > available)
+    {
+        mip++;
+    }
+
+    if (mip < entry.residentMip)
+    {
+        SetResidentMip(id, mip);
+    }
+    return entry.residentMip <= desiredMip;
+}
+
+void TextureResidencyManager::SetBudget(uint64_t budgetBytes)
+{
+    m_budget = budgetBytes;
+    MakeRoom(0, InvalidTextureResidencyId);
+}
+
+void TextureResidencyManager::BeginFrame()
+{
+    m_frame++;
+}
+
+uint64_t TextureResidencyManager::GetBudget() const
+{
+    return m_budget;
+}
+
+uint64_t TextureResidencyManager::GetResidentBytes() const
+{
+    return m_residentBytes;
+}
+
+size_t TextureResidencyManager::GetResidentMip(TextureResidencyId id) const
+{
+    return m_entries[id].residentMip;
+}
+
+bool TextureResidencyManager::SetResidentMip(TextureResidencyId id, size_t residentMip)
+{
+    Entry& entry = m_entries[id];
+
+    if (residentMip >= entry.mipCount)
+    {
+        m_backend.Evict(id);
+    }
+    else if (!m_backend.MakeResident(id, residentMip))
+    {
+        return false;
+    }
+
+    m_residentBytes -= entry.residentSizes[entry.residentMip];
+    m_residentBytes += entry.residentSizes[residentMip];
+    entry.residentMip = residentMip;
+    return true;
+}
+
+void TextureResidencyManager::MakeRoom(uint64_t bytes, TextureResidencyId requester)
+{
+    // Trim one level at a time from the least recently used texture that
+    // still has more than its smallest level, then evict the least recently
+    // used textures outright.
+    for (int pass = 0; pass < 2; pass++)
+    {
+        while (m_residentBytes + bytes > m_budget)
+        {
+            TextureResidencyId victim = InvalidTextureResidencyId;
+            for (TextureResidencyId id = 0; id < m_entries.size(); id++)
+            {
+                const Entry& entry = m_entries[id];
+                size_t keepMip = (pass == 0) ? entry.mipCount - 1 : entry.mipCount;
+                if (!entry.registered || entry.external || id == requester ||
+                    entry.lastUsedFrame == m_frame || entry.residentMip >= keepMip)
+                {
+                    continue;
+                }
+                if (victim == InvalidTextureResidencyId ||
+                    entry.lastUsedFrame < m_entries[victim].lastUsedFrame)
+                {
+                    victim = id;
+                }
+            }
+
+            if (victim == InvalidTextureResidencyId)
+            {
+                break;
+            }
+
+            const Entry& entry = m_entries[victim];
+            size_t residentMip = (pass == 0) ? entry.residentMip + 1 : entry.mipCount;
+            if (!SetResidentMip(victim, residentMip))
+            {
+                // A backend that cannot shrink a texture can always evict it.
+                SetResidentMip(victim, entry.mipCount);
+            }
+        }
+    }
+}
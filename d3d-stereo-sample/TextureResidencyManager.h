@@ -0,0 +1,116 @@
+#pragma once
+#include <stdint.h>
+#include <vector>
+#include "BasicSal.h"
+#include "DDSParser.h"
+
+typedef uint32_t TextureResidencyId;
+const TextureResidencyId InvalidTextureResidencyId = UINT32_MAX;
+
+// Creates and destroys the memory behind the textures that a
+// TextureResidencyManager tracks. The Direct3D backend recreates textures
+// from their DDS data; a backend that only counts bytes can stand in for it
+// where there is no device.
+class TextureResidencyBackend
+{
+public:
+    virtual ~TextureResidencyBackend() = default;
+
+    // Makes mip levels firstMip through the last level of the texture
+    // resident, replacing whatever was resident before. Returns false if the
+    // memory could not be allocated, in which case the previous levels must
+    // stay resident.
+    virtual bool MakeResident(TextureResidencyId id, size_t firstMip) = 0;
+
+    // Releases all of the texture's memory.
+    virtual void Evict(TextureResidencyId id) = 0;
+};
+
+// Keeps the textures it tracks within a total memory budget. Each texture is
+// resident from some mip level down to its smallest level, or not at all.
+// When a request would exceed the budget, the least recently used textures
+// first lose their top mips, down to their smallest level, and are then
+// evicted. Textures requested since the last BeginFrame are never trimmed,
+// so a request that cannot fit is instead granted fewer levels.
+//
+// Textures created elsewhere, such as by BasicLoader, can be registered as
+// resident so that their memory counts against the budget too. They are
+// never trimmed, since the backend cannot recreate them, and other textures
+// make room for them instead.
+class TextureResidencyManager
+{
+public:
+    TextureResidencyManager(
+        TextureResidencyBackend& backend,
+        uint64_t budgetBytes
+    );
+
+    // Starts tracking a texture, which is not resident until requested.
+    // levelSizes holds the bytes of each mip level across all array slices,
+    // largest level first.
+    TextureResidencyId Register(
+        _In_reads_(mipCount) const uint64_t* levelSizes,
+        size_t mipCount
+    );
+
+    // Registers a parsed DDS texture, with level sizes from DDSGetSurfaceInfo.
+    TextureResidencyId Register(const DDSTextureInfo& info);
+
+    // Starts tracking a texture whose levels are all resident already and
+    // that the backend does not manage, trimming textures not used this frame
+    // if the budget is now exceeded. Unregister it when it is released.
+    TextureResidencyId RegisterResident(
+        _In_reads_(mipCount) const uint64_t* levelSizes,
+        size_t mipCount
+    );
+
+    TextureResidencyId RegisterResident(const DDSTextureInfo& info);
+
+    // Evicts the texture if it is resident and stops tracking it.
+    void Unregister(TextureResidencyId id);
+
+    // Marks the texture as used this frame and makes levels desiredMip and
+    // smaller resident, trimming other textures as needed. Returns true if
+    // desiredMip is resident afterwards; otherwise as many levels as fit are.
+    bool Request(TextureResidencyId id, size_t desiredMip = 0);
+
+    // Changes the budget, trimming textures not used this frame if it is
+    // now exceeded.
+    void SetBudget(uint64_t budgetBytes);
+
+    // Advances the frame used to order textures by their last use.
+    void BeginFrame();
+
+    uint64_t GetBudget() const;
+    uint64_t GetResidentBytes() const;
+
+    // The largest resident level of the texture, or its mip count when it is
+    // not resident.
+    size_t GetResidentMip(TextureResidencyId id) const;
+
+private:
+    struct Entry
+    {
+        bool registered;
+        bool external;                          // registered resident, not through the backend
+        std::vector<uint64_t> residentSizes;    // bytes resident from each level down, plus 0 for none
+        size_t mipCount;
+        size_t residentMip;
+        uint64_t lastUsedFrame;
+    };
+
+    TextureResidencyBackend& m_backend;
+    uint64_t m_budget;
+    uint64_t m_residentBytes;
+    uint64_t m_frame;
+    std::vector<Entry> m_entries;
+    std::vector<TextureResidencyId> m_freeIds;
+
+    TextureResidencyId AddEntry(
+        _In_reads_(mipCount) const uint64_t* levelSizes,
+        size_t mipCount,
+        bool external
+    );
+    bool SetResidentMip(TextureResidencyId id, size_t residentMip);
+    void MakeRoom(uint64_t bytes, TextureResidencyId requester);
+};
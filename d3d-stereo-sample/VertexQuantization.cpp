@@ -0,0 +1,283 @@
+#include "VertexQuantization.h"
+#include "BasicVertexStream.h"
+#include <string.h>
+#include <iterator>
+
+const BasicMeshAttribute QuantizedVertexAttributes[3] =
+{
+    { static_cast<uint8_t>(MeshSemantic::Position), 0, static_cast<uint8_t>(MeshAttributeFormat::Snorm16x4), 0, 0, 0 },
+    { static_cast<uint8_t>(MeshSemantic::Normal), 0, static_cast<uint8_t>(MeshAttributeFormat::Snorm16x2), 0, 8, 0 },
+    { static_cast<uint8_t>(MeshSemantic::TexCoord), 0, static_cast<uint8_t>(MeshAttributeFormat::Half2), 0, 12, 0 },
+};
+
+namespace
+{
+    // The smallest extent given to a flat axis, so that positions on it
+    // still quantize to 0 and decode exactly.
+    const float MinimumExtent = 1e-6f;
+
+    int16_t ToSnorm16(float value)
+    {
+        value = (value > 1.0f) ? 1.0f : (value < -1.0f) ? -1.0f : value;
+        return static_cast<int16_t>(lrintf(value * 32767.0f));
+    }
+
+    float FromSnorm16(int16_t value)
+    {
+        float result = value / 32767.0f;
+        return (result < -1.0f) ? -1.0f : result;
+    }
+
+    float SignNotZero(float value)
+    {
+        return (value >= 0.0f) ? 1.0f : -1.0f;
+    }
+}
+
+uint16_t FloatToHalf(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t magnitude = bits & 0x7FFFFFFF;
+
+    if (magnitude >= 0x7F800000)
+    {
+        // Infinity stays infinity; NaN stays a quiet NaN.
+        return static_cast<uint16_t>(sign | 0x7C00 | ((magnitude > 0x7F800000) ? 0x200 : 0));
+    }
+    if (magnitude >= 0x477FF000)
+    {
+        // 65520 and above round to infinity.
+        return static_cast<uint16_t>(sign | 0x7C00);
+    }
+    if (magnitude < 0x38800000)
+    {
+        // Below 2^-14 the result is denormal: the mantissa, with its implicit
+        // bit, shifted down to units of 2^-24.
+        if (magnitude < 0x33000000)
+        {
+            return static_cast<uint16_t>(sign);
+        }
+        uint32_t shift = 126 - (magnitude >> 23);
+        uint32_t mantissa = (magnitude & 0x7FFFFF) | 0x800000;
+        uint32_t result = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1);
+        uint32_t halfway = 1u << (shift - 1);
+        if (remainder > halfway || (remainder == halfway && (result & 1)))
+        {
+            result++;
+        }
+        return static_cast<uint16_t>(sign | result);
+    }
+
+    // Rebias the exponent from 127 to 15 and round off 13 mantissa bits; a
+    // carry out of the mantissa correctly bumps the exponent.
+    uint32_t result = (magnitude - 0x38000000) >> 13;
+    uint32_t remainder = magnitude & 0x1FFF;
+    if (remainder > 0x1000 || (remainder == 0x1000 && (result & 1)))
+    {
+        result++;
+    }
+    return static_cast<uint16_t>(sign | result);
+}
+
+float HalfToFloat(uint16_t half)
+{
+    uint32_t sign = static_cast<uint32_t>(half & 0x8000) << 16;
+    uint32_t exponent = (half >> 10) & 0x1F;
+    uint32_t mantissa = half & 0x3FF;
+
+    uint32_t bits;
+    if (exponent == 0x1F)
+    {
+        bits = sign | 0x7F800000 | (mantissa << 13);
+    }
+    else if (exponent != 0)
+    {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    else if (mantissa != 0)
+    {
+        // Denormal: shift the mantissa up until its leading bit is the
+        // implicit one.
+        exponent = 113;
+        while ((mantissa & 0x400) == 0)
+        {
+            mantissa <<= 1;
+            exponent--;
+        }
+        bits = sign | (exponent << 23) | ((mantissa & 0x3FF) << 13);
+    }
+    else
+    {
+        bits = sign;
+    }
+
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+float2 EncodeOctahedral(float3 normal)
+{
+    float l1 = fabsf(normal.x) + fabsf(normal.y) + fabsf(normal.z);
+    if (l1 == 0.0f)
+    {
+        return float2(0.0f, 0.0f);
+    }
+
+    float x = normal.x / l1;
+    float y = normal.y / l1;
+    if (normal.z < 0.0f)
+    {
+        float foldedX = (1.0f - fabsf(y)) * SignNotZero(x);
+        float foldedY = (1.0f - fabsf(x)) * SignNotZero(y);
+        x = foldedX;
+        y = foldedY;
+    }
+    return float2(x, y);
+}
+
+float3 DecodeOctahedral(float2 encoded)
+{
+    float3 normal(encoded.x, encoded.y, 1.0f - fabsf(encoded.x) - fabsf(encoded.y));
+    float fold = (normal.z < 0.0f) ? -normal.z : 0.0f;
+    normal.x += (normal.x >= 0.0f) ? -fold : fold;
+    normal.y += (normal.y >= 0.0f) ? -fold : fold;
+    return normalize(normal);
+}
+
+AABB ComputeQuantizationBounds(
+    _In_reads_(count) const BasicVertex* vertices,
+    size_t count
+)
+{
+    PositionArrays positions;
+    positions.Assign(vertices, count);
+    AABB bounds = ComputeBoundingBox(positions.Positions());
+    for (unsigned int axis = 0; axis < 3; axis++)
+    {
+        bounds.extents[axis] = fmaxf(bounds.extents[axis], MinimumExtent);
+    }
+    return bounds;
+}
+
+void QuantizeVertices(
+    _In_reads_(count) const BasicVertex* vertices,
+    size_t count,
+    const AABB& bounds,
+    _Out_writes_(count) QuantizedVertex* quantized
+)
+{
+    float3 scale(1.0f / bounds.extents.x, 1.0f / bounds.extents.y, 1.0f / bounds.extents.z);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const BasicVertex& vertex = vertices[i];
+        QuantizedVertex& result = quantized[i];
+
+        float3 position = (vertex.pos - bounds.center) * scale;
+        result.pos[0] = ToSnorm16(position.x);
+        result.pos[1] = ToSnorm16(position.y);
+        result.pos[2] = ToSnorm16(position.z);
+        result.pos[3] = 0;
+
+        float2 normal = EncodeOctahedral(vertex.norm);
+        result.norm[0] = ToSnorm16(normal.x);
+        result.norm[1] = ToSnorm16(normal.y);
+
+        result.tex[0] = FloatToHalf(vertex.tex.x);
+        result.tex[1] = FloatToHalf(vertex.tex.y);
+    }
+}
+
+void DequantizeVertices(
+    _In_reads_(count) const QuantizedVertex* quantized,
+    size_t count,
+    const AABB& bounds,
+    _Out_writes_(count) BasicVertex* vertices
+)
+{
+    for (size_t i = 0; i < count; i++)
+    {
+        const QuantizedVertex& vertex = quantized[i];
+        BasicVertex& result = vertices[i];
+
+        float3 position(FromSnorm16(vertex.pos[0]), FromSnorm16(vertex.pos[1]), FromSnorm16(vertex.pos[2]));
+        result.pos = bounds.center + bounds.extents * position;
+        result.norm = DecodeOctahedral(float2(FromSnorm16(vertex.norm[0]), FromSnorm16(vertex.norm[1])));
+        result.tex = float2(HalfToFloat(vertex.tex[0]), HalfToFloat(vertex.tex[1]));
+    }
+}
+
+BasicMeshResult QuantizeBasicMesh(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    _Out_ std::vector<uint8_t>* file
+)
+{
+    BasicMeshInfo info;
+    BasicMeshResult result = ParseBasicMesh(data, size, &info);
+    if (result != BasicMeshResult::Ok)
+    {
+        return result;
+    }
+
+    const BasicMeshAttribute* position = FindMeshAttribute(info, MeshSemantic::Position);
+    const BasicMeshAttribute* normal = FindMeshAttribute(info, MeshSemantic::Normal);
+    const BasicMeshAttribute* texCoord = FindMeshAttribute(info, MeshSemantic::TexCoord);
+    uint32_t expectedCount = 1 + (normal ? 1 : 0) + (texCoord ? 1 : 0);
+    if (info.attributeCount != expectedCount ||
+        static_cast<MeshAttributeFormat>(position->format) != MeshAttributeFormat::Float3 ||
+        (normal && static_cast<MeshAttributeFormat>(normal->format) != MeshAttributeFormat::Float3) ||
+        (texCoord && static_cast<MeshAttributeFormat>(texCoord->format) != MeshAttributeFormat::Float2))
+    {
+        return BasicMeshResult::InvalidData;
+    }
+
+    // Gather the attributes into BasicVertex records and quantize those.
+    // Missing normals and texture coordinates quantize to zeros, which
+    // decode to +z and (0, 0), so that every quantized mesh has the full
+    // input signature of QuantizedVertexShader.
+    std::vector<BasicVertex> vertices(info.vertexCount);
+    for (size_t i = 0; i < vertices.size(); i++)
+    {
+        const uint8_t* vertex = info.vertexData + i * info.vertexStride;
+        memcpy(&vertices[i].pos, vertex + position->offset, sizeof(float3));
+        vertices[i].norm = float3(0.0f, 0.0f, 1.0f);
+        vertices[i].tex = float2(0.0f, 0.0f);
+        if (normal)
+        {
+            memcpy(&vertices[i].norm, vertex + normal->offset, sizeof(float3));
+        }
+        if (texCoord)
+        {
+            memcpy(&vertices[i].tex, vertex + texCoord->offset, sizeof(float2));
+        }
+    }
+
+    AABB bounds = ComputeQuantizationBounds(vertices.data(), vertices.size());
+    std::vector<QuantizedVertex> quantized(vertices.size());
+    QuantizeVertices(vertices.data(), vertices.size(), bounds, quantized.data());
+
+    std::vector<uint32_t> indices(info.indexCount);
+    for (size_t i = 0; i < indices.size(); i++)
+    {
+        indices[i] = GetMeshIndex(info, i);
+    }
+
+    BasicMeshDesc desc = {};
+    desc.vertices = quantized.data();
+    desc.vertexCount = info.vertexCount;
+    desc.vertexStride = sizeof(QuantizedVertex);
+    desc.attributes = QuantizedVertexAttributes;
+    desc.attributeCount = static_cast<uint32_t>(std::size(QuantizedVertexAttributes));
+    desc.indices = indices.data();
+    desc.indexCount = info.indexCount;
+    std::vector<BasicMeshSubmesh> submeshes = GetMeshSubmeshes(info);
+    desc.submeshes = submeshes.data();
+    desc.submeshCount = info.submeshCount;
+    desc.positionBounds = &bounds;
+    return WriteBasicMesh(desc, file);
+}
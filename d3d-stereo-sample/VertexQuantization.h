@@ -0,0 +1,73 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+#include "BasicMeshFormat.h"
+#include "BasicSal.h"
+#include "BasicVertex.h"
+
+// A 16-byte counterpart to the 32-byte BasicVertex:
+//
+//   pos    16-bit snorm, relative to the mesh bounds: the position is
+//          bounds.center + bounds.extents * pos, which keeps a precision of
+//          1/65534 of the mesh size on each axis. w is unused.
+//   norm   the unit normal, octahedral-encoded into two 16-bit snorms,
+//          within about 0.05 degrees.
+//   tex    half floats, within 1/4096 for coordinates in [0, 1].
+//
+// QuantizedVertexShader.hlsl decodes it; the bounds go in a constant buffer.
+struct QuantizedVertex
+{
+    int16_t pos[4];
+    int16_t norm[2];
+    uint16_t tex[2];
+};
+
+static_assert(sizeof(QuantizedVertex) == 16, "QuantizedVertex must stay 16 bytes");
+
+// The layout of QuantizedVertex.
+extern const BasicMeshAttribute QuantizedVertexAttributes[3];
+
+// IEEE 754 half-precision conversion, rounding to nearest even. Values too
+// large for a half become infinities.
+uint16_t FloatToHalf(float value);
+float HalfToFloat(uint16_t half);
+
+// Maps a unit vector onto the [-1, 1] square by projecting it onto the
+// octahedron |x| + |y| + |z| = 1 and folding the lower half over the upper.
+float2 EncodeOctahedral(float3 normal);
+float3 DecodeOctahedral(float2 encoded);
+
+// Bounds to quantize positions against: the box around the positions, with
+// any flat axis given a small nonzero extent.
+AABB ComputeQuantizationBounds(
+    _In_reads_(count) const BasicVertex* vertices,
+    size_t count
+);
+
+void QuantizeVertices(
+    _In_reads_(count) const BasicVertex* vertices,
+    size_t count,
+    const AABB& bounds,
+    _Out_writes_(count) QuantizedVertex* quantized
+);
+
+void DequantizeVertices(
+    _In_reads_(count) const QuantizedVertex* quantized,
+    size_t count,
+    const AABB& bounds,
+    _Out_writes_(count) BasicVertex* vertices
+);
+
+// Rewrites a BasicMesh version 2 or 3 file with quantized vertices. The position
+// must be float3, and the normal and texture coordinate, if any, float3 and
+// float2. The result always has the three attributes of QuantizedVertex, as
+// QuantizedVertexShader expects: a missing normal becomes +z and a missing
+// texture coordinate (0, 0). Other attributes make the mesh InvalidData,
+// since they would be lost. The header bounds of the result are the
+// quantization bounds.
+BasicMeshResult QuantizeBasicMesh(
+    _In_reads_bytes_(size) const uint8_t* data,
+    size_t size,
+    _Out_ std::vector<uint8_t>* file
+);
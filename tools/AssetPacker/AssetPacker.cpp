@@ -0,0 +1,184 @@
+// AssetPacker: builds and inspects the asset packs read by AssetPack.
+//
+//   AssetPacker [--align N] [--store EXT]... [--no-compress] PACK DIRECTORY
+//       Packs every file under DIRECTORY, named by its path relative to it.
+//   AssetPacker --list PACK
+//       Lists the entries of PACK and checks that each one unpacks.
+//
+// --store keeps files with the given extension (".dds", say) uncompressed, so
+// that they can be used straight from the mapping. The packer only needs the
+// portable sources of the sample and builds on Linux or Windows; from this
+// directory, for example:
+//
+//   g++ -std=c++17 -O2 -I../../d3d-stereo-sample -o AssetPacker AssetPacker.cpp
+//       ../../d3d-stereo-sample/AssetPack.cpp ../../d3d-stereo-sample/LZ4Block.cpp
+//       ../../d3d-stereo-sample/MappedFile.cpp
+
+#include "AssetPack.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    int Usage()
+    {
+        fprintf(stderr,
+            "usage: AssetPacker [--align N] [--store EXT]... [--no-compress] PACK DIRECTORY\n"
+            "       AssetPacker --list PACK\n");
+        return 2;
+    }
+
+    std::string Lower(std::string text)
+    {
+        std::transform(text.begin(), text.end(), text.begin(), [](char c) { return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c; });
+        return text;
+    }
+
+    int List(const fs::path& packPath)
+    {
+        AssetPack pack;
+        if (!pack.Open(packPath.c_str()))
+        {
+            fprintf(stderr, "%s: not a valid asset pack\n", packPath.string().c_str());
+            return 1;
+        }
+
+        int failures = 0;
+        uint64_t totalSize = 0;
+        uint64_t totalStored = 0;
+        for (size_t i = 0; i < pack.GetEntryCount(); i++)
+        {
+            const AssetPackEntry& entry = pack.GetEntry(i);
+            std::vector<uint8_t> data;
+            bool ok = pack.Read(i, &data);
+            failures += ok ? 0 : 1;
+            totalSize += entry.size;
+            totalStored += entry.storedSize;
+
+            printf("%12llu %12llu %-5s %s%s\n",
+                static_cast<unsigned long long>(entry.size),
+                static_cast<unsigned long long>(entry.storedSize),
+                entry.compression == static_cast<uint16_t>(AssetCompression::LZ4) ? "lz4" : "store",
+                pack.GetName(i).c_str(),
+                ok ? "" : "  (CORRUPT)");
+        }
+        printf("%zu entries, %llu bytes in %llu\n", pack.GetEntryCount(),
+            static_cast<unsigned long long>(totalSize), static_cast<unsigned long long>(totalStored));
+        return failures ? 1 : 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    uint32_t alignment = AssetPackDefaultAlignment;
+    bool compress = true;
+    std::vector<std::string> storedExtensions;
+    std::vector<std::string> positional;
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--list") == 0 && i + 1 < argc)
+        {
+            return List(argv[i + 1]);
+        }
+        else if (strcmp(argv[i], "--align") == 0 && i + 1 < argc)
+        {
+            alignment = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 0));
+            if (alignment == 0 || (alignment & (alignment - 1)) != 0)
+            {
+                fprintf(stderr, "--align must be a power of two\n");
+                return 2;
+            }
+        }
+        else if (strcmp(argv[i], "--store") == 0 && i + 1 < argc)
+        {
+            std::string extension = Lower(argv[++i]);
+            storedExtensions.push_back(extension[0] == '.' ? extension : "." + extension);
+        }
+        else if (strcmp(argv[i], "--no-compress") == 0)
+        {
+            compress = false;
+        }
+        else if (argv[i][0] == '-')
+        {
+            return Usage();
+        }
+        else
+        {
+            positional.push_back(argv[i]);
+        }
+    }
+
+    if (positional.size() != 2)
+    {
+        return Usage();
+    }
+
+    fs::path packPath = positional[0];
+    fs::path root = positional[1];
+    std::error_code error;
+    if (!fs::is_directory(root, error))
+    {
+        fprintf(stderr, "%s: not a directory\n", root.string().c_str());
+        return 1;
+    }
+
+    // Sort the files so that the same directory always makes the same pack.
+    std::vector<fs::path> files;
+    for (auto it = fs::recursive_directory_iterator(root, error); !error && it != fs::recursive_directory_iterator(); it.increment(error))
+    {
+        if (it->is_regular_file() && !fs::equivalent(it->path(), packPath, error))
+        {
+            files.push_back(it->path());
+        }
+    }
+    if (error)
+    {
+        fprintf(stderr, "%s: %s\n", root.string().c_str(), error.message().c_str());
+        return 1;
+    }
+    std::sort(files.begin(), files.end());
+
+    AssetPackWriter writer(alignment);
+    for (const auto& file : files)
+    {
+        std::ifstream stream(file, std::ios::binary);
+        std::vector<uint8_t> data((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        if (!stream.good() && !stream.eof())
+        {
+            fprintf(stderr, "%s: cannot read\n", file.string().c_str());
+            return 1;
+        }
+
+        std::string name = file.lexically_relative(root).generic_string();
+        std::string extension = Lower(file.extension().string());
+        bool store = std::find(storedExtensions.begin(), storedExtensions.end(), extension) != storedExtensions.end();
+
+        if (!writer.Add(name.c_str(), data.data(), data.size(), compress && !store))
+        {
+            fprintf(stderr, "%s: duplicate or invalid asset name\n", name.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<uint8_t> pack;
+    writer.Write(&pack);
+
+    std::ofstream output(packPath, std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char*>(pack.data()), static_cast<std::streamsize>(pack.size()));
+    if (!output)
+    {
+        fprintf(stderr, "%s: cannot write\n", packPath.string().c_str());
+        return 1;
+    }
+
+    printf("%zu files, %zu bytes\n", files.size(), pack.size());
+    return 0;
+}
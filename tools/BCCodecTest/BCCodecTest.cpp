@@ -0,0 +1,875 @@
+// BCCodecTest: decodes hand-built BC1-BC5 and BC7 blocks with BCDecoder and
+// checks every texel against values worked out by hand from the format
+// specifications, then checks what BCEncoder and CookBCTexture write by
+// decoding it again. Prints each failure and exits with 1 if there was any.
+//
+//   BCCodecTest
+//
+// The checks cover both BC1 color modes, BC2 and BC3 alpha, unsigned and
+// signed BC4 and BC5 in both palette modes, one block for each of the eight
+// BC7 modes (with partitions, p-bits, rotation and index selection), invalid
+// BC7 blocks and the cropping of blocks on the edges of a surface. A gradient
+// encoded to BC1, BC3 and BC7 must come back at no less than 40, 37 and 36 dB
+// PSNR, with alpha at exactly 255 when the source is opaque; BC1 blocks with
+// alpha below 128 must use the three-color mode, and CookBCTexture must refuse
+// sizes that are not whole blocks.
+//
+// The BC1, BC2 and BC3 colors one and two thirds of the way between the
+// endpoints use the BC7 weights 21/64 and 43/64, so a 2:1 mix of red and
+// blue decodes to a red of 171 where exact thirds give 170. The expected
+// values here pin that rounding; other decoders may differ by 1.
+//
+// The test only needs the portable sources of the sample and builds on Linux
+// or Windows; from this directory, for example:
+//
+//   g++ -std=c++17 -O2 -pthread -I../../d3d-stereo-sample -o BCCodecTest BCCodecTest.cpp
+//       ../../d3d-stereo-sample/BCDecoder.cpp ../../d3d-stereo-sample/BCEncoder.cpp
+//       ../../d3d-stereo-sample/TextureCooker.cpp ../../d3d-stereo-sample/MipmapGenerator.cpp
+//       ../../d3d-stereo-sample/DDSParser.cpp
+//
+// Add -DBASICMATH_NO_SIMD to check the scalar code instead of the SSE2 or
+// NEON one.
+
+#include "BCDecoder.h"
+#include "BCEncoder.h"
+#include "TextureCooker.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    int g_failures = 0;
+
+    void Check(const char* test, const char* what, unsigned int value, unsigned int expected)
+    {
+        if (value != expected)
+        {
+            g_failures++;
+            fprintf(stderr, "FAIL %s: %s is %u, expected %u\n", test, what, value, expected);
+        }
+    }
+
+    struct Texel
+    {
+        uint8_t r, g, b, a;
+    };
+
+    // Packs the fields of a block from the least significant bit of the first
+    // byte up, which is the order all of the BC formats store them in.
+    class BlockWriter
+    {
+    public:
+        BlockWriter() :
+            m_bytes(),
+            m_position(0)
+        {
+        }
+
+        void Write(unsigned int value, unsigned int count)
+        {
+            for (unsigned int i = 0; i < count; i++, m_position++)
+            {
+                if (value & (1u << i))
+                {
+                    m_bytes[m_position / 8] |= static_cast<uint8_t>(1 << (m_position % 8));
+                }
+            }
+        }
+
+        // Writes one index of count bits for each of the 16 texels, using
+        // anchorCount bits for the texels listed in anchors.
+        void WriteIndices(
+            const unsigned int (&indices)[16],
+            unsigned int count,
+            const std::vector<unsigned int>& anchors = {},
+            unsigned int anchorCount = 0)
+        {
+            for (unsigned int i = 0; i < 16; i++)
+            {
+                bool anchor = false;
+                for (unsigned int texel : anchors)
+                {
+                    anchor = anchor || texel == i;
+                }
+                Write(indices[i], anchor ? anchorCount : count);
+            }
+        }
+
+        unsigned int GetPosition() const
+        {
+            return m_position;
+        }
+
+        const uint8_t* GetBytes() const
+        {
+            return m_bytes;
+        }
+
+    private:
+        uint8_t m_bytes[16];
+        unsigned int m_position;
+    };
+
+    // Starts a BC7 block: mode m is stored as m zero bits and a one.
+    void WriteBC7Mode(BlockWriter& writer, unsigned int mode)
+    {
+        writer.Write(1u << mode, mode + 1);
+    }
+
+    void CheckBlock(const char* test, DDS_FORMAT format, const uint8_t* block, const Texel (&expected)[16])
+    {
+        uint8_t rgba[64];
+        memset(rgba, 0xcd, sizeof(rgba));
+        Check(test, "result", static_cast<unsigned int>(DecodeBCBlock(format, block, rgba)), static_cast<unsigned int>(DDSResult::Ok));
+
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            const uint8_t* texel = rgba + i * 4;
+            const Texel& e = expected[i];
+            if (texel[0] != e.r || texel[1] != e.g || texel[2] != e.b || texel[3] != e.a)
+            {
+                g_failures++;
+                fprintf(stderr, "FAIL %s: texel %u is (%u, %u, %u, %u), expected (%u, %u, %u, %u)\n", test, i,
+                    texel[0], texel[1], texel[2], texel[3], e.r, e.g, e.b, e.a);
+            }
+        }
+    }
+
+    void CheckBlock(const char* test, DDS_FORMAT format, const BlockWriter& writer, const Texel (&expected)[16])
+    {
+        CheckBlock(test, format, writer.GetBytes(), expected);
+    }
+
+    const Texel Black = { 0, 0, 0, 255 };
+    const Texel White = { 255, 255, 255, 255 };
+    const Texel Red = { 255, 0, 0, 255 };
+    const Texel Green = { 0, 255, 0, 255 };
+    const Texel Blue = { 0, 0, 255, 255 };
+    const Texel Transparent = { 0, 0, 0, 0 };
+
+    const uint16_t Red565 = 0xf800;
+    const uint16_t Green565 = 0x07e0;
+    const uint16_t Blue565 = 0x001f;
+    const uint16_t White565 = 0xffff;
+
+    // The BC1 thirds are 43/64 and 21/64 of the way from one endpoint to the
+    // other: (43 * 255 + 32) >> 6 = 171 and (21 * 255 + 32) >> 6 = 84.
+    const Texel RedThird = { 171, 0, 84, 255 };
+    const Texel BlueThird = { 84, 0, 171, 255 };
+
+    // The color half shared by BC1, BC2 and BC3: color0, color1 and 16 2-bit
+    // indices cycling through 0 to 3.
+    void WriteColorBlock(BlockWriter& writer, uint16_t color0, uint16_t color1)
+    {
+        writer.Write(color0, 16);
+        writer.Write(color1, 16);
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            writer.Write(i & 3, 2);
+        }
+    }
+
+    // A BC4 channel with 16 3-bit indices cycling through the palette.
+    void WriteChannelBlock(BlockWriter& writer, uint8_t endpoint0, uint8_t endpoint1)
+    {
+        writer.Write(endpoint0, 8);
+        writer.Write(endpoint1, 8);
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            writer.Write(i & 7, 3);
+        }
+    }
+
+    void CheckBC1()
+    {
+        // color0 > color1: four colors, red and blue and the two thirds.
+        BlockWriter fourColor;
+        WriteColorBlock(fourColor, Red565, Blue565);
+        const Texel fourColorTexels[16] =
+        {
+            Red, Blue, RedThird, BlueThird, Red, Blue, RedThird, BlueThird,
+            Red, Blue, RedThird, BlueThird, Red, Blue, RedThird, BlueThird,
+        };
+        CheckBlock("BC1, four colors", DDS_FORMAT_BC1_UNORM, fourColor, fourColorTexels);
+
+        // color0 <= color1: the midpoint, (32 * 255 + 32) >> 6 = 128, and
+        // transparent black.
+        BlockWriter threeColor;
+        WriteColorBlock(threeColor, Blue565, Red565);
+        const Texel Midpoint = { 128, 0, 128, 255 };
+        const Texel threeColorTexels[16] =
+        {
+            Blue, Red, Midpoint, Transparent, Blue, Red, Midpoint, Transparent,
+            Blue, Red, Midpoint, Transparent, Blue, Red, Midpoint, Transparent,
+        };
+        CheckBlock("BC1, three colors", DDS_FORMAT_BC1_UNORM_SRGB, threeColor, threeColorTexels);
+    }
+
+    void CheckBC2()
+    {
+        // Texel i has 4-bit alpha i, expanded as i * 17. BC2 always uses four
+        // colors, even with color0 <= color1.
+        BlockWriter writer;
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            writer.Write(i, 4);
+        }
+        WriteColorBlock(writer, Blue565, Red565);
+
+        const Texel colors[4] = { Blue, Red, BlueThird, RedThird };
+        Texel expected[16];
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            expected[i] = colors[i & 3];
+            expected[i].a = static_cast<uint8_t>(i * 17);
+        }
+        CheckBlock("BC2", DDS_FORMAT_BC2_UNORM, writer, expected);
+    }
+
+    // The 8-entry palette of 255 and 0 is (7 - i) * 255 / 7 for i = 1 to 6,
+    // rounded to nearest, and the 6-entry palette of 0 and 255 is i * 255 / 5
+    // for i = 1 to 4, followed by 0 and 255.
+    const uint8_t EightValuePalette[8] = { 255, 0, 219, 182, 146, 109, 73, 36 };
+    const uint8_t SixValuePalette[8] = { 0, 255, 51, 102, 153, 204, 0, 255 };
+
+    void CheckBC3()
+    {
+        BlockWriter writer;
+        WriteChannelBlock(writer, 255, 0);
+        WriteColorBlock(writer, Red565, Blue565);
+
+        const Texel colors[4] = { Red, Blue, RedThird, BlueThird };
+        Texel expected[16];
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            expected[i] = colors[i & 3];
+            expected[i].a = EightValuePalette[i & 7];
+        }
+        CheckBlock("BC3", DDS_FORMAT_BC3_UNORM, writer, expected);
+    }
+
+    // Signed palettes remap [-127, 127] to [0, 255]. 127 and -128 (read as
+    // -127) give the 8-entry palette of 127, -127, +-91, +-54 and +-18, which
+    // remaps to the same values as the unsigned one. -128 and 0 give the
+    // 6-entry palette -127, 0, -102, -76, -51, -25, -127, 127.
+    const uint8_t SignedEightValuePalette[8] = { 255, 0, 219, 182, 146, 109, 73, 36 };
+    const uint8_t SignedSixValuePalette[8] = { 0, 128, 25, 51, 76, 102, 0, 255 };
+
+    void CheckBC4()
+    {
+        BlockWriter unorm;
+        WriteChannelBlock(unorm, 0, 255);
+        Texel expected[16];
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            expected[i] = { SixValuePalette[i & 7], 0, 0, 255 };
+        }
+        CheckBlock("BC4 UNORM", DDS_FORMAT_BC4_UNORM, unorm, expected);
+
+        BlockWriter snorm;
+        WriteChannelBlock(snorm, 0x80, 0);
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            expected[i] = { SignedSixValuePalette[i & 7], 0, 0, 255 };
+        }
+        CheckBlock("BC4 SNORM", DDS_FORMAT_BC4_SNORM, snorm, expected);
+    }
+
+    void CheckBC5()
+    {
+        BlockWriter unorm;
+        WriteChannelBlock(unorm, 255, 0);
+        WriteChannelBlock(unorm, 0, 255);
+        Texel expected[16];
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            expected[i] = { EightValuePalette[i & 7], SixValuePalette[i & 7], 0, 255 };
+        }
+        CheckBlock("BC5 UNORM", DDS_FORMAT_BC5_UNORM, unorm, expected);
+
+        BlockWriter snorm;
+        WriteChannelBlock(snorm, 0x7f, 0x80);
+        WriteChannelBlock(snorm, 0x80, 0);
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            expected[i] = { SignedEightValuePalette[i & 7], SignedSixValuePalette[i & 7], 0, 255 };
+        }
+        CheckBlock("BC5 SNORM", DDS_FORMAT_BC5_SNORM, snorm, expected);
+    }
+
+    // In the BC7 blocks below endpoints are expanded by appending the p-bit,
+    // if any, and repeating the top bits in the bottom ones; texels blend them
+    // as ((64 - w) * e0 + w * e1 + 32) >> 6 with the 2-, 3- or 4-bit weights
+    // of the specification.
+
+    // Three subsets with 4-bit colors, endpoint p-bits and 3-bit indices.
+    // Partition 0 puts texels 2, 3, 6, 7 and 11 in subset 1 and 9, 10 and 12
+    // to 15 in subset 2; the anchors are texels 0, 3 and 15.
+    void CheckBC7Mode0()
+    {
+        BlockWriter writer;
+        WriteBC7Mode(writer, 0);
+        writer.Write(0, 4);
+
+        // Subset 0 is white to black, subset 1 is (15, 0, 0) with p-bit 1,
+        // which expands to (255, 8, 8), and subset 2 starts at (0, 0, 15)
+        // with p-bit 0, which expands to (0, 0, 247).
+        const unsigned int endpoints[3][6] =
+        {
+            { 15, 0, 15, 0, 0, 0 },     // red of s0e0, s0e1, s1e0, s1e1, s2e0, s2e1
+            { 15, 0, 0, 0, 0, 0 },      // green
+            { 15, 0, 0, 0, 15, 0 },     // blue
+        };
+        for (const auto& channel : endpoints)
+        {
+            for (unsigned int value : channel)
+            {
+                writer.Write(value, 4);
+            }
+        }
+        writer.Write(0x1 | 0x4, 6);     // p-bits of s0e0 and s1e0
+
+        // Texel 1 takes the second endpoint of subset 0 and texel 2 weight
+        // 27 of subset 1: (37 * 255 + 32) >> 6 = 147, (37 * 8 + 32) >> 6 = 5.
+        const unsigned int indices[16] = { 0, 7, 3 };
+        writer.WriteIndices(indices, 3, { 0, 3, 15 }, 2);
+        Check("BC7 mode 0", "bits written", writer.GetPosition(), 128);
+
+        const Texel S1 = { 255, 8, 8, 255 };
+        const Texel S2 = { 0, 0, 247, 255 };
+        const Texel expected[16] =
+        {
+            White, Black, { 147, 5, 5, 255 }, S1,
+            White, White, S1, S1,
+            White, S2, S2, S1,
+            S2, S2, S2, S2,
+        };
+        CheckBlock("BC7 mode 0", DDS_FORMAT_BC7_UNORM, writer, expected);
+    }
+
+    // Two subsets with 6-bit colors, one p-bit per subset and 3-bit indices.
+    // Partition 13 puts the top two rows in subset 0 and the bottom two in
+    // subset 1, whose anchor is texel 15.
+    void CheckBC7Mode1()
+    {
+        BlockWriter writer;
+        WriteBC7Mode(writer, 1);
+        writer.Write(13, 6);
+
+        // With p-bit 0, subset 0 goes from 63 in red, expanding to 253, to
+        // 63 in green. With p-bit 1, subset 1 goes from (0, 0, 63), expanding
+        // to (2, 2, 255), to white.
+        const unsigned int endpoints[3][4] =
+        {
+            { 63, 0, 0, 63 },
+            { 0, 63, 0, 63 },
+            { 0, 0, 63, 63 },
+        };
+        for (const auto& channel : endpoints)
+        {
+            for (unsigned int value : channel)
+            {
+                writer.Write(value, 6);
+            }
+        }
+        writer.Write(0x2, 2);
+
+        // Texel 2 has weight 37: (27 * 253 + 32) >> 6 = 107 and
+        // (37 * 253 + 32) >> 6 = 146. Texel 15 has weight 27:
+        // (37 * 2 + 27 * 255 + 32) >> 6 = 109.
+        const unsigned int indices[16] = { 0, 7, 4, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3 };
+        writer.WriteIndices(indices, 3, { 0, 15 }, 2);
+        Check("BC7 mode 1", "bits written", writer.GetPosition(), 128);
+
+        const Texel S0 = { 253, 0, 0, 255 };
+        const Texel S1 = { 2, 2, 255, 255 };
+        const Texel expected[16] =
+        {
+            S0, { 0, 253, 0, 255 }, { 107, 146, 0, 255 }, S0,
+            S0, S0, S0, S0,
+            S1, S1, S1, S1,
+            S1, S1, S1, { 109, 109, 255, 255 },
+        };
+        CheckBlock("BC7 mode 1", DDS_FORMAT_BC7_UNORM, writer, expected);
+    }
+
+    // Three subsets with 5-bit colors, no p-bits and 2-bit indices.
+    // Partition 11 puts the first two columns in subset 0, the third in
+    // subset 1 and the last in subset 2; the anchors are texels 0, 6 and 15.
+    void CheckBC7Mode2()
+    {
+        BlockWriter writer;
+        WriteBC7Mode(writer, 2);
+        writer.Write(11, 6);
+
+        // Red to black, green to black and blue to white.
+        const unsigned int endpoints[3][6] =
+        {
+            { 31, 0, 0, 0, 0, 31 },
+            { 0, 0, 31, 0, 0, 31 },
+            { 0, 0, 0, 0, 31, 31 },
+        };
+        for (const auto& channel : endpoints)
+        {
+            for (unsigned int value : channel)
+            {
+                writer.Write(value, 5);
+            }
+        }
+
+        // Texels 1 and 15 have weight 21.
+        const unsigned int indices[16] = { 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+        writer.WriteIndices(indices, 2, { 0, 6, 15 }, 1);
+        Check("BC7 mode 2", "bits written", writer.GetPosition(), 128);
+
+        const Texel expected[16] =
+        {
+            Red, { 171, 0, 0, 255 }, Green, Blue,
+            Red, Red, Green, Blue,
+            Red, Red, Green, Blue,
+            Red, Red, Green, { 84, 84, 255, 255 },
+        };
+        CheckBlock("BC7 mode 2", DDS_FORMAT_BC7_UNORM, writer, expected);
+    }
+
+    // Two subsets with 7-bit colors, endpoint p-bits and 2-bit indices.
+    // Partition 0 puts the first two columns in subset 0 and the last two in
+    // subset 1, whose anchor is texel 15.
+    void CheckBC7Mode3()
+    {
+        BlockWriter writer;
+        WriteBC7Mode(writer, 3);
+        writer.Write(0, 6);
+
+        // With the p-bits the endpoints are 8 bits and need no expansion:
+        // subset 0 goes from (255, 1, 1) to black and subset 1 from black to
+        // (128, 64, 32).
+        const unsigned int endpoints[3][4] =
+        {
+            { 127, 0, 0, 64 },
+            { 0, 0, 0, 32 },
+            { 0, 0, 0, 16 },
+        };
+        for (const auto& channel : endpoints)
+        {
+            for (unsigned int value : channel)
+            {
+                writer.Write(value, 7);
+            }
+        }
+        writer.Write(0x1, 4);
+
+        // Texels 0 and 15 have weight 21: (43 * 255 + 32) >> 6 = 171,
+        // (43 * 1 + 32) >> 6 = 1, and (21 * 128 + 32) >> 6 = 42 and so on.
+        const unsigned int indices[16] = { 1, 0, 3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+        writer.WriteIndices(indices, 2, { 0, 15 }, 1);
+        Check("BC7 mode 3", "bits written", writer.GetPosition(), 128);
+
+        const Texel S0 = { 255, 1, 1, 255 };
+        const Texel expected[16] =
+        {
+            { 171, 1, 1, 255 }, S0, { 128, 64, 32, 255 }, Black,
+            S0, S0, Black, Black,
+            S0, S0, Black, Black,
+            S0, S0, Black, { 42, 21, 11, 255 },
+        };
+        CheckBlock("BC7 mode 3", DDS_FORMAT_BC7_UNORM, writer, expected);
+    }
+
+    // One subset with 5-bit colors, 6-bit alpha, 2-bit and 3-bit index sets,
+    // a rotation and an index selection.
+    void CheckBC7Mode4()
+    {
+        BlockWriter writer;
+        WriteBC7Mode(writer, 4);
+        writer.Write(1, 2);     // swap red and alpha
+        writer.Write(1, 1);     // the 3-bit indices drive color
+
+        // Red to green, alpha 0 to 255.
+        const unsigned int endpoints[3][2] = { { 31, 0 }, { 0, 31 }, { 0, 0 } };
+        for (const auto& channel : endpoints)
+        {
+            for (unsigned int value : channel)
+            {
+                writer.Write(value, 5);
+            }
+        }
+        writer.Write(0, 6);
+        writer.Write(63, 6);
+
+        // Texel 0 has color weight 27, (37 * 255 + 32) >> 6 = 147 and
+        // (27 * 255 + 32) >> 6 = 108, and alpha weight 21, 84.
+        const unsigned int alphaIndices[16] = { 1, 0, 0, 0, 0, 3 };
+        const unsigned int colorIndices[16] = { 3, 0, 0, 0, 0, 7 };
+        writer.WriteIndices(alphaIndices, 2, { 0 }, 1);
+        writer.WriteIndices(colorIndices, 3, { 0 }, 2);
+        Check("BC7 mode 4", "bits written", writer.GetPosition(), 128);
+
+        // Transparent red and opaque green, with red and alpha swapped.
+        const Texel R = { 0, 0, 0, 255 };
+        const Texel expected[16] =
+        {
+            { 84, 108, 0, 147 }, R, R, R,
+            R, { 255, 255, 0, 0 }, R, R,
+            R, R, R, R,
+            R, R, R, R,
+        };
+        CheckBlock("BC7 mode 4", DDS_FORMAT_BC7_UNORM, writer, expected);
+    }
+
+    // One subset with 7-bit colors, 8-bit alpha and two 2-bit index sets.
+    void CheckBC7Mode5()
+    {
+        BlockWriter writer;
+        WriteBC7Mode(writer, 5);
+        writer.Write(0, 2);
+
+        // (127, 0, 64), which expands to (255, 0, 129), to green; alpha 255
+        // to 0.
+        const unsigned int endpoints[3][2] = { { 127, 0 }, { 0, 127 }, { 64, 0 } };
+        for (const auto& channel : endpoints)
+        {
+            for (unsigned int value : channel)
+            {
+                writer.Write(value, 7);
+            }
+        }
+        writer.Write(255, 8);
+        writer.Write(0, 8);
+
+        // Texel 0 has weight 21 for both: (43 * 129 + 32) >> 6 = 87 in blue.
+        const unsigned int colorIndices[16] = { 1, 0, 0, 0, 0, 0, 0, 0, 0, 3 };
+        const unsigned int alphaIndices[16] = { 1, 0, 0, 0, 0, 0, 0, 0, 0, 2 };
+        writer.WriteIndices(colorIndices, 2, { 0 }, 1);
+        writer.WriteIndices(alphaIndices, 2, { 0 }, 1);
+        Check("BC7 mode 5", "bits written", writer.GetPosition(), 128);
+
+        const Texel E0 = { 255, 0, 129, 255 };
+        const Texel expected[16] =
+        {
+            { 171, 84, 87, 171 }, E0, E0, E0,
+            E0, E0, E0, E0,
+            E0, { 0, 255, 0, 84 }, E0, E0,
+            E0, E0, E0, E0,
+        };
+        CheckBlock("BC7 mode 5", DDS_FORMAT_BC7_UNORM, writer, expected);
+    }
+
+    // One subset with 7-bit color and alpha, endpoint p-bits and 4-bit
+    // indices. Texel i has index i, which walks all 16 weights from white
+    // to transparent black.
+    void CheckBC7Mode6()
+    {
+        BlockWriter writer;
+        WriteBC7Mode(writer, 6);
+        for (unsigned int channel = 0; channel < 4; channel++)
+        {
+            writer.Write(127, 7);
+            writer.Write(0, 7);
+        }
+        writer.Write(0x1, 2);
+
+        const unsigned int indices[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+        writer.WriteIndices(indices, 4, { 0 }, 3);
+        Check("BC7 mode 6", "bits written", writer.GetPosition(), 128);
+
+        // (64 - w) * 255 / 64, rounded to nearest, for each weight w.
+        const uint8_t ramp[16] = { 255, 239, 219, 203, 187, 171, 151, 135, 120, 104, 84, 68, 52, 36, 16, 0 };
+        Texel expected[16];
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            expected[i] = { ramp[i], ramp[i], ramp[i], ramp[i] };
+        }
+        CheckBlock("BC7 mode 6", DDS_FORMAT_BC7_UNORM_SRGB, writer, expected);
+    }
+
+    // Two subsets with 5-bit color and alpha, endpoint p-bits and 2-bit
+    // indices, using partition 13 as in mode 1.
+    void CheckBC7Mode7()
+    {
+        BlockWriter writer;
+        WriteBC7Mode(writer, 7);
+        writer.Write(13, 6);
+
+        // Subset 0 goes from (31, 0, 0, 31) with p-bit 1, which expands to
+        // (255, 4, 4, 255), to transparent black. Subset 1 goes from
+        // (0, 0, 31, 15) with p-bit 0, which expands to (0, 0, 251, 121), to
+        // opaque white.
+        const unsigned int endpoints[4][4] =
+        {
+            { 31, 0, 0, 31 },
+            { 0, 0, 0, 31 },
+            { 0, 0, 31, 31 },
+            { 31, 0, 15, 31 },
+        };
+        for (const auto& channel : endpoints)
+        {
+            for (unsigned int value : channel)
+            {
+                writer.Write(value, 5);
+            }
+        }
+        writer.Write(0x1 | 0x8, 4);
+
+        // Texels 0 and 15 have weight 21: (43 * 4 + 32) >> 6 = 3,
+        // (43 * 251 + 21 * 255 + 32) >> 6 = 252 and
+        // (43 * 121 + 21 * 255 + 32) >> 6 = 165.
+        const unsigned int indices[16] = { 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1 };
+        writer.WriteIndices(indices, 2, { 0, 15 }, 1);
+        Check("BC7 mode 7", "bits written", writer.GetPosition(), 128);
+
+        const Texel S0 = { 255, 4, 4, 255 };
+        const Texel S1 = { 0, 0, 251, 121 };
+        const Texel expected[16] =
+        {
+            { 171, 3, 3, 171 }, S0, S0, S0,
+            S0, S0, S0, S0,
+            S1, S1, S1, S1,
+            S1, S1, S1, { 84, 84, 252, 165 },
+        };
+        CheckBlock("BC7 mode 7", DDS_FORMAT_BC7_UNORM, writer, expected);
+    }
+
+    // A first byte of zero names no mode; whatever follows, the block
+    // decodes to transparent black.
+    void CheckInvalidBC7()
+    {
+        uint8_t block[16];
+        memset(block, 0xff, sizeof(block));
+        block[0] = 0;
+
+        Texel expected[16];
+        for (Texel& texel : expected)
+        {
+            texel = Transparent;
+        }
+        CheckBlock("invalid BC7", DDS_FORMAT_BC7_UNORM, block, expected);
+    }
+
+    void CheckInvalidArguments()
+    {
+        uint8_t block[16] = {};
+        uint8_t rgba[64];
+        Check("invalid arguments", "uncompressed format",
+            static_cast<unsigned int>(DecodeBCBlock(DDS_FORMAT_R8G8B8A8_UNORM, block, rgba)),
+            static_cast<unsigned int>(DDSResult::InvalidArgument));
+        Check("invalid arguments", "null block",
+            static_cast<unsigned int>(DecodeBCBlock(DDS_FORMAT_BC1_UNORM, nullptr, rgba)),
+            static_cast<unsigned int>(DDSResult::InvalidArgument));
+        Check("invalid arguments", "short row pitch",
+            static_cast<unsigned int>(DecodeBCSurface(DDS_FORMAT_BC1_UNORM, block, 8, 4, 4, rgba, 15, 1)),
+            static_cast<unsigned int>(DDSResult::InvalidArgument));
+    }
+
+    // A 6x5 surface is 2x2 blocks of red, green, blue and white; only the
+    // texels inside the surface are written, on one thread or several.
+    void CheckEdgeCropping(unsigned int threadCount)
+    {
+        const uint16_t colors[4] = { Red565, Green565, Blue565, White565 };
+        const Texel texels[4] = { Red, Green, Blue, White };
+
+        uint8_t blocks[4][8];
+        for (unsigned int i = 0; i < 4; i++)
+        {
+            BlockWriter writer;
+            writer.Write(colors[i], 16);
+            writer.Write(0, 16);
+            writer.Write(0, 32);
+            memcpy(blocks[i], writer.GetBytes(), 8);
+        }
+
+        const size_t width = 6;
+        const size_t height = 5;
+        const size_t rowPitch = 32;
+        std::vector<uint8_t> rgba(rowPitch * (height + 1), 0xcd);
+        Check("edge cropping", "result",
+            static_cast<unsigned int>(DecodeBCSurface(DDS_FORMAT_BC1_UNORM, &blocks[0][0], 16, width, height, rgba.data(), rowPitch, threadCount)),
+            static_cast<unsigned int>(DDSResult::Ok));
+
+        unsigned int wrong = 0;
+        unsigned int overwritten = 0;
+        for (size_t y = 0; y <= height; y++)
+        {
+            for (size_t x = 0; x < rowPitch / 4; x++)
+            {
+                const uint8_t* texel = rgba.data() + y * rowPitch + x * 4;
+                if (x < width && y < height)
+                {
+                    const Texel& e = texels[(y / 4) * 2 + x / 4];
+                    wrong += (texel[0] != e.r || texel[1] != e.g || texel[2] != e.b || texel[3] != e.a);
+                }
+                else
+                {
+                    overwritten += (texel[0] != 0xcd || texel[1] != 0xcd || texel[2] != 0xcd || texel[3] != 0xcd);
+                }
+            }
+        }
+
+        char test[64];
+        snprintf(test, sizeof(test), "edge cropping, %u threads", threadCount);
+        Check(test, "wrong texels", wrong, 0);
+        Check(test, "texels written outside the surface", overwritten, 0);
+    }
+    // A 64x64 image whose color channels ramp at different rates along the
+    // diagonal; alpha is 255 or, when not opaque, ramps across the rows.
+    std::vector<uint8_t> MakeGradient(bool opaque)
+    {
+        std::vector<uint8_t> rgba(64 * 64 * 4);
+        for (unsigned int y = 0; y < 64; y++)
+        {
+            for (unsigned int x = 0; x < 64; x++)
+            {
+                uint8_t* texel = rgba.data() + (y * 64 + x) * 4;
+                texel[0] = static_cast<uint8_t>((x + y) * 2);
+                texel[1] = static_cast<uint8_t>(255 - (x + y) * 2);
+                texel[2] = static_cast<uint8_t>(64 + x + y);
+                texel[3] = opaque ? 255 : static_cast<uint8_t>(x * 4);
+            }
+        }
+        return rgba;
+    }
+
+    // The peak signal-to-noise ratio in dB over the first channels of each
+    // texel.
+    double MeasurePSNR(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, unsigned int channels)
+    {
+        double squaredError = 0.0;
+        for (size_t i = 0; i < a.size(); i++)
+        {
+            if (i % 4 < channels)
+            {
+                double difference = static_cast<double>(a[i]) - b[i];
+                squaredError += difference * difference;
+            }
+        }
+
+        double meanSquaredError = squaredError / (a.size() / 4 * channels);
+        return (meanSquaredError == 0.0) ? INFINITY : 10.0 * log10(255.0 * 255.0 / meanSquaredError);
+    }
+
+    // Encodes the gradient, decodes it again and checks the quality. Opaque
+    // images are measured on color alone and must keep alpha at exactly 255.
+    void CheckRoundTrip(const char* test, DDS_FORMAT format, bool opaque, double minPSNR)
+    {
+        std::vector<uint8_t> source = MakeGradient(opaque);
+        size_t blockSize = DDSBitsPerPixel(format) * 2;
+        std::vector<uint8_t> blocks(16 * 16 * blockSize);
+        Check(test, "encode result",
+            static_cast<unsigned int>(EncodeBCSurface(format, source.data(), 64 * 4, 64, 64, blocks.data(), 16 * blockSize)),
+            static_cast<unsigned int>(DDSResult::Ok));
+
+        std::vector<uint8_t> decoded(source.size());
+        Check(test, "decode result",
+            static_cast<unsigned int>(DecodeBCSurface(format, blocks.data(), 16 * blockSize, 64, 64, decoded.data(), 64 * 4)),
+            static_cast<unsigned int>(DDSResult::Ok));
+
+        double psnr = MeasurePSNR(source, decoded, opaque ? 3 : 4);
+        if (!(psnr >= minPSNR))
+        {
+            g_failures++;
+            fprintf(stderr, "FAIL %s: PSNR is %.2f dB, expected at least %.0f dB\n", test, psnr, minPSNR);
+        }
+
+        if (opaque)
+        {
+            unsigned int translucent = 0;
+            for (size_t i = 3; i < decoded.size(); i += 4)
+            {
+                translucent += (decoded[i] != 255);
+            }
+            Check(test, "texels with alpha below 255", translucent, 0);
+        }
+    }
+
+    // BC1 blocks with alpha below 128 use the three-color mode, color0 <=
+    // color1, and store those texels as transparent black; the others stay
+    // opaque.
+    void CheckBC1PunchThrough()
+    {
+        uint8_t rgba[64];
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            rgba[i * 4 + 0] = static_cast<uint8_t>(i * 16);
+            rgba[i * 4 + 1] = 128;
+            rgba[i * 4 + 2] = static_cast<uint8_t>(255 - i * 16);
+            rgba[i * 4 + 3] = (i % 3 == 0) ? 127 : 128;
+        }
+
+        uint8_t block[8];
+        Check("BC1 punch-through", "encode result",
+            static_cast<unsigned int>(EncodeBCBlock(DDS_FORMAT_BC1_UNORM, rgba, block)),
+            static_cast<unsigned int>(DDSResult::Ok));
+        unsigned int color0 = block[0] | (block[1] << 8);
+        unsigned int color1 = block[2] | (block[3] << 8);
+        Check("BC1 punch-through", "three-color mode", color0 <= color1, 1);
+
+        uint8_t decoded[64];
+        DecodeBCBlock(DDS_FORMAT_BC1_UNORM, block, decoded);
+        for (unsigned int i = 0; i < 16; i++)
+        {
+            char what[64];
+            snprintf(what, sizeof(what), "alpha of texel %u", i);
+            Check("BC1 punch-through", what, decoded[i * 4 + 3], (i % 3 == 0) ? 0 : 255);
+        }
+    }
+
+    // Direct3D needs the top level of a block-compressed texture to be whole
+    // blocks.
+    void CheckCookedSizes()
+    {
+        std::vector<uint8_t> source = MakeGradient(true);
+        MipmapOptions options;
+        const size_t sizes[][2] = { { 64, 64 }, { 8, 4 }, { 6, 8 }, { 8, 6 }, { 2, 2 } };
+        for (const auto& size : sizes)
+        {
+            std::vector<uint8_t> ddsFile;
+            DDSResult result = CookBCTexture(source.data(), 64 * 4, size[0], size[1],
+                DDS_FORMAT_BC1_UNORM, DDS_ALPHA_MODE_OPAQUE, &options, 1, &ddsFile);
+
+            bool whole = size[0] % 4 == 0 && size[1] % 4 == 0;
+            char what[64];
+            snprintf(what, sizeof(what), "result for %zux%zu", size[0], size[1]);
+            Check("cooked sizes", what, static_cast<unsigned int>(result),
+                static_cast<unsigned int>(whole ? DDSResult::Ok : DDSResult::InvalidArgument));
+            Check("cooked sizes", "file written", !ddsFile.empty(), whole);
+        }
+    }
+}
+
+int main()
+{
+    CheckBC1();
+    CheckBC2();
+    CheckBC3();
+    CheckBC4();
+    CheckBC5();
+    CheckBC7Mode0();
+    CheckBC7Mode1();
+    CheckBC7Mode2();
+    CheckBC7Mode3();
+    CheckBC7Mode4();
+    CheckBC7Mode5();
+    CheckBC7Mode6();
+    CheckBC7Mode7();
+    CheckInvalidBC7();
+    CheckInvalidArguments();
+    CheckEdgeCropping(1);
+    CheckEdgeCropping(2);
+    CheckRoundTrip("BC1 round trip", DDS_FORMAT_BC1_UNORM, true, 40.0);
+    CheckRoundTrip("BC3 round trip", DDS_FORMAT_BC3_UNORM, false, 37.0);
+    CheckRoundTrip("BC7 round trip", DDS_FORMAT_BC7_UNORM, false, 36.0);
+    CheckRoundTrip("opaque BC7 round trip", DDS_FORMAT_BC7_UNORM, true, 36.0);
+    CheckBC1PunchThrough();
+    CheckCookedSizes();
+
+    if (g_failures != 0)
+    {
+        fprintf(stderr, "%d checks failed\n", g_failures);
+        return 1;
+    }
+
+    printf("all checks passed\n");
+    return 0;
+}
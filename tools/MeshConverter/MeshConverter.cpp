@@ -0,0 +1,434 @@
+// MeshConverter: converts BasicMesh files to version 3 and inspects them.
+//
+//   MeshConverter INPUT OUTPUT
+//       Converts a version 1 mesh (two counts, BasicVertex records and
+//       16-bit indices) to version 3.
+//   MeshConverter --info FILE
+//       Prints the header, vertex layout and submeshes of a version 2 or 3
+//       mesh.
+//   MeshConverter --optimize INPUT OUTPUT
+//       Reorders a mesh for the vertex cache, overdraw and vertex fetch (see
+//       MeshOptimizer.h), converting it from version 1 first if needed, and
+//       prints its vertex cache statistics before and after.
+//   MeshConverter --stats FILE
+//       Prints the vertex cache statistics (ACMR and ATVR) of a mesh for
+//       several cache sizes.
+//   MeshConverter --lods LEVELS INPUT OUTPUT
+//       Adds up to LEVELS levels of detail, each with about half the
+//       triangles of the one before, after each submesh (see
+//       MeshSimplifier.h), and prints their sizes and errors.
+//   MeshConverter --quantize INPUT OUTPUT
+//       Rewrites a mesh with 16-byte quantized vertices (see
+//       VertexQuantization.h), decodes the result again and prints the largest
+//       position, normal and texture coordinate errors.
+//
+// The converter only needs the portable sources of the sample and builds on
+// Linux or Windows; from this directory, for example:
+//
+//   g++ -std=c++17 -O2 -I../../d3d-stereo-sample -o MeshConverter MeshConverter.cpp
+//       ../../d3d-stereo-sample/BasicMeshFormat.cpp ../../d3d-stereo-sample/MeshOptimizer.cpp
+//       ../../d3d-stereo-sample/MeshSimplifier.cpp ../../d3d-stereo-sample/VertexQuantization.cpp
+//       ../../d3d-stereo-sample/BasicVertexStream.cpp
+
+#include "BasicMeshFormat.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "VertexQuantization.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    const char* const SemanticNames[] = { "position", "normal", "texcoord", "tangent", "color" };
+    const char* const FormatNames[] =
+    {
+        "float2", "float3", "float4", "half2", "half4",
+        "snorm16x2", "snorm16x4", "unorm16x2", "unorm16x4", "snorm8x4", "unorm8x4",
+    };
+
+    int Usage()
+    {
+        fprintf(stderr,
+            "usage: MeshConverter INPUT OUTPUT\n"
+            "       MeshConverter --info FILE\n"
+            "       MeshConverter --optimize INPUT OUTPUT\n"
+            "       MeshConverter --stats FILE\n"
+            "       MeshConverter --lods LEVELS INPUT OUTPUT\n"
+            "       MeshConverter --quantize INPUT OUTPUT\n");
+        return 2;
+    }
+
+    bool ReadWholeFile(const char* path, std::vector<uint8_t>* data)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        data->assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        return true;
+    }
+
+    const char* ResultText(BasicMeshResult result)
+    {
+        switch (result)
+        {
+        case BasicMeshResult::Ok: return "ok";
+        case BasicMeshResult::InvalidArgument: return "empty file";
+        case BasicMeshResult::InvalidData: return "malformed or unsupported mesh";
+        case BasicMeshResult::OutOfBounds: return "file is shorter than its header describes";
+        default: return "unknown error";
+        }
+    }
+
+    bool WriteWholeFile(const char* path, const std::vector<uint8_t>& data)
+    {
+        std::ofstream file(path, std::ios::binary);
+        file.write(reinterpret_cast<const char*>(data.data()), data.size());
+        return static_cast<bool>(file);
+    }
+
+    // Reads a mesh of any version, converting version 1 to version 3.
+    bool ReadMesh(const char* path, std::vector<uint8_t>* mesh)
+    {
+        std::vector<uint8_t> data;
+        if (!ReadWholeFile(path, &data))
+        {
+            fprintf(stderr, "error: cannot read %s\n", path);
+            return false;
+        }
+
+        if (IsBasicMesh(data.data(), data.size()))
+        {
+            mesh->swap(data);
+            return true;
+        }
+
+        BasicMeshResult result = ConvertLegacyBasicMesh(data.data(), data.size(), mesh);
+        if (result != BasicMeshResult::Ok)
+        {
+            fprintf(stderr, "error: %s: %s\n", path, ResultText(result));
+            return false;
+        }
+        return true;
+    }
+
+    // Prints the statistics of a parsed mesh for a cache of cacheSize
+    // entries. Returns false if an index is out of range.
+    bool PrintStatistics(const BasicMeshInfo& info, uint32_t cacheSize)
+    {
+        std::vector<uint32_t> indices(info.indexCount);
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            indices[i] = GetMeshIndex(info, i);
+            if (indices[i] >= info.vertexCount)
+            {
+                fprintf(stderr, "error: index %zu is out of range\n", i);
+                return false;
+            }
+        }
+
+        VertexCacheStatistics statistics = AnalyzeVertexCache(indices.data(), indices.size(), info.vertexCount, cacheSize);
+        printf("  cache %2u: ACMR %.3f, ATVR %.3f (%u vertex shader runs for %u triangles)\n",
+            cacheSize, statistics.acmr, statistics.atvr, statistics.vertexTransforms, statistics.triangleCount);
+        return true;
+    }
+
+    int Stats(const char* path)
+    {
+        std::vector<uint8_t> mesh;
+        if (!ReadMesh(path, &mesh))
+        {
+            return 1;
+        }
+
+        BasicMeshInfo info;
+        BasicMeshResult result = ParseBasicMesh(mesh.data(), mesh.size(), &info);
+        if (result != BasicMeshResult::Ok)
+        {
+            fprintf(stderr, "error: %s: %s\n", path, ResultText(result));
+            return 1;
+        }
+
+        printf("%s: %u vertices, %u triangles\n", path, info.vertexCount, info.indexCount / 3);
+        for (uint32_t cacheSize : { 8u, 16u, 32u })
+        {
+            if (!PrintStatistics(info, cacheSize))
+            {
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    int Optimize(const char* inputPath, const char* outputPath)
+    {
+        std::vector<uint8_t> mesh;
+        if (!ReadMesh(inputPath, &mesh))
+        {
+            return 1;
+        }
+
+        std::vector<uint8_t> optimized;
+        BasicMeshResult result = OptimizeBasicMesh(mesh.data(), mesh.size(), &optimized);
+        if (result != BasicMeshResult::Ok)
+        {
+            fprintf(stderr, "error: %s: %s\n", inputPath, ResultText(result));
+            return 1;
+        }
+
+        if (!WriteWholeFile(outputPath, optimized))
+        {
+            fprintf(stderr, "error: cannot write %s\n", outputPath);
+            return 1;
+        }
+
+        BasicMeshInfo before;
+        BasicMeshInfo after;
+        ParseBasicMesh(mesh.data(), mesh.size(), &before);
+        ParseBasicMesh(optimized.data(), optimized.size(), &after);
+        printf("before:\n");
+        PrintStatistics(before, DefaultVertexCacheSize);
+        printf("after:\n");
+        PrintStatistics(after, DefaultVertexCacheSize);
+        return 0;
+    }
+
+    int GenerateLods(const char* levels, const char* inputPath, const char* outputPath)
+    {
+        char* end;
+        unsigned long levelCount = strtoul(levels, &end, 10);
+        if (*end != '\0' || levelCount == 0 || levelCount > 16)
+        {
+            fprintf(stderr, "error: LEVELS must be a number from 1 to 16\n");
+            return 2;
+        }
+
+        std::vector<uint8_t> mesh;
+        if (!ReadMesh(inputPath, &mesh))
+        {
+            return 1;
+        }
+
+        std::vector<uint8_t> output;
+        BasicMeshResult result = GenerateBasicMeshLods(mesh.data(), mesh.size(), static_cast<uint32_t>(levelCount), 0.5f, &output);
+        if (result != BasicMeshResult::Ok)
+        {
+            fprintf(stderr, "error: %s: %s\n", inputPath, ResultText(result));
+            return 1;
+        }
+
+        if (!WriteWholeFile(outputPath, output))
+        {
+            fprintf(stderr, "error: cannot write %s\n", outputPath);
+            return 1;
+        }
+
+        BasicMeshInfo info;
+        ParseBasicMesh(output.data(), output.size(), &info);
+        for (uint32_t i = 0; i < info.submeshCount; i++)
+        {
+            const BasicMeshSubmesh& submesh = info.submeshes[i];
+            printf("submesh %u: %u triangles, error %g\n", i, submesh.indexCount / 3, submesh.lodError);
+        }
+        return 0;
+    }
+
+    // Decodes attribute semantic of vertex i, or returns fallback if the mesh
+    // has no such attribute.
+    float4 ReadAttribute(const BasicMeshInfo& info, MeshSemantic semantic, size_t i, float4 fallback)
+    {
+        const BasicMeshAttribute* attribute = FindMeshAttribute(info, semantic);
+        if (!attribute)
+        {
+            return fallback;
+        }
+        return DecodeMeshAttribute(
+            static_cast<MeshAttributeFormat>(attribute->format),
+            info.vertexData + i * info.vertexStride + attribute->offset);
+    }
+
+    int Quantize(const char* inputPath, const char* outputPath)
+    {
+        std::vector<uint8_t> mesh;
+        if (!ReadMesh(inputPath, &mesh))
+        {
+            return 1;
+        }
+
+        std::vector<uint8_t> quantized;
+        BasicMeshResult result = QuantizeBasicMesh(mesh.data(), mesh.size(), &quantized);
+        if (result != BasicMeshResult::Ok)
+        {
+            fprintf(stderr, "error: %s: %s\n", inputPath, ResultText(result));
+            return 1;
+        }
+
+        if (!WriteWholeFile(outputPath, quantized))
+        {
+            fprintf(stderr, "error: cannot write %s\n", outputPath);
+            return 1;
+        }
+
+        // Decode both meshes and compare them vertex by vertex; quantization
+        // keeps the vertex order.
+        BasicMeshInfo before;
+        BasicMeshInfo after;
+        ParseBasicMesh(mesh.data(), mesh.size(), &before);
+        ParseBasicMesh(quantized.data(), quantized.size(), &after);
+
+        float positionError = 0.0f;
+        float normalError = 0.0f;
+        float texCoordError = 0.0f;
+        const float4 up(0.0f, 0.0f, 1.0f, 0.0f);
+        const float4 zero(0.0f, 0.0f, 0.0f, 0.0f);
+        for (size_t i = 0; i < before.vertexCount; i++)
+        {
+            float4 position = ReadAttribute(before, MeshSemantic::Position, i, zero);
+            float4 encodedPosition = ReadAttribute(after, MeshSemantic::Position, i, zero);
+            float4 normal = ReadAttribute(before, MeshSemantic::Normal, i, up);
+            float4 encodedNormal = ReadAttribute(after, MeshSemantic::Normal, i, zero);
+            float4 texCoord = ReadAttribute(before, MeshSemantic::TexCoord, i, zero);
+            float4 decodedTexCoord = ReadAttribute(after, MeshSemantic::TexCoord, i, zero);
+
+            float3 decodedPosition = after.bounds.center + after.bounds.extents *
+                float3(encodedPosition.x, encodedPosition.y, encodedPosition.z);
+            positionError = fmaxf(positionError, length(decodedPosition - float3(position.x, position.y, position.z)));
+
+            if (FindMeshAttribute(before, MeshSemantic::Normal))
+            {
+                float3 decodedNormal = DecodeOctahedral(float2(encodedNormal.x, encodedNormal.y));
+                float cosine = dot(decodedNormal, normalize(float3(normal.x, normal.y, normal.z)));
+                normalError = fmaxf(normalError, acosf(fminf(cosine, 1.0f)) * 57.2957795f);
+            }
+
+            texCoordError = fmaxf(texCoordError, fabsf(decodedTexCoord.x - texCoord.x));
+            texCoordError = fmaxf(texCoordError, fabsf(decodedTexCoord.y - texCoord.y));
+        }
+
+        printf("%s: %zu bytes -> %s: %zu bytes\n", inputPath, mesh.size(), outputPath, quantized.size());
+        printf("largest errors: position %g, normal %g degrees, texcoord %g\n",
+            positionError, normalError, texCoordError);
+        return 0;
+    }
+
+    int Info(const char* path)
+    {
+        std::vector<uint8_t> data;
+        if (!ReadWholeFile(path, &data))
+        {
+            fprintf(stderr, "error: cannot read %s\n", path);
+            return 1;
+        }
+
+        if (!IsBasicMesh(data.data(), data.size()))
+        {
+            fprintf(stderr, "error: %s is not a version 2 or 3 mesh; convert it first\n", path);
+            return 1;
+        }
+
+        BasicMeshInfo info;
+        BasicMeshResult result = ParseBasicMesh(data.data(), data.size(), &info);
+        if (result != BasicMeshResult::Ok)
+        {
+            fprintf(stderr, "error: %s: %s\n", path, ResultText(result));
+            return 1;
+        }
+
+        printf("version %u, %u vertices of %u bytes, %u triangles, %u-bit indices\n",
+            info.version, info.vertexCount, info.vertexStride, info.indexCount / 3, info.indexSize * 8);
+        printf("bounds: center (%g, %g, %g), extents (%g, %g, %g), sphere radius %g\n",
+            info.bounds.center.x, info.bounds.center.y, info.bounds.center.z,
+            info.bounds.extents.x, info.bounds.extents.y, info.bounds.extents.z,
+            info.boundingSphere.radius);
+
+        for (uint32_t i = 0; i < info.attributeCount; i++)
+        {
+            const BasicMeshAttribute& attribute = info.attributes[i];
+            printf("attribute %s%u: %s at offset %u\n",
+                SemanticNames[attribute.semantic], attribute.semanticIndex,
+                FormatNames[attribute.format], attribute.offset);
+        }
+
+        std::vector<BasicMeshSubmesh> submeshes = GetMeshSubmeshes(info);
+        for (uint32_t i = 0; i < info.submeshCount; i++)
+        {
+            const BasicMeshSubmesh& submesh = submeshes[i];
+            printf("submesh %u: indices [%u, %u), vertices [%u, %u), material %u",
+                i, submesh.indexStart, submesh.indexStart + submesh.indexCount,
+                submesh.vertexStart, submesh.vertexStart + submesh.vertexCount, submesh.materialIndex);
+            if (submesh.lodError != 0.0f)
+            {
+                printf(", level of detail with error %g", submesh.lodError);
+            }
+            printf("\n");
+        }
+        return 0;
+    }
+
+    int Convert(const char* inputPath, const char* outputPath)
+    {
+        std::vector<uint8_t> input;
+        if (!ReadWholeFile(inputPath, &input))
+        {
+            fprintf(stderr, "error: cannot read %s\n", inputPath);
+            return 1;
+        }
+
+        if (IsBasicMesh(input.data(), input.size()))
+        {
+            fprintf(stderr, "error: %s is already a version 2 or 3 mesh\n", inputPath);
+            return 1;
+        }
+
+        std::vector<uint8_t> output;
+        BasicMeshResult result = ConvertLegacyBasicMesh(input.data(), input.size(), &output);
+        if (result != BasicMeshResult::Ok)
+        {
+            fprintf(stderr, "error: %s: %s\n", inputPath, ResultText(result));
+            return 1;
+        }
+
+        if (!WriteWholeFile(outputPath, output))
+        {
+            fprintf(stderr, "error: cannot write %s\n", outputPath);
+            return 1;
+        }
+
+        printf("%s: %zu bytes -> %s: %zu bytes\n", inputPath, input.size(), outputPath, output.size());
+        return 0;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc == 3 && strcmp(argv[1], "--info") == 0)
+    {
+        return Info(argv[2]);
+    }
+    if (argc == 3 && strcmp(argv[1], "--stats") == 0)
+    {
+        return Stats(argv[2]);
+    }
+    if (argc == 4 && strcmp(argv[1], "--optimize") == 0)
+    {
+        return Optimize(argv[2], argv[3]);
+    }
+    if (argc == 5 && strcmp(argv[1], "--lods") == 0)
+    {
+        return GenerateLods(argv[2], argv[3], argv[4]);
+    }
+    if (argc == 4 && strcmp(argv[1], "--quantize") == 0)
+    {
+        return Quantize(argv[2], argv[3]);
+    }
+    if (argc == 3 && argv[1][0] != '-')
+    {
+        return Convert(argv[1], argv[2]);
+    }
+    return Usage();
+}
@@ -0,0 +1,283 @@
+// MipmapTest: builds mip chains with GenerateMipChain and checks levels whose
+// values can be worked out by hand. Prints each failure and exits with 1 if
+// there was any.
+//
+//   MipmapTest [--save file] [--compare file]
+//
+// The checks cover box filtering of black and white in sRGB and linear space,
+// premultiplied alpha, constant images under the Kaiser filter, and the level
+// sizes of images that are not powers of two.
+//
+// The SIMD and scalar filters must give the same bytes. --save writes the
+// chains of a test image under several option sets to a file, and --compare
+// checks them against a file saved by another build. The test only needs the
+// portable sources of the sample and builds on Linux or Windows; from this
+// directory, for example:
+//
+//   g++ -std=c++17 -O2 -pthread -I../../d3d-stereo-sample -o MipmapTest MipmapTest.cpp
+//       ../../d3d-stereo-sample/MipmapGenerator.cpp ../../d3d-stereo-sample/DDSParser.cpp
+//   g++ -std=c++17 -O2 -pthread -DBASICMATH_NO_SIMD -I../../d3d-stereo-sample -o MipmapTestScalar
+//       MipmapTest.cpp ../../d3d-stereo-sample/MipmapGenerator.cpp ../../d3d-stereo-sample/DDSParser.cpp
+//   MipmapTestScalar --save scalar.bin && MipmapTest --compare scalar.bin
+
+#include "MipmapGenerator.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    int g_failures = 0;
+
+    void Check(const char* test, const char* what, size_t value, size_t expected)
+    {
+        if (value != expected)
+        {
+            g_failures++;
+            fprintf(stderr, "FAIL %s: %s is %zu, expected %zu\n", test, what, value, expected);
+        }
+    }
+
+    // Builds the chain of a tightly packed image and checks that it succeeds.
+    std::vector<DDSSubresource> Generate(
+        const char* test,
+        const std::vector<uint8_t>& pixels,
+        size_t width,
+        size_t height,
+        const MipmapOptions& options,
+        std::vector<uint8_t>* chain)
+    {
+        std::vector<DDSSubresource> levels;
+        DDSResult result = GenerateMipChain(pixels.data(), width * 4, width, height,
+            GetMipCount(width, height), options, chain, &levels);
+        Check(test, "result", static_cast<size_t>(result), static_cast<size_t>(DDSResult::Ok));
+        Check(test, "level count", levels.size(), GetMipCount(width, height));
+        return levels;
+    }
+
+    void CheckTexel(const char* test, const DDSSubresource& level, size_t x, size_t y, const uint8_t (&expected)[4])
+    {
+        const uint8_t* texel = level.data + y * level.rowPitch + x * 4;
+        if (memcmp(texel, expected, 4) != 0)
+        {
+            g_failures++;
+            fprintf(stderr, "FAIL %s: texel (%zu, %zu) is (%u, %u, %u, %u), expected (%u, %u, %u, %u)\n",
+                test, x, y, texel[0], texel[1], texel[2], texel[3], expected[0], expected[1], expected[2], expected[3]);
+        }
+    }
+
+    // A 2x2 checker of black and white averages to half the light, which is
+    // 188 in sRGB (0.5 encodes to 187.5) and 128 when the values are linear.
+    // Alpha is always averaged as stored.
+    void CheckBlackAndWhite()
+    {
+        const std::vector<uint8_t> pixels =
+        {
+            0, 0, 0, 255,           255, 255, 255, 0,
+            255, 255, 255, 0,       0, 0, 0, 255,
+        };
+
+        MipmapOptions options;
+        options.filter = MipFilter::Box;
+        std::vector<uint8_t> chain;
+        std::vector<DDSSubresource> levels = Generate("sRGB box", pixels, 2, 2, options, &chain);
+        if (levels.size() == 2)
+        {
+            CheckTexel("sRGB box", levels[1], 0, 0, { 188, 188, 188, 128 });
+        }
+
+        options.srgb = false;
+        levels = Generate("linear box", pixels, 2, 2, options, &chain);
+        if (levels.size() == 2)
+        {
+            CheckTexel("linear box", levels[1], 0, 0, { 128, 128, 128, 128 });
+        }
+    }
+
+    // A premultiplied half-transparent white next to a fully transparent
+    // texel averages to a quarter of the coverage, and the transparent
+    // texel's color must not darken it: (64, 64, 64, 64) in sRGB and linear.
+    void CheckPremultipliedAlpha()
+    {
+        const std::vector<uint8_t> pixels =
+        {
+            128, 128, 128, 128,     0, 0, 0, 0,
+        };
+
+        MipmapOptions options;
+        options.premultipliedAlpha = true;
+        std::vector<uint8_t> chain;
+        std::vector<DDSSubresource> levels = Generate("premultiplied sRGB", pixels, 2, 1, options, &chain);
+        if (levels.size() == 2)
+        {
+            CheckTexel("premultiplied sRGB", levels[1], 0, 0, { 64, 64, 64, 64 });
+        }
+
+        options.srgb = false;
+        levels = Generate("premultiplied linear", pixels, 2, 1, options, &chain);
+        if (levels.size() == 2)
+        {
+            CheckTexel("premultiplied linear", levels[1], 0, 0, { 64, 64, 64, 64 });
+        }
+    }
+
+    // The Kaiser weights are normalized, so a constant image keeps its value
+    // in every level, even where the filter reaches past the edges.
+    void CheckKaiserConstant()
+    {
+        const uint8_t value[4] = { 200, 100, 50, 180 };
+        std::vector<uint8_t> pixels(24 * 10 * 4);
+        for (size_t i = 0; i < pixels.size(); i++)
+        {
+            pixels[i] = value[i % 4];
+        }
+
+        MipmapOptions options;
+        options.filter = MipFilter::Kaiser;
+        std::vector<uint8_t> chain;
+        std::vector<DDSSubresource> levels = Generate("Kaiser constant", pixels, 24, 10, options, &chain);
+        for (size_t mip = 1; mip < levels.size(); mip++)
+        {
+            size_t changed = 0;
+            for (size_t y = 0; y < levels[mip].height; y++)
+            {
+                for (size_t x = 0; x < levels[mip].width; x++)
+                {
+                    changed += memcmp(levels[mip].data + y * levels[mip].rowPitch + x * 4, value, 4) != 0;
+                }
+            }
+
+            char what[64];
+            snprintf(what, sizeof(what), "changed texels in level %zu", mip);
+            Check("Kaiser constant", what, changed, 0);
+        }
+    }
+
+    // Each level halves the previous one and rounds down, to no less than 1:
+    // 7x5, 3x2, 1x1, with rows packed at four bytes per texel.
+    void CheckNonPowerOfTwo()
+    {
+        std::vector<uint8_t> pixels(7 * 5 * 4, 255);
+        std::vector<uint8_t> chain;
+        std::vector<DDSSubresource> levels = Generate("7x5", pixels, 7, 5, MipmapOptions(), &chain);
+
+        const size_t sizes[3][2] = { { 7, 5 }, { 3, 2 }, { 1, 1 } };
+        size_t offset = 0;
+        for (size_t mip = 0; mip < levels.size() && mip < 3; mip++)
+        {
+            char what[64];
+            snprintf(what, sizeof(what), "width of level %zu", mip);
+            Check("7x5", what, levels[mip].width, sizes[mip][0]);
+            snprintf(what, sizeof(what), "height of level %zu", mip);
+            Check("7x5", what, levels[mip].height, sizes[mip][1]);
+            snprintf(what, sizeof(what), "row pitch of level %zu", mip);
+            Check("7x5", what, levels[mip].rowPitch, sizes[mip][0] * 4);
+            snprintf(what, sizeof(what), "offset of level %zu", mip);
+            Check("7x5", what, static_cast<size_t>(levels[mip].data - chain.data()), offset);
+            offset += sizes[mip][0] * sizes[mip][1] * 4;
+        }
+        Check("7x5", "chain size", chain.size(), offset);
+    }
+
+    // The chains of a 37x23 pattern under each filter, with and without sRGB
+    // and premultiplied alpha, one after the other.
+    std::vector<uint8_t> BuildReferenceChains()
+    {
+        const size_t width = 37;
+        const size_t height = 23;
+        std::vector<uint8_t> pixels(width * height * 4);
+        for (size_t i = 0; i < pixels.size(); i++)
+        {
+            pixels[i] = static_cast<uint8_t>((i * 2654435761u) >> 13);
+        }
+
+        std::vector<uint8_t> chains;
+        for (MipFilter filter : { MipFilter::Box, MipFilter::Kaiser })
+        {
+            for (unsigned int flags = 0; flags < 4; flags++)
+            {
+                MipmapOptions options;
+                options.filter = filter;
+                options.srgb = (flags & 1) != 0;
+                options.premultipliedAlpha = (flags & 2) != 0;
+
+                std::vector<uint8_t> chain;
+                Generate("reference", pixels, width, height, options, &chain);
+                chains.insert(chains.end(), chain.begin(), chain.end());
+            }
+        }
+        return chains;
+    }
+
+    void SaveChains(const char* path)
+    {
+        std::vector<uint8_t> chains = BuildReferenceChains();
+        FILE* file = fopen(path, "wb");
+        if (!file || fwrite(chains.data(), 1, chains.size(), file) != chains.size())
+        {
+            g_failures++;
+            fprintf(stderr, "FAIL save: cannot write %s\n", path);
+        }
+        if (file)
+        {
+            fclose(file);
+        }
+    }
+
+    void CompareChains(const char* path)
+    {
+        std::vector<uint8_t> chains = BuildReferenceChains();
+        std::vector<uint8_t> saved(chains.size() + 1);
+        FILE* file = fopen(path, "rb");
+        if (!file)
+        {
+            g_failures++;
+            fprintf(stderr, "FAIL compare: cannot read %s\n", path);
+            return;
+        }
+        size_t read = fread(saved.data(), 1, saved.size(), file);
+        fclose(file);
+
+        Check("compare", "saved size", read, chains.size());
+        size_t different = 0;
+        for (size_t i = 0; i < chains.size() && i < read; i++)
+        {
+            different += chains[i] != saved[i];
+        }
+        Check("compare", "different bytes", different, 0);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    CheckBlackAndWhite();
+    CheckPremultipliedAlpha();
+    CheckKaiserConstant();
+    CheckNonPowerOfTwo();
+
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--save") == 0 && i + 1 < argc)
+        {
+            SaveChains(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--compare") == 0 && i + 1 < argc)
+        {
+            CompareChains(argv[++i]);
+        }
+        else
+        {
+            fprintf(stderr, "usage: MipmapTest [--save file] [--compare file]\n");
+            return 1;
+        }
+    }
+
+    if (g_failures != 0)
+    {
+        fprintf(stderr, "%d checks failed\n", g_failures);
+        return 1;
+    }
+
+    printf("all checks passed\n");
+    return 0;
+}
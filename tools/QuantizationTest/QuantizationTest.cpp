@@ -0,0 +1,260 @@
+// QuantizationTest: encodes and decodes vertices with VertexQuantization and
+// checks the round trip against the limits that VertexQuantization.h
+// documents. Prints each failure and exits with 1 if there was any.
+//
+//   QuantizationTest
+//
+// Positions must come back within half a quantization step on each axis,
+// normals within MaximumNormalError degrees, and texture coordinates as
+// exactly the nearest half float. The meshes are the shapes of
+// ShapeGenerator, a point cloud far from the origin, and BasicMesh files
+// with and without normals and texture coordinates.
+//
+// The test only needs the portable sources of the sample and builds on Linux
+// or Windows; from this directory, for example:
+//
+//   g++ -std=c++17 -O2 -I../../d3d-stereo-sample -o QuantizationTest QuantizationTest.cpp
+//       ../../d3d-stereo-sample/VertexQuantization.cpp ../../d3d-stereo-sample/BasicMeshFormat.cpp
+//       ../../d3d-stereo-sample/BasicVertexStream.cpp ../../d3d-stereo-sample/ShapeGenerator.cpp
+
+#include "BasicMeshFormat.h"
+#include "ShapeGenerator.h"
+#include "VertexQuantization.h"
+#include <float.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+namespace
+{
+    // Two snorms on the octahedron give about 0.044 degrees at worst.
+    const float MaximumNormalError = 0.05f;
+
+    int g_failures = 0;
+
+    void Fail(const char* test, const char* what, size_t index, float value, float limit)
+    {
+        if (g_failures++ < 20)
+        {
+            fprintf(stderr, "FAIL %s: %s of vertex %zu is %g, limit %g\n", test, what, index, value, limit);
+        }
+    }
+
+    float AngleInDegrees(float3 a, float3 b)
+    {
+        float cosine = dot(normalize(a), normalize(b));
+        return acosf(fmaxf(-1.0f, fminf(cosine, 1.0f))) * 57.2957795f;
+    }
+
+    // Half a step of the 16-bit snorm grid over the bounds, with room for
+    // the rounding of the float arithmetic on either side.
+    float HalfStep(const AABB& bounds, unsigned int axis)
+    {
+        float magnitude = fabsf(bounds.center[axis]) + bounds.extents[axis];
+        return bounds.extents[axis] / 65534.0f + 4.0f * FLT_EPSILON * magnitude;
+    }
+
+    void CheckRoundTrip(const char* test, const std::vector<BasicVertex>& vertices)
+    {
+        AABB bounds = ComputeQuantizationBounds(vertices.data(), vertices.size());
+        std::vector<QuantizedVertex> quantized(vertices.size());
+        std::vector<BasicVertex> decoded(vertices.size());
+        QuantizeVertices(vertices.data(), vertices.size(), bounds, quantized.data());
+        DequantizeVertices(quantized.data(), quantized.size(), bounds, decoded.data());
+
+        for (size_t i = 0; i < vertices.size(); i++)
+        {
+            for (unsigned int axis = 0; axis < 3; axis++)
+            {
+                float error = fabsf(decoded[i].pos[axis] - vertices[i].pos[axis]);
+                if (error > HalfStep(bounds, axis))
+                {
+                    Fail(test, "position error", i, error, HalfStep(bounds, axis));
+                }
+            }
+
+            float normalError = AngleInDegrees(decoded[i].norm, vertices[i].norm);
+            if (normalError > MaximumNormalError)
+            {
+                Fail(test, "normal error in degrees", i, normalError, MaximumNormalError);
+            }
+
+            for (unsigned int axis = 0; axis < 2; axis++)
+            {
+                float expected = HalfToFloat(FloatToHalf(vertices[i].tex[axis]));
+                if (memcmp(&decoded[i].tex[axis], &expected, sizeof(float)) != 0)
+                {
+                    Fail(test, "texture coordinate", i, decoded[i].tex[axis], expected);
+                }
+            }
+        }
+        printf("%-12s %6zu vertices\n", test, vertices.size());
+    }
+
+    template <class Generate>
+    std::vector<BasicVertex> MakeShape(ShapeSize size, Generate generate)
+    {
+        std::vector<BasicVertex> vertices(size.vertexCount);
+        std::vector<uint32_t> indices(size.indexCount);
+        generate(vertices.data(), vertices.size(), indices.data(), indices.size());
+        return vertices;
+    }
+
+    // A reproducible pseudo-random float in [-1, 1).
+    float Random(uint32_t* state)
+    {
+        *state = *state * 1664525u + 1013904223u;
+        return static_cast<float>(*state >> 8) / 8388608.0f - 1.0f;
+    }
+
+    // Every finite half must survive the trip through float unchanged, which
+    // is what makes the texture coordinate check above exact.
+    void CheckHalfFloats()
+    {
+        for (uint32_t bits = 0; bits <= 0xFFFF; bits++)
+        {
+            uint16_t half = static_cast<uint16_t>(bits);
+            bool isNan = (half & 0x7C00) == 0x7C00 && (half & 0x03FF) != 0;
+            if (!isNan && FloatToHalf(HalfToFloat(half)) != half)
+            {
+                Fail("half", "half bits", bits, HalfToFloat(half), HalfToFloat(half));
+            }
+        }
+        printf("%-12s %6u values\n", "half", 0x10000u);
+    }
+
+    // Quantizes a BasicMesh file and checks that the result has the layout
+    // QuantizedVertexShader reads, whatever attributes the source had.
+    void CheckBasicMesh(const char* test, const std::vector<BasicVertex>& vertices, uint32_t attributeCount)
+    {
+        std::vector<uint32_t> indices(vertices.size() - vertices.size() % 3);
+        for (size_t i = 0; i < indices.size(); i++)
+        {
+            indices[i] = static_cast<uint32_t>(i);
+        }
+
+        // The BasicVertex attributes start with the position, so a prefix of
+        // them with the full stride describes a mesh without the rest.
+        BasicMeshDesc desc = {};
+        desc.vertices = vertices.data();
+        desc.vertexCount = static_cast<uint32_t>(vertices.size());
+        desc.vertexStride = sizeof(BasicVertex);
+        desc.attributes = BasicVertexAttributes;
+        desc.attributeCount = attributeCount;
+        desc.indices = indices.data();
+        desc.indexCount = static_cast<uint32_t>(indices.size());
+
+        std::vector<uint8_t> mesh;
+        std::vector<uint8_t> quantizedMesh;
+        BasicMeshInfo info;
+        if (WriteBasicMesh(desc, &mesh) != BasicMeshResult::Ok ||
+            QuantizeBasicMesh(mesh.data(), mesh.size(), &quantizedMesh) != BasicMeshResult::Ok ||
+            ParseBasicMesh(quantizedMesh.data(), quantizedMesh.size(), &info) != BasicMeshResult::Ok)
+        {
+            Fail(test, "quantization result", 0, 0.0f, 0.0f);
+            return;
+        }
+        if (info.vertexStride != sizeof(QuantizedVertex) || info.attributeCount != 3 ||
+            memcmp(info.attributes, QuantizedVertexAttributes, sizeof(QuantizedVertexAttributes)) != 0)
+        {
+            Fail(test, "attribute count", 0, static_cast<float>(info.attributeCount), 3.0f);
+            return;
+        }
+
+        // The file must hold exactly what QuantizeVertices makes of the
+        // vertices, with the defaults for attributes the source lacked.
+        std::vector<BasicVertex> expected = vertices;
+        for (BasicVertex& vertex : expected)
+        {
+            vertex.norm = (attributeCount >= 2) ? vertex.norm : float3(0.0f, 0.0f, 1.0f);
+            vertex.tex = (attributeCount >= 3) ? vertex.tex : float2(0.0f, 0.0f);
+        }
+        std::vector<QuantizedVertex> quantized(expected.size());
+        QuantizeVertices(expected.data(), expected.size(), info.bounds, quantized.data());
+        for (size_t i = 0; i < quantized.size(); i++)
+        {
+            if (memcmp(&quantized[i], info.vertexData + i * sizeof(QuantizedVertex), sizeof(QuantizedVertex)) != 0)
+            {
+                Fail(test, "encoded vertex", i, 0.0f, 0.0f);
+            }
+        }
+        printf("%-12s %6zu vertices, %u attributes\n", test, vertices.size(), attributeCount);
+    }
+}
+
+int main()
+{
+    CheckHalfFloats();
+
+    SphereDesc sphere;
+    CheckRoundTrip("sphere", MakeShape(GetSphereSize(sphere), [&](BasicVertex* v, size_t vc, uint32_t* i, size_t ic)
+    {
+        return GenerateSphere(sphere, v, vc, i, ic);
+    }));
+    IcosphereDesc icosphere;
+    icosphere.frequency = 40;
+    icosphere.radius = 25.0f;
+    CheckRoundTrip("icosphere", MakeShape(GetIcosphereSize(icosphere), [&](BasicVertex* v, size_t vc, uint32_t* i, size_t ic)
+    {
+        return GenerateIcosphere(icosphere, v, vc, i, ic);
+    }));
+    TorusDesc torus;
+    CheckRoundTrip("torus", MakeShape(GetTorusSize(torus), [&](BasicVertex* v, size_t vc, uint32_t* i, size_t ic)
+    {
+        return GenerateTorus(torus, v, vc, i, ic);
+    }));
+    CylinderDesc cylinder;
+    CheckRoundTrip("cylinder", MakeShape(GetCylinderSize(cylinder), [&](BasicVertex* v, size_t vc, uint32_t* i, size_t ic)
+    {
+        return GenerateCylinder(cylinder, v, vc, i, ic);
+    }));
+    GridDesc grid;
+    grid.width = 100.0f;
+    CheckRoundTrip("grid", MakeShape(GetGridSize(grid), [&](BasicVertex* v, size_t vc, uint32_t* i, size_t ic)
+    {
+        return GenerateGrid(grid, v, vc, i, ic);
+    }));
+    CheckRoundTrip("box", MakeShape(GetBoxSize(), [&](BasicVertex* v, size_t vc, uint32_t* i, size_t ic)
+    {
+        return GenerateBox(float3(3.0f, 2.0f, 4.0f), v, vc, i, ic);
+    }));
+
+    // Random normals cover the whole octahedron, including the folded lower
+    // half, and texture coordinates outside [0, 1] as used for tiling.
+    std::vector<BasicVertex> cloud(50000);
+    uint32_t state = 1;
+    for (BasicVertex& vertex : cloud)
+    {
+        vertex.pos = float3(1000.0f, -250.0f, 4.0f) + float3(Random(&state) * 30.0f, Random(&state), Random(&state) * 0.01f);
+        do
+        {
+            vertex.norm = float3(Random(&state), Random(&state), Random(&state));
+        } while (dot(vertex.norm, vertex.norm) < 1e-4f);
+        vertex.norm = normalize(vertex.norm);
+        vertex.tex = float2(Random(&state) * 4.0f, Random(&state) * 0.5f + 0.5f);
+    }
+    const float3 axes[] =
+    {
+        float3(1.0f, 0.0f, 0.0f), float3(-1.0f, 0.0f, 0.0f), float3(0.0f, 1.0f, 0.0f),
+        float3(0.0f, -1.0f, 0.0f), float3(0.0f, 0.0f, 1.0f), float3(0.0f, 0.0f, -1.0f),
+    };
+    for (size_t i = 0; i < 6; i++)
+    {
+        cloud[i].norm = axes[i];
+    }
+    CheckRoundTrip("cloud", cloud);
+
+    std::vector<BasicVertex> meshVertices(cloud.begin(), cloud.begin() + 3000);
+    CheckBasicMesh("mesh", meshVertices, 3);
+    CheckBasicMesh("mesh", meshVertices, 2);
+    CheckBasicMesh("mesh", meshVertices, 1);
+
+    if (g_failures != 0)
+    {
+        fprintf(stderr, "%d checks failed\n", g_failures);
+        return 1;
+    }
+    printf("all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,330 @@
+// ResidencyTest: drives TextureResidencyManager with a backend that only
+// counts bytes, and checks which levels each texture keeps. Prints each
+// failure and exits with 1 if there was any.
+//
+//   ResidencyTest
+//
+// The checks cover trimming the top mips of the least recently used textures,
+// evicting them once only their smallest level is left, keeping textures
+// requested since BeginFrame, granting fewer levels when the budget cannot be
+// met, backends that fail to allocate, and textures registered as resident.
+//
+// The test only needs the portable sources of the sample and builds on Linux
+// or Windows; from this directory, for example:
+//
+//   g++ -std=c++17 -O2 -I../../d3d-stereo-sample -o ResidencyTest ResidencyTest.cpp
+//       ../../d3d-stereo-sample/TextureResidencyManager.cpp ../../d3d-stereo-sample/DDSParser.cpp
+
+#include "TextureResidencyManager.h"
+#include <stdio.h>
+#include <vector>
+
+namespace
+{
+    int g_failures = 0;
+
+    void Check(const char* test, const char* what, uint64_t value, uint64_t expected)
+    {
+        if (value != expected)
+        {
+            g_failures++;
+            fprintf(stderr, "FAIL %s: %s is %llu, expected %llu\n", test, what,
+                static_cast<unsigned long long>(value), static_cast<unsigned long long>(expected));
+        }
+    }
+
+    // Stands in for the Direct3D backend. Keeps the resident levels and the
+    // bytes they hold for each texture, so that the test can check them
+    // against what the manager reports, and fails allocations over a limit.
+    class FakeBackend : public TextureResidencyBackend
+    {
+    public:
+        explicit FakeBackend(uint64_t limit = UINT64_MAX) :
+            m_limit(limit),
+            m_allocatedBytes(0)
+        {
+        }
+
+        void AddTexture(TextureResidencyId id, const std::vector<uint64_t>& levelSizes)
+        {
+            if (id >= m_textures.size())
+            {
+                m_textures.resize(id + 1);
+            }
+            m_textures[id].levelSizes = levelSizes;
+            m_textures[id].firstMip = levelSizes.size();
+        }
+
+        bool MakeResident(TextureResidencyId id, size_t firstMip) override
+        {
+            Texture& texture = m_textures[id];
+            uint64_t bytes = Bytes(texture, firstMip);
+            uint64_t previous = Bytes(texture, texture.firstMip);
+            if (m_allocatedBytes - previous + bytes > m_limit)
+            {
+                return false;
+            }
+
+            m_allocatedBytes = m_allocatedBytes - previous + bytes;
+            texture.firstMip = firstMip;
+            return true;
+        }
+
+        void Evict(TextureResidencyId id) override
+        {
+            Texture& texture = m_textures[id];
+            m_allocatedBytes -= Bytes(texture, texture.firstMip);
+            texture.firstMip = texture.levelSizes.size();
+        }
+
+        size_t GetFirstMip(TextureResidencyId id) const
+        {
+            return m_textures[id].firstMip;
+        }
+
+        uint64_t GetAllocatedBytes() const
+        {
+            return m_allocatedBytes;
+        }
+
+    private:
+        struct Texture
+        {
+            std::vector<uint64_t> levelSizes;
+            size_t firstMip;
+        };
+
+        uint64_t m_limit;
+        uint64_t m_allocatedBytes;
+        std::vector<Texture> m_textures;
+
+        static uint64_t Bytes(const Texture& texture, size_t firstMip)
+        {
+            uint64_t bytes = 0;
+            for (size_t mip = firstMip; mip < texture.levelSizes.size(); mip++)
+            {
+                bytes += texture.levelSizes[mip];
+            }
+            return bytes;
+        }
+    };
+
+    // Four levels of 64, 16, 4 and 1 bytes: 85 bytes in all, 21 without the
+    // top level, 5 without two and 1 for the smallest alone.
+    const std::vector<uint64_t> LevelSizes = { 64, 16, 4, 1 };
+
+    TextureResidencyId Add(TextureResidencyManager& manager, FakeBackend& backend)
+    {
+        TextureResidencyId id = manager.Register(LevelSizes.data(), LevelSizes.size());
+        backend.AddTexture(id, LevelSizes);
+        return id;
+    }
+
+    // The manager and the backend must agree on the levels of every texture
+    // and on the bytes resident.
+    void CheckState(
+        const char* test,
+        const TextureResidencyManager& manager,
+        const FakeBackend& backend,
+        const std::vector<TextureResidencyId>& ids,
+        const std::vector<size_t>& residentMips)
+    {
+        for (size_t i = 0; i < ids.size(); i++)
+        {
+            char what[64];
+            snprintf(what, sizeof(what), "resident mip of texture %zu", i);
+            Check(test, what, manager.GetResidentMip(ids[i]), residentMips[i]);
+            snprintf(what, sizeof(what), "backend mip of texture %zu", i);
+            Check(test, what, backend.GetFirstMip(ids[i]), residentMips[i]);
+        }
+        Check(test, "resident bytes", manager.GetResidentBytes(), backend.GetAllocatedBytes());
+    }
+
+    // The least recently used texture loses its top mips first, one level
+    // at a time, while the more recently used one keeps all of its levels.
+    void CheckTrimming()
+    {
+        FakeBackend backend;
+        TextureResidencyManager manager(backend, 191);
+        TextureResidencyId older = Add(manager, backend);
+        TextureResidencyId newer = Add(manager, backend);
+        TextureResidencyId requester = Add(manager, backend);
+
+        manager.BeginFrame();
+        manager.Request(older);
+        manager.BeginFrame();
+        manager.Request(newer);
+        CheckState("trimming, setup", manager, backend, { older, newer, requester }, { 0, 0, 4 });
+
+        // Dropping the older texture's top level frees just enough for the
+        // requester.
+        manager.BeginFrame();
+        Check("trimming", "request result", manager.Request(requester), 1);
+        CheckState("trimming", manager, backend, { older, newer, requester }, { 1, 0, 0 });
+        Check("trimming", "resident bytes", manager.GetResidentBytes(), 21 + 85 + 85);
+
+        // Shrinking the budget trims the older texture down to its smallest
+        // level before touching the newer one.
+        manager.BeginFrame();
+        manager.SetBudget(120);
+        CheckState("trimming, budget", manager, backend, { older, newer, requester }, { 3, 1, 0 });
+        Check("trimming, budget", "resident bytes", manager.GetResidentBytes(), 1 + 21 + 85);
+    }
+
+    // Once no texture has more than its smallest level to give, the least
+    // recently used ones are evicted outright.
+    void CheckEviction()
+    {
+        FakeBackend backend;
+        TextureResidencyManager manager(backend, 86);
+        TextureResidencyId first = Add(manager, backend);
+        TextureResidencyId second = Add(manager, backend);
+        TextureResidencyId requester = Add(manager, backend);
+
+        manager.BeginFrame();
+        manager.Request(first, 3);
+        manager.BeginFrame();
+        manager.Request(second, 3);
+        CheckState("eviction, setup", manager, backend, { first, second, requester }, { 3, 3, 4 });
+
+        manager.BeginFrame();
+        Check("eviction", "request result", manager.Request(requester), 1);
+        CheckState("eviction", manager, backend, { first, second, requester }, { 4, 3, 0 });
+
+        // Within the same frame the requester keeps its levels, so shrinking
+        // the budget evicts the other texture as well.
+        manager.SetBudget(85);
+        CheckState("eviction, budget", manager, backend, { first, second, requester }, { 4, 4, 0 });
+    }
+
+    // Textures requested since the last BeginFrame are drawn this frame and
+    // keep their levels, so a request that does not fit otherwise is granted
+    // as many levels as are left, and a budget too small for them is
+    // exceeded until the next frame.
+    void CheckProtection()
+    {
+        FakeBackend backend;
+        TextureResidencyManager manager(backend, 100);
+        TextureResidencyId used = Add(manager, backend);
+        TextureResidencyId requester = Add(manager, backend);
+
+        manager.BeginFrame();
+        manager.Request(used);
+        Check("protection", "request result", manager.Request(requester), 0);
+        CheckState("protection", manager, backend, { used, requester }, { 0, 2 });
+
+        // The full request succeeds once the other texture falls out of use.
+        manager.BeginFrame();
+        Check("protection, next frame", "request result", manager.Request(requester), 1);
+        CheckState("protection, next frame", manager, backend, { used, requester }, { 2, 0 });
+
+        manager.SetBudget(10);
+        CheckState("protection, budget", manager, backend, { used, requester }, { 4, 0 });
+        Check("protection, budget", "resident bytes", manager.GetResidentBytes(), 85);
+
+        manager.BeginFrame();
+        manager.SetBudget(10);
+        CheckState("protection, budget next frame", manager, backend, { used, requester }, { 4, 2 });
+    }
+
+    // A request larger than the whole budget is granted the largest levels
+    // that fit, and none when not even the smallest does.
+    void CheckPartialGrant()
+    {
+        FakeBackend backend;
+        TextureResidencyManager manager(backend, 30);
+        TextureResidencyId texture = Add(manager, backend);
+
+        manager.BeginFrame();
+        Check("partial grant", "request result", manager.Request(texture), 0);
+        CheckState("partial grant", manager, backend, { texture }, { 1 });
+        Check("partial grant", "desired mip result", manager.Request(texture, 1), 1);
+        Check("partial grant", "clamped mip result", manager.Request(texture, 10), 1);
+
+        TextureResidencyManager empty(backend, 0);
+        TextureResidencyId none = Add(empty, backend);
+        Check("partial grant, no budget", "request result", empty.Request(none, 3), 0);
+        Check("partial grant, no budget", "resident mip", empty.GetResidentMip(none), 4);
+    }
+
+    // A backend that cannot allocate keeps the previous levels, and the
+    // manager keeps counting them.
+    void CheckBackendFailure()
+    {
+        FakeBackend backend(21);
+        TextureResidencyManager manager(backend, 1000);
+        TextureResidencyId texture = Add(manager, backend);
+
+        Check("backend failure", "small request result", manager.Request(texture, 1), 1);
+        Check("backend failure", "request result", manager.Request(texture), 0);
+        CheckState("backend failure", manager, backend, { texture }, { 1 });
+    }
+
+    // Textures registered as resident count against the budget at once and
+    // make others give way, but are never trimmed themselves.
+    void CheckResidentTextures()
+    {
+        FakeBackend backend;
+        TextureResidencyManager manager(backend, 100);
+        TextureResidencyId managed = Add(manager, backend);
+        manager.Request(managed);
+
+        manager.BeginFrame();
+        TextureResidencyId loaded = manager.RegisterResident(LevelSizes.data(), LevelSizes.size());
+        Check("resident", "loaded resident mip", manager.GetResidentMip(loaded), 0);
+        Check("resident", "managed resident mip", manager.GetResidentMip(managed), 2);
+        Check("resident", "resident bytes", manager.GetResidentBytes(), 85 + 5);
+
+        manager.BeginFrame();
+        manager.SetBudget(50);
+        Check("resident, budget", "loaded resident mip", manager.GetResidentMip(loaded), 0);
+        Check("resident, budget", "managed resident mip", manager.GetResidentMip(managed), 4);
+        Check("resident, budget", "request result", manager.Request(loaded), 1);
+
+        manager.Unregister(loaded);
+        Check("resident, unregistered", "resident bytes", manager.GetResidentBytes(), 0);
+        Check("resident, unregistered", "backend bytes", backend.GetAllocatedBytes(), 0);
+    }
+
+    // Registering a parsed DDS texture takes each level across all slices.
+    void CheckDDSRegistration()
+    {
+        FakeBackend backend;
+        TextureResidencyManager manager(backend, UINT64_MAX);
+
+        DDSTextureInfo info = {};
+        info.format = DDS_FORMAT_BC1_UNORM;
+        info.dimension = DDS_DIMENSION_TEXTURE2D;
+        info.width = 16;
+        info.height = 8;
+        info.depth = 1;
+        info.mipCount = 5;
+        info.arraySize = 6;
+        info.isCubeMap = true;
+
+        // BC1 blocks are 8 bytes for each 4x4 pixels, rounded up: 4x2, 2x1,
+        // then single blocks for the 4x2, 2x1 and 1x1 levels.
+        manager.RegisterResident(info);
+        Check("DDS registration", "resident bytes", manager.GetResidentBytes(), 6 * 8 * (8 + 2 + 1 + 1 + 1));
+    }
+}
+
+int main()
+{
+    CheckTrimming();
+    CheckEviction();
+    CheckProtection();
+    CheckPartialGrant();
+    CheckBackendFailure();
+    CheckResidentTextures();
+    CheckDDSRegistration();
+
+    if (g_failures != 0)
+    {
+        fprintf(stderr, "%d checks failed\n", g_failures);
+        return 1;
+    }
+
+    printf("all checks passed\n");
+    return 0;
+}
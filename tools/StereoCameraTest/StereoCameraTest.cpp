@@ -0,0 +1,174 @@
+// StereoCameraTest: drives StereoCameraState, the dirty tracking behind
+// StereoCamera, and checks which parts of the camera each change rebuilds.
+// Prints each failure and exits with 1 if there was any.
+//
+//   StereoCameraTest
+//
+// The checks cover frames with no changes, view-only changes, changes to the
+// inputs of the projections, setters called with the current values, and the
+// exaggeration while stereo is off. StereoCamera rebuilds its projections
+// exactly when Update reports ChangedProjection, so the counts here are the
+// ones StereoCamera reports.
+//
+// The test only needs the portable sources of the sample and builds on Linux
+// or Windows; from this directory, for example:
+//
+//   g++ -std=c++17 -O2 -I../../d3d-stereo-sample -o StereoCameraTest StereoCameraTest.cpp
+//       ../../d3d-stereo-sample/StereoCameraState.cpp ../../d3d-stereo-sample/StereoParameters.cpp
+//       ../../d3d-stereo-sample/FrustumCulling.cpp ../../d3d-stereo-sample/MeshLod.cpp
+//       ../../d3d-stereo-sample/StereoDepth.cpp
+
+#include "StereoCameraState.h"
+#include <stdio.h>
+#include <string.h>
+
+namespace
+{
+    int g_failures = 0;
+
+    void Check(const char* test, const char* what, unsigned int value, unsigned int expected)
+    {
+        if (value != expected)
+        {
+            g_failures++;
+            fprintf(stderr, "FAIL %s: %s is %u, expected %u\n", test, what, value, expected);
+        }
+    }
+
+    // A camera set up as the sample does it, with the first frame's matrices
+    // already built.
+    void SetUp(StereoCameraState& camera)
+    {
+        camera.SetViewport(20.0f, 11.25f);
+        camera.SetWorldScale(2.0f);
+        camera.SetStereoExaggeration(1.0f);
+        camera.SetStereoEnabled(true);
+        camera.SetDepthRange(0.01f, 100.0f);
+        camera.SetView(translation(0.0f, -1.0f, -5.0f));
+        camera.Update();
+    }
+
+    // Checks the changes reported by the next Update and the counts after it.
+    void CheckUpdate(
+        const char* test,
+        StereoCameraState& camera,
+        unsigned int changes,
+        unsigned int recomputeCount,
+        unsigned int projectionRecomputeCount)
+    {
+        Check(test, "changes", camera.Update(), changes);
+        Check(test, "recompute count", camera.GetRecomputeCount(), recomputeCount);
+        Check(test, "projection recompute count", camera.GetProjectionRecomputeCount(), projectionRecomputeCount);
+    }
+
+    // A new camera builds everything once, and frames that change nothing,
+    // including frames that set the same values again, rebuild nothing.
+    void CheckUnchangedFrames()
+    {
+        StereoCameraState camera;
+        CheckUpdate("first frame", camera, StereoCameraState::ChangedProjection | StereoCameraState::ChangedView, 1, 1);
+
+        SetUp(camera);
+        Check("setup", "recompute count", camera.GetRecomputeCount(), 2);
+
+        for (int frame = 0; frame < 3; frame++)
+        {
+            CheckUpdate("unchanged frame", camera, StereoCameraState::ChangedNone, 2, 2);
+        }
+
+        SetUp(camera);
+        CheckUpdate("same values", camera, StereoCameraState::ChangedNone, 2, 2);
+    }
+
+    // Moving the camera rebuilds the view-projections and the frustum but
+    // none of the projections, and the frustum follows the view.
+    void CheckViewChange()
+    {
+        StereoCameraState camera;
+        SetUp(camera);
+        StereoParameters parameters = camera.GetParameters();
+        Frustum frustum = camera.GetFrustum();
+
+        camera.SetView(translation(1.0f, -1.0f, -5.0f));
+        CheckUpdate("view change", camera, StereoCameraState::ChangedView, 2, 1);
+        Check("view change", "parameters unchanged",
+            memcmp(&parameters, &camera.GetParameters(), sizeof(parameters)) == 0, 1);
+        Check("view change", "frustum rebuilt",
+            memcmp(&frustum, &camera.GetFrustum(), sizeof(frustum)) != 0, 1);
+
+        for (int frame = 0; frame < 4; frame++)
+        {
+            camera.SetView(translation(1.0f + frame, -1.0f, -5.0f));
+        }
+        CheckUpdate("view changes in one frame", camera, StereoCameraState::ChangedView, 3, 1);
+    }
+
+    // Each input of the projections rebuilds them once, however many times
+    // it changes between Updates.
+    void CheckProjectionChanges()
+    {
+        StereoCameraState camera;
+        SetUp(camera);
+
+        camera.SetViewport(30.0f, 16.875f);
+        CheckUpdate("viewport", camera, StereoCameraState::ChangedProjection, 2, 2);
+
+        camera.SetWorldScale(4.0f);
+        CheckUpdate("world scale", camera, StereoCameraState::ChangedProjection, 3, 3);
+
+        camera.SetStereoExaggeration(1.5f);
+        CheckUpdate("exaggeration", camera, StereoCameraState::ChangedProjection, 4, 4);
+
+        camera.SetDepthRange(0.1f, 100.0f);
+        CheckUpdate("depth range", camera, StereoCameraState::ChangedProjection, 5, 5);
+
+        camera.SetDepthMode(StereoDepthMode::InfiniteReverseZ);
+        CheckUpdate("depth mode", camera, StereoCameraState::ChangedProjection, 6, 6);
+
+        camera.SetStereoEnabled(false);
+        CheckUpdate("stereo off", camera, StereoCameraState::ChangedProjection, 7, 7);
+
+        camera.SetViewport(20.0f, 11.25f);
+        camera.SetWorldScale(2.0f);
+        camera.SetView(translation(0.0f, 0.0f, -5.0f));
+        CheckUpdate("projection and view", camera,
+            StereoCameraState::ChangedProjection | StereoCameraState::ChangedView, 8, 8);
+    }
+
+    // Mono rendering uses no eye separation, so the exaggeration only
+    // matters once stereo is turned back on.
+    void CheckMonoExaggeration()
+    {
+        StereoCameraState camera;
+        SetUp(camera);
+        camera.SetStereoEnabled(false);
+        CheckUpdate("mono", camera, StereoCameraState::ChangedProjection, 2, 2);
+        Check("mono", "interocular distance", camera.GetParameters().interocularDistance == 0.0f, 1);
+
+        camera.SetStereoExaggeration(2.0f);
+        CheckUpdate("mono exaggeration", camera, StereoCameraState::ChangedNone, 2, 2);
+
+        camera.SetStereoEnabled(true);
+        CheckUpdate("stereo on", camera, StereoCameraState::ChangedProjection, 3, 3);
+
+        // 1.25 inches at 2x exaggeration, in world units of 2 inches.
+        Check("stereo on", "interocular distance", camera.GetParameters().interocularDistance == 1.25f, 1);
+    }
+}
+
+int main()
+{
+    CheckUnchangedFrames();
+    CheckViewChange();
+    CheckProjectionChanges();
+    CheckMonoExaggeration();
+
+    if (g_failures != 0)
+    {
+        fprintf(stderr, "%d checks failed\n", g_failures);
+        return 1;
+    }
+
+    printf("all checks passed\n");
+    return 0;
+}